@@ -3,7 +3,13 @@ TARGET = basephone
 
 QT += quick multimedia
 
-LOCAL_SOURCES = main.cpp 
+# GStreamer tracers of the glass-to-glass latency, of multicast reception and of
+# packet loss recovery (see "latency.h", "multicast.h" and "recovery.h")
+CONFIG += link_pkgconfig
+PKGCONFIG += gstreamer-1.0 gstreamer-rtp-1.0
+
+LOCAL_SOURCES = main.cpp latency.cpp multicast.cpp recovery.cpp
+LOCAL_HEADERS = latency.h multicast.h recovery.h
 
 SOURCES += $$LOCAL_SOURCES
 HEADERS += $$LOCAL_HEADERS
@@ -0,0 +1,601 @@
+/*
+ * Glass-to-glass latency of streams stamped by outdoor, see "latency.h".
+ */
+
+#include <gst/gst.h>
+#include <gst/rtp/gstrtpbuffer.h>
+#include <gst/rtp/gstrtcpbuffer.h>
+
+#include <string.h>
+#include <algorithm>
+
+#include <QtCore/QDebug>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QStringList>
+
+#include "latency.h"
+
+/* Recent RTP timestamps and frames of a stream, latest frames shown on screen */
+#define LATENCY_MAX_ARRIVALS 128
+#define LATENCY_MAX_FRAMES 64
+#define LATENCY_RECENT_FRAMES 30
+
+/* Sender reports used to estimate the clock offset */
+#define LATENCY_MAX_REPORTS 8
+
+/* Seconds between 1900 (NTP) and 1970 (Unix) */
+#define LATENCY_NTP_UNIX_OFFSET G_GUINT64_CONSTANT(2208988800)
+
+/* NAL unit types and SEI payload type (user data unregistered) */
+#define LATENCY_NAL_SLICE 1
+#define LATENCY_NAL_IDR_SLICE 5
+#define LATENCY_NAL_SEI 6
+#define LATENCY_SEI_USER_DATA_UNREGISTERED 5
+
+static const guint8 latency_stamp_uuid[] = LATENCY_STAMP_UUID;
+static const char *latency_stage_names[] = { "encode", "network", "buffer", "decode", "present", "total" };
+
+static bool latency_installed = false;
+
+/* URL of the stream of every pipeline (reset when the pipeline changes state) */
+static QHash<GstObject *, QString> latency_urls;
+static QMutex latency_urls_lock;
+
+/* ---------- GStreamer tracer ---------- */
+
+typedef struct {
+    GstTracer parent;
+} LatencyTracer;
+
+typedef struct {
+    GstTracerClass parent_class;
+} LatencyTracerClass;
+
+G_DEFINE_TYPE(LatencyTracer, latency_tracer, GST_TYPE_TRACER)
+
+/* Checks if "object" is an element made by factory "name" */
+static bool latency_is_factory(GstObject *object, const char *name)
+{
+    GstElementFactory *factory;
+
+    if ((object == nullptr) || !GST_IS_ELEMENT(object))
+        return false;
+
+    factory = gst_element_get_factory(GST_ELEMENT(object));
+    return (factory != nullptr) && (g_strcmp0(GST_OBJECT_NAME(factory), name) == 0);
+}
+
+/* Checks if "object" is a video decoder */
+static bool latency_is_decoder(GstObject *object)
+{
+    GstElementFactory *factory;
+    const gchar *klass;
+
+    if ((object == nullptr) || !GST_IS_ELEMENT(object))
+        return false;
+
+    factory = gst_element_get_factory(GST_ELEMENT(object));
+    if (factory == nullptr)
+        return false;
+
+    klass = gst_element_factory_get_metadata(factory, GST_ELEMENT_METADATA_KLASS);
+    return (klass != nullptr) && (strstr(klass, "Decoder") != nullptr) && (strstr(klass, "Video") != nullptr);
+}
+
+/* Location of the first "rtspsrc" element of "bin", empty if none */
+static QString latency_find_location(GstBin *bin)
+{
+    GstIterator *iterator = gst_bin_iterate_recurse(bin);
+    GValue item = G_VALUE_INIT;
+    QString location;
+    gchar *value = nullptr;
+
+    while (location.isEmpty() && (gst_iterator_next(iterator, &item) == GST_ITERATOR_OK)) {
+        GstElement *element = GST_ELEMENT(g_value_get_object(&item));
+
+        if (latency_is_factory(GST_OBJECT(element), "rtspsrc")) {
+            g_object_get(element, "location", &value, NULL);
+            location = QString::fromUtf8(value);
+            g_free(value);
+        }
+
+        g_value_reset(&item);
+    }
+
+    g_value_unset(&item);
+    gst_iterator_free(iterator);
+
+    return location;
+}
+
+/* URL of the stream of the pipeline containing "object" (MediaPlayer source) */
+static QString latency_get_url(GstObject *object)
+{
+    GstObject *pipeline = object;
+    gchar *value = nullptr;
+    QString url;
+
+    while (GST_OBJECT_PARENT(pipeline) != nullptr)
+        pipeline = GST_OBJECT_PARENT(pipeline);
+
+    QMutexLocker locker(&latency_urls_lock);
+
+    if (latency_urls.contains(pipeline))
+        return latency_urls.value(pipeline);
+
+    /* "playbin" has the URL, other pipelines have an "rtspsrc" element */
+    if (g_object_class_find_property(G_OBJECT_GET_CLASS(pipeline), "uri") != nullptr) {
+        g_object_get(pipeline, "uri", &value, NULL);
+        url = QString::fromUtf8(value);
+        g_free(value);
+    } else if (GST_IS_BIN(pipeline)) {
+        url = latency_find_location(GST_BIN(pipeline));
+    }
+
+    if (!url.isEmpty())
+        latency_urls.insert(pipeline, url);
+
+    return url;
+}
+
+/* Reads the stamp of the access unit or NAL unit "data" (byte-stream or
+ * 4-byte lengths). The stamp is before the first slice */
+static bool latency_parse_stamp(const guint8 *data, gsize size, qint64 *captureTime, qint64 *encodeTime)
+{
+    bool byteStream = (size > 4) && (data[0] == 0) && (data[1] == 0) &&
+                      ((data[2] == 1) || ((data[2] == 0) && (data[3] == 1)));
+    gsize offset = 0;
+
+    while (offset + 4 < size) {
+        gsize start;
+        gsize end;
+
+        if (byteStream) {
+            /* Skip the start code, the NAL unit ends at the next one */
+            while ((offset + 3 < size) && !((data[offset] == 0) && (data[offset + 1] == 0) && (data[offset + 2] == 1)))
+                offset++;
+            start = offset + 3;
+            for (end = start; (end + 3 <= size) && !((data[end] == 0) && (data[end + 1] == 0) && (data[end + 2] <= 1)); end++)
+                ;
+            if (end + 3 > size)
+                end = size;
+        } else {
+            start = offset + 4;
+            end = start + GST_READ_UINT32_BE(data + offset);
+            if (end > size)
+                return false;
+        }
+
+        if (start >= end)
+            return false;
+
+        guint type = data[start] & 0x1f;
+        if ((type == LATENCY_NAL_SLICE) || (type == LATENCY_NAL_IDR_SLICE))
+            return false;
+
+        if (type == LATENCY_NAL_SEI) {
+            /* Remove emulation prevention bytes */
+            QByteArray rbsp;
+            int zeros = 0;
+
+            for (gsize index = start + 1; index < end; index++) {
+                if ((zeros >= 2) && (data[index] == 0x03)) {
+                    zeros = 0;
+                    continue;
+                }
+                rbsp.append(char(data[index]));
+                zeros = (data[index] == 0x00) ? zeros + 1 : 0;
+            }
+
+            /* SEI messages */
+            const guint8 *payload = reinterpret_cast<const guint8 *>(rbsp.constData());
+            int position = 0;
+
+            while (position < rbsp.size() - 1) {
+                guint payloadType = 0;
+                guint payloadSize = 0;
+
+                while ((position < rbsp.size()) && (payload[position] == 0xff))
+                    payloadType += payload[position++];
+                if (position < rbsp.size())
+                    payloadType += payload[position++];
+                while ((position < rbsp.size()) && (payload[position] == 0xff))
+                    payloadSize += payload[position++];
+                if (position < rbsp.size())
+                    payloadSize += payload[position++];
+
+                if (position + int(payloadSize) > rbsp.size())
+                    break;
+
+                if ((payloadType == LATENCY_SEI_USER_DATA_UNREGISTERED) && (payloadSize >= 32) &&
+                    (memcmp(payload + position, latency_stamp_uuid, sizeof(latency_stamp_uuid)) == 0)) {
+                    *captureTime = qint64(GST_READ_UINT64_BE(payload + position + 16));
+                    *encodeTime = qint64(GST_READ_UINT64_BE(payload + position + 24));
+                    return true;
+                }
+
+                position += payloadSize;
+            }
+        }
+
+        offset = end;
+    }
+
+    return false;
+}
+
+/* Hook "pad-push-pre": follows buffers of the stream through the pipeline */
+static void latency_on_pad_push(GObject *, GstClockTime, GstPad *pad, GstBuffer *buffer)
+{
+    GstPad *peer = GST_PAD_PEER(pad);
+    GstObject *parent = GST_OBJECT_PARENT(pad);
+    const gchar *peerName = (peer != nullptr) ? GST_OBJECT_NAME(peer) : nullptr;
+    LatencyMonitor *monitor = LatencyMonitor::instance();
+    qint64 now = g_get_real_time();
+
+    if ((peerName != nullptr) && g_str_has_prefix(peerName, "recv_rtp_sink_")) {
+        /* RTP packet received (UDP or interleaved in RTSP) */
+        GstRTPBuffer rtp = GST_RTP_BUFFER_INIT;
+
+        if (gst_rtp_buffer_map(buffer, GST_MAP_READ, &rtp)) {
+            monitor->packetReceived(latency_get_url(parent), gst_rtp_buffer_get_timestamp(&rtp), now);
+            gst_rtp_buffer_unmap(&rtp);
+        }
+    } else if ((peerName != nullptr) && g_str_has_prefix(peerName, "recv_rtcp_sink_")) {
+        /* RTCP: NTP time of sender reports (outdoor clock) */
+        GstRTCPBuffer rtcp = GST_RTCP_BUFFER_INIT;
+        GstRTCPPacket packet;
+
+        if (gst_rtcp_buffer_map(buffer, GST_MAP_READ, &rtcp)) {
+            for (gboolean more = gst_rtcp_buffer_get_first_packet(&rtcp, &packet); more;
+                 more = gst_rtcp_packet_move_to_next(&packet)) {
+                guint32 ssrc, rtpTime, packets, octets;
+                guint64 ntpTime;
+
+                if (gst_rtcp_packet_get_type(&packet) != GST_RTCP_TYPE_SR)
+                    continue;
+
+                gst_rtcp_packet_sr_get_sender_info(&packet, &ssrc, &ntpTime, &rtpTime, &packets, &octets);
+                monitor->senderReport(latency_get_url(parent),
+                                      qint64((ntpTime >> 32) - LATENCY_NTP_UNIX_OFFSET) * G_USEC_PER_SEC +
+                                      qint64(((ntpTime & 0xffffffff) * G_USEC_PER_SEC) >> 32), now);
+            }
+            gst_rtcp_buffer_unmap(&rtcp);
+        }
+    } else if ((peer != nullptr) && latency_is_factory(GST_OBJECT_PARENT(peer), "rtph264depay")) {
+        /* Out of the jitter buffer: PTS of the RTP timestamp */
+        GstRTPBuffer rtp = GST_RTP_BUFFER_INIT;
+
+        if (GST_BUFFER_PTS_IS_VALID(buffer) && gst_rtp_buffer_map(buffer, GST_MAP_READ, &rtp)) {
+            monitor->packetDepayloaded(latency_get_url(parent), gst_rtp_buffer_get_timestamp(&rtp),
+                                       GST_BUFFER_PTS(buffer));
+            gst_rtp_buffer_unmap(&rtp);
+        }
+    } else if (latency_is_factory(parent, "rtph264depay")) {
+        /* Access unit (or NAL unit) out of the depayloader */
+        GstMapInfo map;
+        qint64 captureTime = 0;
+        qint64 encodeTime = 0;
+
+        if (GST_BUFFER_PTS_IS_VALID(buffer) && gst_buffer_map(buffer, &map, GST_MAP_READ)) {
+            if (latency_parse_stamp(map.data, map.size, &captureTime, &encodeTime))
+                monitor->frameDepayloaded(latency_get_url(parent), GST_BUFFER_PTS(buffer),
+                                          captureTime, encodeTime, now);
+            gst_buffer_unmap(buffer, &map);
+        }
+    } else if (latency_is_decoder(parent) && GST_BUFFER_PTS_IS_VALID(buffer)) {
+        monitor->frameDecoded(latency_get_url(parent), GST_BUFFER_PTS(buffer), now);
+    }
+}
+
+/* Hook "pad-push-list-pre" */
+static void latency_on_pad_push_list(GObject *self, GstClockTime ts, GstPad *pad, GstBufferList *list)
+{
+    for (guint index = 0; index < gst_buffer_list_length(list); index++)
+        latency_on_pad_push(self, ts, pad, gst_buffer_list_get(list, index));
+}
+
+/* Hook "element-change-state-post": the URL of a pipeline may change */
+static void latency_on_change_state(GObject *, GstClockTime, GstElement *element,
+                                    GstStateChange, GstStateChangeReturn)
+{
+    if (GST_OBJECT_PARENT(element) == nullptr) {
+        QMutexLocker locker(&latency_urls_lock);
+        latency_urls.remove(GST_OBJECT(element));
+    }
+}
+
+static void latency_tracer_class_init(LatencyTracerClass *)
+{
+}
+
+static void latency_tracer_init(LatencyTracer *self)
+{
+    GstTracer *tracer = GST_TRACER(self);
+
+    gst_tracing_register_hook(tracer, "pad-push-pre", G_CALLBACK(latency_on_pad_push));
+    gst_tracing_register_hook(tracer, "pad-push-list-pre", G_CALLBACK(latency_on_pad_push_list));
+    gst_tracing_register_hook(tracer, "element-change-state-post", G_CALLBACK(latency_on_change_state));
+}
+
+/* ---------- LatencyMonitor ---------- */
+
+LatencyMonitor::LatencyMonitor(QObject *parent) : QObject(parent)
+{
+    connect(&m_timer, &QTimer::timeout, this, &LatencyMonitor::logPercentiles);
+    m_timer.start(LATENCY_LOG_INTERVAL * 1000);
+}
+
+LatencyMonitor *LatencyMonitor::instance()
+{
+    static LatencyMonitor monitor;
+    return &monitor;
+}
+
+void LatencyMonitor::install()
+{
+    if (latency_installed)
+        return;
+
+    /* MediaPlayer initializes GStreamer again, it has no effect.
+     * The tracer stays registered until exit */
+    gst_init(nullptr, nullptr);
+    instance();
+    gst_object_ref_sink(g_object_new(latency_tracer_get_type(), nullptr));
+
+    latency_installed = true;
+    qDebug() << "Glass-to-glass latency: enabled (streams must be stamped by outdoor --latency-stamp)";
+}
+
+bool LatencyMonitor::isInstalled()
+{
+    return latency_installed;
+}
+
+void LatencyMonitor::senderReport(const QString &url, qint64 senderTime, qint64 time)
+{
+    QMutexLocker locker(&m_lock);
+    Stream &stream = m_streams[url];
+
+    /* The smallest difference has the smallest network delay */
+    stream.offsets.append(time - senderTime);
+    if (stream.offsets.size() > LATENCY_MAX_REPORTS)
+        stream.offsets.removeFirst();
+
+    stream.offset = stream.offsets.first();
+    for (qint64 offset : stream.offsets)
+        stream.offset = qMin(stream.offset, offset);
+}
+
+void LatencyMonitor::packetReceived(const QString &url, quint32 rtpTime, qint64 time)
+{
+    QMutexLocker locker(&m_lock);
+    Stream &stream = m_streams[url];
+
+    /* Packets of a frame share its RTP timestamp, the first one is kept */
+    for (int index = stream.arrivals.size() - 1; index >= 0; index--) {
+        if (stream.arrivals.at(index).first == rtpTime)
+            return;
+    }
+
+    stream.arrivals.append(qMakePair(rtpTime, time));
+    if (stream.arrivals.size() > LATENCY_MAX_ARRIVALS)
+        stream.arrivals.removeFirst();
+}
+
+void LatencyMonitor::packetDepayloaded(const QString &url, quint32 rtpTime, quint64 pts)
+{
+    QMutexLocker locker(&m_lock);
+    Stream &stream = m_streams[url];
+    Frame frame = { pts, 0, 0, 0, 0, 0 };
+
+    if (findFrame(stream, pts) != nullptr)
+        return;
+
+    for (const QPair<quint32, qint64> &arrival : stream.arrivals) {
+        if (arrival.first == rtpTime)
+            frame.received = arrival.second;
+    }
+
+    stream.frames.append(frame);
+    if (stream.frames.size() > LATENCY_MAX_FRAMES)
+        stream.frames.removeFirst();
+}
+
+void LatencyMonitor::frameDepayloaded(const QString &url, quint64 pts, qint64 captureTime,
+                                      qint64 encodeTime, qint64 time)
+{
+    QMutexLocker locker(&m_lock);
+    Frame *frame = findFrame(m_streams[url], pts);
+
+    if (frame != nullptr) {
+        frame->capture = captureTime;
+        frame->encoded = encodeTime;
+        frame->depayloaded = time;
+    }
+}
+
+void LatencyMonitor::frameDecoded(const QString &url, quint64 pts, qint64 time)
+{
+    QMutexLocker locker(&m_lock);
+    Frame *frame = findFrame(m_streams[url], pts);
+
+    if ((frame != nullptr) && (frame->decoded == 0))
+        frame->decoded = time;
+}
+
+void LatencyMonitor::framePresented(const QString &url, qint64 pts, qint64 time)
+{
+    QMutexLocker locker(&m_lock);
+    Stream &stream = m_streams[url];
+    Sample sample;
+
+    for (int index = 0; index < stream.frames.size(); index++) {
+        const Frame &frame = stream.frames.at(index);
+
+        if (qint64(frame.pts / 1000) != pts)
+            continue;
+
+        if ((frame.capture != 0) && (frame.decoded != 0)) {
+            /* Frames without RTP arrival are counted in the network stage */
+            qint64 received = (frame.received != 0) ? frame.received : frame.depayloaded;
+
+            sample.stages[Encode] = frame.encoded - frame.capture;
+            sample.stages[Network] = received - (frame.encoded + stream.offset);
+            sample.stages[Buffer] = frame.depayloaded - received;
+            sample.stages[Decode] = frame.decoded - frame.depayloaded;
+            sample.stages[Present] = time - frame.decoded;
+            sample.stages[Total] = time - (frame.capture + stream.offset);
+
+            stream.samples.append(sample);
+            stream.recent.append(sample);
+            if (stream.recent.size() > LATENCY_RECENT_FRAMES)
+                stream.recent.removeFirst();
+        }
+
+        /* Older frames were not presented (dropped) */
+        stream.frames.remove(0, index + 1);
+        break;
+    }
+}
+
+QString LatencyMonitor::summary(const QString &url)
+{
+    QMutexLocker locker(&m_lock);
+    qint64 sums[StageCount] = { 0 };
+
+    if (!m_streams.contains(url) || m_streams[url].recent.isEmpty())
+        return QString();
+
+    const QVector<Sample> &recent = m_streams[url].recent;
+    for (const Sample &sample : recent) {
+        for (int stage = 0; stage < StageCount; stage++)
+            sums[stage] += sample.stages[stage];
+    }
+
+    return QString::asprintf("%.0f ms = encode %.0f + network %.0f + buffer %.0f + decode %.0f + present %.0f",
+                             sums[Total] / 1000.0 / recent.size(), sums[Encode] / 1000.0 / recent.size(),
+                             sums[Network] / 1000.0 / recent.size(), sums[Buffer] / 1000.0 / recent.size(),
+                             sums[Decode] / 1000.0 / recent.size(), sums[Present] / 1000.0 / recent.size());
+}
+
+void LatencyMonitor::logPercentiles()
+{
+    QMutexLocker locker(&m_lock);
+
+    for (auto it = m_streams.begin(); it != m_streams.end(); ++it) {
+        Stream &stream = it.value();
+        QStringList stages;
+
+        if (stream.samples.isEmpty())
+            continue;
+
+        for (int stage = 0; stage < StageCount; stage++) {
+            QVector<qint64> values;
+
+            for (const Sample &sample : stream.samples)
+                values.append(sample.stages[stage]);
+
+            stages << QString::asprintf("%s p50 %.1f p95 %.1f p99 %.1f", latency_stage_names[stage],
+                                        percentile(values, 50) / 1000.0, percentile(values, 95) / 1000.0,
+                                        percentile(values, 99) / 1000.0);
+        }
+
+        qDebug().noquote() << QString::asprintf("Latency of %s (%d frames, clock offset %s):",
+                                                qPrintable(it.key()), stream.samples.size(),
+                                                stream.offsets.isEmpty() ? "none" :
+                                                qPrintable(QString::asprintf("%+.1f ms", stream.offset / 1000.0)))
+                           << stages.join(", ") << "(ms)";
+
+        stream.samples.clear();
+    }
+}
+
+LatencyMonitor::Frame *LatencyMonitor::findFrame(Stream &stream, quint64 pts)
+{
+    for (int index = stream.frames.size() - 1; index >= 0; index--) {
+        if (stream.frames.at(index).pts == pts)
+            return &stream.frames[index];
+    }
+
+    return nullptr;
+}
+
+qint64 LatencyMonitor::percentile(QVector<qint64> &values, int percent)
+{
+    std::sort(values.begin(), values.end());
+    return values.at((values.size() - 1) * percent / 100);
+}
+
+/* ---------- LatencyFilter ---------- */
+
+class LatencyFilterRunnable : public QVideoFilterRunnable
+{
+public:
+    explicit LatencyFilterRunnable(LatencyFilter *filter) : m_filter(filter) {}
+
+    /* Called by the render thread just before the frame is drawn */
+    QVideoFrame run(QVideoFrame *input, const QVideoSurfaceFormat &, RunFlags) override
+    {
+        if (input->startTime() >= 0)
+            LatencyMonitor::instance()->framePresented(m_filter->url(), input->startTime(), g_get_real_time());
+
+        return *input;
+    }
+
+private:
+    LatencyFilter *m_filter;
+};
+
+LatencyFilter::LatencyFilter(QObject *parent) : QAbstractVideoFilter(parent)
+{
+    connect(&m_timer, &QTimer::timeout, this, &LatencyFilter::update);
+
+    if (LatencyMonitor::isInstalled())
+        m_timer.start(1000);
+}
+
+QVideoFilterRunnable *LatencyFilter::createFilterRunnable()
+{
+    return new LatencyFilterRunnable(this);
+}
+
+QUrl LatencyFilter::source() const
+{
+    return m_source;
+}
+
+void LatencyFilter::setSource(const QUrl &source)
+{
+    if (source == m_source)
+        return;
+
+    m_source = source;
+
+    m_lock.lock();
+    m_url = source.toString();
+    m_lock.unlock();
+
+    emit sourceChanged();
+}
+
+QString LatencyFilter::url()
+{
+    QMutexLocker locker(&m_lock);
+    return m_url;
+}
+
+QString LatencyFilter::text() const
+{
+    return m_text;
+}
+
+void LatencyFilter::update()
+{
+    QString text = LatencyMonitor::instance()->summary(url());
+
+    if (text != m_text) {
+        m_text = text;
+        emit textChanged();
+    }
+}
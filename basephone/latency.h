@@ -0,0 +1,154 @@
+/*
+ * Glass-to-glass latency of streams stamped by outdoor ("--latency-stamp").
+ *
+ * outdoor inserts an SEI message in every access unit with the wall-clock
+ * times (us since 1970, on the outdoor board) of its capture and of its
+ * encoding (see "outdoor/stamp.h"). The basephone follows every frame
+ * through the GStreamer pipelines of MediaPlayer with a tracer (pad hooks,
+ * no change to the pipelines) and through VideoOutput with a video filter:
+ *
+ *   capture -> encode   (outdoor clock: both times of the stamp)
+ *   encode  -> network  (first RTP packet of the frame received)
+ *   network -> buffer   (frame out of the jitter buffer and depayloader)
+ *   buffer  -> decode   (frame out of the decoder)
+ *   decode  -> present  (frame handed to the scene graph for rendering)
+ *
+ * Outdoor times are mapped to the basephone clock with RTCP sender
+ * reports: their NTP timestamp is the outdoor wall clock when they were
+ * sent. The offset is the smallest difference between arrival and NTP
+ * time of recent reports, so the network stage excludes the smallest
+ * one-way delay (less than 1 ms on a LAN). Until the first report, both
+ * clocks are assumed to be synchronized (single board mode).
+ *
+ * The latest breakdown is shown on every stream, and percentiles are
+ * logged every LATENCY_LOG_INTERVAL seconds.
+ */
+
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QObject>
+#include <QtCore/QPair>
+#include <QtCore/QString>
+#include <QtCore/QTimer>
+#include <QtCore/QUrl>
+#include <QtCore/QVector>
+#include <QtMultimedia/QAbstractVideoFilter>
+
+/* UUID of stamps (must match "STAMP_UUID" of outdoor) */
+#define LATENCY_STAMP_UUID { 0x52, 0x5a, 0x47, 0x32, 0x2d, 0x64, 0x6f, 0x6f, \
+                             0x72, 0x70, 0x68, 0x6f, 0x6e, 0x65, 0x2d, 0x74 }
+
+/* Interval of percentile logs (seconds) */
+#define LATENCY_LOG_INTERVAL 10
+
+class LatencyMonitor : public QObject
+{
+    Q_OBJECT
+
+public:
+    /* Stages of a frame, in order */
+    enum Stage { Encode, Network, Buffer, Decode, Present, Total, StageCount };
+
+    static LatencyMonitor *instance();
+
+    /* Registers the GStreamer tracer which follows frames of all pipelines.
+     * Must be called before MediaPlayer creates pipelines */
+    static void install();
+    static bool isInstalled();
+
+    /* From streaming threads. Times are wall-clock times (us since 1970),
+     * "pts" are timestamps of the pipeline (ns) */
+    void senderReport(const QString &url, qint64 senderTime, qint64 time);
+    void packetReceived(const QString &url, quint32 rtpTime, qint64 time);
+    void packetDepayloaded(const QString &url, quint32 rtpTime, quint64 pts);
+    void frameDepayloaded(const QString &url, quint64 pts, qint64 captureTime,
+                          qint64 encodeTime, qint64 time);
+    void frameDecoded(const QString &url, quint64 pts, qint64 time);
+
+    /* From the render thread, "pts" in us (QVideoFrame::startTime) */
+    void framePresented(const QString &url, qint64 pts, qint64 time);
+
+    /* Average breakdown of the latest frames of "url", empty if unknown */
+    QString summary(const QString &url);
+
+private slots:
+    void logPercentiles();
+
+private:
+    struct Frame {
+        quint64 pts;
+        qint64 received;
+        qint64 capture;
+        qint64 encoded;
+        qint64 depayloaded;
+        qint64 decoded;
+    };
+
+    struct Sample {
+        qint64 stages[StageCount];
+    };
+
+    struct Stream {
+        /* First arrival of recent RTP timestamps */
+        QVector<QPair<quint32, qint64> > arrivals;
+
+        /* Frames between depayloader and display, in order */
+        QVector<Frame> frames;
+
+        /* Arrival minus NTP time of recent sender reports */
+        QVector<qint64> offsets;
+        qint64 offset = 0;
+
+        QVector<Sample> samples;
+        QVector<Sample> recent;
+    };
+
+    explicit LatencyMonitor(QObject *parent = nullptr);
+
+    Frame *findFrame(Stream &stream, quint64 pts);
+
+    static qint64 percentile(QVector<qint64> &values, int percent);
+
+    QMutex m_lock;
+    QHash<QString, Stream> m_streams;
+    QTimer m_timer;
+};
+
+class LatencyFilter : public QAbstractVideoFilter
+{
+    Q_OBJECT
+    Q_PROPERTY(QUrl source READ source WRITE setSource NOTIFY sourceChanged)
+    Q_PROPERTY(QString text READ text NOTIFY textChanged)
+
+public:
+    explicit LatencyFilter(QObject *parent = nullptr);
+
+    QVideoFilterRunnable *createFilterRunnable() override;
+
+    QUrl source() const;
+    void setSource(const QUrl &source);
+
+    /* URL of the stream, for the render thread */
+    QString url();
+
+    QString text() const;
+
+signals:
+    void sourceChanged();
+    void textChanged();
+
+private slots:
+    void update();
+
+private:
+    QUrl m_source;
+    QString m_url;
+    QString m_text;
+    QMutex m_lock;
+    QTimer m_timer;
+};
+
+#endif // LATENCY_H
@@ -44,6 +44,10 @@
 #include <QtCore/QTimer>
 #include <signal.h>
 
+#include "latency.h"
+#include "multicast.h"
+#include "recovery.h"
+
 void exit_properly (int);
 static QGuiApplication *p_app;
 
@@ -53,11 +57,35 @@ int main(int argc, char *argv[])
     QQmlApplicationEngine engine;
     p_app = &app;	/* For calling quit in signal handler */
     QString serverIpParam("192.168.5.182");
+    bool latencyEnabled = false;
+    bool multicastEnabled = false;
+    bool recoveryEnabled = false;
 
-    if (argc > 1) {
-        serverIpParam = argv[1];
+    // Usage: basephone [server IP] [--latency] [--multicast] [--recovery]
+    for (int i = 1; i < argc; i++) {
+        if (QString(argv[i]) == "--latency")
+            latencyEnabled = true;
+        else if (QString(argv[i]) == "--multicast")
+            multicastEnabled = true;
+        else if (QString(argv[i]) == "--recovery")
+            recoveryEnabled = true;
+        else
+            serverIpParam = argv[i];
     }
 
+    // Glass-to-glass latency of streams stamped by outdoor (before MediaPlayer starts GStreamer)
+    if (latencyEnabled)
+        LatencyMonitor::install();
+    qmlRegisterType<LatencyFilter>("Doorphone", 1, 0, "LatencyFilter");
+
+    // Join multicast groups of outdoor --multicast (unicast over TCP otherwise)
+    if (multicastEnabled)
+        Multicast::install();
+
+    // Recover lost packets with NACKs and ULPFEC of outdoor (AVPF profile)
+    if (recoveryEnabled)
+        Recovery::install();
+
     //Show information of screen (all monitors)
     // If 2 screen availabe, chose the larger as it is usually default
     QScreen *screen;
@@ -84,6 +112,7 @@ int main(int argc, char *argv[])
     engine.rootContext()->setContextProperty("screenHeight", screen->availableSize().height() );
     engine.rootContext()->setContextProperty("screenWidth", screen->availableSize().width());
     engine.rootContext()->setContextProperty("serverIP", serverIpParam);
+    engine.rootContext()->setContextProperty("latencyEnabled", latencyEnabled);
 
     engine.load(QUrl(QStringLiteral("qrc:/qml/main.qml")));
 
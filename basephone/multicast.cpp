@@ -0,0 +1,57 @@
+/*
+ * Multicast reception of streams published by outdoor, see "multicast.h".
+ */
+
+#include <gst/gst.h>
+
+#include <QtCore/QDebug>
+
+#include "multicast.h"
+
+static bool multicast_installed = false;
+
+/* ---------- GStreamer tracer ---------- */
+
+typedef struct {
+    GstTracer parent;
+} MulticastTracer;
+
+typedef struct {
+    GstTracerClass parent_class;
+} MulticastTracerClass;
+
+G_DEFINE_TYPE(MulticastTracer, multicast_tracer, GST_TYPE_TRACER)
+
+/* Elements are configured when they are created, before "rtspsrc" connects */
+static void multicast_on_element_new(GObject *, GstClockTime, GstElement *element)
+{
+    GstElementFactory *factory = gst_element_get_factory(element);
+
+    if ((factory != nullptr) && (g_strcmp0(GST_OBJECT_NAME(factory), "rtspsrc") == 0))
+        gst_util_set_object_arg(G_OBJECT(element), "protocols", MULTICAST_PROTOCOLS);
+}
+
+static void multicast_tracer_class_init(MulticastTracerClass *)
+{
+}
+
+static void multicast_tracer_init(MulticastTracer *self)
+{
+    gst_tracing_register_hook(GST_TRACER(self), "element-new", G_CALLBACK(multicast_on_element_new));
+}
+
+/* ---------- Multicast ---------- */
+
+void Multicast::install()
+{
+    if (multicast_installed)
+        return;
+
+    /* MediaPlayer initializes GStreamer again, it has no effect.
+     * The tracer stays registered until exit */
+    gst_init(nullptr, nullptr);
+    gst_object_ref_sink(g_object_new(multicast_tracer_get_type(), nullptr));
+
+    multicast_installed = true;
+    qDebug() << "Multicast: enabled (" MULTICAST_PROTOCOLS ")";
+}
@@ -0,0 +1,26 @@
+/*
+ * Multicast reception of streams published by outdoor with "--multicast".
+ *
+ * MediaPlayer plays RTSP streams with "rtspsrc", which asks for unicast UDP
+ * first. Once installed, every "rtspsrc" asks for the multicast group of
+ * the stream instead (advertised in its SDP), so that all basephones of a
+ * LAN share one send of outdoor. If the mount point has no multicast
+ * transport, or if no packet of the group arrives (such as: IGMP snooping
+ * or a router drops it), "rtspsrc" falls back to unicast over TCP.
+ */
+
+#ifndef MULTICAST_H
+#define MULTICAST_H
+
+/* Transports asked by "rtspsrc", in order (see its "protocols" property) */
+#define MULTICAST_PROTOCOLS "udp-mcast+tcp"
+
+class Multicast
+{
+public:
+    /* Registers the GStreamer tracer which configures new "rtspsrc" elements.
+     * Must be called before MediaPlayer creates pipelines */
+    static void install();
+};
+
+#endif // MULTICAST_H
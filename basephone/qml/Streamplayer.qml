@@ -1,17 +1,23 @@
 import QtQuick 2.5
-import QtMultimedia 5.4
+import QtMultimedia 5.5
+import Doorphone 1.0
 
 /*Streamplayer qml type use MediaPlayer to receive rtsp server stream
  *Source of stream is set by source property
+ *If sub_source is set, it is played instead of source while the player is a
+ *subscreen (low resolution substream of the same camera)
  *There is a label on the top left of the rectangle which can be set text
- *by title property*/
+ *by title property
+ *With "--latency", the glass-to-glass latency of the stream is shown on the
+ *bottom left (see "latency.h")*/
 
 Rectangle {
     id: root
     visible: true
 
     property alias color: stream_field.color
-    property alias source: media_player.source
+    property string source: "rtsp://192.168.5.182:5001/camera-1"
+    property string sub_source: ""
     property alias mouse_area_enabled: mouse_area.enabled
     property alias mouse_area: mouse_area
     property alias title: title.text
@@ -42,7 +48,7 @@ Rectangle {
 
         MediaPlayer {
             id: media_player
-            source: "rtsp://192.168.5.182:5001/camera"
+            source: (root.main_screen || root.sub_source === "") ? root.source : root.sub_source
 
             Component.onCompleted: {
                 media_player.play()
@@ -55,12 +61,18 @@ Rectangle {
             }
         }
 
+        LatencyFilter {
+            id: latency_filter
+            source: media_player.source
+        }
+
         VideoOutput {
             id: video_output
             anchors.fill: parent
             fillMode: VideoOutput.Stretch
             visible: true
             source: media_player
+            filters: latencyEnabled ? [latency_filter] : []
         }
 
         Rectangle {
@@ -84,6 +96,28 @@ Rectangle {
             text: qsTr("STREAM 1")
         }
 
+        Rectangle {
+            id: latency_field
+            anchors.left: parent.left
+            anchors.bottom: parent.bottom
+            width: latency_text.width + 20 * scalew
+            height: 30 * scaleh
+            color: "black"
+            opacity: 0.4
+            visible: latencyEnabled && (latency_text.text !== "")
+        }
+
+        Text {
+            id: latency_text
+            anchors.verticalCenter: latency_field.verticalCenter
+            anchors.horizontalCenter: latency_field.horizontalCenter
+            font.family: "Open Sans"
+            color: "white"
+            font.pixelSize: 14 * scaleh
+            visible: latency_field.visible
+            text: latency_filter.text
+        }
+
         /*When the subscreen is clicked, it will change width, height and position
          *to become main screen and the main screen will change width, height and
          *position to become subscreen*/
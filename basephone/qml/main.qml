@@ -78,8 +78,9 @@ Window {
             x: 30 * scalew
             y: 20 * scaleh
             color: "#ECECEC"
-            source: "rtsp://" + serverIP + ":5001/camera" // "serverIP" is one-time variable.
+            source: "rtsp://" + serverIP + ":5001/camera-1" // "serverIP" is one-time variable.
                                                           // Do not use for other purposes.
+            sub_source: "rtsp://" + serverIP + ":5001/camera-1/sub"
             main_screen: true
             title: "STREAM 1"
             mouse_area.onClicked: {
@@ -94,7 +95,8 @@ Window {
             x : 1350 * scalew                      //stream1.x + stream1.width + 40
             y : 20 * scaleh
             color: "#ECECEC"
-            source: "rtsp://" + serverIP + ":5002/camera"
+            source: "rtsp://" + serverIP + ":5001/camera-2"
+            sub_source: "rtsp://" + serverIP + ":5001/camera-2/sub"
             main_screen: false
             title: "STREAM 2"
             mouse_area.onClicked: {
@@ -109,7 +111,8 @@ Window {
             x : 1350 * scalew
             y : 380 * scaleh                        //stream2.y + stream2.height + 40
             color: "#ECECEC"
-            source: "rtsp://" + serverIP + ":5003/camera"
+            source: "rtsp://" + serverIP + ":5001/camera-3"
+            sub_source: "rtsp://" + serverIP + ":5001/camera-3/sub"
             main_screen: false
             title: "STREAM 3"
             mouse_area.onClicked: {
@@ -124,7 +127,8 @@ Window {
             x : 1350 * scalew
             y : 740 * scaleh                        //stream3.y + stream3.height + 40
             color: "#ECECEC"
-            source: "rtsp://" + serverIP + ":5004/camera"
+            source: "rtsp://" + serverIP + ":5001/camera-4"
+            sub_source: "rtsp://" + serverIP + ":5001/camera-4/sub"
             main_screen: false
             title: "STREAM 4"
             mouse_area.onClicked: {
@@ -327,21 +331,25 @@ Window {
                             if (cam1_input.placeholderVisible !== true) {
                                 stream1.stop_media()
                                 stream1.source = cam1_input.text
+                                stream1.sub_source = ""
                                 stream1.play_media()
                             }
                             if (cam2_input.placeholderVisible !== true) {
                                 stream2.stop_media()
                                 stream2.source = cam2_input.text
+                                stream2.sub_source = ""
                                 stream2.play_media()
                             }
                             if (cam3_input.placeholderVisible !== true) {
                                 stream3.stop_media()
                                 stream3.source = cam3_input.text
+                                stream3.sub_source = ""
                                 stream3.play_media()
                             }
                             if (cam4_input.placeholderVisible !== true) {
                                 stream4.stop_media()
                                 stream4.source = cam4_input.text
+                                stream4.sub_source = ""
                                 stream4.play_media()
                             }
                             setting_dialog.visible = false
@@ -0,0 +1,61 @@
+/*
+ * Packet loss recovery of streams published by outdoor, see "recovery.h".
+ */
+
+#include <gst/gst.h>
+
+#include <QtCore/QDebug>
+
+#include "recovery.h"
+
+static bool recovery_installed = false;
+
+/* ---------- GStreamer tracer ---------- */
+
+typedef struct {
+    GstTracer parent;
+} RecoveryTracer;
+
+typedef struct {
+    GstTracerClass parent_class;
+} RecoveryTracerClass;
+
+G_DEFINE_TYPE(RecoveryTracer, recovery_tracer, GST_TYPE_TRACER)
+
+/* Elements are configured when they are created, before "rtspsrc" connects */
+static void recovery_on_element_new(GObject *, GstClockTime, GstElement *element)
+{
+    GstElementFactory *factory = gst_element_get_factory(element);
+
+    if ((factory == nullptr) || (g_strcmp0(GST_OBJECT_NAME(factory), "rtspsrc") != 0))
+        return;
+
+    /* NACKs need RTCP feedback, ULPFEC is taken from the SDP */
+    gst_util_set_object_arg(G_OBJECT(element), "profiles", RECOVERY_PROFILES);
+    g_object_set(element, "do-retransmission", TRUE, nullptr);
+}
+
+static void recovery_tracer_class_init(RecoveryTracerClass *)
+{
+}
+
+static void recovery_tracer_init(RecoveryTracer *self)
+{
+    gst_tracing_register_hook(GST_TRACER(self), "element-new", G_CALLBACK(recovery_on_element_new));
+}
+
+/* ---------- Recovery ---------- */
+
+void Recovery::install()
+{
+    if (recovery_installed)
+        return;
+
+    /* MediaPlayer initializes GStreamer again, it has no effect.
+     * The tracer stays registered until exit */
+    gst_init(nullptr, nullptr);
+    gst_object_ref_sink(g_object_new(recovery_tracer_get_type(), nullptr));
+
+    recovery_installed = true;
+    qDebug() << "Recovery: enabled (" RECOVERY_PROFILES ", NACK and ULPFEC)";
+}
@@ -0,0 +1,31 @@
+/*
+ * Packet loss recovery of streams published by outdoor ("--retransmission",
+ * "--fec").
+ *
+ * A single lost packet of a keyframe corrupts the video until the next one.
+ * Once installed, every "rtspsrc" asks for the AVPF profile (RTCP feedback):
+ * its jitter buffer sends a NACK for every missing packet, and outdoor sends
+ * it again in its RTX stream (RFC 4588). Mount points protected by ULPFEC
+ * advertise it in their SDP, "rtspsrc" repairs lost packets with it (no
+ * round trip). Repaired packets must arrive within the jitter buffer of
+ * MediaPlayer ("rtspsrc" latency), which is not made longer.
+ *
+ * outdoor must publish AVPF ("--retransmission" greater than 0, the
+ * default), otherwise "rtspsrc" finds no stream to play.
+ */
+
+#ifndef RECOVERY_H
+#define RECOVERY_H
+
+/* Profile asked by "rtspsrc" (see its "profiles" property) */
+#define RECOVERY_PROFILES "avpf"
+
+class Recovery
+{
+public:
+    /* Registers the GStreamer tracer which configures new "rtspsrc" elements.
+     * Must be called before MediaPlayer creates pipelines */
+    static void install();
+};
+
+#endif // RECOVERY_H
@@ -0,0 +1,456 @@
+/***********************************************************************
+ * FILENAME: abr.c
+ *
+ * DESCRIPTION:
+ *   Adaptive bitrate of camera encoders.
+ *
+ * NOTE:
+ *   For more further information about datatypes and function usages,
+ *   please refer to "abr.h".
+ *
+ * AUTHOR: RVC       START DATE: 16/10/2026
+ *
+ * CHANGES:
+ *
+ ***********************************************************************/
+
+/* ---------- Header files ---------- */
+
+#include <glib.h>
+#include <glib/gprintf.h>
+
+#include <gst/gst.h>
+#include <gst/rtsp-server/rtsp-server.h>
+
+#include "abr.h"
+
+/* ---------- Macros ---------- */
+
+/* Congestion thresholds: fraction of lost packets and interarrival jitter */
+#define ABR_LOSS_HIGH 0.05
+#define ABR_LOSS_LOW 0.01
+#define ABR_JITTER_HIGH_MS 50.0
+
+/* Multiplicative decrease, additive increase (fraction of the ceiling) */
+#define ABR_DECREASE_FACTOR 0.75
+#define ABR_INCREASE_STEP 0.10
+
+/* Number of updates without loss before increasing the bitrate */
+#define ABR_INCREASE_DELAY 3
+
+/* Clock rate of H.264 RTP streams (jitter unit) */
+#define ABR_DEFAULT_CLOCK_RATE 90000
+
+/* ---------- Datatypes ---------- */
+
+struct abr_t
+{
+    gchar *name;
+
+    GstElement *encoder;
+
+    const gchar *bitrate_property;
+
+    guint bitrate_unit;
+
+    enum abr_policy_t policy;
+
+    guint min_bitrate;
+
+    guint max_bitrate;
+
+    guint bitrate;
+
+    gint stable_counts;
+};
+
+/* ---------- Private functions ---------- */
+
+/*
+ * Function: abr_get_reports
+ * ---
+ *   Collects the latest receiver report of every client of "media".
+ *
+ *   losses: Fractions of lost packets (gdouble, 0.0 to 1.0).
+ *   jitters: Interarrival jitters (gdouble, milliseconds).
+ *
+ *   return: void.
+ */
+static void abr_get_reports(GstRTSPMedia *media, GArray *losses, GArray *jitters);
+
+/*
+ * Function: abr_select
+ * ---
+ *   Combine values of all clients according to "policy".
+ *
+ *   return: gdouble (the worst or the median value).
+ */
+static gdouble abr_select(GArray *values, const enum abr_policy_t policy);
+
+/*
+ * Function: abr_compare
+ * ---
+ *   Compare function for "g_array_sort" (ascending gdouble values).
+ */
+static gint abr_compare(gconstpointer a, gconstpointer b);
+
+/*
+ * Function: abr_set_encoder_bitrate
+ * ---
+ *   Sets the target bitrate of the encoder to "bitrate" (bps), in the unit of the encoder.
+ *
+ *   return: void.
+ */
+static void abr_set_encoder_bitrate(struct abr_t *abr, const guint bitrate);
+
+/* ---------- Private functions ---------- */
+
+void abr_get_reports(GstRTSPMedia *media, GArray *losses, GArray *jitters)
+{
+    GstRTSPStream *stream = NULL;
+    GObject *session = NULL;
+    GValueArray *sources = NULL;
+    GObject *source = NULL;
+    GstStructure *stats = NULL;
+
+    gboolean internal = FALSE;
+    gboolean have_rb = FALSE;
+    guint fraction_lost = 0;
+    guint jitter = 0;
+    gint clock_rate = 0;
+
+    gdouble loss = 0.0;
+    gdouble jitter_ms = 0.0;
+
+    guint stream_index = 0;
+    guint index = 0;
+
+    for (stream_index = 0; stream_index < gst_rtsp_media_n_streams(media); stream_index++)
+    {
+        stream = gst_rtsp_media_get_stream(media, stream_index);
+
+        session = gst_rtsp_stream_get_rtpsession(stream);
+        if (session == NULL)
+        {
+            continue;
+        }
+
+        /* Clients of the media are sources of its RTP session, besides our own */
+        G_GNUC_BEGIN_IGNORE_DEPRECATIONS
+        g_object_get(session, "sources", &sources, NULL);
+
+        for (index = 0; (sources != NULL) && (index < sources->n_values); index++)
+        {
+            source = g_value_get_object(g_value_array_get_nth(sources, index));
+            g_object_get(source, "stats", &stats, NULL);
+
+            /* Skip our own source and clients which have not reported yet */
+            if ((stats != NULL) &&
+                gst_structure_get_boolean(stats, "internal", &internal) && (!internal) &&
+                gst_structure_get_boolean(stats, "have-rb", &have_rb) && have_rb &&
+                gst_structure_get_uint(stats, "rb-fractionlost", &fraction_lost) &&
+                gst_structure_get_uint(stats, "rb-jitter", &jitter))
+            {
+                if (!gst_structure_get_int(stats, "clock-rate", &clock_rate) || (clock_rate <= 0))
+                {
+                    clock_rate = ABR_DEFAULT_CLOCK_RATE;
+                }
+
+                /* "fraction lost" is a fixed point number (8 bits) */
+                loss = fraction_lost / 256.0;
+                jitter_ms = jitter * 1000.0 / clock_rate;
+
+                g_array_append_val(losses, loss);
+                g_array_append_val(jitters, jitter_ms);
+            }
+
+            if (stats != NULL)
+            {
+                gst_structure_free(stats);
+                stats = NULL;
+            }
+        }
+
+        if (sources != NULL)
+        {
+            g_value_array_free(sources);
+            sources = NULL;
+        }
+        G_GNUC_END_IGNORE_DEPRECATIONS
+
+        g_object_unref(session);
+    }
+}
+
+gint abr_compare(gconstpointer a, gconstpointer b)
+{
+    gdouble value_a = *(const gdouble*)a;
+    gdouble value_b = *(const gdouble*)b;
+
+    return (value_a > value_b) - (value_a < value_b);
+}
+
+gdouble abr_select(GArray *values, const enum abr_policy_t policy)
+{
+    g_array_sort(values, abr_compare);
+
+    if (policy == ABR_POLICY_MEDIAN)
+    {
+        return g_array_index(values, gdouble, values->len / 2);
+    }
+
+    /* The worst client has the highest value */
+    return g_array_index(values, gdouble, values->len - 1);
+}
+
+void abr_set_encoder_bitrate(struct abr_t *abr, const guint bitrate)
+{
+    g_object_set(abr->encoder, abr->bitrate_property, bitrate / abr->bitrate_unit, NULL);
+}
+
+/* ---------- Public functions ---------- */
+
+struct abr_t *abr_create(const gchar *name, GstElement *encoder,
+                         const enum abr_policy_t policy,
+                         const guint min_bitrate, const guint max_bitrate)
+{
+    struct abr_t *abr = NULL;
+
+    /* Check parameter(s) */
+    g_return_val_if_fail((name != NULL) && (encoder != NULL) && (min_bitrate <= max_bitrate), NULL);
+
+    abr = g_new0(struct abr_t, 1);
+
+    abr->name = g_strdup(name);
+    abr->encoder = gst_object_ref(encoder);
+    abr->policy = policy;
+    abr->min_bitrate = min_bitrate;
+    abr->max_bitrate = max_bitrate;
+
+    /* "omxh264enc" has "target-bitrate" (bps). Software encoders have "bitrate",
+     * in kbps for "x264enc" and in bps for "openh264enc" */
+    if (g_object_class_find_property(G_OBJECT_GET_CLASS(encoder), "target-bitrate") != NULL)
+    {
+        abr->bitrate_property = "target-bitrate";
+        abr->bitrate_unit = 1;
+    }
+    else
+    {
+        abr->bitrate_property = "bitrate";
+        abr->bitrate_unit = (g_strcmp0(GST_OBJECT_NAME(gst_element_get_factory(encoder)), "x264enc") == 0) ? 1000 : 1;
+    }
+
+    /* Start from the bitrate of the pipeline string */
+    g_object_get(encoder, abr->bitrate_property, &abr->bitrate, NULL);
+    abr->bitrate = CLAMP(abr->bitrate * abr->bitrate_unit, min_bitrate, max_bitrate);
+
+    return abr;
+}
+
+void abr_update(struct abr_t *abr, GPtrArray *medias)
+{
+    GArray *losses = NULL;
+    GArray *jitters = NULL;
+
+    gdouble loss = 0.0;
+    gdouble jitter = 0.0;
+    guint bitrate = 0;
+    guint index = 0;
+
+    /* Check parameter(s) */
+    g_return_if_fail((abr != NULL) && (medias != NULL));
+
+    if (abr->policy == ABR_POLICY_OFF)
+    {
+        return;
+    }
+
+    losses = g_array_new(FALSE, FALSE, sizeof(gdouble));
+    jitters = g_array_new(FALSE, FALSE, sizeof(gdouble));
+
+    for (index = 0; index < medias->len; index++)
+    {
+        abr_get_reports(GST_RTSP_MEDIA(g_ptr_array_index(medias, index)), losses, jitters);
+    }
+
+    /* Nothing to decide without reports */
+    if (losses->len > 0)
+    {
+        loss = abr_select(losses, abr->policy);
+        jitter = abr_select(jitters, abr->policy);
+        bitrate = abr->bitrate;
+
+        if ((loss > ABR_LOSS_HIGH) || (jitter > ABR_JITTER_HIGH_MS))
+        {
+            /* Congestion: back off quickly */
+            bitrate = MAX((guint)(abr->bitrate * ABR_DECREASE_FACTOR), abr->min_bitrate);
+            abr->stable_counts = 0;
+        }
+        else if (loss < ABR_LOSS_LOW)
+        {
+            /* Probe for more bandwidth slowly */
+            if (++abr->stable_counts >= ABR_INCREASE_DELAY)
+            {
+                bitrate = MIN(abr->bitrate + (guint)(abr->max_bitrate * ABR_INCREASE_STEP),
+                              abr->max_bitrate);
+                abr->stable_counts = 0;
+            }
+        }
+        else
+        {
+            abr->stable_counts = 0;
+        }
+
+        if (bitrate != abr->bitrate)
+        {
+            g_message("Info: Bitrate of %s: %u -> %u bps (%s of %u client(s): loss %.1f%%, jitter %.1f ms)",
+                      abr->name, abr->bitrate, bitrate, abr_policy_to_string(abr->policy),
+                      losses->len, loss * 100.0, jitter);
+
+            /* The bitrate can be changed while the encoder is running */
+            abr->bitrate = bitrate;
+            abr_set_encoder_bitrate(abr, bitrate);
+        }
+    }
+
+    /* Free resources */
+    g_array_free(losses, TRUE);
+    g_array_free(jitters, TRUE);
+}
+
+void abr_set_max_bitrate(struct abr_t *abr, const guint max_bitrate)
+{
+    guint bitrate = 0;
+
+    /* Check parameter(s) */
+    g_return_if_fail(abr != NULL);
+
+    if (abr->policy == ABR_POLICY_OFF)
+    {
+        bitrate = max_bitrate;
+    }
+    else if (max_bitrate > abr->max_bitrate)
+    {
+        /* Keep the backoff decided from clients' reports */
+        bitrate = (guint)((guint64)abr->bitrate * max_bitrate / MAX(abr->max_bitrate, 1));
+    }
+    else
+    {
+        bitrate = MIN(abr->bitrate, max_bitrate);
+    }
+
+    abr->max_bitrate = MAX(max_bitrate, abr->min_bitrate);
+    bitrate = CLAMP(bitrate, abr->min_bitrate, abr->max_bitrate);
+
+    if (bitrate != abr->bitrate)
+    {
+        g_message("Info: Bitrate of %s: %u -> %u bps (ceiling %u bps)",
+                  abr->name, abr->bitrate, bitrate, abr->max_bitrate);
+
+        abr->bitrate = bitrate;
+        abr_set_encoder_bitrate(abr, bitrate);
+    }
+}
+
+void abr_split_budget(struct abr_t *main_abr, struct abr_t *sub_abr, const guint bitrate,
+                      const guint main_nominal, const guint sub_nominal)
+{
+    guint64 sub_bitrate = 0;
+
+    /* Check parameter(s) */
+    g_return_if_fail((main_abr != NULL) && (main_nominal + sub_nominal > 0));
+
+    if (sub_abr == NULL)
+    {
+        abr_set_max_bitrate(main_abr, bitrate);
+        return;
+    }
+
+    sub_bitrate = (guint64)bitrate * sub_nominal / (main_nominal + sub_nominal);
+
+    /* "abr_set_max_bitrate" raises a ceiling below the floor, keep both parts above
+     * their floor so that the sum stays within the budget */
+    if ((guint64)bitrate >= (guint64)main_abr->min_bitrate + sub_abr->min_bitrate)
+    {
+        sub_bitrate = CLAMP(sub_bitrate, sub_abr->min_bitrate, bitrate - main_abr->min_bitrate);
+    }
+
+    abr_set_max_bitrate(sub_abr, (guint)sub_bitrate);
+    abr_set_max_bitrate(main_abr, bitrate - (guint)sub_bitrate);
+}
+
+guint abr_get_bitrate(const struct abr_t *abr)
+{
+    /* Check parameter(s) */
+    g_return_val_if_fail(abr != NULL, 0);
+
+    return abr->bitrate;
+}
+
+guint abr_get_min_bitrate(const struct abr_t *abr)
+{
+    /* Check parameter(s) */
+    g_return_val_if_fail(abr != NULL, 0);
+
+    return abr->min_bitrate;
+}
+
+void abr_free(struct abr_t *abr)
+{
+    /* Check parameter(s) */
+    g_return_if_fail(abr != NULL);
+
+    gst_object_unref(abr->encoder);
+    g_free(abr->name);
+
+    g_free(abr);
+}
+
+const gchar* abr_policy_to_string(const enum abr_policy_t policy)
+{
+    const gchar* result = "";
+
+    switch (policy)
+    {
+        case ABR_POLICY_OFF:
+            result = "off";
+        break;
+
+        case ABR_POLICY_WORST:
+            result = "worst";
+        break;
+
+        case ABR_POLICY_MEDIAN:
+            result = "median";
+        break;
+
+        default:
+            result = "unknown";
+        break;
+    }
+
+    return result;
+}
+
+enum abr_policy_t abr_policy_from_string(const gchar *str)
+{
+    enum abr_policy_t policy = ABR_POLICY_UNKNOWN;
+
+    /* Check parameter(s) */
+    g_return_val_if_fail(str != NULL, ABR_POLICY_UNKNOWN);
+
+    if (g_ascii_strcasecmp(str, "off") == 0)
+    {
+        policy = ABR_POLICY_OFF;
+    }
+    else if (g_ascii_strcasecmp(str, "worst") == 0)
+    {
+        policy = ABR_POLICY_WORST;
+    }
+    else if (g_ascii_strcasecmp(str, "median") == 0)
+    {
+        policy = ABR_POLICY_MEDIAN;
+    }
+
+    return policy;
+}
@@ -0,0 +1,196 @@
+/***********************************************************************
+ * FILENAME: abr.h
+ *
+ * DESCRIPTION:
+ *   Contains APIs to adapt the bitrate of an encoder to the network
+ *   conditions reported by its RTSP clients (RTCP receiver reports).
+ *
+ * PUBLIC FUNCTIONS:
+ *   struct abr_t *abr_create(const gchar *name, GstElement *encoder,
+ *                            const enum abr_policy_t policy,
+ *                            const guint min_bitrate, const guint max_bitrate);
+ *
+ *   void abr_update(struct abr_t *abr, GPtrArray *medias);
+ *
+ *   void abr_set_max_bitrate(struct abr_t *abr, const guint max_bitrate);
+ *
+ *   void abr_split_budget(struct abr_t *main_abr, struct abr_t *sub_abr, const guint bitrate,
+ *                         const guint main_nominal, const guint sub_nominal);
+ *
+ *   guint abr_get_bitrate(const struct abr_t *abr);
+ *
+ *   guint abr_get_min_bitrate(const struct abr_t *abr);
+ *
+ *   void abr_free(struct abr_t *abr);
+ *
+ *   const gchar* abr_policy_to_string(const enum abr_policy_t policy);
+ *
+ *   enum abr_policy_t abr_policy_from_string(const gchar *str);
+ *
+ * AUTHOR: RVC       START DATE: 16/10/2026
+ *
+ * CHANGES:
+ *
+ ***********************************************************************/
+
+#ifndef _ABR_H_
+#define _ABR_H_
+
+/* ---------- Macros ---------- */
+
+/* Period of bitrate decisions (milliseconds). RTCP receiver reports arrive every ~5 seconds */
+#define ABR_UPDATE_INTERVAL 5000
+
+/* ---------- Datatypes ---------- */
+
+/*
+ * Enum: abr_policy_t
+ * ---
+ *   Represents how one bitrate is chosen for all clients of a shared stream:
+ *     - ABR_POLICY_OFF: Do not follow clients. The bitrate is the ceiling.
+ *     - ABR_POLICY_WORST: Follow the client with the worst loss/jitter. Nobody
+ *       freezes, but one bad client lowers the quality for everybody.
+ *     - ABR_POLICY_MEDIAN: Follow the median client. Clients worse than it
+ *       should use the substream instead.
+ *     - ABR_POLICY_UNKNOWN: Indicate that the policy is invalid.
+ */
+enum abr_policy_t
+{
+    ABR_POLICY_OFF,
+    ABR_POLICY_WORST,
+    ABR_POLICY_MEDIAN,
+    ABR_POLICY_UNKNOWN
+};
+
+/*
+ * Struct: abr_t
+ * ---
+ *   Represents the bitrate controller of an encoder:
+ *     - name (string): Stream name (used in logs).
+ *     - encoder (GstElement): H.264 encoder ("omxh264enc", or a software encoder).
+ *     - bitrate_property (string): Bitrate property of the encoder ("target-bitrate" or "bitrate").
+ *     - bitrate_unit (guint): Unit of "bitrate_property" (bps, 1000 for kbps).
+ *     - policy (enum abr_policy_t): How clients' reports are combined.
+ *     - min_bitrate, max_bitrate (guint): Floor and ceiling of the bitrate (bps).
+ *     - bitrate (guint): Current target bitrate (bps).
+ *     - stable_counts (gint): The number of consecutive updates without congestion.
+ */
+struct abr_t;
+
+/* ---------- Functions ---------- */
+
+/*
+ * Function: abr_create
+ * ---
+ *   Creates "abr_t" object. The current bitrate of "encoder" is the
+ *   initial bitrate (clamped to "min_bitrate" and "max_bitrate").
+ *
+ *   name: Stream name.
+ *   encoder: Encoder element (a reference is taken).
+ *   policy: How clients' reports are combined.
+ *   min_bitrate, max_bitrate: Floor and ceiling of the bitrate (bps).
+ *
+ *   return: Pointer to "abr_t".
+ *
+ *   Note: Should use "abr_free()" to deallocate if it is not used anymore.
+ */
+struct abr_t *abr_create(const gchar *name, GstElement *encoder,
+                         const enum abr_policy_t policy,
+                         const guint min_bitrate, const guint max_bitrate);
+
+/*
+ * Function: abr_update
+ * ---
+ *   Reads the latest RTCP receiver reports of all clients of "medias", combines
+ *   them according to the policy and adjusts the bitrate of the encoder:
+ *     - Loss or jitter above the thresholds: decrease the bitrate (x 0.75).
+ *     - No loss during several updates: increase it (+ 10% of the ceiling).
+ *
+ *   abr: Reference to "abr_t" object.
+ *   medias: Array of "GstRTSPMedia" fed by the encoder.
+ *
+ *   return: void.
+ */
+void abr_update(struct abr_t *abr, GPtrArray *medias);
+
+/*
+ * Function: abr_set_max_bitrate
+ * ---
+ *   Changes the ceiling of the bitrate (such as: the share given by "allocator.h").
+ *   If the ceiling is raised, the current bitrate is scaled by the same ratio, so that
+ *   the backoff decided from clients' reports is kept. If it is lowered, the current
+ *   bitrate is capped. With ABR_POLICY_OFF, the bitrate is the ceiling.
+ *
+ *   abr: Reference to "abr_t" object.
+ *   max_bitrate: New ceiling (bps). It is never lower than the floor.
+ *
+ *   return: void.
+ */
+void abr_set_max_bitrate(struct abr_t *abr, const guint max_bitrate);
+
+/*
+ * Function: abr_split_budget
+ * ---
+ *   Splits a bitrate budget between the encoders of a main stream and of its substream,
+ *   in proportion to "main_nominal" and "sub_nominal", and sets their ceilings (see
+ *   "abr_set_max_bitrate"). When the budget holds both floors, each encoder gets at
+ *   least its floor and the two ceilings add up to the budget.
+ *
+ *   main_abr: Encoder of the main stream.
+ *   sub_abr: Encoder of the substream (NULL: the main stream takes the whole budget).
+ *   bitrate: Budget (bps).
+ *   main_nominal, sub_nominal: Nominal bitrates of the streams (bps).
+ *
+ *   return: void.
+ */
+void abr_split_budget(struct abr_t *main_abr, struct abr_t *sub_abr, const guint bitrate,
+                      const guint main_nominal, const guint sub_nominal);
+
+/*
+ * Function: abr_get_bitrate
+ * ---
+ *   Get current target bitrate (bps).
+ *
+ *   return: guint (bitrate).
+ */
+guint abr_get_bitrate(const struct abr_t *abr);
+
+/*
+ * Function: abr_get_min_bitrate
+ * ---
+ *   Get the floor of the bitrate (bps).
+ *
+ *   return: guint (bitrate).
+ */
+guint abr_get_min_bitrate(const struct abr_t *abr);
+
+/*
+ * Function: abr_free
+ * ---
+ *   Frees "abr_t" object.
+ *
+ *   return: void.
+ */
+void abr_free(struct abr_t *abr);
+
+/*
+ * Function: abr_policy_to_string
+ * ---
+ *   Convert "enum abr_policy_t" to string.
+ *
+ *   Note: The output string must not be de-allocated or modified.
+ *
+ *   return: String (policy).
+ */
+const gchar* abr_policy_to_string(const enum abr_policy_t policy);
+
+/*
+ * Function: abr_policy_from_string
+ * ---
+ *   Convert string to "enum abr_policy_t".
+ *
+ *   return: ABR_POLICY_UNKNOWN if "str" is not a valid policy.
+ */
+enum abr_policy_t abr_policy_from_string(const gchar *str);
+
+#endif
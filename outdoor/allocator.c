@@ -0,0 +1,467 @@
+/***********************************************************************
+ * FILENAME: allocator.c
+ *
+ * DESCRIPTION:
+ *   Bitrate allocation between cameras.
+ *
+ * NOTE:
+ *   For more further information about datatypes and function usages,
+ *   please refer to "allocator.h".
+ *
+ * AUTHOR: RVC       START DATE: 16/10/2026
+ *
+ * CHANGES:
+ *
+ ***********************************************************************/
+
+/* ---------- Header files ---------- */
+
+#include <glib.h>
+#include <glib/gprintf.h>
+#include <stdio.h>
+
+#include <gst/gst.h>
+#include <gst/rtsp-server/rtsp-server.h>
+
+#include "media.h"
+#include "camera.h"
+#include "abr.h"
+#include "capture.h"
+#include "allocator.h"
+
+/* ---------- Macros ---------- */
+
+/* Maximum length of a word of a control command (see "%15s" formats) */
+#define ALLOCATOR_WORD_LENGTH 16
+
+/* Iterations of the search of the bitrate per weight (each one halves the interval) */
+#define ALLOCATOR_SEARCH_ITERATIONS 64
+
+/* ---------- Datatypes ---------- */
+
+/*
+ * Struct: allocator_entry_t
+ * ---
+ *   Represents a camera of the allocator:
+ *     - allocator (struct allocator_t): The allocator.
+ *     - capture (struct capture_t): Camera pipeline.
+ *     - number (gint): Camera number (from 1).
+ *     - weight (gint): Priority of the camera.
+ *     - event (string): Latest event (NULL if the camera is not boosted).
+ *     - cooldown_source_id (guint): Timer ending the boost.
+ *     - min_share (guint): Lowest share of the camera (bps). It is at least the sum of
+ *       the floors of its encoders, which the split between tiers never goes below.
+ *     - share (guint): Allocated bitrate (bps).
+ */
+struct allocator_entry_t
+{
+    struct allocator_t *allocator;
+
+    struct capture_t *capture;
+
+    gint number;
+
+    gint weight;
+
+    gchar *event;
+
+    guint cooldown_source_id;
+
+    guint min_share;
+
+    guint share;
+};
+
+struct allocator_t
+{
+    guint total_bitrate;
+
+    guint min_bitrate;
+
+    guint max_bitrate;
+
+    guint cooldown;
+
+    gint camera_counts;
+
+    GPtrArray *entries;
+};
+
+/* ---------- Private functions ---------- */
+
+/*
+ * Function: allocator_get_entry
+ * ---
+ *   Get the entry of camera number "camera".
+ *
+ *   return: NULL (invalid camera number).
+ */
+static struct allocator_entry_t *allocator_get_entry(struct allocator_t *allocator,
+                                                     const gint camera);
+
+/*
+ * Function: allocator_get_weight
+ * ---
+ *   Get the effective priority of "entry" (boosted during events).
+ */
+static gint allocator_get_weight(const struct allocator_entry_t *entry);
+
+/*
+ * Function: allocator_fill
+ * ---
+ *   Sets the share of every camera to "level" times its effective priority,
+ *   within the bounds of the camera.
+ *
+ *   return: Sum of the shares (bps).
+ */
+static guint64 allocator_fill(struct allocator_t *allocator, const gdouble level);
+
+/*
+ * Function: allocator_on_cooldown
+ * ---
+ *   Timer callback. Ends the boost of a camera, then rebalances.
+ *
+ *   return: G_SOURCE_REMOVE.
+ */
+static gboolean allocator_on_cooldown(gpointer user_data);
+
+/*
+ * Function: allocator_print_status
+ * ---
+ *   Write the current allocation to "output" (one line per camera).
+ */
+static void allocator_print_status(const struct allocator_t *allocator, GString *output);
+
+/* ---------- Private functions ---------- */
+
+struct allocator_entry_t *allocator_get_entry(struct allocator_t *allocator, const gint camera)
+{
+    struct allocator_entry_t *entry = NULL;
+    guint index = 0;
+
+    for (index = 0; index < allocator->entries->len; index++)
+    {
+        entry = g_ptr_array_index(allocator->entries, index);
+        if (entry->number == camera)
+        {
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+gint allocator_get_weight(const struct allocator_entry_t *entry)
+{
+    return (entry->event != NULL) ? (entry->weight * ALLOCATOR_BOOST_FACTOR) : entry->weight;
+}
+
+guint64 allocator_fill(struct allocator_t *allocator, const gdouble level)
+{
+    struct allocator_entry_t *entry = NULL;
+    gdouble share = 0;
+    guint64 sum = 0;
+    guint index = 0;
+
+    for (index = 0; index < allocator->entries->len; index++)
+    {
+        entry = g_ptr_array_index(allocator->entries, index);
+
+        share = level * allocator_get_weight(entry);
+        entry->share = (guint)CLAMP(share, (gdouble)entry->min_share,
+                                    (gdouble)MAX(entry->min_share, allocator->max_bitrate));
+
+        sum += entry->share;
+    }
+
+    return sum;
+}
+
+gboolean allocator_on_cooldown(gpointer user_data)
+{
+    struct allocator_entry_t *entry = (struct allocator_entry_t*)user_data;
+    gchar reason[100];
+
+    g_snprintf(reason, sizeof(reason), "end of %s on camera %d", entry->event, entry->number);
+
+    entry->cooldown_source_id = 0;
+    g_clear_pointer(&entry->event, g_free);
+
+    allocator_rebalance(entry->allocator, reason);
+
+    return G_SOURCE_REMOVE;
+}
+
+void allocator_print_status(const struct allocator_t *allocator, GString *output)
+{
+    struct allocator_entry_t *entry = NULL;
+    const struct camera_t *camera = NULL;
+    guint index = 0;
+
+    for (index = 0; index < allocator->entries->len; index++)
+    {
+        entry = g_ptr_array_index(allocator->entries, index);
+        camera = capture_get_camera(entry->capture);
+
+        g_string_append_printf(output, "camera %d (%s '%s'): %u bps (share %u bps, weight %d%s%s)\n",
+                               entry->number, camera_get_type_str(camera), camera_get_id(camera),
+                               capture_get_bitrate(entry->capture), entry->share,
+                               allocator_get_weight(entry),
+                               (entry->event != NULL) ? ", " : "",
+                               (entry->event != NULL) ? entry->event : "");
+    }
+}
+
+/* ---------- Public functions ---------- */
+
+struct allocator_t *allocator_create(const guint total_bitrate, const guint min_bitrate,
+                                     const guint max_bitrate, const guint cooldown)
+{
+    struct allocator_t *allocator = NULL;
+
+    /* Check parameter(s) */
+    g_return_val_if_fail(min_bitrate <= max_bitrate, NULL);
+
+    allocator = g_new0(struct allocator_t, 1);
+
+    allocator->total_bitrate = total_bitrate;
+    allocator->min_bitrate = min_bitrate;
+    allocator->max_bitrate = max_bitrate;
+    allocator->cooldown = cooldown;
+    allocator->entries = g_ptr_array_new();
+
+    return allocator;
+}
+
+void allocator_add(struct allocator_t *allocator, struct capture_t *capture)
+{
+    struct allocator_entry_t *entry = NULL;
+
+    /* Check parameter(s) */
+    g_return_if_fail((allocator != NULL) && (capture != NULL));
+
+    /* Keep numbers of cameras even if some of them have no encoder */
+    allocator->camera_counts++;
+
+    if (capture_get_bitrate(capture) == 0)
+    {
+        return;
+    }
+
+    entry = g_new0(struct allocator_entry_t, 1);
+
+    entry->allocator = allocator;
+    entry->capture = capture;
+    entry->number = allocator->camera_counts;
+    entry->weight = ALLOCATOR_DEFAULT_WEIGHT;
+    entry->min_share = MAX(allocator->min_bitrate, capture_get_min_bitrate(capture));
+
+    g_ptr_array_add(allocator->entries, entry);
+}
+
+void allocator_rebalance(struct allocator_t *allocator, const gchar *reason)
+{
+    struct allocator_entry_t *entry = NULL;
+    GString *status = NULL;
+
+    gdouble low = 0;
+    gdouble high = 0;
+    gdouble level = 0;
+    guint64 sum = 0;
+    guint64 min_sum = 0;
+
+    guint index = 0;
+
+    /* Check parameter(s) */
+    g_return_if_fail((allocator != NULL) && (reason != NULL));
+
+    if (allocator->entries->len == 0)
+    {
+        return;
+    }
+
+    /* Water-filling: every camera gets the same bitrate per weight ("level"), within its
+     * bounds. The sum of shares grows with the level, look for the highest level which
+     * fits in the total. At "high", every camera is at its maximum */
+    for (index = 0; index < allocator->entries->len; index++)
+    {
+        entry = g_ptr_array_index(allocator->entries, index);
+
+        high = MAX(high, entry->min_share);
+        min_sum += entry->min_share;
+    }
+
+    high = MAX(high, allocator->max_bitrate);
+
+    if (allocator_fill(allocator, high) > allocator->total_bitrate)
+    {
+        for (index = 0; index < ALLOCATOR_SEARCH_ITERATIONS; index++)
+        {
+            level = (low + high) / 2;
+
+            if (allocator_fill(allocator, level) > allocator->total_bitrate)
+            {
+                high = level;
+            }
+            else
+            {
+                low = level;
+            }
+        }
+
+        /* At "low" (0: every camera at its minimum), the shares fit unless the total
+         * is below the minimum of all cameras */
+        sum = allocator_fill(allocator, low);
+
+        g_warn_if_fail((sum <= allocator->total_bitrate) || (min_sum > allocator->total_bitrate));
+    }
+
+    /* Apply shares to encoders */
+    for (index = 0; index < allocator->entries->len; index++)
+    {
+        entry = g_ptr_array_index(allocator->entries, index);
+        capture_set_bitrate_budget(entry->capture, entry->share);
+    }
+
+    /* Log the decision */
+    status = g_string_new(NULL);
+    allocator_print_status(allocator, status);
+
+    g_message("Info: Bitrate allocation (%s), total %u bps:\n%s",
+              reason, allocator->total_bitrate, status->str);
+
+    g_string_free(status, TRUE);
+}
+
+gboolean allocator_boost(struct allocator_t *allocator, const gint camera, const gchar *event)
+{
+    struct allocator_entry_t *entry = NULL;
+    gchar reason[100];
+
+    /* Check parameter(s) */
+    g_return_val_if_fail((allocator != NULL) && (event != NULL), FALSE);
+
+    entry = allocator_get_entry(allocator, camera);
+    if (entry == NULL)
+    {
+        return FALSE;
+    }
+
+    /* Restart the cooldown on every event */
+    if (entry->cooldown_source_id != 0)
+    {
+        g_source_remove(entry->cooldown_source_id);
+    }
+
+    g_free(entry->event);
+    entry->event = g_strdup(event);
+    entry->cooldown_source_id = g_timeout_add_seconds(allocator->cooldown,
+                                                      allocator_on_cooldown, entry);
+
+    g_snprintf(reason, sizeof(reason), "%s on camera %d, for %u s", event, camera,
+               allocator->cooldown);
+    allocator_rebalance(allocator, reason);
+
+    return TRUE;
+}
+
+gboolean allocator_set_priority(struct allocator_t *allocator, const gint camera,
+                                const gint weight)
+{
+    struct allocator_entry_t *entry = NULL;
+    gchar reason[100];
+
+    /* Check parameter(s) */
+    g_return_val_if_fail(allocator != NULL, FALSE);
+
+    entry = allocator_get_entry(allocator, camera);
+    if ((entry == NULL) || (weight < 1) || (weight > ALLOCATOR_MAX_WEIGHT))
+    {
+        return FALSE;
+    }
+
+    entry->weight = weight;
+
+    g_snprintf(reason, sizeof(reason), "priority of camera %d set to %d", camera, weight);
+    allocator_rebalance(allocator, reason);
+
+    return TRUE;
+}
+
+gboolean allocator_handle_command(const gchar *command, GString *reply, gpointer user_data)
+{
+    struct allocator_t *allocator = (struct allocator_t*)user_data;
+
+    gchar name[ALLOCATOR_WORD_LENGTH];
+    gchar argument[ALLOCATOR_WORD_LENGTH];
+    gint camera = 0;
+    gint weight = 0;
+
+    gboolean result = FALSE;
+
+    /* Check parameter(s) */
+    g_return_val_if_fail((allocator != NULL) && (command != NULL) && (reply != NULL), FALSE);
+
+    if (g_strcmp0(command, "status") == 0)
+    {
+        allocator_print_status(allocator, reply);
+        result = TRUE;
+    }
+    else if (sscanf(command, "event %d %15s", &camera, argument) == 2)
+    {
+        if ((g_strcmp0(argument, "doorbell") != 0) && (g_strcmp0(argument, "motion") != 0))
+        {
+            g_string_append_printf(reply, "Unknown event '%s'\n", argument);
+        }
+        else if (!(result = allocator_boost(allocator, camera, argument)))
+        {
+            g_string_append_printf(reply, "Unknown camera %d\n", camera);
+        }
+    }
+    else if (sscanf(command, "priority %d %d", &camera, &weight) == 2)
+    {
+        result = allocator_set_priority(allocator, camera, weight);
+        if (!result)
+        {
+            g_string_append_printf(reply, "Invalid camera %d or weight %d (1 to %d)\n",
+                                   camera, weight, ALLOCATOR_MAX_WEIGHT);
+        }
+    }
+    else
+    {
+        if (sscanf(command, "%15s", name) != 1)
+        {
+            name[0] = '\0';
+        }
+
+        g_string_append_printf(reply, "Unknown command '%s'\n", name);
+    }
+
+    return result;
+}
+
+void allocator_free(struct allocator_t *allocator)
+{
+    struct allocator_entry_t *entry = NULL;
+    guint index = 0;
+
+    /* Check parameter(s) */
+    g_return_if_fail(allocator != NULL);
+
+    for (index = 0; index < allocator->entries->len; index++)
+    {
+        entry = g_ptr_array_index(allocator->entries, index);
+
+        if (entry->cooldown_source_id != 0)
+        {
+            g_source_remove(entry->cooldown_source_id);
+        }
+
+        g_free(entry->event);
+        g_free(entry);
+    }
+
+    g_ptr_array_free(allocator->entries, TRUE);
+
+    g_free(allocator);
+}
@@ -0,0 +1,148 @@
+/***********************************************************************
+ * FILENAME: allocator.h
+ *
+ * DESCRIPTION:
+ *   Contains APIs to split a total uplink bitrate between cameras by
+ *   priority, and to boost cameras on doorbell/motion events.
+ *
+ * PUBLIC FUNCTIONS:
+ *   struct allocator_t *allocator_create(const guint total_bitrate, const guint min_bitrate,
+ *                                        const guint max_bitrate, const guint cooldown);
+ *
+ *   void allocator_add(struct allocator_t *allocator, struct capture_t *capture);
+ *
+ *   void allocator_rebalance(struct allocator_t *allocator, const gchar *reason);
+ *
+ *   gboolean allocator_boost(struct allocator_t *allocator, const gint camera,
+ *                            const gchar *event);
+ *
+ *   gboolean allocator_set_priority(struct allocator_t *allocator, const gint camera,
+ *                                   const gint weight);
+ *
+ *   gboolean allocator_handle_command(const gchar *command, GString *reply, gpointer user_data);
+ *
+ *   void allocator_free(struct allocator_t *allocator);
+ *
+ * AUTHOR: RVC       START DATE: 16/10/2026
+ *
+ * CHANGES:
+ *
+ ***********************************************************************/
+
+#ifndef _ALLOCATOR_H_
+#define _ALLOCATOR_H_
+
+/* ---------- Macros ---------- */
+
+/* Default priority of cameras, and the highest one */
+#define ALLOCATOR_DEFAULT_WEIGHT 1
+#define ALLOCATOR_MAX_WEIGHT 10
+
+/* Priority of a camera is multiplied by this factor during an event */
+#define ALLOCATOR_BOOST_FACTOR 4
+
+/* ---------- Datatypes ---------- */
+
+/*
+ * Struct: allocator_t
+ * ---
+ *   Represents the bitrate allocator:
+ *     - total_bitrate (guint): Uplink budget shared by all cameras (bps).
+ *     - min_bitrate, max_bitrate (guint): Bounds of the share of one camera (bps).
+ *     - cooldown (guint): Duration of a boost after the last event (seconds).
+ *     - camera_counts (gint): The number of added cameras.
+ *     - entries (array of "allocator_entry_t"): Cameras, their priority and boost state.
+ */
+struct allocator_t;
+
+/* ---------- Functions ---------- */
+
+/*
+ * Function: allocator_create
+ * ---
+ *   Creates "allocator_t" object.
+ *
+ *   total_bitrate: Uplink budget shared by all cameras (bps).
+ *   min_bitrate, max_bitrate: Bounds of the share of one camera, all tiers (bps). The
+ *                             share of a camera is never below the sum of the floors
+ *                             of its encoders.
+ *   cooldown: Duration of a boost after the last event (seconds).
+ *
+ *   return: Pointer to "allocator_t".
+ *
+ *   Note: Should use "allocator_free()" to deallocate if it is not used anymore.
+ */
+struct allocator_t *allocator_create(const guint total_bitrate, const guint min_bitrate,
+                                     const guint max_bitrate, const guint cooldown);
+
+/*
+ * Function: allocator_add
+ * ---
+ *   Adds a camera to the allocator. Cameras are numbered from 1, in the order they
+ *   are added (the same as their mount points "/camera-N").
+ *
+ *   Note: "capture_enable_abr" must be called first. Cameras without encoder
+ *         (sample videos) do not take a share.
+ *
+ *   return: void.
+ */
+void allocator_add(struct allocator_t *allocator, struct capture_t *capture);
+
+/*
+ * Function: allocator_rebalance
+ * ---
+ *   Splits the total bitrate between cameras in proportion to their priority
+ *   (boosted priority during events), within the bounds of one camera. The
+ *   budget not used by a camera at its bound goes to the others.
+ *   The decision is logged with "reason".
+ *
+ *   return: void.
+ */
+void allocator_rebalance(struct allocator_t *allocator, const gchar *reason);
+
+/*
+ * Function: allocator_boost
+ * ---
+ *   Boosts the priority of "camera" because of "event" (such as: "doorbell", "motion"),
+ *   then rebalances. The boost ends "cooldown" seconds after the last event.
+ *
+ *   return: TRUE (the camera is boosted).
+ *           FALSE (invalid camera number).
+ */
+gboolean allocator_boost(struct allocator_t *allocator, const gint camera,
+                         const gchar *event);
+
+/*
+ * Function: allocator_set_priority
+ * ---
+ *   Changes the priority (weight) of "camera", then rebalances.
+ *
+ *   return: TRUE (the priority is changed).
+ *           FALSE (invalid camera number or weight).
+ */
+gboolean allocator_set_priority(struct allocator_t *allocator, const gint camera,
+                                const gint weight);
+
+/*
+ * Function: allocator_handle_command
+ * ---
+ *   Handler of control commands (see "control.h"), "user_data" is "allocator_t":
+ *     - "event <camera> <doorbell|motion>": Boost a camera.
+ *     - "priority <camera> <weight>": Change the priority of a camera (1 to 10).
+ *     - "status": Print the current allocation.
+ *
+ *   return: TRUE (the command succeeded).
+ *           FALSE (unknown or invalid command, the reason is written to "reply").
+ */
+gboolean allocator_handle_command(const gchar *command, GString *reply, gpointer user_data);
+
+/*
+ * Function: allocator_free
+ * ---
+ *   Frees "allocator_t" object.
+ *
+ *   return: void.
+ */
+void allocator_free(struct allocator_t *allocator);
+
+#endif
@@ -0,0 +1,355 @@
+/***********************************************************************
+ * FILENAME: allocator_test.c
+ *
+ * DESCRIPTION:
+ *   Test of the bitrate allocation between cameras of "allocator.h".
+ *
+ *   Camera pipelines are replaced by fakes which hold the real bitrate
+ *   controllers ("abr.h") of a main stream and of its substream, on fake
+ *   encoders. Shares go through the real split between both tiers. Each
+ *   case checks the bitrates of the encoders against the expected ones,
+ *   and that they never exceed the uplink budget when it can hold the
+ *   floors of every camera.
+ *
+ * AUTHOR: RVC       START DATE: 17/10/2026
+ *
+ * CHANGES:
+ *
+ ***********************************************************************/
+
+/* ---------- Header files ---------- */
+#include <glib.h>
+#include <glib/gprintf.h>
+
+#include <gst/gst.h>
+#include <gst/rtsp-server/rtsp-server.h>
+
+#include "media.h"
+#include "camera.h"
+#include "abr.h"
+#include "capture.h"
+#include "allocator.h"
+
+/* ---------- Macros ---------- */
+
+/* The most cameras of a case */
+#define TEST_MAX_CAMERAS 16
+
+/* Shares are rounded down to bps, and the level is searched with a finite precision */
+#define TEST_TOLERANCE 1000
+
+/* Bounds of one camera and boost cooldown of every case (bps, seconds). As in "main.c",
+ * the allocator gets the bounds of main streams */
+#define TEST_MIN_BITRATE 1000000
+#define TEST_MAX_BITRATE 8000000
+#define TEST_COOLDOWN 10
+
+/* Nominal bitrates of the tiers (see "my_gst.h") */
+#define TEST_MAIN_BITRATE 4000000
+#define TEST_SUB_BITRATE 800000
+
+/* ---------- Datatypes ---------- */
+
+/*
+ * Struct: TestEncoder
+ * ---
+ *   Fake encoder element, with the bitrate property of "omxh264enc":
+ *     - bitrate (guint): Target bitrate (bps).
+ */
+typedef struct
+{
+    GstElement parent;
+
+    guint bitrate;
+} TestEncoder;
+
+typedef struct
+{
+    GstElementClass parent_class;
+} TestEncoderClass;
+
+G_DEFINE_TYPE(TestEncoder, test_encoder, GST_TYPE_ELEMENT);
+
+/* Properties */
+enum
+{
+    TEST_ENCODER_PROP_0,
+    TEST_ENCODER_PROP_TARGET_BITRATE
+};
+
+/*
+ * Struct: capture_t
+ * ---
+ *   Fake camera pipeline:
+ *     - main_abr, sub_abr (struct abr_t): Bitrate controllers of the main stream and
+ *       of the substream, as created by "capture_enable_abr".
+ */
+struct capture_t
+{
+    struct abr_t *main_abr;
+
+    struct abr_t *sub_abr;
+};
+
+/*
+ * Struct: test_case_t
+ * ---
+ *   Represents an allocation:
+ *     - name (string): Description of the case.
+ *     - total_bitrate (guint): Uplink budget (bps).
+ *     - camera_counts (gint): The number of cameras.
+ *     - weights (array of gint): Priority of each camera (0: default priority).
+ *     - boosted (gint): Camera number with an event (0: none).
+ *     - shares (array of guint): Expected share of each camera (bps).
+ */
+struct test_case_t
+{
+    const gchar *name;
+
+    guint total_bitrate;
+
+    gint camera_counts;
+
+    gint weights[TEST_MAX_CAMERAS];
+
+    gint boosted;
+
+    guint shares[TEST_MAX_CAMERAS];
+};
+
+/* Cases: the first one had 17 Mbps allocated out of 12 Mbps (the boosted camera kept
+ * its maximum after the others were raised to their minimum). Then, a camera at the
+ * minimum share ran at 1.2 times of it (its substream was raised to its floor) */
+const struct test_case_t test_cases[] = {
+    { "10 cameras, camera 1 priority 10 and boosted", 15000000, 10,
+      { 10 }, 1,
+      { 4200000, 1200000, 1200000, 1200000, 1200000, 1200000, 1200000, 1200000, 1200000, 1200000 } },
+    { "10 cameras, budget at their minimum", 12000000, 10,
+      { 10 }, 1,
+      { 1200000, 1200000, 1200000, 1200000, 1200000, 1200000, 1200000, 1200000, 1200000, 1200000 } },
+    { "3 cameras, proportional shares", 12000000, 3,
+      { 1, 1, 2 }, 0,
+      { 3000000, 3000000, 6000000 } },
+    { "3 cameras, camera 3 boosted to its maximum", 12000000, 3,
+      { 1, 1, 1 }, 3,
+      { 2000000, 2000000, 8000000 } },
+    { "2 cameras, budget above their maximum", 20000000, 2,
+      { 1, 1 }, 0,
+      { 8000000, 8000000 } },
+    { "4 cameras, budget below their minimum", 3000000, 4,
+      { 10, 1, 1, 1 }, 1,
+      { 1200000, 1200000, 1200000, 1200000 } },
+};
+
+/* ---------- Fake encoder ---------- */
+
+static void test_encoder_set_property(GObject *object, guint id, const GValue *value, GParamSpec *pspec)
+{
+    TestEncoder *encoder = (TestEncoder *)object;
+
+    switch (id)
+    {
+        case TEST_ENCODER_PROP_TARGET_BITRATE:
+            encoder->bitrate = g_value_get_uint(value);
+        break;
+
+        default:
+            G_OBJECT_WARN_INVALID_PROPERTY_ID(object, id, pspec);
+        break;
+    }
+}
+
+static void test_encoder_get_property(GObject *object, guint id, GValue *value, GParamSpec *pspec)
+{
+    TestEncoder *encoder = (TestEncoder *)object;
+
+    switch (id)
+    {
+        case TEST_ENCODER_PROP_TARGET_BITRATE:
+            g_value_set_uint(value, encoder->bitrate);
+        break;
+
+        default:
+            G_OBJECT_WARN_INVALID_PROPERTY_ID(object, id, pspec);
+        break;
+    }
+}
+
+static void test_encoder_class_init(TestEncoderClass *klass)
+{
+    GObjectClass *object_class = G_OBJECT_CLASS(klass);
+
+    object_class->set_property = test_encoder_set_property;
+    object_class->get_property = test_encoder_get_property;
+
+    g_object_class_install_property(object_class, TEST_ENCODER_PROP_TARGET_BITRATE,
+        g_param_spec_uint("target-bitrate", "Target bitrate", "Target bitrate (bps)", 0, G_MAXUINT, 0,
+                          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+}
+
+static void test_encoder_init(TestEncoder *encoder)
+{
+}
+
+/* ---------- Fake camera pipelines ---------- */
+
+void capture_set_bitrate_budget(struct capture_t *capture, const guint bitrate)
+{
+    abr_split_budget(capture->main_abr, capture->sub_abr, bitrate, TEST_MAIN_BITRATE, TEST_SUB_BITRATE);
+}
+
+guint capture_get_bitrate(const struct capture_t *capture)
+{
+    return abr_get_bitrate(capture->main_abr) + abr_get_bitrate(capture->sub_abr);
+}
+
+guint capture_get_min_bitrate(const struct capture_t *capture)
+{
+    return abr_get_min_bitrate(capture->main_abr) + abr_get_min_bitrate(capture->sub_abr);
+}
+
+const struct camera_t *capture_get_camera(const struct capture_t *capture)
+{
+    return NULL;
+}
+
+const gchar* camera_get_type_str(const struct camera_t *camera)
+{
+    return "fake";
+}
+
+const gchar* camera_get_id(const struct camera_t *camera)
+{
+    return "camera";
+}
+
+/* ---------- Test ---------- */
+
+/*
+ * Function: test_on_log
+ * ---
+ *   Log handler dropping messages (allocation logs are not part of the results).
+ */
+static void test_on_log(const gchar *domain, GLogLevelFlags level, const gchar *message,
+                        gpointer user_data)
+{
+}
+
+/*
+ * Function: test_run
+ * ---
+ *   Allocates the budget of "test" and checks the bitrates of the encoders.
+ *
+ *   return: TRUE (expected shares), FALSE (otherwise).
+ */
+static gboolean test_run(const struct test_case_t *test)
+{
+    struct allocator_t *allocator = NULL;
+    struct capture_t captures[TEST_MAX_CAMERAS];
+    GstElement *encoder = NULL;
+
+    guint bitrates[TEST_MAX_CAMERAS];
+    guint64 sum = 0;
+    guint64 min_sum = 0;
+    guint64 error = 0;
+    gboolean result = TRUE;
+    gint index = 0;
+
+    allocator = allocator_create(test->total_bitrate, TEST_MIN_BITRATE, TEST_MAX_BITRATE, TEST_COOLDOWN);
+
+    /* Bounds of the substream keep the ratio of the nominal bitrates (see "capture_enable_abr") */
+    for (index = 0; index < test->camera_counts; index++)
+    {
+        encoder = g_object_new(test_encoder_get_type(), NULL);
+        captures[index].main_abr = abr_create("main", encoder, ABR_POLICY_OFF,
+                                              TEST_MIN_BITRATE, TEST_MAX_BITRATE);
+        gst_object_unref(encoder);
+
+        encoder = g_object_new(test_encoder_get_type(), NULL);
+        captures[index].sub_abr = abr_create("sub", encoder, ABR_POLICY_OFF,
+                                             (guint)((guint64)TEST_MIN_BITRATE * TEST_SUB_BITRATE / TEST_MAIN_BITRATE),
+                                             (guint)((guint64)TEST_MAX_BITRATE * TEST_SUB_BITRATE / TEST_MAIN_BITRATE));
+        gst_object_unref(encoder);
+
+        min_sum += capture_get_min_bitrate(&captures[index]);
+
+        allocator_add(allocator, &captures[index]);
+
+        if (test->weights[index] > 0)
+        {
+            allocator_set_priority(allocator, index + 1, test->weights[index]);
+        }
+    }
+
+    if (test->boosted > 0)
+    {
+        allocator_boost(allocator, test->boosted, "doorbell");
+    }
+    else
+    {
+        allocator_rebalance(allocator, "test");
+    }
+
+    for (index = 0; index < test->camera_counts; index++)
+    {
+        bitrates[index] = capture_get_bitrate(&captures[index]);
+        sum += bitrates[index];
+
+        error = (bitrates[index] > test->shares[index]) ? bitrates[index] - test->shares[index]
+                                                        : test->shares[index] - bitrates[index];
+        if (error > TEST_TOLERANCE)
+        {
+            g_print("  camera %d: %u bps, expected %u bps\n", index + 1, bitrates[index],
+                    test->shares[index]);
+            result = FALSE;
+        }
+    }
+
+    if ((min_sum <= test->total_bitrate) && (sum > test->total_bitrate))
+    {
+        g_print("  %" G_GUINT64_FORMAT " bps allocated, budget %u bps\n", sum, test->total_bitrate);
+        result = FALSE;
+    }
+
+    allocator_free(allocator);
+
+    for (index = 0; index < test->camera_counts; index++)
+    {
+        abr_free(captures[index].main_abr);
+        abr_free(captures[index].sub_abr);
+    }
+
+    return result;
+}
+
+/*
+ * Function: main
+ * ---
+ *   Usage: allocator_test
+ *
+ *   returns: 0 (every case passed), 1 (failure).
+ */
+int main(int argc, char *argv[])
+{
+    gint result = 0;
+    guint index = 0;
+
+    gst_init(&argc, &argv);
+
+    g_log_set_handler(NULL, G_LOG_LEVEL_MESSAGE, test_on_log, NULL);
+
+    for (index = 0; index < G_N_ELEMENTS(test_cases); index++)
+    {
+        if (test_run(&test_cases[index]))
+        {
+            g_print("%-48s ok\n", test_cases[index].name);
+        }
+        else
+        {
+            g_print("%-48s FAILED\n", test_cases[index].name);
+            result = 1;
+        }
+    }
+
+    return result;
+}
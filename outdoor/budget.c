@@ -0,0 +1,579 @@
+/***********************************************************************
+ * FILENAME: budget.c
+ *
+ * DESCRIPTION:
+ *   Admission control of camera streams.
+ *
+ * NOTE:
+ *   For more further information about datatypes and function usages,
+ *   please refer to "budget.h".
+ *
+ * AUTHOR: RVC       START DATE: 16/10/2026
+ *
+ * CHANGES:
+ *
+ ***********************************************************************/
+
+/* ---------- Header files ---------- */
+
+#include <glib.h>
+#include <glib/gprintf.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "media.h"
+#include "camera.h"
+#include "probe.h"
+#include "my_gst.h"
+#include "budget.h"
+
+/* ---------- Macros ---------- */
+
+/* Number of buffers allocated in CMA for each stage of a camera pipeline (estimated) */
+#define BUDGET_CAPTURE_BUFFERS 4
+#define BUDGET_OUTPUT_BUFFERS 6
+
+/* CMA memory kept for other users (such as: basephone in single board mode) */
+#define BUDGET_CMA_RESERVE (64 * 1024 * 1024)
+
+#define MEGABYTE (1024 * 1024)
+
+/* ---------- Datatypes ---------- */
+
+/*
+ * Struct: budget_cost_t
+ * ---
+ *   Represents resources consumed by one (or several) camera stream(s).
+ */
+struct budget_cost_t
+{
+    gint encoders;
+
+    guint64 encoder_rate;
+
+    guint64 vsp_rate;
+
+    guint64 cma_size;
+};
+
+/*
+ * Struct: budget_profile_t
+ * ---
+ *   Represents hardware resources of a board.
+ *
+ *   Note: Throughputs are conservative estimates (pixels per second).
+ *         "cma_size" is only used if "/proc/meminfo" cannot be read.
+ */
+struct budget_profile_t
+{
+    gint encoders;
+
+    guint64 encoder_rate;
+
+    guint64 vsp_rate;
+
+    guint64 cma_size;
+};
+
+struct budget_t
+{
+    const gchar *platform;
+
+    gboolean limited;
+
+    struct budget_cost_t total;
+
+    struct budget_cost_t used;
+};
+
+/* ---------- Private variables ---------- */
+
+/* Warning: "budget_profiles" array must have the same order as supported platforms
+ * (see "supported_platform_get_index()") */
+const struct budget_profile_t budget_profiles[] =
+{
+    /* RZ/G2E: 1080p30 encoder, one VSP for capture scaling */
+    { 2, 1920ULL * 1080 * 30, 1920ULL * 1080 * 60, 384ULL * MEGABYTE },
+
+    /* RZ/G2M/N/H: 1080p60 encoder, several VSPs */
+    { 4, 1920ULL * 1080 * 60, 1920ULL * 1080 * 120, 448ULL * MEGABYTE },
+    { 4, 1920ULL * 1080 * 60, 1920ULL * 1080 * 120, 448ULL * MEGABYTE },
+    { 4, 1920ULL * 1080 * 60, 1920ULL * 1080 * 120, 448ULL * MEGABYTE },
+};
+
+/* ---------- Private functions ---------- */
+
+/*
+ * Function: budget_get_cma_free
+ * ---
+ *   Read free CMA memory from "/proc/meminfo".
+ *
+ *   return: Free CMA memory (bytes), 0 if it cannot be read.
+ */
+static guint64 budget_get_cma_free();
+
+/*
+ * Function: budget_get_cost
+ * ---
+ *   Estimate resources consumed by a camera stream at output resolution "width"x"height".
+ *   "is_default" tells if the default pipeline of "my_gst.h" is used.
+ *   "substream" asks for the cost of the substream alone (its encoder and VSP pass)
+ *   instead of the one of the main stream (capture, encoder and VSP pass).
+ *   USB cameras are costed at capture mode "mode" (NULL: the default one of the pipeline).
+ *
+ *   return: void.
+ */
+static void budget_get_cost(const struct camera_t *camera, const gint width, const gint height,
+                            const gboolean is_default, const gboolean substream,
+                            const struct probe_mode_t *mode, struct budget_cost_t *cost);
+
+/*
+ * Function: budget_probe_mode
+ * ---
+ *   Select the capture mode the pipeline of a USB camera would use at output
+ *   resolution "width"x"height" (see "probe.h").
+ *
+ *   return: "mode" (the mode is selected).
+ *           NULL (not a USB camera, or the device cannot be probed).
+ */
+static const struct probe_mode_t *budget_probe_mode(const struct camera_t *camera,
+                                                    const gint width, const gint height,
+                                                    struct probe_mode_t *mode);
+
+/*
+ * Function: budget_check
+ * ---
+ *   Check if "cost" fits the remaining budget.
+ *
+ *   return: NULL (it fits).
+ *           String (name of the exhausted resource).
+ */
+static const gchar* budget_check(const struct budget_t *budget, const struct budget_cost_t *cost);
+
+/*
+ * Function: budget_reserve
+ * ---
+ *   Adds "cost" to the used resources.
+ *
+ *   return: void.
+ */
+static void budget_reserve(struct budget_t *budget, const struct budget_cost_t *cost);
+
+/*
+ * Function: budget_get_resolution
+ * ---
+ *   Get current output resolution of "camera" in numbers.
+ *
+ *   return: TRUE (the resolution is known).
+ *           FALSE (the camera has no resolution settings).
+ */
+static gboolean budget_get_resolution(const struct camera_t *camera, gint *width, gint *height);
+
+/* ---------- Private functions ---------- */
+
+guint64 budget_get_cma_free()
+{
+    guint64 result = 0;
+    guint64 value = 0;
+
+    FILE *fd = NULL;
+    gchar line[100];
+
+    fd = fopen("/proc/meminfo", "rt");
+    if (fd == NULL)
+    {
+        g_debug("Warning: Unable to open file /proc/meminfo");
+    }
+    else
+    {
+        while (fgets((char*)line, sizeof(line), fd) != NULL)
+        {
+            /* Line format: "CmaFree:          491520 kB" */
+            if (sscanf(line, "CmaFree: %" G_GUINT64_FORMAT " kB", &value) == 1)
+            {
+                result = value * 1024;
+                break;
+            }
+        }
+
+        /* Close file */
+        fclose(fd);
+    }
+
+    return result;
+}
+
+void budget_get_cost(const struct camera_t *camera, const gint width, const gint height,
+                     const gboolean is_default, const gboolean substream,
+                     const struct probe_mode_t *mode, struct budget_cost_t *cost)
+{
+    guint64 capture_pixels = 0;
+    guint64 output_pixels = (guint64)width * height;
+    guint64 sub_pixels = 0;
+
+    memset(cost, 0, sizeof(struct budget_cost_t));
+
+    switch (camera_get_type(camera))
+    {
+        case MIPI_CAMERA:
+            /* The sensor always captures at full resolution, VSP scales it down */
+            capture_pixels = (guint64)MIPI_CAM_CAPTURE_WIDTH * MIPI_CAM_CAPTURE_HEIGHT;
+            sub_pixels = (guint64)MIPI_CAM_SUB_WIDTH * MIPI_CAM_SUB_HEIGHT;
+        break;
+
+        case USB_CAMERA:
+            /* The capture mode chosen for this output. Without it, the default
+             * pipeline captures 800x600 and upscales it to 1280x720 */
+            if (mode != NULL)
+            {
+                capture_pixels = (guint64)mode->width * mode->height;
+            }
+            else if (is_default)
+            {
+                capture_pixels = (guint64)USB_CAM_DEFAULT_CAPTURE_WIDTH * USB_CAM_DEFAULT_CAPTURE_HEIGHT;
+            }
+            else
+            {
+                capture_pixels = output_pixels;
+            }
+
+            sub_pixels = (guint64)USB_CAM_SUB_WIDTH * USB_CAM_SUB_HEIGHT;
+        break;
+
+        case SYNTHETIC_CAMERA:
+            /* Patterns are generated at the output resolution, then encoded like USB cameras */
+            capture_pixels = output_pixels;
+            sub_pixels = (guint64)USB_CAM_SUB_WIDTH * USB_CAM_SUB_HEIGHT;
+        break;
+
+        default:
+            /* Fake cameras are neither scaled nor encoded */
+            return;
+    }
+
+    if (!substream)
+    {
+        cost->encoders = 1;
+        cost->encoder_rate = output_pixels * CAMERA_DEFAULT_FPS;
+
+        /* VSP reads the captured frame and writes the output frame */
+        cost->vsp_rate = (capture_pixels + output_pixels) * CAMERA_DEFAULT_FPS;
+
+        /* Captured frames are YUY2/UYVY (2 bytes/pixel), output frames are NV12 (1.5 bytes/pixel) */
+        cost->cma_size = (capture_pixels * 2 * BUDGET_CAPTURE_BUFFERS) +
+                         (output_pixels * 3 / 2 * BUDGET_OUTPUT_BUFFERS);
+    }
+    else if (sub_pixels < output_pixels)
+    {
+        /* The substream needs its own encoder and VSP pass (see "gst_get_camera_pipeline").
+         * It is not encoded if it would not be smaller than the main stream */
+        cost->encoders = 1;
+        cost->encoder_rate = sub_pixels * CAMERA_DEFAULT_FPS;
+        cost->vsp_rate = (capture_pixels + sub_pixels) * CAMERA_DEFAULT_FPS;
+        cost->cma_size = sub_pixels * 3 / 2 * BUDGET_OUTPUT_BUFFERS;
+    }
+}
+
+const struct probe_mode_t *budget_probe_mode(const struct camera_t *camera,
+                                             const gint width, const gint height,
+                                             struct probe_mode_t *mode)
+{
+    if (camera_get_type(camera) != USB_CAMERA)
+    {
+        return NULL;
+    }
+
+    if (!probe_select_mode(camera_get_id(camera), NULL, width, height, CAMERA_DEFAULT_FPS, mode))
+    {
+        return NULL;
+    }
+
+    return mode;
+}
+
+const gchar* budget_check(const struct budget_t *budget, const struct budget_cost_t *cost)
+{
+    const gchar *result = NULL;
+
+    if (budget->used.encoders + cost->encoders > budget->total.encoders)
+    {
+        result = "encoder instances";
+    }
+    else if (budget->used.encoder_rate + cost->encoder_rate > budget->total.encoder_rate)
+    {
+        result = "encoder throughput";
+    }
+    else if (budget->used.vsp_rate + cost->vsp_rate > budget->total.vsp_rate)
+    {
+        result = "VSP throughput";
+    }
+    else if (budget->used.cma_size + cost->cma_size > budget->total.cma_size)
+    {
+        result = "CMA memory";
+    }
+
+    return result;
+}
+
+void budget_reserve(struct budget_t *budget, const struct budget_cost_t *cost)
+{
+    budget->used.encoders += cost->encoders;
+    budget->used.encoder_rate += cost->encoder_rate;
+    budget->used.vsp_rate += cost->vsp_rate;
+    budget->used.cma_size += cost->cma_size;
+}
+
+gboolean budget_get_resolution(const struct camera_t *camera, gint *width, gint *height)
+{
+    gboolean result = TRUE;
+
+    switch (camera_get_type(camera))
+    {
+        case MIPI_CAMERA:
+            *width = MIPI_CAM_DEFAULT_WIDTH;
+            *height = MIPI_CAM_DEFAULT_HEIGHT;
+        break;
+
+        case USB_CAMERA:
+        case SYNTHETIC_CAMERA:
+            *width = USB_CAM_DEFAULT_WIDTH;
+            *height = USB_CAM_DEFAULT_HEIGHT;
+        break;
+
+        default:
+            *width = 0;
+            *height = 0;
+
+            result = FALSE;
+        break;
+    }
+
+    /* User-defined resolution overrides the default one */
+    if (result && (camera_get_width(camera)[0] != '\0'))
+    {
+        *width = (gint)g_ascii_strtoll(camera_get_width(camera), NULL, 10);
+        *height = (gint)g_ascii_strtoll(camera_get_height(camera), NULL, 10);
+    }
+
+    return result;
+}
+
+/* ---------- Public functions ---------- */
+
+struct budget_t *budget_create()
+{
+    struct budget_t *budget = NULL;
+    const struct budget_profile_t *profile = NULL;
+
+    const gint profile_arr_size = (const gint)(sizeof(budget_profiles) / sizeof(struct budget_profile_t));
+    gint index = 0;
+
+    guint64 cma_free = 0;
+
+    budget = g_new0(struct budget_t, 1);
+    budget->platform = g_get_host_name();
+
+    /* Look for the profile of this board */
+    index = supported_platform_get_index();
+    if ((index >= 0) && (index < profile_arr_size))
+    {
+        profile = &budget_profiles[index];
+    }
+
+    if (profile == NULL)
+    {
+        /* Unknown board, every stream will be admitted as it is */
+        g_debug("Info: No resource profile for '%s'", budget->platform);
+        budget->limited = FALSE;
+    }
+    else
+    {
+        budget->limited = TRUE;
+
+        budget->total.encoders = profile->encoders;
+        budget->total.encoder_rate = profile->encoder_rate;
+        budget->total.vsp_rate = profile->vsp_rate;
+        budget->total.cma_size = profile->cma_size;
+
+        /* Prefer the real amount of free CMA memory */
+        cma_free = budget_get_cma_free();
+        if (cma_free != 0)
+        {
+            budget->total.cma_size = (cma_free > BUDGET_CMA_RESERVE) ? (cma_free - BUDGET_CMA_RESERVE) : 0;
+        }
+    }
+
+    return budget;
+}
+
+gboolean budget_admit(struct budget_t *budget, struct camera_t *camera)
+{
+    struct budget_cost_t cost;
+    struct probe_mode_t probed;
+    const struct probe_mode_t *mode = NULL;
+    const gchar *exhausted = NULL;
+    const gchar **resolutions = NULL;
+
+    gint width = 0;
+    gint height = 0;
+    gint candidate_width = 0;
+    gint candidate_height = 0;
+    gint index = 0;
+
+    gchar width_str[10];
+    gchar height_str[10];
+
+    /* Check parameter(s) */
+    g_return_val_if_fail((budget != NULL) && (camera != NULL), FALSE);
+
+    /* Streams of unknown boards and streams without encoding are always admitted */
+    if ((!budget->limited) || (!budget_get_resolution(camera, &width, &height)))
+    {
+        return TRUE;
+    }
+
+    /* Passthrough cameras use neither VSP nor encoder instances (nor CMA for their frames) */
+    if (camera_is_passthrough(camera))
+    {
+        g_message("Info: %s '%s' encodes H.264 itself, no resource is reserved",
+                  camera_get_type_str(camera), camera_get_id(camera));
+        return TRUE;
+    }
+
+    /* Try the current resolution first. The device is probed once per resolution,
+     * the pipeline reuses the mode (see "camera_set_capture_mode()") */
+    mode = budget_probe_mode(camera, width, height, &probed);
+    budget_get_cost(camera, width, height, camera_get_width(camera)[0] == '\0', FALSE, mode, &cost);
+
+    exhausted = budget_check(budget, &cost);
+    if (exhausted == NULL)
+    {
+        if (mode != NULL)
+        {
+            camera_set_capture_mode(camera, mode);
+        }
+
+        budget_reserve(budget, &cost);
+        return TRUE;
+    }
+
+    g_message("Warning: Not enough %s for %s '%s' at %dx%d",
+              exhausted, camera_get_type_str(camera), camera_get_id(camera), width, height);
+
+    /* Encoder instances cannot be saved by lowering the resolution */
+    if (cost.encoders + budget->used.encoders > budget->total.encoders)
+    {
+        g_message("Error: Refused %s '%s' (no %s left)",
+                  camera_get_type_str(camera), camera_get_id(camera), exhausted);
+        return FALSE;
+    }
+
+    /* Downgrade step by step, from the highest lower resolution */
+    resolutions = gst_get_supported_resolutions(camera_get_type(camera));
+    while (resolutions[index] != NULL)
+    {
+        index++;
+    }
+
+    for (index = index - 1; index >= 0; index--)
+    {
+        if (sscanf(resolutions[index], "%dx%d", &candidate_width, &candidate_height) != 2)
+        {
+            continue;
+        }
+
+        /* Only consider smaller resolutions */
+        if ((guint64)candidate_width * candidate_height >= (guint64)width * height)
+        {
+            continue;
+        }
+
+        mode = budget_probe_mode(camera, candidate_width, candidate_height, &probed);
+        budget_get_cost(camera, candidate_width, candidate_height, FALSE, FALSE, mode, &cost);
+
+        exhausted = budget_check(budget, &cost);
+        if (exhausted == NULL)
+        {
+            g_message("Info: Downgraded %s '%s' from %dx%d to %dx%d",
+                      camera_get_type_str(camera), camera_get_id(camera),
+                      width, height, candidate_width, candidate_height);
+
+            g_snprintf(width_str, sizeof(width_str), "%d", candidate_width);
+            g_snprintf(height_str, sizeof(height_str), "%d", candidate_height);
+            camera_set_resolution(camera, width_str, height_str);
+
+            if (mode != NULL)
+            {
+                camera_set_capture_mode(camera, mode);
+            }
+
+            budget_reserve(budget, &cost);
+            return TRUE;
+        }
+    }
+
+    g_message("Error: Refused %s '%s' (not enough %s at any resolution)",
+              camera_get_type_str(camera), camera_get_id(camera), exhausted);
+
+    return FALSE;
+}
+
+void budget_admit_substream(struct budget_t *budget, struct camera_t *camera)
+{
+    struct budget_cost_t cost;
+    const gchar *exhausted = NULL;
+
+    gint width = 0;
+    gint height = 0;
+
+    /* Check parameter(s) */
+    g_return_if_fail((budget != NULL) && (camera != NULL));
+
+    /* Passthrough cameras have no substream (see "budget_admit") */
+    if ((!budget->limited) || (!camera_has_substream(camera)) || camera_is_passthrough(camera) ||
+        (!budget_get_resolution(camera, &width, &height)))
+    {
+        return;
+    }
+
+    budget_get_cost(camera, width, height, camera_get_width(camera)[0] == '\0', TRUE,
+                    camera_get_capture_mode(camera), &cost);
+
+    exhausted = budget_check(budget, &cost);
+    if (exhausted == NULL)
+    {
+        budget_reserve(budget, &cost);
+        return;
+    }
+
+    camera_set_substream(camera, FALSE);
+
+    g_message("Info: Disabled substream of %s '%s' (not enough %s)",
+              camera_get_type_str(camera), camera_get_id(camera), exhausted);
+}
+
+void budget_print_all(const struct budget_t *budget)
+{
+    /* Check parameter(s) */
+    g_return_if_fail(budget != NULL);
+
+    if (!budget->limited)
+    {
+        g_message("Resource budget: unlimited (unknown board '%s')", budget->platform);
+        return;
+    }
+
+    g_message("Resource budget of '%s':", budget->platform);
+    g_message("  Encoder instances: %d/%d", budget->used.encoders, budget->total.encoders);
+    g_message("  Encoder throughput: %" G_GUINT64_FORMAT "/%" G_GUINT64_FORMAT " pixels/s",
+              budget->used.encoder_rate, budget->total.encoder_rate);
+    g_message("  VSP throughput: %" G_GUINT64_FORMAT "/%" G_GUINT64_FORMAT " pixels/s",
+              budget->used.vsp_rate, budget->total.vsp_rate);
+    g_message("  CMA memory: %" G_GUINT64_FORMAT "/%" G_GUINT64_FORMAT " MB",
+              budget->used.cma_size / MEGABYTE, budget->total.cma_size / MEGABYTE);
+}
+
+void budget_free(struct budget_t *budget)
+{
+    g_free(budget);
+}
@@ -0,0 +1,109 @@
+/***********************************************************************
+ * FILENAME: budget.h
+ *
+ * DESCRIPTION:
+ *   Contains APIs to decide how many camera streams (and at which
+ *   resolution) the board is able to run.
+ *
+ * PUBLIC FUNCTIONS:
+ *   struct budget_t *budget_create();
+ *
+ *   gboolean budget_admit(struct budget_t *budget, struct camera_t *camera);
+ *
+ *   void budget_admit_substream(struct budget_t *budget, struct camera_t *camera);
+ *
+ *   void budget_print_all(const struct budget_t *budget);
+ *
+ *   void budget_free(struct budget_t *budget);
+ *
+ * AUTHOR: RVC       START DATE: 16/10/2026
+ *
+ * CHANGES:
+ *
+ ***********************************************************************/
+
+#ifndef _BUDGET_H_
+#define _BUDGET_H_
+
+/* ---------- Datatypes ---------- */
+
+/*
+ * Struct: budget_t
+ * ---
+ *   Represents hardware resources available for camera streams:
+ *     - platform (string): Board name (host name).
+ *     - limited (gboolean): FALSE if the board is unknown (no admission control).
+ *     - encoders (gint): Number of H.264 encoder instances.
+ *     - encoder_rate (guint64): Encoder throughput (pixels per second).
+ *     - vsp_rate (guint64): VSP throughput (pixels per second).
+ *     - cma_size (guint64): CMA memory available for camera streams (bytes).
+ *     - used (struct budget_cost_t): Resources consumed by admitted streams.
+ */
+struct budget_t;
+
+/* ---------- Functions ---------- */
+
+/*
+ * Function: budget_create
+ * ---
+ *   Creates "budget_t" object for the current board.
+ *
+ *   The board is detected from its host name. The CMA size is read from
+ *   "/proc/meminfo" (CmaFree) if possible.
+ *
+ *   return: Pointer to "budget_t".
+ *
+ *   Note: Should use "budget_free()" to deallocate if it is not used anymore.
+ */
+struct budget_t *budget_create();
+
+/*
+ * Function: budget_admit
+ * ---
+ *   Checks if the main stream of "camera" fits the remaining budget. If it does not fit
+ *   at its current resolution, the resolution of "camera" is lowered step by step (using
+ *   supported resolutions of "my_gst.h") until it fits. Substreams are checked later
+ *   (see "budget_admit_substream()").
+ *
+ *   budget: Reference to "budget_t" object.
+ *   camera: Reference to "camera_t" object (its resolution may be changed).
+ *
+ *   return: TRUE (the camera is admitted, its cost is reserved).
+ *           FALSE (the camera is refused, the budget is not changed).
+ */
+gboolean budget_admit(struct budget_t *budget, struct camera_t *camera);
+
+/*
+ * Function: budget_admit_substream
+ * ---
+ *   Checks if the substream of an admitted camera fits the remaining budget, and
+ *   disables it otherwise. Should be called once every main stream is admitted, so
+ *   that the preview of a camera never takes the resources of the main stream of
+ *   another one.
+ *
+ *   budget: Reference to "budget_t" object.
+ *   camera: Reference to "camera_t" object (its substream may be disabled).
+ *
+ *   return: void.
+ */
+void budget_admit_substream(struct budget_t *budget, struct camera_t *camera);
+
+/*
+ * Function: budget_print_all
+ * ---
+ *   Print available and used resources.
+ *
+ *   return: void.
+ */
+void budget_print_all(const struct budget_t *budget);
+
+/*
+ * Function: budget_free
+ * ---
+ *   Frees "budget_t" object.
+ *
+ *   return: void.
+ */
+void budget_free(struct budget_t *budget);
+
+#endif
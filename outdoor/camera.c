@@ -22,6 +22,10 @@
 #include <stdio.h>
 #include <string.h>
 
+#include <linux/media-bus-format.h>
+
+#include "media.h"
+#include "probe.h"
 #include "camera.h"
 
 /* ---------- Datatypes ---------- */
@@ -30,16 +34,33 @@ union camera_id_t
 {
     gchar fd[20];
     gchar file_path[100];
+    gchar name[20];
 };
 
 struct camera_t
 {
     enum camera_type_t type;
     union camera_id_t id;
+
+    gchar width[10];
+    gchar height[10];
+
+    gboolean substream;
+
+    gboolean passthrough;
+
+    struct probe_mode_t mode;
+    gboolean has_mode;
+
+    gint fps;
+    enum camera_motion_t motion;
 };
 
 /* ---------- Macros ---------- */
 
+/* Media device of the MIPI camera pipeline */
+#define MIPI_MEDIA_DEVICE "/dev/media0"
+
 #define RZG2E_MIPI_CAM_LIMIT_INPUT_WIDTH 640
 #define RZG2E_MIPI_CAM_LIMIT_INPUT_HEIGHT 480
 #define RZG2E_MIPI_CAM_LIMIT_ENC_BITRATE 2500000
@@ -64,63 +85,63 @@ struct camera_t
 #define RZG2N_USB_CAM_LIMIT_INPUT_HEIGHT 720
 #define RZG2N_USB_CAM_LIMIT_ENC_BITRATE 4000000
 
-/* ---------- Private functions ---------- */
-
-/*
- * Function: supported_platform_get_index
- * ---
- *   Get index of "supported_platforms" array.
- *
- *   return: index >= 0 if host name exists in the array.
- *           index == -1 if host name does not exist in the array.
- */
-static gint supported_platform_get_index();
+/* Name of synthetic cameras (followed by their number) */
+#define SYNTHETIC_CAMERA_NAME "synthetic-"
 
 /* ---------- Private variables ---------- */
 
 /* The following code is based on document "R01US0424EJ0102_VideoCapture_UME_v1.02_06.pdf" */
 
-/* Commands to initialize MIPI camera on RZ/G2E */
-const gchar *rzg2e_mipi_init_steps[] = 
+/* Steps to initialize MIPI camera on RZ/G2E */
+const struct media_step_t rzg2e_mipi_init_steps[] =
 {
     /* Reset all links before enabling new links */
-    "media-ctl -d /dev/media0 -r",
+    { .type = MEDIA_STEP_RESET },
 
     /* Link "VIN4" to "CSI40/VC0". After this, we can start capturing video data from "/dev/video0"
      * which is associated with "VIN4" */
-    "media-ctl -d /dev/media0 -l \"'rcar_csi2 feaa0000.csi2':1 -> 'VIN4 output':0 [1]\"",
+    { .type = MEDIA_STEP_LINK, .entity = "rcar_csi2 feaa0000.csi2", .pad = 1,
+      .sink = "VIN4 output", .sink_pad = 0 },
 
     /* Set the same format as camera "OV5645" */
-    "media-ctl -d /dev/media0 -V \"'rcar_csi2 feaa0000.csi2':1 [fmt:UYVY8_2X8/1280x960 field:none]\"",
+    { .type = MEDIA_STEP_FORMAT, .entity = "rcar_csi2 feaa0000.csi2", .pad = 1,
+      .code = MEDIA_BUS_FMT_UYVY8_2X8, .width = 1280, .height = 960 },
 
     /* Set data format "UYVY8_2X8" and resolution "1280x960" to camera "OV5645" */
-    "media-ctl -d /dev/media0 -V \"'ov5645 3-003c':0 [fmt:UYVY8_2X8/1280x960 field:none]\"",
+    { .type = MEDIA_STEP_FORMAT, .entity = "ov5645 3-003c", .pad = 0,
+      .code = MEDIA_BUS_FMT_UYVY8_2X8, .width = 1280, .height = 960 },
 
-    NULL
+    { .type = MEDIA_STEP_END }
 };
 
-/* Commands to initialize MIPI camera for RZ/G2M/N/H */
-const gchar *rzg2mnh_mipi_init_steps[] =
+/* Steps to initialize MIPI camera for RZ/G2M/N/H */
+const struct media_step_t rzg2mnh_mipi_init_steps[] =
 {
     /* Reset all links before enabling new links */
-    "media-ctl -d /dev/media0 -r",
+    { .type = MEDIA_STEP_RESET },
 
     /* Link "VIN4" to "CSI20/VC0". After this, we can start capturing video data from "/dev/video4"
      * which is associated with "VIN4" */
-    "media-ctl -d /dev/media0 -l \"'rcar_csi2 fea80000.csi2':1 -> 'VIN4 output':0 [1]\"",
-    "media-ctl -d /dev/media0 -V \"'rcar_csi2 fea80000.csi2':1 [fmt:UYVY8_2X8/1280x960 field:none]\"",
-    "media-ctl -d /dev/media0 -V \"'ov5645 2-003c':0 [fmt:UYVY8_2X8/1280x960 field:none]\"",
-
-    NULL
+    { .type = MEDIA_STEP_LINK, .entity = "rcar_csi2 fea80000.csi2", .pad = 1,
+      .sink = "VIN4 output", .sink_pad = 0 },
+    { .type = MEDIA_STEP_FORMAT, .entity = "rcar_csi2 fea80000.csi2", .pad = 1,
+      .code = MEDIA_BUS_FMT_UYVY8_2X8, .width = 1280, .height = 960 },
+    { .type = MEDIA_STEP_FORMAT, .entity = "ov5645 2-003c", .pad = 0,
+      .code = MEDIA_BUS_FMT_UYVY8_2X8, .width = 1280, .height = 960 },
+
+    { .type = MEDIA_STEP_END }
 };
 
+/* Names of "enum camera_motion_t" (the same order) */
+const gchar *camera_motion_names[] = { "static", "low", "medium", "high" };
+
 const gchar *supported_platforms[] = { "ek874", "hihope-rzg2m", "hihope-rzg2n", "hihope-rzg2h" };
 
 /* List of MIPI camera based on RZ/G2 platforms */
 const gchar *mipi_camera_fds[] = { "video0", "video4", "video4", "video4" };
 
 /* Warning: "mipi_init_steps" array must have the same size as "supported_platforms" array */
-const gchar **mipi_init_steps[] =
+const struct media_step_t *mipi_init_steps[] =
 {
     /* MIPI initialization steps on RZ/G2E platform */
     rzg2e_mipi_init_steps,
@@ -135,7 +156,7 @@ const gchar **mipi_init_steps[] =
     rzg2mnh_mipi_init_steps
 };
 
-/* ---------- Private functions ---------- */
+/* ---------- Public functions ---------- */
 
 gint supported_platform_get_index()
 {
@@ -143,7 +164,8 @@ gint supported_platform_get_index()
     gint index = 0;
 
     /* Get hostname */
-    const gchar *host_name = g_get_host_name();
+    const gchar *host_name = (media_get_mock_platform() != NULL) ? media_get_mock_platform()
+                                                                 : g_get_host_name();
 
     /* Check if hostname exist in the array or not? */
     for (index = 0; index < platform_arr_size; index++)
@@ -164,23 +186,19 @@ gint supported_platform_get_index()
     return index;
 }
 
-/* ---------- Public functions ---------- */
-
 gboolean mipi_camera_is_supported()
 {
     /* Return TRUE if the host name exists in "supported_platforms" array */
     return (supported_platform_get_index() != -1) ? TRUE : FALSE;
 }
 
-struct camera_t *mipi_camera_init()
+struct camera_t *mipi_camera_init(const enum media_method_t method)
 {
     struct camera_t *mipi_camera = NULL;
 
     gint platform_index = 0;
-    gint command_index = 0;
-
-    const gchar *mipi_init_cmd = NULL;
-    gint exec_code = 0;
+    gint64 start_time = 0;
+    GError *error = NULL;
 
     /* Get index of "supported_platforms" array */
     platform_index = supported_platform_get_index();
@@ -190,39 +208,25 @@ struct camera_t *mipi_camera_init()
     }
     else
     {
-        g_debug("Info: Initializing MIPI camera");
+        g_debug("Info: Initializing MIPI camera (%s)", media_method_to_string(method));
 
         /* Try to initialize MIPI camera */
-        command_index = 0;
-        mipi_init_cmd = mipi_init_steps[platform_index][command_index];
-
-        do
-        {
-            /* Try to run command "mipi_init_cmd" */
-            exec_code = system((const char*)mipi_init_cmd);
-            if (exec_code != 0)
-            {
-                /* If failed to run, exit the loop immediately to report error */
-                break;
-            }
-
-            /* Move to the next command */
-            command_index++;
-            mipi_init_cmd = mipi_init_steps[platform_index][command_index];
-        }
-        while (mipi_init_cmd != NULL);
+        start_time = g_get_monotonic_time();
 
-        if (mipi_init_cmd != NULL)
+        if (!media_setup(MIPI_MEDIA_DEVICE, mipi_init_steps[platform_index], method, &error))
         {
-            /* This means that the function cannot run all commands */
-            g_debug("Error: Failed to run command '%s'", mipi_init_cmd);
+            /* The error tells which step failed, on which entity, and why */
+            g_message("Error: Failed to initialize MIPI camera: %s", error->message);
+            g_clear_error(&error);
         }
         else
         {
-            /* All commands have already run successfully */
-            g_message("Info: Initialize MIPI camera successfully");
+            /* All steps have already run successfully */
+            g_message("Info: Initialize MIPI camera successfully in %.1f ms (%s)",
+                      (g_get_monotonic_time() - start_time) / 1000.0,
+                      media_method_to_string(method));
 
-            mipi_camera = g_new(struct camera_t, 1);
+            mipi_camera = g_new0(struct camera_t, 1);
 
             /* Set required data to "camera_t" object.
              * The order of functions is important */
@@ -242,7 +246,7 @@ struct camera_t *usb_camera_create(const gchar *camera_fd)
     g_return_val_if_fail(camera_fd != NULL, NULL);
 
     /* Create new "camera_t" object */
-    usb_cam = g_new(struct camera_t, 1);
+    usb_cam = g_new0(struct camera_t, 1);
 
     /* Set required data to "camera_t" object.
      * The order of functions is important */
@@ -263,7 +267,7 @@ struct camera_t *fake_camera_create(const gchar *path)
     g_return_val_if_fail(g_path_is_absolute(path), NULL);
 
     /* Create new "camera_t" object */
-    fake_cam = g_new(struct camera_t, 1);
+    fake_cam = g_new0(struct camera_t, 1);
 
     /* Set required data to "camera_t" object.
      * The order of functions is important */
@@ -273,6 +277,31 @@ struct camera_t *fake_camera_create(const gchar *path)
     return fake_cam;
 }
 
+struct camera_t *synthetic_camera_create(const gint index, const gint fps,
+                                         const enum camera_motion_t motion)
+{
+    struct camera_t *synthetic_cam = NULL;
+    gchar name[20];
+
+    /* Check parameter(s) */
+    g_return_val_if_fail((index > 0) && (fps > 0) && (motion < CAMERA_MOTION_UNKNOWN), NULL);
+
+    /* Create new "camera_t" object */
+    synthetic_cam = g_new0(struct camera_t, 1);
+
+    /* Set required data to "camera_t" object.
+     * The order of functions is important */
+    camera_set_type(synthetic_cam, SYNTHETIC_CAMERA);
+
+    g_snprintf(name, sizeof(name), SYNTHETIC_CAMERA_NAME "%d", index);
+    camera_set_id(synthetic_cam, name);
+
+    synthetic_cam->fps = fps;
+    synthetic_cam->motion = motion;
+
+    return synthetic_cam;
+}
+
 gboolean usb_camera_is_existed(const gchar *camera_fd)
 {
     gchar dev_file[20];
@@ -331,6 +360,31 @@ void camera_print_all(const struct camera_t *camera, gchar *info)
 
     /* Extract camera type */
     g_sprintf(info, "Type: %s; ID: %s", camera_get_type_str(camera), camera_get_id(camera));
+
+    /* Extract camera resolution (if it is set) */
+    if (camera->width[0] != '\0')
+    {
+        g_sprintf(info + strlen(info), "; Resolution: %sx%s", camera->width, camera->height);
+    }
+
+    /* Extract substream status */
+    if (camera->substream)
+    {
+        g_sprintf(info + strlen(info), "; Substream: yes");
+    }
+
+    /* Extract encoder */
+    if (camera->passthrough)
+    {
+        g_sprintf(info + strlen(info), "; Encoder: camera (H.264 passthrough)");
+    }
+
+    /* Extract pattern of synthetic cameras */
+    if (camera->type == SYNTHETIC_CAMERA)
+    {
+        g_sprintf(info + strlen(info), "; Pattern: %s motion at %d fps",
+                  camera_motion_to_string(camera->motion), camera->fps);
+    }
 }
 
 const gchar* camera_type_to_string(const enum camera_type_t type)
@@ -351,6 +405,10 @@ const gchar* camera_type_to_string(const enum camera_type_t type)
             result = "Fake camera";
         break;
 
+        case SYNTHETIC_CAMERA:
+            result = "Synthetic camera";
+        break;
+
         default:
             result = "Unknown camera";
 
@@ -395,6 +453,10 @@ const gchar* camera_get_id(const struct camera_t *camera)
             result = (camera->id).file_path;
         break;
 
+        case SYNTHETIC_CAMERA:
+            result = (camera->id).name;
+        break;
+
         default:
             g_critical("Error: Camera type is undefined");
         break;
@@ -420,6 +482,10 @@ void camera_set_id(struct camera_t *camera, const gchar *id)
             g_sprintf((camera->id).file_path, "%s", id);
         break;
 
+        case SYNTHETIC_CAMERA:
+            g_snprintf((camera->id).name, sizeof((camera->id).name), "%s", id);
+        break;
+
         default:
             g_critical("Error: Camera type is undefined");
         break;
@@ -434,3 +500,124 @@ void camera_set_type (struct camera_t *camera, const enum camera_type_t type)
     /* Set camera type */
     camera->type = type;
 }
+
+void camera_set_resolution(struct camera_t *camera, const gchar *width, const gchar *height)
+{
+    /* Check parameter(s) */
+    g_return_if_fail((camera != NULL) && (width != NULL) && (height != NULL));
+
+    /* Set camera resolution. Empty strings mean the default resolution of the pipeline */
+    g_snprintf(camera->width, sizeof(camera->width), "%s", width);
+    g_snprintf(camera->height, sizeof(camera->height), "%s", height);
+
+    /* The capture mode was chosen for the previous resolution */
+    camera->has_mode = FALSE;
+}
+
+const gchar* camera_get_width(const struct camera_t *camera)
+{
+    /* Check parameter(s) */
+    g_return_val_if_fail(camera != NULL, "");
+
+    return camera->width;
+}
+
+const gchar* camera_get_height(const struct camera_t *camera)
+{
+    /* Check parameter(s) */
+    g_return_val_if_fail(camera != NULL, "");
+
+    return camera->height;
+}
+
+void camera_set_substream(struct camera_t *camera, const gboolean enabled)
+{
+    /* Check parameter(s) */
+    g_return_if_fail(camera != NULL);
+
+    /* Only real cameras can be encoded a second time.
+     * Passthrough cameras have no raw frames to encode */
+    camera->substream = ((camera->type != FAKE_CAMERA) && (!camera->passthrough)) ? enabled : FALSE;
+}
+
+gboolean camera_has_substream(const struct camera_t *camera)
+{
+    /* Check parameter(s) */
+    g_return_val_if_fail(camera != NULL, FALSE);
+
+    return camera->substream;
+}
+
+void camera_set_passthrough(struct camera_t *camera, const gboolean enabled)
+{
+    /* Check parameter(s) */
+    g_return_if_fail(camera != NULL);
+
+    camera->passthrough = (camera->type == USB_CAMERA) ? enabled : FALSE;
+
+    if (camera->passthrough)
+    {
+        camera->substream = FALSE;
+    }
+}
+
+gboolean camera_is_passthrough(const struct camera_t *camera)
+{
+    /* Check parameter(s) */
+    g_return_val_if_fail(camera != NULL, FALSE);
+
+    return camera->passthrough;
+}
+
+void camera_set_capture_mode(struct camera_t *camera, const struct probe_mode_t *mode)
+{
+    /* Check parameter(s) */
+    g_return_if_fail((camera != NULL) && (mode != NULL));
+
+    camera->mode = *mode;
+    camera->has_mode = TRUE;
+}
+
+const struct probe_mode_t *camera_get_capture_mode(const struct camera_t *camera)
+{
+    /* Check parameter(s) */
+    g_return_val_if_fail(camera != NULL, NULL);
+
+    return (camera->has_mode) ? &camera->mode : NULL;
+}
+
+gint camera_get_fps(const struct camera_t *camera)
+{
+    /* Check parameter(s) */
+    g_return_val_if_fail(camera != NULL, 0);
+
+    return camera->fps;
+}
+
+enum camera_motion_t camera_get_motion(const struct camera_t *camera)
+{
+    /* Check parameter(s) */
+    g_return_val_if_fail(camera != NULL, CAMERA_MOTION_UNKNOWN);
+
+    return camera->motion;
+}
+
+const gchar* camera_motion_to_string(const enum camera_motion_t motion)
+{
+    return (motion < CAMERA_MOTION_UNKNOWN) ? camera_motion_names[motion] : "unknown";
+}
+
+enum camera_motion_t camera_motion_from_string(const gchar *motion)
+{
+    enum camera_motion_t result = CAMERA_MOTION_STATIC;
+
+    for (result = CAMERA_MOTION_STATIC; result < CAMERA_MOTION_UNKNOWN; result++)
+    {
+        if (g_strcmp0(camera_motion_names[result], motion) == 0)
+        {
+            break;
+        }
+    }
+
+    return result;
+}
@@ -2,17 +2,23 @@
  * FILENAME: camera.h
  *
  * DESCRIPTION:
- *   Contains APIs to detect and initialize (MIPI, USB) cameras.
+ *   Contains APIs to detect and initialize (MIPI, USB) cameras, and to
+ *   create fake cameras (videos) and synthetic cameras (test patterns).
  *
  * PUBLIC FUNCTIONS:
+ *   gint supported_platform_get_index();
+ *
  *   gboolean mipi_camera_is_supported();
  *
- *   struct camera_t *mipi_camera_init();
+ *   struct camera_t *mipi_camera_init(const enum media_method_t method);
  *
  *   struct camera_t *usb_camera_create(const gchar *camera_fd);
  *
  *   gboolean usb_camera_is_existed(const gchar *camera_fd);
  *
+ *   struct camera_t *synthetic_camera_create(const gint index, const gint fps,
+ *                                            const enum camera_motion_t motion);
+ *
  *   const gchar* camera_type_to_string(const enum camera_type_t type);
  *
  *   const gchar* camera_get_type_str(const struct camera_t *camera);
@@ -25,6 +31,32 @@
  *
  *   void camera_set_type(struct camera_t *camera, const enum camera_type_t type);
  *
+ *   void camera_set_resolution(struct camera_t *camera, const gchar *width, const gchar *height);
+ *
+ *   const gchar* camera_get_width(const struct camera_t *camera);
+ *
+ *   const gchar* camera_get_height(const struct camera_t *camera);
+ *
+ *   void camera_set_substream(struct camera_t *camera, const gboolean enabled);
+ *
+ *   gboolean camera_has_substream(const struct camera_t *camera);
+ *
+ *   void camera_set_passthrough(struct camera_t *camera, const gboolean enabled);
+ *
+ *   gboolean camera_is_passthrough(const struct camera_t *camera);
+ *
+ *   void camera_set_capture_mode(struct camera_t *camera, const struct probe_mode_t *mode);
+ *
+ *   const struct probe_mode_t *camera_get_capture_mode(const struct camera_t *camera);
+ *
+ *   gint camera_get_fps(const struct camera_t *camera);
+ *
+ *   enum camera_motion_t camera_get_motion(const struct camera_t *camera);
+ *
+ *   const gchar* camera_motion_to_string(const enum camera_motion_t motion);
+ *
+ *   enum camera_motion_t camera_motion_from_string(const gchar *motion);
+ *
  * AUTHOR: RVC       START DATE: 30/12/2019
  *
  * CHANGES:
@@ -43,6 +75,8 @@
  *     - MIPI_CAMERA: Indicate that the camera is MIPI camera.
  *     - USB_CAMERA: Indicate that the camera is USB camera.
  *     - FAKE_CAMERA: Indicate that the camera is actually just a video.
+ *     - SYNTHETIC_CAMERA: Indicate that the camera is a generated test pattern
+ *       (encoded like a USB camera, for benchmarks without cameras).
  *     - UNKNOWN_CAMERA: Indicate that the camera is invalid.
  */
 enum camera_type_t
@@ -50,9 +84,30 @@ enum camera_type_t
     MIPI_CAMERA,
     USB_CAMERA,
     FAKE_CAMERA,
+    SYNTHETIC_CAMERA,
     UNKNOWN_CAMERA
 };
 
+/*
+ * Enum: camera_motion_t
+ * ---
+ *   Represents how much the pattern of a synthetic camera changes between frames
+ *   (the more it changes, the more the encoder works):
+ *     - CAMERA_MOTION_STATIC: Still color bars.
+ *     - CAMERA_MOTION_LOW: A small moving ball.
+ *     - CAMERA_MOTION_MEDIUM: Scrolling color bars.
+ *     - CAMERA_MOTION_HIGH: Random noise (nothing can be predicted).
+ *     - CAMERA_MOTION_UNKNOWN: Invalid level.
+ */
+enum camera_motion_t
+{
+    CAMERA_MOTION_STATIC,
+    CAMERA_MOTION_LOW,
+    CAMERA_MOTION_MEDIUM,
+    CAMERA_MOTION_HIGH,
+    CAMERA_MOTION_UNKNOWN
+};
+
 /*
  * Union: camera_id_t
  * ---
@@ -63,6 +118,9 @@ enum camera_type_t
  *     - camera_id_t::file_path (string): Store the location to a video
  *       if the camera is FAKE_CAMERA. The search path depends on
  *       prog_params_t::video_directory (param_parser.h).
+ *
+ *     - camera_id_t::name (string): Store the name (such as: synthetic-1)
+ *       if the camera is SYNTHETIC_CAMERA.
  */
 union camera_id_t;
 
@@ -72,11 +130,34 @@ union camera_id_t;
  *   Represents camera device:
  *     - type (enum camera_type_t): Camera type (such as: USB, MIPI or fake camera).
  *     - id (union camera_id_t): Camera ID (store either virtual device or video's (absolute) path).
+ *     - width (string): Output width of the stream (empty: default width of the pipeline).
+ *     - height (string): Output height of the stream (empty: default height of the pipeline).
+ *     - substream (gboolean): Set if a low resolution copy of the stream is also encoded.
+ *     - passthrough (gboolean): Set if the camera encodes H.264 itself (streamed without VSP and encoder).
+ *     - mode (struct probe_mode_t): Capture mode of USB cameras, chosen for the output resolution.
+ *     - has_mode (gboolean): Set if "mode" is chosen.
+ *     - fps (gint): Frame rate of synthetic cameras (0 for other cameras).
+ *     - motion (enum camera_motion_t): Pattern of synthetic cameras.
  */
 struct camera_t;
 
+/* Capture mode of a camera (see "probe.h") */
+struct probe_mode_t;
+
 /* ---------- Functions ---------- */
 
+/*
+ * Function: supported_platform_get_index
+ * ---
+ *   Get index of the board in the supported platforms: "ek874", "hihope-rzg2m",
+ *   "hihope-rzg2n", "hihope-rzg2h" (in this order). The platform is the host name,
+ *   or the one emulated by the mock media device (see "media_get_mock_platform()").
+ *
+ *   return: index >= 0 if host name is a supported platform.
+ *           index == -1 if host name is not a supported platform.
+ */
+gint supported_platform_get_index();
+
 /*
  * Function: mipi_camera_is_supported
  * ---
@@ -90,7 +171,10 @@ gboolean mipi_camera_is_supported();
 /*
  * Function: mipi_camera_init
  * ---
- *   Initializes MIPI camera.
+ *   Initializes MIPI camera (links and formats of its media pipeline, see "media.h").
+ *   The time it takes is logged.
+ *
+ *   method: In-process ioctls (MEDIA_METHOD_IOCTL) or "media-ctl" commands.
  *
  *   return: NULL (unable to initialize MIPI camera).
  *           not NULL (successfully initialize MIPI camera).
@@ -98,7 +182,7 @@ gboolean mipi_camera_is_supported();
  *   Note: The "camera_t" ouput is allocated dynamically.
  *         Should use "free()" to deallocate if it is not used anymore.
  */
-struct camera_t *mipi_camera_init();
+struct camera_t *mipi_camera_init(const enum media_method_t method);
 
 /*
  * Function: usb_camera_create
@@ -130,6 +214,25 @@ struct camera_t *usb_camera_create(const gchar *camera_fd);
  */
 struct camera_t *fake_camera_create(const gchar *path);
 
+/*
+ * Function: synthetic_camera_create
+ * ---
+ *   Creates synthetic camera "synthetic-<index>", which generates a test pattern
+ *   (no device needed). Its resolution is set by "camera_set_resolution".
+ *
+ *   index: Number of the camera (from 1).
+ *   fps: Frame rate (frames per second).
+ *   motion: Motion complexity of the pattern.
+ *
+ *   return: NULL (invalid parameters).
+ *           not NULL (successfully create synthetic camera).
+ *
+ *   Note: The "camera_t" ouput is allocated dynamically.
+ *         Should use "free()" to deallocate if it is not used anymore.
+ */
+struct camera_t *synthetic_camera_create(const gint index, const gint fps,
+                                         const enum camera_motion_t motion);
+
 /*
  * Function: usb_camera_is_existed
  * ---
@@ -220,6 +323,7 @@ const gchar* camera_get_id(const struct camera_t *camera);
  *   id: Camera ID
  *     - If "camera" is either USB or MIPI camera, the ID would be file descriptor (such as: video8, video9...).
  *     - If "camera" is fake camera, the ID would be the video's path.
+ *     - If "camera" is synthetic camera, the ID would be its name (such as: synthetic-1).
  *
  *   return: void.
  */
@@ -237,4 +341,158 @@ void camera_set_id(struct camera_t *camera, const gchar *id);
  */
 void camera_set_type(struct camera_t *camera, const enum camera_type_t type);
 
+/*
+ * Function: camera_set_resolution
+ * ---
+ *   Set output resolution of "camera" object.
+ *
+ *   camera: Reference to "camera_t" struct.
+ *   width: Output width (empty string: use default resolution of the pipeline).
+ *   height: Output height (empty string: use default resolution of the pipeline).
+ *
+ *   return: void.
+ */
+void camera_set_resolution(struct camera_t *camera, const gchar *width, const gchar *height);
+
+/*
+ * Function: camera_get_width
+ * ---
+ *   Get output width inside "camera_t" struct.
+ *
+ *   camera: Reference to "camera_t" struct.
+ *
+ *   Note: The output string must not be de-allocated or modified.
+ *
+ *   return: String (empty if the default resolution is used).
+ */
+const gchar* camera_get_width(const struct camera_t *camera);
+
+/*
+ * Function: camera_get_height
+ * ---
+ *   Get output height inside "camera_t" struct.
+ *
+ *   camera: Reference to "camera_t" struct.
+ *
+ *   Note: The output string must not be de-allocated or modified.
+ *
+ *   return: String (empty if the default resolution is used).
+ */
+const gchar* camera_get_height(const struct camera_t *camera);
+
+/*
+ * Function: camera_set_substream
+ * ---
+ *   Enable/disable substream (low resolution copy of the stream) of "camera".
+ *
+ *   camera: Reference to "camera_t" struct.
+ *   enabled: TRUE to encode a substream.
+ *
+ *   Note: Substreams are always disabled for fake cameras and passthrough cameras.
+ *
+ *   return: void.
+ */
+void camera_set_substream(struct camera_t *camera, const gboolean enabled);
+
+/*
+ * Function: camera_has_substream
+ * ---
+ *   Check if "camera" has a substream or not?
+ *
+ *   camera: Reference to "camera_t" struct.
+ *
+ *   return: TRUE (a substream is encoded).
+ *           FALSE (only the main stream is encoded).
+ */
+gboolean camera_has_substream(const struct camera_t *camera);
+
+/*
+ * Function: camera_set_passthrough
+ * ---
+ *   Stream H.264 encoded by "camera" itself instead of encoding its frames.
+ *   This disables the substream.
+ *
+ *   camera: Reference to "camera_t" struct.
+ *   enabled: TRUE to stream H.264 of the camera.
+ *
+ *   Note: Only USB cameras can be passthrough cameras.
+ *
+ *   return: void.
+ */
+void camera_set_passthrough(struct camera_t *camera, const gboolean enabled);
+
+/*
+ * Function: camera_is_passthrough
+ * ---
+ *   Check if "camera" is streamed without VSP and encoder.
+ *
+ *   camera: Reference to "camera_t" struct.
+ *
+ *   return: TRUE (H.264 of the camera is streamed as it is).
+ *           FALSE (frames are encoded by the pipeline).
+ */
+gboolean camera_is_passthrough(const struct camera_t *camera);
+
+/*
+ * Function: camera_set_capture_mode
+ * ---
+ *   Keeps the capture mode chosen for the output resolution of "camera" (such as:
+ *   by the resource budget), so that its pipeline does not probe the device again.
+ *   Changing the resolution forgets it.
+ *
+ *   return: void.
+ */
+void camera_set_capture_mode(struct camera_t *camera, const struct probe_mode_t *mode);
+
+/*
+ * Function: camera_get_capture_mode
+ * ---
+ *   Get the capture mode kept by "camera_set_capture_mode()".
+ *
+ *   return: NULL if no mode is chosen yet.
+ */
+const struct probe_mode_t *camera_get_capture_mode(const struct camera_t *camera);
+
+/*
+ * Function: camera_get_fps
+ * ---
+ *   Get frame rate of synthetic camera "camera".
+ *
+ *   camera: Reference to "camera_t" struct.
+ *
+ *   return: Frames per second (0 if "camera" is not a synthetic camera).
+ */
+gint camera_get_fps(const struct camera_t *camera);
+
+/*
+ * Function: camera_get_motion
+ * ---
+ *   Get motion complexity of the pattern of synthetic camera "camera".
+ *
+ *   camera: Reference to "camera_t" struct.
+ *
+ *   return: "enum camera_motion_t" (CAMERA_MOTION_STATIC if "camera" is not a synthetic camera).
+ */
+enum camera_motion_t camera_get_motion(const struct camera_t *camera);
+
+/*
+ * Function: camera_motion_to_string
+ * ---
+ *   Convert "enum camera_motion_t" to string.
+ *
+ *   Note: The output string must not be de-allocated or modified.
+ *
+ *   return: String (such as: "static", "low", "medium", "high", "unknown").
+ */
+const gchar* camera_motion_to_string(const enum camera_motion_t motion);
+
+/*
+ * Function: camera_motion_from_string
+ * ---
+ *   Convert string "motion" (such as: "static", "high") to "enum camera_motion_t".
+ *
+ *   return: Motion complexity (CAMERA_MOTION_UNKNOWN if "motion" is invalid).
+ */
+enum camera_motion_t camera_motion_from_string(const gchar *motion);
+
 #endif
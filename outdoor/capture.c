@@ -0,0 +1,2043 @@
+/***********************************************************************
+ * FILENAME: capture.c
+ *
+ * DESCRIPTION:
+ *   Camera pipeline implementations.
+ *
+ * NOTE:
+ *   For more further information about datatypes and function usages,
+ *   please refer to "capture.h".
+ *
+ * AUTHOR: RVC       START DATE: 16/10/2026
+ *
+ * CHANGES:
+ *
+ ***********************************************************************/
+
+/* ---------- Header files ---------- */
+
+#include <glib.h>
+#include <glib/gprintf.h>
+
+#include <gst/gst.h>
+#include <gst/app/gstappsrc.h>
+#include <gst/app/gstappsink.h>
+#include <gst/rtsp-server/rtsp-server.h>
+
+#include "media.h"
+#include "camera.h"
+#include "my_gst.h"
+#include "server.h"
+#include "abr.h"
+#include "clip.h"
+#include "replay.h"
+#include "profile.h"
+#include "stamp.h"
+#include "rtppace.h"
+#include "capture.h"
+
+/* ---------- Macros ---------- */
+
+/* Maximum number of access units kept in the GOP cache of a branch. Longer GOPs are not cached */
+#define CAPTURE_GOP_CACHE_MAX_UNITS 300
+
+/* A cached GOP is sent to a new client in bursts of CAPTURE_BURST_UNITS access units
+ * every CAPTURE_BURST_INTERVAL milliseconds (10 times faster than 30 fps) */
+#define CAPTURE_BURST_INTERVAL 10
+#define CAPTURE_BURST_UNITS 3
+
+/* NAL unit types of slices */
+#define CAPTURE_NAL_SLICE 1
+#define CAPTURE_NAL_IDR_SLICE 5
+
+/* ---------- Datatypes ---------- */
+
+/*
+ * Struct: capture_consumer_t
+ * ---
+ *   Represents an RTSP media fed by a branch:
+ *     - branch (struct capture_branch_t): The branch feeding the media.
+ *     - media (GstRTSPMedia): The media (valid until it is unprepared).
+ *     - appsrc (GstElement): "appsrc" element of the media.
+ *     - synced (gboolean): Set once the first keyframe has been pushed. Until then,
+ *       access units are dropped because the client cannot decode them.
+ *     - mount (string): Mount point of the media (used in logs).
+ *     - configure_time (gint64): Monotonic time (us) when the media was created.
+ *     - warm (gboolean): Set if the camera pipeline was already running at that time.
+ *     - backlog (queue of GstBuffer): Access units waiting to be sent in bursts
+ *       (the cached GOP, then live access units received in the meantime).
+ *     - session (struct replay_session_t): RTP header fields of the media (RTP cache only).
+ *     - offset (GstClockTimeDiff): Running time of the media minus running time of the camera
+ *       pipeline, set by the first access unit out of "appsrc" ("has_offset").
+ *     - client (string): Address of the client (NULL until it is needed in logs).
+ *     - pushed_counts, dropped_counts (gsize): Access units pushed to the media, and dropped
+ *       because the session queue was full.
+ *     - overflow_counts (gsize): The number of times the session queue filled up.
+ *     - overflow_drops (gsize): "dropped_counts" when the queue last filled up.
+ *     - max_level (guint64): Highest level of the session queue ("appsrc", bytes).
+ *     - overflowing (gboolean): Set while the session queue is full.
+ *     - skipping (gboolean): Set while access units are dropped until the next keyframe.
+ *     - closing (gboolean): Set once the client is being disconnected.
+ */
+struct capture_consumer_t
+{
+    struct capture_branch_t *branch;
+
+    GstRTSPMedia *media;
+
+    GstElement *appsrc;
+
+    gboolean synced;
+
+    gchar *mount;
+
+    gint64 configure_time;
+
+    gboolean warm;
+
+    GQueue backlog;
+
+    struct replay_session_t session;
+
+    GstClockTimeDiff offset;
+
+    gboolean has_offset;
+
+    gchar *client;
+
+    gsize pushed_counts;
+
+    gsize dropped_counts;
+
+    gsize overflow_counts;
+
+    gsize overflow_drops;
+
+    guint64 max_level;
+
+    gboolean overflowing;
+
+    gboolean skipping;
+
+    gboolean closing;
+};
+
+/*
+ * Struct: capture_branch_t
+ * ---
+ *   Represents an encoding branch (stream tier) of the camera pipeline:
+ *     - capture (struct capture_t): The camera pipeline owning the branch.
+ *     - appsink (GstElement): "appsink" element at the end of the branch.
+ *     - encoder (GstElement): H.264 encoder of the branch (NULL for fake cameras).
+ *     - abr (struct abr_t): Bitrate controller of the encoder (NULL if disabled).
+ *     - caps (GstCaps): Latest caps of encoded access units.
+ *     - gop (queue of GstBuffer): The latest keyframe and the access units after it.
+ *     - gop_valid (gboolean): FALSE if the current GOP is too long to be cached.
+ *     - consumers (array of "capture_consumer_t"): RTSP media fed by this branch.
+ *     - frame_counts (gint): Access units since the last statistics.
+ *     - latency_sum (gsize), latency_max (gint): Latency of these access units (from capture
+ *       to "appsink": scaling and encoding), total and worst (us).
+ *     - latency_counts (gint): Access units whose latency is in "latency_sum".
+ *       Statistics are updated and taken atomically, like the counters below.
+ *     - factory (GstRTSPMediaFactory): Factory of the tier (not referenced, NULL until it is created).
+ *     - unit_counts, keyframe_counts, unit_bytes, unit_sizes, keyframe_interval, rtp_bytes,
+ *       dropped_counts, stale_counts, encoder_errors: Counters of "capture_counters_t". They
+ *       are updated and read atomically (streaming threads do not wait for readers).
+ *     - stale_logged (array of gsize): "stale_counts" at the last statistics.
+ *     - units_since_keyframe (gint): Access units since the latest keyframe ("appsink" thread only).
+ */
+struct capture_branch_t
+{
+    struct capture_t *capture;
+
+    GstElement *appsink;
+
+    GstElement *encoder;
+
+    struct abr_t *abr;
+
+    GstCaps *caps;
+
+    GQueue gop;
+
+    gboolean gop_valid;
+
+    GPtrArray *consumers;
+
+    gint frame_counts;
+
+    gsize latency_sum;
+
+    gint latency_max;
+
+    gint latency_counts;
+
+    GstRTSPMediaFactory *factory;
+
+    gsize unit_counts;
+
+    gsize keyframe_counts;
+
+    gsize unit_bytes;
+
+    gsize unit_sizes[CAPTURE_UNIT_SIZE_BUCKETS];
+
+    gint keyframe_interval;
+
+    gint units_since_keyframe;
+
+    gsize rtp_bytes;
+
+    gsize dropped_counts;
+
+    gsize stale_counts[CAPTURE_STAGE_COUNTS];
+
+    gsize stale_logged[CAPTURE_STAGE_COUNTS];
+
+    gsize encoder_errors;
+};
+
+struct capture_t
+{
+    const struct camera_t *camera;
+
+    GstElement *pipeline;
+
+    guint bus_watch_id;
+
+    struct capture_branch_t branches[CAPTURE_TIER_COUNTS];
+
+    gint consumer_counts;
+
+    /* Keep the pipeline running without consumers */
+    gboolean keep_warm;
+
+    gboolean running;
+
+    /* Monotonic time (us) when the pipeline was started, 0 after its first frame */
+    gint64 start_time;
+
+    /* Timer sending backlogs of new consumers (0 if there is no backlog) */
+    guint burst_source_id;
+
+    /* Timer of bitrate decisions (0 if adaptive bitrate is disabled) */
+    guint abr_source_id;
+
+    /* Timer of statistics logs (0 if disabled) and monotonic time (us) of the last ones */
+    guint stats_source_id;
+    gint64 stats_time;
+
+    /* Profiler of the pipeline and of RTSP media (NULL if disabled) */
+    struct profile_t *profile;
+
+    /* Stamp access units with their capture time (see "stamp.h") */
+    gboolean stamp_enabled;
+
+    /* Errors of VSP elements and of other elements (atomic, see "capture_counters_t") */
+    gsize vsp_errors;
+    gsize other_errors;
+
+    /* Clip feeding the pipeline (fake cameras only, NULL otherwise) */
+    struct clip_t *clip;
+
+    /* RTP packets of the clip, pushed to media instead of access units (NULL if disabled) */
+    struct replay_t *replay;
+
+    /* Slow clients: policy and size (bytes) of session queues */
+    enum capture_overflow_t overflow;
+    gsize session_queue;
+
+    /* Egress of media: spread (%) and batch (packets) of "rtppace", no pacing if batch is 0 */
+    guint pace_spread;
+    guint pace_batch;
+
+    /* Protects "consumers" arrays and "caps" (used by streaming threads) */
+    GMutex lock;
+
+    /* Also held while "consumers" arrays change, so that metrics read them without "lock"
+     * (streaming threads never wait for a scrape) */
+    GMutex clients_lock;
+
+    /* Serializes consumer registrations and pipeline state changes */
+    GMutex state_lock;
+};
+
+/* ---------- Private variables ---------- */
+
+/* Names of "appsink" elements, indexed by "enum capture_tier_t" */
+const gchar *capture_tier_names[] = { GST_MAIN_STREAM_NAME, GST_SUB_STREAM_NAME };
+
+/* Upper bounds of access unit size buckets */
+const gsize capture_unit_size_bounds[] = CAPTURE_UNIT_SIZE_BOUNDS;
+
+/* Names of stages in leaky queue names, indexed by "enum capture_stage_t" */
+const gchar *capture_stage_names[] = { GST_SCALE_STAGE_NAME, GST_ENCODE_STAGE_NAME };
+
+/* ---------- Private functions ---------- */
+
+/*
+ * Function: capture_on_new_sample
+ * ---
+ *   Callback of "appsink". Pushes the new access unit to every consumer of the branch.
+ */
+static GstFlowReturn capture_on_new_sample(GstAppSink *appsink, gpointer user_data);
+
+/*
+ * Function: capture_on_eos
+ * ---
+ *   Callback of "appsink". Forwards end-of-stream to every consumer of the branch.
+ */
+static void capture_on_eos(GstAppSink *appsink, gpointer user_data);
+
+/*
+ * Function: capture_on_bus_message
+ * ---
+ *   Prints errors and warnings of the camera pipeline.
+ */
+static gboolean capture_on_bus_message(GstBus *bus, GstMessage *message, gpointer user_data);
+
+/*
+ * Function: capture_on_media_configure
+ * ---
+ *   Callback of "GstRTSPMediaFactory::media-configure". Registers the "appsrc"
+ *   element of the new media as a consumer of the branch.
+ */
+static void capture_on_media_configure(GstRTSPMediaFactory *factory, GstRTSPMedia *media,
+                                       gpointer user_data);
+
+/*
+ * Function: capture_on_media_unprepared
+ * ---
+ *   Callback of "GstRTSPMedia::unprepared". Unregisters the consumer.
+ */
+static void capture_on_media_unprepared(GstRTSPMedia *media, gpointer user_data);
+
+/*
+ * Function: capture_on_rtp
+ * ---
+ *   Probe of the payloader of RTSP media. Counts RTP bytes of the branch.
+ *
+ *   return: GST_PAD_PROBE_OK.
+ */
+static GstPadProbeReturn capture_on_rtp(GstPad *pad, GstPadProbeInfo *info, gpointer user_data);
+
+/*
+ * Function: capture_on_unit_out
+ * ---
+ *   Probe of the "appsrc" element of RTSP media (not fed by the RTP cache). Moves
+ *   timestamps of access units from the running time of the camera pipeline to the
+ *   running time of the media, so that frames of the GOP cache keep their gaps.
+ *
+ *   return: GST_PAD_PROBE_OK.
+ */
+static GstPadProbeReturn capture_on_unit_out(GstPad *pad, GstPadProbeInfo *info, gpointer user_data);
+
+/*
+ * Function: capture_get_running_time
+ * ---
+ *   Get the current running time of "element" (its clock time minus its base time).
+ *
+ *   return: GST_CLOCK_TIME_NONE (the element has no clock, such as: not playing).
+ */
+static GstClockTime capture_get_running_time(GstElement *element);
+
+/*
+ * Function: capture_on_overrun
+ * ---
+ *   Callback of "queue::overrun" of the leaky queue in front of a stage: the queue is full,
+ *   its oldest frame is dropped. Increments the counter "user_data" (see "stale_counts").
+ */
+static void capture_on_overrun(GstElement *queue, gpointer user_data);
+
+/*
+ * Function: capture_count_error
+ * ---
+ *   Counts an error of element "source": encoder of a branch, VSP ("vspmfilter") or other.
+ */
+static void capture_count_error(struct capture_t *capture, GstObject *source);
+
+/*
+ * Function: capture_update_state
+ * ---
+ *   Starts the camera pipeline if it has consumers (or is kept warm), stops it otherwise.
+ *
+ *   Note: "state_lock" must be held, "lock" must not.
+ *
+ *   return: TRUE (the pipeline was already running).
+ *           FALSE (the pipeline was stopped).
+ */
+static gboolean capture_update_state(struct capture_t *capture);
+
+/*
+ * Function: capture_clear_units
+ * ---
+ *   Removes (and unrefs) all access units of "units".
+ */
+static void capture_clear_units(GQueue *units);
+
+/*
+ * Function: capture_push_unit
+ * ---
+ *   Pushes access unit "buffer" to the "appsrc" element of "consumer".
+ *
+ *   Note: "lock" must be held.
+ */
+static void capture_push_unit(struct capture_consumer_t *consumer, GstBuffer *buffer);
+
+/*
+ * Function: capture_admit_unit
+ * ---
+ *   Checks the session queue of "consumer" before access unit "buffer" is pushed,
+ *   and applies the overflow policy if it is full.
+ *
+ *   Note: "lock" must be held.
+ *
+ *   return: TRUE (push the access unit).
+ *           FALSE (drop it).
+ */
+static gboolean capture_admit_unit(struct capture_consumer_t *consumer, GstBuffer *buffer);
+
+/*
+ * Function: capture_is_reference
+ * ---
+ *   Check if access unit "buffer" (AVC format) may be referred to by other frames or not?
+ *
+ *   return: FALSE (all slices have nal_ref_idc 0).
+ *           TRUE (otherwise, or the access unit cannot be parsed).
+ */
+static gboolean capture_is_reference(GstBuffer *buffer, const guint nal_length_size);
+
+/*
+ * Function: capture_on_disconnect
+ * ---
+ *   Idle callback (default main context). Closes the connection of the client of
+ *   media "user_data" (see CAPTURE_OVERFLOW_DISCONNECT).
+ *
+ *   return: G_SOURCE_REMOVE.
+ */
+static gboolean capture_on_disconnect(gpointer user_data);
+
+/*
+ * Function: capture_on_burst
+ * ---
+ *   Timer callback. Sends the next access units of every consumer backlog.
+ *
+ *   return: G_SOURCE_CONTINUE (some backlogs are not empty).
+ *           G_SOURCE_REMOVE (all backlogs are sent).
+ */
+static gboolean capture_on_burst(gpointer user_data);
+
+/*
+ * Function: capture_on_abr
+ * ---
+ *   Timer callback. Adjusts the bitrate of every encoder to the reports of its clients.
+ *
+ *   return: G_SOURCE_CONTINUE.
+ */
+static gboolean capture_on_abr(gpointer user_data);
+
+/*
+ * Function: capture_on_stats
+ * ---
+ *   Timer callback. Logs frame rate and latency of every branch since the last call,
+ *   and the queue of every session.
+ *
+ *   return: G_SOURCE_CONTINUE.
+ */
+static gboolean capture_on_stats(gpointer user_data);
+
+/*
+ * Function: capture_add_consumer
+ * ---
+ *   Adds "consumer" to its branch. Starts the camera pipeline for the first consumer.
+ */
+static void capture_add_consumer(struct capture_consumer_t *consumer);
+
+/*
+ * Function: capture_remove_consumer
+ * ---
+ *   Removes "consumer" from its branch. Stops the camera pipeline after the last consumer.
+ */
+static void capture_remove_consumer(struct capture_consumer_t *consumer);
+
+/* ---------- Private functions ---------- */
+
+GstFlowReturn capture_on_new_sample(GstAppSink *appsink, gpointer user_data)
+{
+    struct capture_branch_t *branch = (struct capture_branch_t*)user_data;
+    struct capture_t *capture = branch->capture;
+    struct capture_consumer_t *consumer = NULL;
+
+    GstSample *sample = NULL;
+    GstBuffer *buffer = NULL;
+    GstBuffer *stamped = NULL;
+    GstBuffer *unstamped = NULL;
+    GstCaps *caps = NULL;
+    GstClockTime now = GST_CLOCK_TIME_NONE;
+
+    gint64 encode_time = 0;
+    gint latency = 0;
+    gint max = 0;
+    gsize size = 0;
+    guint index = 0;
+
+    sample = gst_app_sink_pull_sample(appsink);
+    if (sample == NULL)
+    {
+        return GST_FLOW_EOS;
+    }
+
+    buffer = gst_sample_get_buffer(sample);
+    unstamped = buffer;
+    caps = gst_sample_get_caps(sample);
+
+    /* Running time of the access unit. Live sources timestamp frames with the running
+     * time of their capture, the difference is the time spent in the branch */
+    if (((capture->stats_source_id != 0) || capture->stamp_enabled) && GST_BUFFER_PTS_IS_VALID(buffer))
+    {
+        now = capture_get_running_time(GST_ELEMENT(appsink));
+    }
+
+    /* Stamp wall-clock times of capture and encoding. Without running time (clips), the
+     * access unit is captured now. Access units replayed from the RTP cache are matched
+     * with their packets by size, so they are not stamped. Neither are byte-stream
+     * access units (see "stamp_is_supported") */
+    if (capture->stamp_enabled && (capture->replay == NULL) && (caps != NULL) && stamp_is_supported(caps))
+    {
+        encode_time = g_get_real_time();
+
+        stamped = stamp_insert(buffer, stamp_get_nal_length_size(caps),
+                               (GST_CLOCK_TIME_IS_VALID(now) && (now >= GST_BUFFER_PTS(buffer))) ?
+                               encode_time - (gint64)GST_TIME_AS_USECONDS(now - GST_BUFFER_PTS(buffer)) :
+                               encode_time, encode_time);
+        if (stamped != NULL)
+        {
+            buffer = stamped;
+        }
+    }
+
+    /* Counters of metrics (see "capture_get_counters"), without lock */
+    size = gst_buffer_get_size(buffer);
+
+    index = 0;
+    while ((index < CAPTURE_UNIT_SIZE_BUCKETS - 1) && (size > capture_unit_size_bounds[index]))
+    {
+        index++;
+    }
+
+    g_atomic_pointer_add(&branch->unit_sizes[index], 1);
+    g_atomic_pointer_add(&branch->unit_counts, 1);
+    g_atomic_pointer_add(&branch->unit_bytes, size);
+
+    if (!GST_BUFFER_FLAG_IS_SET(buffer, GST_BUFFER_FLAG_DELTA_UNIT))
+    {
+        if (branch->units_since_keyframe > 0)
+        {
+            g_atomic_int_set(&branch->keyframe_interval, branch->units_since_keyframe);
+        }
+
+        g_atomic_pointer_add(&branch->keyframe_counts, 1);
+        branch->units_since_keyframe = 0;
+    }
+
+    branch->units_since_keyframe++;
+
+    /* Statistics (see "capture_on_stats"), without lock */
+    g_atomic_int_inc(&branch->frame_counts);
+
+    if (GST_CLOCK_TIME_IS_VALID(now) && (now >= GST_BUFFER_PTS(buffer)))
+    {
+        latency = (gint)GST_TIME_AS_USECONDS(now - GST_BUFFER_PTS(buffer));
+
+        g_atomic_pointer_add(&branch->latency_sum, latency);
+        g_atomic_int_inc(&branch->latency_counts);
+
+        /* Only the statistics timer resets the maximum: retry if it did meanwhile */
+        do
+        {
+            max = g_atomic_int_get(&branch->latency_max);
+        }
+        while ((latency > max) && !g_atomic_int_compare_and_exchange(&branch->latency_max, max, latency));
+    }
+
+    g_mutex_lock(&capture->lock);
+
+    /* Report how long the camera took to deliver its first frame */
+    if (capture->start_time != 0)
+    {
+        g_message("Info: %s '%s' delivered its first frame %.1f ms after start",
+                  camera_get_type_str(capture->camera), camera_get_id(capture->camera),
+                  (g_get_monotonic_time() - capture->start_time) / 1000.0);
+
+        capture->start_time = 0;
+    }
+
+    /* Forward new caps (such as: new SPS/PPS in codec_data). Media fed by
+     * the RTP cache keep the caps of the packets */
+    if ((caps != NULL) && ((branch->caps == NULL) || !gst_caps_is_equal(branch->caps, caps)))
+    {
+        gst_caps_replace(&branch->caps, caps);
+
+        for (index = 0; (index < branch->consumers->len) && (capture->replay == NULL); index++)
+        {
+            consumer = g_ptr_array_index(branch->consumers, index);
+            gst_app_src_set_caps(GST_APP_SRC(consumer->appsrc), caps);
+        }
+
+        /* Cached access units may not match new caps */
+        capture_clear_units(&branch->gop);
+        branch->gop_valid = FALSE;
+    }
+
+    /* Update the GOP cache: a keyframe starts a new GOP */
+    if (!GST_BUFFER_FLAG_IS_SET(buffer, GST_BUFFER_FLAG_DELTA_UNIT))
+    {
+        capture_clear_units(&branch->gop);
+        branch->gop_valid = TRUE;
+    }
+
+    /* The GOP cache is sent to late-joining clients: it keeps access units without
+     * stamp, which would report the age of the cache as latency */
+    if (branch->gop_valid)
+    {
+        if (g_queue_get_length(&branch->gop) < CAPTURE_GOP_CACHE_MAX_UNITS)
+        {
+            g_queue_push_tail(&branch->gop, gst_buffer_ref(unstamped));
+        }
+        else
+        {
+            /* Do not keep a partial GOP, it cannot be decoded */
+            capture_clear_units(&branch->gop);
+            branch->gop_valid = FALSE;
+        }
+    }
+
+    for (index = 0; index < branch->consumers->len; index++)
+    {
+        consumer = g_ptr_array_index(branch->consumers, index);
+
+        /* Consumers sending their backlog get live access units after it */
+        if (!g_queue_is_empty(&consumer->backlog))
+        {
+            g_queue_push_tail(&consumer->backlog, gst_buffer_ref(buffer));
+            continue;
+        }
+
+        /* Consumers without cached GOP start from a keyframe */
+        if ((!consumer->synced) && GST_BUFFER_FLAG_IS_SET(buffer, GST_BUFFER_FLAG_DELTA_UNIT))
+        {
+            g_atomic_pointer_add(&branch->dropped_counts, 1);
+            continue;
+        }
+
+        capture_push_unit(consumer, buffer);
+    }
+
+    g_mutex_unlock(&capture->lock);
+
+    if (stamped != NULL)
+    {
+        gst_buffer_unref(stamped);
+    }
+
+    gst_sample_unref(sample);
+
+    return GST_FLOW_OK;
+}
+
+void capture_on_eos(GstAppSink *appsink, gpointer user_data)
+{
+    struct capture_branch_t *branch = (struct capture_branch_t*)user_data;
+    struct capture_t *capture = branch->capture;
+    struct capture_consumer_t *consumer = NULL;
+
+    guint index = 0;
+
+    g_mutex_lock(&capture->lock);
+
+    for (index = 0; index < branch->consumers->len; index++)
+    {
+        consumer = g_ptr_array_index(branch->consumers, index);
+        gst_app_src_end_of_stream(GST_APP_SRC(consumer->appsrc));
+    }
+
+    g_mutex_unlock(&capture->lock);
+}
+
+gboolean capture_on_bus_message(GstBus *bus, GstMessage *message, gpointer user_data)
+{
+    struct capture_t *capture = (struct capture_t*)user_data;
+
+    GError *error = NULL;
+    gchar *debug = NULL;
+
+    switch (GST_MESSAGE_TYPE(message))
+    {
+        case GST_MESSAGE_ERROR:
+            gst_message_parse_error(message, &error, &debug);
+            g_message("Error: %s '%s': %s (%s)", camera_get_type_str(capture->camera),
+                      camera_get_id(capture->camera), error->message, (debug != NULL) ? debug : "");
+
+            capture_count_error(capture, GST_MESSAGE_SRC(message));
+        break;
+
+        case GST_MESSAGE_WARNING:
+            gst_message_parse_warning(message, &error, &debug);
+            g_message("Warning: %s '%s': %s", camera_get_type_str(capture->camera),
+                      camera_get_id(capture->camera), error->message);
+        break;
+
+        case GST_MESSAGE_QOS:
+            if (capture->profile != NULL)
+            {
+                profile_handle_message(capture->profile, message);
+            }
+        break;
+
+        default:
+        break;
+    }
+
+    /* Free resources */
+    g_clear_error(&error);
+    g_free(debug);
+
+    return TRUE;
+}
+
+void capture_on_media_configure(GstRTSPMediaFactory *factory, GstRTSPMedia *media,
+                                gpointer user_data)
+{
+    struct capture_branch_t *branch = (struct capture_branch_t*)user_data;
+    struct capture_consumer_t *consumer = NULL;
+
+    struct replay_t *replay = branch->capture->replay;
+
+    GstElement *element = NULL;
+    GstElement *appsrc = NULL;
+    GstElement *payloader = NULL;
+    GstPad *pad = NULL;
+
+    /* Look for "appsrc" element of the media (see "RTSP_PIPELINE_STR" and "RTSP_REPLAY_PIPELINE_STR",
+     * it is the last element of the media only if the RTP cache is not paced) */
+    element = gst_rtsp_media_get_element(media);
+    appsrc = gst_bin_get_by_name_recurse_up(GST_BIN(element),
+                                            ((replay != NULL) && (branch->capture->pace_batch == 0)) ? "pay0"
+                                                                                                    : "src");
+    gst_object_unref(element);
+
+    if (appsrc == NULL)
+    {
+        g_critical("Error: RTSP media has no 'appsrc' element");
+        return;
+    }
+
+    consumer = g_new0(struct capture_consumer_t, 1);
+    consumer->branch = branch;
+    consumer->media = media;
+    consumer->appsrc = appsrc;
+    consumer->synced = FALSE;
+    consumer->configure_time = g_get_monotonic_time();
+    g_queue_init(&consumer->backlog);
+
+    /* "appsrc" never blocks ("block" is FALSE), its own limit only matches the session queue */
+    g_object_set(appsrc, "max-bytes", (guint64)branch->capture->session_queue, NULL);
+
+    /* Packets of the RTP cache get the sequence numbers, timestamps and SSRC of the media.
+     * Access units get the running time of the media when they leave "appsrc" */
+    if (replay != NULL)
+    {
+        replay_init_session(&consumer->session);
+        gst_app_src_set_caps(GST_APP_SRC(appsrc), replay_get_caps(replay));
+    }
+    else
+    {
+        pad = gst_element_get_static_pad(appsrc, "src");
+        gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_BUFFER, capture_on_unit_out, consumer, NULL);
+        gst_object_unref(pad);
+        pad = NULL;
+    }
+
+    /* Mount point is set by "server_add_stream" */
+    consumer->mount = g_strdup(g_object_get_data(G_OBJECT(factory), SERVER_MOUNT_PATH_KEY));
+    if (consumer->mount == NULL)
+    {
+        consumer->mount = g_strdup(camera_get_id(branch->capture->camera));
+    }
+
+    /* Count RTP packets of the media ("pay0" is the payloader, the "appsrc" of the RTP cache, or "rtppace") */
+    element = gst_rtsp_media_get_element(media);
+    payloader = gst_bin_get_by_name_recurse_up(GST_BIN(element), "pay0");
+    gst_object_unref(element);
+
+    if (payloader != NULL)
+    {
+        pad = gst_element_get_static_pad(payloader, "src");
+        gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_BUFFER_LIST,
+                          capture_on_rtp, branch, NULL);
+
+        gst_object_unref(pad);
+        gst_object_unref(payloader);
+    }
+
+    /* Media elements of every client are profiled as well (payloading) */
+    if (branch->capture->profile != NULL)
+    {
+        element = gst_rtsp_media_get_element(media);
+        profile_attach(branch->capture->profile, element, consumer->mount);
+        gst_object_unref(element);
+    }
+
+    /* Unregister the consumer when the media is not used anymore */
+    g_signal_connect(media, "unprepared", G_CALLBACK(capture_on_media_unprepared), consumer);
+
+    capture_add_consumer(consumer);
+}
+
+GstPadProbeReturn capture_on_rtp(GstPad *pad, GstPadProbeInfo *info, gpointer user_data)
+{
+    struct capture_branch_t *branch = (struct capture_branch_t*)user_data;
+
+    if (info->type & GST_PAD_PROBE_TYPE_BUFFER_LIST)
+    {
+        g_atomic_pointer_add(&branch->rtp_bytes,
+                             gst_buffer_list_calculate_size(GST_PAD_PROBE_INFO_BUFFER_LIST(info)));
+    }
+    else
+    {
+        g_atomic_pointer_add(&branch->rtp_bytes, gst_buffer_get_size(GST_PAD_PROBE_INFO_BUFFER(info)));
+    }
+
+    return GST_PAD_PROBE_OK;
+}
+
+GstPadProbeReturn capture_on_unit_out(GstPad *pad, GstPadProbeInfo *info, gpointer user_data)
+{
+    struct capture_consumer_t *consumer = (struct capture_consumer_t*)user_data;
+    GstBuffer *buffer = GST_PAD_PROBE_INFO_BUFFER(info);
+
+    GstClockTime media_time = GST_CLOCK_TIME_NONE;
+    GstClockTime capture_time = GST_CLOCK_TIME_NONE;
+
+    /* Access units without timestamp are timestamped on arrival ("do-timestamp") */
+    if (!GST_BUFFER_PTS_IS_VALID(buffer))
+    {
+        return GST_PAD_PROBE_OK;
+    }
+
+    /* Both running times are taken once, when the media plays: the offset is constant
+     * as long as the camera pipeline runs (it is not restarted while it has consumers) */
+    if (!consumer->has_offset)
+    {
+        media_time = capture_get_running_time(GST_ELEMENT(GST_PAD_PARENT(pad)));
+        capture_time = capture_get_running_time(consumer->branch->capture->pipeline);
+
+        if (!GST_CLOCK_TIME_IS_VALID(media_time) || !GST_CLOCK_TIME_IS_VALID(capture_time))
+        {
+            return GST_PAD_PROBE_OK;
+        }
+
+        consumer->offset = GST_CLOCK_DIFF(capture_time, media_time);
+
+        /* The media may be younger than the cached GOP: its first access unit
+         * starts at running time 0 instead of before it */
+        consumer->offset = MAX(consumer->offset, -(GstClockTimeDiff)GST_BUFFER_PTS(buffer));
+        consumer->has_offset = TRUE;
+    }
+
+    buffer = gst_buffer_make_writable(buffer);
+    GST_PAD_PROBE_INFO_DATA(info) = buffer;
+
+    GST_BUFFER_PTS(buffer) = (GstClockTime)MAX((GstClockTimeDiff)GST_BUFFER_PTS(buffer) + consumer->offset, 0);
+
+    if (GST_BUFFER_DTS_IS_VALID(buffer))
+    {
+        GST_BUFFER_DTS(buffer) = (GstClockTime)MAX((GstClockTimeDiff)GST_BUFFER_DTS(buffer) + consumer->offset, 0);
+    }
+
+    return GST_PAD_PROBE_OK;
+}
+
+GstClockTime capture_get_running_time(GstElement *element)
+{
+    GstClock *clock = NULL;
+    GstClockTime now = GST_CLOCK_TIME_NONE;
+
+    clock = gst_element_get_clock(element);
+    if (clock != NULL)
+    {
+        now = gst_clock_get_time(clock) - gst_element_get_base_time(element);
+        gst_object_unref(clock);
+    }
+
+    return now;
+}
+
+void capture_on_overrun(GstElement *queue, gpointer user_data)
+{
+    g_atomic_pointer_add((gsize*)user_data, 1);
+}
+
+void capture_count_error(struct capture_t *capture, GstObject *source)
+{
+    GstElementFactory *factory = NULL;
+    gint tier = 0;
+
+    for (tier = 0; tier < CAPTURE_TIER_COUNTS; tier++)
+    {
+        if ((capture->branches[tier].encoder != NULL) &&
+            (source == GST_OBJECT(capture->branches[tier].encoder)))
+        {
+            g_atomic_pointer_add(&capture->branches[tier].encoder_errors, 1);
+            return;
+        }
+    }
+
+    if (GST_IS_ELEMENT(source))
+    {
+        factory = gst_element_get_factory(GST_ELEMENT(source));
+    }
+
+    if ((factory != NULL) && g_str_has_prefix(GST_OBJECT_NAME(factory), "vspm"))
+    {
+        g_atomic_pointer_add(&capture->vsp_errors, 1);
+    }
+    else
+    {
+        g_atomic_pointer_add(&capture->other_errors, 1);
+    }
+}
+
+void capture_on_media_unprepared(GstRTSPMedia *media, gpointer user_data)
+{
+    struct capture_consumer_t *consumer = (struct capture_consumer_t*)user_data;
+
+    capture_remove_consumer(consumer);
+
+    if (consumer->client == NULL)
+    {
+        consumer->client = server_get_media_client(media);
+    }
+
+    /* Summary of the session, to tell which client was degraded */
+    g_message("Info: Session of %s (%s) ended: %" G_GSIZE_FORMAT " access units sent, %"
+              G_GSIZE_FORMAT " dropped, %" G_GSIZE_FORMAT " overflows, max queue %.1f KB",
+              consumer->mount, (consumer->client != NULL) ? consumer->client : "shared",
+              consumer->pushed_counts, consumer->dropped_counts, consumer->overflow_counts,
+              consumer->max_level / 1024.0);
+
+    /* Free resources */
+    gst_object_unref(consumer->appsrc);
+    g_free(consumer->mount);
+    g_free(consumer->client);
+    g_free(consumer);
+}
+
+gboolean capture_update_state(struct capture_t *capture)
+{
+    gboolean was_running = capture->running;
+    gboolean running = FALSE;
+    gint tier = 0;
+
+    g_mutex_lock(&capture->lock);
+    running = (capture->keep_warm) || (capture->consumer_counts > 0);
+    g_mutex_unlock(&capture->lock);
+
+    if (running == was_running)
+    {
+        return was_running;
+    }
+
+    /* Note: Do not hold "lock" here, streaming threads need it to stop */
+    if (running)
+    {
+        g_debug("Info: Starting %s '%s'", camera_get_type_str(capture->camera),
+                camera_get_id(capture->camera));
+
+        g_mutex_lock(&capture->lock);
+        capture->start_time = g_get_monotonic_time();
+        g_mutex_unlock(&capture->lock);
+
+        /* Running time starts at 0 again, so do clip timestamps */
+        if (capture->clip != NULL)
+        {
+            clip_rewind(capture->clip);
+        }
+
+        gst_element_set_state(capture->pipeline, GST_STATE_PLAYING);
+    }
+    else
+    {
+        /* Release the device after the last consumer */
+        g_debug("Info: Stopping %s '%s'", camera_get_type_str(capture->camera),
+                camera_get_id(capture->camera));
+
+        gst_element_set_state(capture->pipeline, GST_STATE_NULL);
+
+        /* Caps may change next time the pipeline starts */
+        g_mutex_lock(&capture->lock);
+
+        for (tier = 0; tier < CAPTURE_TIER_COUNTS; tier++)
+        {
+            gst_caps_replace(&capture->branches[tier].caps, NULL);
+
+            /* The next GOP starts with the next run */
+            capture_clear_units(&capture->branches[tier].gop);
+            capture->branches[tier].gop_valid = FALSE;
+        }
+
+        capture->start_time = 0;
+
+        g_mutex_unlock(&capture->lock);
+    }
+
+    capture->running = running;
+
+    return was_running;
+}
+
+void capture_clear_units(GQueue *units)
+{
+    GstBuffer *buffer = NULL;
+
+    while ((buffer = g_queue_pop_head(units)) != NULL)
+    {
+        gst_buffer_unref(buffer);
+    }
+}
+
+void capture_push_unit(struct capture_consumer_t *consumer, GstBuffer *buffer)
+{
+    struct replay_t *replay = consumer->branch->capture->replay;
+    GstBuffer *output = NULL;
+
+    /* The client does not keep up: drop the access unit instead of queueing it */
+    if (!capture_admit_unit(consumer, buffer))
+    {
+        consumer->dropped_counts++;
+        g_atomic_pointer_add(&consumer->branch->dropped_counts, 1);
+        return;
+    }
+
+    consumer->pushed_counts++;
+
+    if (!consumer->synced)
+    {
+        consumer->synced = TRUE;
+
+        /* Time to first frame: from media creation (client's DESCRIBE) to its first keyframe */
+        g_message("Info: Time to first frame of %s: %.1f ms (%s pipeline)", consumer->mount,
+                  (g_get_monotonic_time() - consumer->configure_time) / 1000.0,
+                  (consumer->warm) ? "warm" : "cold");
+    }
+
+    /* Send the cached packets of the access unit instead of the access unit */
+    if (replay != NULL)
+    {
+        replay_push_unit(replay, &consumer->session, GST_APP_SRC(consumer->appsrc), buffer);
+        return;
+    }
+
+    /* Media have their own clock and base time: timestamps of the camera pipeline are moved
+     * to the running time of the media when the access unit leaves "appsrc" (see
+     * "capture_on_unit_out"), so that the cached GOP keeps the gaps between its frames.
+     * The copy shares memory with "buffer" */
+    output = gst_buffer_copy(buffer);
+
+    /* Refused by the media (such as: flushing) */
+    if (gst_app_src_push_buffer(GST_APP_SRC(consumer->appsrc), output) != GST_FLOW_OK)
+    {
+        g_atomic_pointer_add(&consumer->branch->dropped_counts, 1);
+    }
+}
+
+gboolean capture_admit_unit(struct capture_consumer_t *consumer, GstBuffer *buffer)
+{
+    struct capture_t *capture = consumer->branch->capture;
+
+    guint64 level = gst_app_src_get_current_level_bytes(GST_APP_SRC(consumer->appsrc));
+    gsize size = gst_buffer_get_size(buffer);
+    gboolean keyframe = !GST_BUFFER_FLAG_IS_SET(buffer, GST_BUFFER_FLAG_DELTA_UNIT);
+
+    consumer->max_level = MAX(consumer->max_level, level);
+
+    /* Nothing is sent to a client being disconnected */
+    if (consumer->closing)
+    {
+        return FALSE;
+    }
+
+    /* Frames after a dropped reference frame cannot be decoded */
+    if (consumer->skipping && !keyframe)
+    {
+        return FALSE;
+    }
+
+    /* The queue has room (an empty queue always has, even for a large keyframe) */
+    if ((level == 0) || (level + size <= capture->session_queue))
+    {
+        if (consumer->overflowing)
+        {
+            g_message("Info: Client %s of %s caught up (%" G_GSIZE_FORMAT " access units dropped)",
+                      consumer->client, consumer->mount,
+                      consumer->dropped_counts - consumer->overflow_drops);
+
+            consumer->overflowing = FALSE;
+        }
+
+        consumer->skipping = FALSE;
+
+        return TRUE;
+    }
+
+    if (!consumer->overflowing)
+    {
+        if (consumer->client == NULL)
+        {
+            consumer->client = server_get_media_client(consumer->media);
+        }
+
+        if (consumer->client == NULL)
+        {
+            consumer->client = g_strdup("unknown");
+        }
+
+        g_message("Warning: Client %s of %s is too slow: %.1f KB queued, %s",
+                  consumer->client, consumer->mount, level / 1024.0,
+                  capture_overflow_to_string(capture->overflow));
+
+        consumer->overflowing = TRUE;
+        consumer->overflow_counts++;
+        consumer->overflow_drops = consumer->dropped_counts;
+    }
+
+    switch (capture->overflow)
+    {
+        case CAPTURE_OVERFLOW_DROP_NON_REFERENCE:
+            /* Reference frames cannot be dropped alone, skip to the next keyframe */
+            if (!keyframe && !capture_is_reference(buffer, (consumer->branch->caps != NULL) ?
+                                                   stamp_get_nal_length_size(consumer->branch->caps) : 4))
+            {
+                break;
+            }
+
+            consumer->skipping = TRUE;
+        break;
+
+        case CAPTURE_OVERFLOW_DISCONNECT:
+            consumer->closing = TRUE;
+
+            /* Not from a streaming thread: closing the client unprepares the media */
+            g_main_context_invoke_full(NULL, G_PRIORITY_DEFAULT, capture_on_disconnect,
+                                       g_object_ref(consumer->media), g_object_unref);
+        break;
+
+        default:
+            consumer->skipping = TRUE;
+        break;
+    }
+
+    return FALSE;
+}
+
+gboolean capture_is_reference(GstBuffer *buffer, const guint nal_length_size)
+{
+    GstMapInfo map;
+
+    gsize offset = 0;
+    gsize length = 0;
+    gboolean reference = FALSE;
+    gboolean found = FALSE;
+    guint index = 0;
+    guint type = 0;
+
+    if (!gst_buffer_map(buffer, &map, GST_MAP_READ))
+    {
+        return TRUE;
+    }
+
+    /* Slices of the access unit: nal_ref_idc is in bits 5-6 of the NAL header */
+    while ((offset + nal_length_size < map.size) && !reference)
+    {
+        for (length = 0, index = 0; index < nal_length_size; index++)
+        {
+            length = (length << 8) | map.data[offset + index];
+        }
+
+        type = map.data[offset + nal_length_size] & 0x1f;
+        if ((type == CAPTURE_NAL_SLICE) || (type == CAPTURE_NAL_IDR_SLICE))
+        {
+            found = TRUE;
+            reference = ((map.data[offset + nal_length_size] & 0x60) != 0);
+        }
+
+        offset += nal_length_size + length;
+    }
+
+    gst_buffer_unmap(buffer, &map);
+
+    return reference || !found;
+}
+
+gboolean capture_on_disconnect(gpointer user_data)
+{
+    GstRTSPMedia *media = GST_RTSP_MEDIA(user_data);
+    gchar *client = server_get_media_client(media);
+
+    if (server_close_media_client(media))
+    {
+        g_message("Info: Disconnected slow client %s", (client != NULL) ? client : "unknown");
+    }
+
+    g_free(client);
+
+    return G_SOURCE_REMOVE;
+}
+
+gboolean capture_on_burst(gpointer user_data)
+{
+    struct capture_t *capture = (struct capture_t*)user_data;
+    struct capture_consumer_t *consumer = NULL;
+
+    GstBuffer *buffer = NULL;
+    gboolean pending = FALSE;
+
+    guint index = 0;
+    gint tier = 0;
+    gint units = 0;
+
+    g_mutex_lock(&capture->lock);
+
+    for (tier = 0; tier < CAPTURE_TIER_COUNTS; tier++)
+    {
+        for (index = 0; index < capture->branches[tier].consumers->len; index++)
+        {
+            consumer = g_ptr_array_index(capture->branches[tier].consumers, index);
+
+            /* Pace the backlog so that the client's network buffers do not overflow */
+            for (units = 0; units < CAPTURE_BURST_UNITS; units++)
+            {
+                buffer = g_queue_pop_head(&consumer->backlog);
+                if (buffer == NULL)
+                {
+                    break;
+                }
+
+                capture_push_unit(consumer, buffer);
+                gst_buffer_unref(buffer);
+            }
+
+            pending = pending || !g_queue_is_empty(&consumer->backlog);
+        }
+    }
+
+    if (!pending)
+    {
+        capture->burst_source_id = 0;
+    }
+
+    g_mutex_unlock(&capture->lock);
+
+    return (pending) ? G_SOURCE_CONTINUE : G_SOURCE_REMOVE;
+}
+
+gboolean capture_on_abr(gpointer user_data)
+{
+    struct capture_t *capture = (struct capture_t*)user_data;
+    struct capture_branch_t *branch = NULL;
+    struct capture_consumer_t *consumer = NULL;
+
+    GPtrArray *medias = NULL;
+
+    guint index = 0;
+    gint tier = 0;
+
+    for (tier = 0; tier < CAPTURE_TIER_COUNTS; tier++)
+    {
+        branch = &capture->branches[tier];
+        if (branch->abr == NULL)
+        {
+            continue;
+        }
+
+        /* Keep the medias alive while their reports are read (outside "lock") */
+        medias = g_ptr_array_new_with_free_func(g_object_unref);
+
+        g_mutex_lock(&capture->lock);
+
+        for (index = 0; index < branch->consumers->len; index++)
+        {
+            consumer = g_ptr_array_index(branch->consumers, index);
+            g_ptr_array_add(medias, g_object_ref(consumer->media));
+        }
+
+        g_mutex_unlock(&capture->lock);
+
+        abr_update(branch->abr, medias);
+
+        g_ptr_array_free(medias, TRUE);
+    }
+
+    return G_SOURCE_CONTINUE;
+}
+
+gboolean capture_on_stats(gpointer user_data)
+{
+    struct capture_t *capture = (struct capture_t*)user_data;
+    struct capture_branch_t *branch = NULL;
+    struct capture_consumer_t *consumer = NULL;
+
+    gchar *client = NULL;
+    gsize stale[CAPTURE_STAGE_COUNTS];
+    guint index = 0;
+    gint stage = 0;
+    gint frames = 0;
+    gsize latency_sum = 0;
+    gint latency_max = 0;
+    gint latency_counts = 0;
+
+    gint64 now = g_get_monotonic_time();
+    gdouble elapsed = (now - capture->stats_time) / (gdouble)G_USEC_PER_SEC;
+    gint tier = 0;
+
+    capture->stats_time = now;
+
+    for (tier = 0; tier < CAPTURE_TIER_COUNTS; tier++)
+    {
+        branch = &capture->branches[tier];
+        if (branch->appsink == NULL)
+        {
+            continue;
+        }
+
+        /* Take and reset the counters of the interval (an access unit counted
+         * meanwhile may go to the next interval) */
+        frames = g_atomic_int_and(&branch->frame_counts, 0);
+        latency_sum = g_atomic_pointer_and(&branch->latency_sum, 0);
+        latency_max = g_atomic_int_and(&branch->latency_max, 0);
+        latency_counts = g_atomic_int_and(&branch->latency_counts, 0);
+
+        /* Stopped pipelines (no consumers) have nothing to report */
+        if (frames == 0)
+        {
+            continue;
+        }
+
+        /* Parsed by "script/bench_outdoor.sh" */
+        g_message("Info: Stats of %s '%s' (%s): %.1f fps, latency %.1f ms (max %.1f ms)",
+                  camera_get_type_str(capture->camera), camera_get_id(capture->camera),
+                  capture_tier_names[tier], frames / elapsed,
+                  (latency_counts > 0) ? (gdouble)latency_sum / latency_counts / 1000.0 : 0.0,
+                  (gdouble)latency_max / 1000.0);
+
+        /* Stale frames of the interval: the scaler or the encoder could not keep up */
+        for (stage = 0; stage < CAPTURE_STAGE_COUNTS; stage++)
+        {
+            stale[stage] = (gsize)g_atomic_pointer_get(&branch->stale_counts[stage]) - branch->stale_logged[stage];
+            branch->stale_logged[stage] += stale[stage];
+        }
+
+        if ((stale[CAPTURE_STAGE_SCALE] > 0) || (stale[CAPTURE_STAGE_ENCODE] > 0))
+        {
+            g_message("Info: Stale frames of %s '%s' (%s): %" G_GSIZE_FORMAT " dropped before scaling, %"
+                      G_GSIZE_FORMAT " before encoding", camera_get_type_str(capture->camera),
+                      camera_get_id(capture->camera), capture_tier_names[tier],
+                      stale[CAPTURE_STAGE_SCALE], stale[CAPTURE_STAGE_ENCODE]);
+        }
+
+        /* Sessions of the tier, so that a degraded client stands out */
+        g_mutex_lock(&capture->lock);
+
+        for (index = 0; index < branch->consumers->len; index++)
+        {
+            consumer = g_ptr_array_index(branch->consumers, index);
+            client = server_get_media_client(consumer->media);
+
+            g_message("Info: Session of %s (%s): queue %.1f KB (max %.1f KB), %" G_GSIZE_FORMAT
+                      " access units sent, %" G_GSIZE_FORMAT " dropped, %" G_GSIZE_FORMAT " overflows",
+                      consumer->mount, (client != NULL) ? client : "shared",
+                      gst_app_src_get_current_level_bytes(GST_APP_SRC(consumer->appsrc)) / 1024.0,
+                      consumer->max_level / 1024.0, consumer->pushed_counts,
+                      consumer->dropped_counts, consumer->overflow_counts);
+
+            g_free(client);
+        }
+
+        g_mutex_unlock(&capture->lock);
+    }
+
+    return G_SOURCE_CONTINUE;
+}
+
+void capture_add_consumer(struct capture_consumer_t *consumer)
+{
+    struct capture_branch_t *branch = consumer->branch;
+    struct capture_t *capture = branch->capture;
+
+    GList *item = NULL;
+
+    g_mutex_lock(&capture->state_lock);
+
+    g_mutex_lock(&capture->lock);
+
+    /* Give the latest caps to the media. Later changes are forwarded by "capture_on_new_sample" */
+    if ((branch->caps != NULL) && (capture->replay == NULL))
+    {
+        gst_app_src_set_caps(GST_APP_SRC(consumer->appsrc), branch->caps);
+    }
+
+    /* Start from the cached GOP so that the first picture can be decoded immediately.
+     * Other consumers of the branch are not affected (no keyframe is forced) */
+    for (item = branch->gop.head; item != NULL; item = item->next)
+    {
+        g_queue_push_tail(&consumer->backlog, gst_buffer_ref(GST_BUFFER(item->data)));
+    }
+
+    if ((!g_queue_is_empty(&consumer->backlog)) && (capture->burst_source_id == 0))
+    {
+        capture->burst_source_id = g_timeout_add(CAPTURE_BURST_INTERVAL, capture_on_burst, capture);
+    }
+
+    g_mutex_lock(&capture->clients_lock);
+    g_ptr_array_add(branch->consumers, consumer);
+    g_mutex_unlock(&capture->clients_lock);
+
+    capture->consumer_counts++;
+
+    g_mutex_unlock(&capture->lock);
+
+    /* Start the camera pipeline for the first consumer */
+    consumer->warm = capture_update_state(capture);
+
+    g_mutex_unlock(&capture->state_lock);
+}
+
+void capture_remove_consumer(struct capture_consumer_t *consumer)
+{
+    struct capture_branch_t *branch = consumer->branch;
+    struct capture_t *capture = branch->capture;
+
+    g_mutex_lock(&capture->state_lock);
+
+    g_mutex_lock(&capture->lock);
+
+    g_mutex_lock(&capture->clients_lock);
+
+    if (g_ptr_array_remove(branch->consumers, consumer))
+    {
+        capture->consumer_counts--;
+    }
+
+    g_mutex_unlock(&capture->clients_lock);
+
+    /* Drop access units the consumer has not received */
+    capture_clear_units(&consumer->backlog);
+
+    g_mutex_unlock(&capture->lock);
+
+    /* Stop the camera pipeline after the last consumer (unless it is kept warm) */
+    capture_update_state(capture);
+
+    g_mutex_unlock(&capture->state_lock);
+}
+
+/* ---------- Public functions ---------- */
+
+struct capture_t *capture_create(const struct camera_t *camera, const gchar *pipeline)
+{
+    struct capture_t *capture = NULL;
+    struct capture_branch_t *branch = NULL;
+
+    GstBus *bus = NULL;
+    GstElement *appsrc = NULL;
+    GstElement *queue = NULL;
+    GError *error = NULL;
+
+    gchar *name = NULL;
+    gint tier = 0;
+    gint stage = 0;
+
+    GstAppSinkCallbacks callbacks =
+    {
+        .eos = capture_on_eos,
+        .new_preroll = NULL,
+        .new_sample = capture_on_new_sample
+    };
+
+    /* Check parameter(s) */
+    g_return_val_if_fail((camera != NULL) && (pipeline != NULL), NULL);
+
+    capture = g_new0(struct capture_t, 1);
+    capture->camera = camera;
+    capture->overflow = CAPTURE_OVERFLOW_SKIP_TO_IDR;
+    capture->session_queue = CAPTURE_DEFAULT_SESSION_QUEUE;
+    capture->pace_spread = 0;
+    capture->pace_batch = 0;
+
+    g_mutex_init(&capture->lock);
+    g_mutex_init(&capture->clients_lock);
+    g_mutex_init(&capture->state_lock);
+
+    /* Create camera pipeline */
+    capture->pipeline = gst_parse_launch(pipeline, &error);
+    if (capture->pipeline == NULL)
+    {
+        g_message("Error: Failed to create pipeline of %s '%s': %s", camera_get_type_str(camera),
+                  camera_get_id(camera), (error != NULL) ? error->message : "unknown error");
+
+        g_clear_error(&error);
+        capture_free(capture);
+
+        return NULL;
+    }
+
+    /* Note: "gst_parse_launch" may return a pipeline with a (non-fatal) error */
+    g_clear_error(&error);
+
+    /* Look for "appsink" elements, one per tier */
+    for (tier = 0; tier < CAPTURE_TIER_COUNTS; tier++)
+    {
+        branch = &capture->branches[tier];
+
+        branch->capture = capture;
+        branch->consumers = g_ptr_array_new();
+        g_queue_init(&branch->gop);
+        branch->appsink = gst_bin_get_by_name(GST_BIN(capture->pipeline), capture_tier_names[tier]);
+
+        if (branch->appsink != NULL)
+        {
+            gst_app_sink_set_callbacks(GST_APP_SINK(branch->appsink), &callbacks, branch, NULL);
+        }
+
+        /* Look for the encoder of the branch (fake cameras have none) */
+        name = g_strdup_printf(GST_ENCODER_NAME_FMT, capture_tier_names[tier]);
+        branch->encoder = gst_bin_get_by_name(GST_BIN(capture->pipeline), name);
+        g_free(name);
+
+        /* Count stale frames dropped in front of each stage (passthrough pipelines have none) */
+        for (stage = 0; stage < CAPTURE_STAGE_COUNTS; stage++)
+        {
+            name = g_strdup_printf(GST_QUEUE_NAME_FMT, capture_tier_names[tier], capture_stage_names[stage]);
+            queue = gst_bin_get_by_name(GST_BIN(capture->pipeline), name);
+            g_free(name);
+
+            if (queue != NULL)
+            {
+                g_signal_connect(queue, "overrun", G_CALLBACK(capture_on_overrun), &branch->stale_counts[stage]);
+                gst_object_unref(queue);
+            }
+        }
+    }
+
+    if (capture->branches[CAPTURE_TIER_MAIN].appsink == NULL)
+    {
+        g_critical("Error: Pipeline has no '%s' element", GST_MAIN_STREAM_NAME);
+
+        capture_free(capture);
+        return NULL;
+    }
+
+    /* Fake cameras: index the clip once, then loop it from memory */
+    appsrc = gst_bin_get_by_name(GST_BIN(capture->pipeline), GST_CLIP_SOURCE_NAME);
+    if (appsrc != NULL)
+    {
+        capture->clip = clip_create(camera_get_id(camera), &error);
+        if (capture->clip != NULL)
+        {
+            clip_attach(capture->clip, appsrc);
+        }
+
+        gst_object_unref(appsrc);
+    }
+
+    if ((appsrc != NULL) && (capture->clip == NULL))
+    {
+        g_message("Error: Cannot play %s '%s': %s", camera_get_type_str(camera),
+                  camera_get_id(camera), error->message);
+
+        g_clear_error(&error);
+        capture_free(capture);
+
+        return NULL;
+    }
+
+    /* Print errors of the pipeline */
+    bus = gst_element_get_bus(capture->pipeline);
+    capture->bus_watch_id = gst_bus_add_watch(bus, capture_on_bus_message, capture);
+    gst_object_unref(bus);
+
+    return capture;
+}
+
+GstRTSPMediaFactory *capture_create_factory(struct capture_t *capture,
+                                            const enum capture_tier_t tier)
+{
+    GstRTSPMediaFactory *factory = NULL;
+    struct capture_branch_t *branch = NULL;
+    gchar *launch = NULL;
+
+    /* Check parameter(s) */
+    g_return_val_if_fail((capture != NULL) && (tier < CAPTURE_TIER_COUNTS), NULL);
+
+    /* Fall back to the main stream if the pipeline has no such tier */
+    branch = capture_has_tier(capture, tier) ? &capture->branches[tier]
+                                             : &capture->branches[CAPTURE_TIER_MAIN];
+
+    /* Create a new GstRTSPMediaFactory instance */
+    factory = gst_rtsp_media_factory_new();
+
+    /* Create an RTP feed from "appsrc" (packetized by "rtph264pay", or by the RTP cache) */
+    if (capture->pace_batch == 0)
+    {
+        gst_rtsp_media_factory_set_launch(factory, (capture->replay != NULL) ? RTSP_REPLAY_PIPELINE_STR
+                                                                             : RTSP_PIPELINE_STR);
+    }
+    else
+    {
+        launch = g_strdup_printf((capture->replay != NULL) ? RTSP_PACED_REPLAY_PIPELINE_FMT_STR
+                                                           : RTSP_PACED_PIPELINE_FMT_STR,
+                                 capture->pace_spread, capture->pace_batch);
+
+        gst_rtsp_media_factory_set_launch(factory, launch);
+        g_free(launch);
+    }
+
+    /* One media per client: a slow client only fills the queue of its own media. The
+     * camera pipeline still encodes once, access units are shared by all media */
+    gst_rtsp_media_factory_set_shared(factory, FALSE);
+
+    /* Connect new media to the branch */
+    g_signal_connect(factory, "media-configure", G_CALLBACK(capture_on_media_configure), branch);
+
+    /* Mount point of metrics (the factory of a missing tier belongs to the main stream) */
+    if (branch == &capture->branches[tier])
+    {
+        branch->factory = factory;
+    }
+
+    return factory;
+}
+
+void capture_enable_abr(struct capture_t *capture, const enum abr_policy_t policy,
+                        const guint min_bitrate, const guint max_bitrate)
+{
+    struct capture_branch_t *branch = NULL;
+    gchar *name = NULL;
+    gint tier = 0;
+
+    /* Check parameter(s) */
+    g_return_if_fail(capture != NULL);
+
+    for (tier = 0; tier < CAPTURE_TIER_COUNTS; tier++)
+    {
+        branch = &capture->branches[tier];
+        if ((branch->encoder == NULL) || (branch->abr != NULL))
+        {
+            continue;
+        }
+
+        name = g_strdup_printf("%s '%s' (%s)", camera_get_type_str(capture->camera),
+                               camera_get_id(capture->camera), capture_tier_names[tier]);
+
+        /* The substream keeps the same ratio to its nominal bitrate as the main stream */
+        if (tier == CAPTURE_TIER_MAIN)
+        {
+            branch->abr = abr_create(name, branch->encoder, policy, min_bitrate, max_bitrate);
+        }
+        else
+        {
+            branch->abr = abr_create(name, branch->encoder, policy,
+                                     (guint)((guint64)min_bitrate * SUB_STREAM_BITRATE / MAIN_STREAM_BITRATE),
+                                     (guint)((guint64)max_bitrate * SUB_STREAM_BITRATE / MAIN_STREAM_BITRATE));
+        }
+
+        g_free(name);
+    }
+
+    /* Without policy, bitrates are only changed by "capture_set_bitrate_budget" */
+    if ((policy != ABR_POLICY_OFF) && (capture->abr_source_id == 0))
+    {
+        capture->abr_source_id = g_timeout_add(ABR_UPDATE_INTERVAL, capture_on_abr, capture);
+    }
+}
+
+void capture_enable_stamp(struct capture_t *capture)
+{
+    /* Check parameter(s) */
+    g_return_if_fail(capture != NULL);
+
+    capture->stamp_enabled = TRUE;
+}
+
+void capture_enable_profile(struct capture_t *capture, struct profile_t *profile)
+{
+    gchar *name = NULL;
+
+    /* Check parameter(s) */
+    g_return_if_fail((capture != NULL) && (profile != NULL));
+
+    if (capture->profile == NULL)
+    {
+        capture->profile = profile;
+
+        name = g_strdup_printf("%s '%s'", camera_get_type_str(capture->camera),
+                               camera_get_id(capture->camera));
+        profile_attach(profile, capture->pipeline, name);
+        g_free(name);
+    }
+}
+
+void capture_enable_stats(struct capture_t *capture, const guint interval)
+{
+    /* Check parameter(s) */
+    g_return_if_fail((capture != NULL) && (interval > 0));
+
+    if (capture->stats_source_id == 0)
+    {
+        capture->stats_time = g_get_monotonic_time();
+        capture->stats_source_id = g_timeout_add_seconds(interval, capture_on_stats, capture);
+    }
+}
+
+gboolean capture_enable_replay(struct capture_t *capture)
+{
+    GError *error = NULL;
+
+    /* Check parameter(s) */
+    g_return_val_if_fail(capture != NULL, FALSE);
+
+    /* Only clips are the same on every loop */
+    if ((capture->clip == NULL) || (capture->replay != NULL))
+    {
+        return (capture->replay != NULL);
+    }
+
+    capture->replay = replay_create(capture->clip, &error);
+    if (capture->replay == NULL)
+    {
+        g_message("Warning: No RTP cache for %s '%s' (%s), it is packetized by rtph264pay",
+                  camera_get_type_str(capture->camera), camera_get_id(capture->camera),
+                  error->message);
+
+        g_clear_error(&error);
+    }
+
+    return (capture->replay != NULL);
+}
+
+void capture_set_bitrate_budget(struct capture_t *capture, const guint bitrate)
+{
+    /* Check parameter(s) */
+    g_return_if_fail(capture != NULL);
+
+    /* Split the budget between tiers in proportion to their nominal bitrates */
+    if (capture->branches[CAPTURE_TIER_MAIN].abr != NULL)
+    {
+        abr_split_budget(capture->branches[CAPTURE_TIER_MAIN].abr, capture->branches[CAPTURE_TIER_SUB].abr,
+                         bitrate, MAIN_STREAM_BITRATE, SUB_STREAM_BITRATE);
+    }
+}
+
+guint capture_get_bitrate(const struct capture_t *capture)
+{
+    guint bitrate = 0;
+    gint tier = 0;
+
+    /* Check parameter(s) */
+    g_return_val_if_fail(capture != NULL, 0);
+
+    for (tier = 0; tier < CAPTURE_TIER_COUNTS; tier++)
+    {
+        if (capture->branches[tier].abr != NULL)
+        {
+            bitrate += abr_get_bitrate(capture->branches[tier].abr);
+        }
+    }
+
+    return bitrate;
+}
+
+guint capture_get_min_bitrate(const struct capture_t *capture)
+{
+    guint bitrate = 0;
+    gint tier = 0;
+
+    /* Check parameter(s) */
+    g_return_val_if_fail(capture != NULL, 0);
+
+    for (tier = 0; tier < CAPTURE_TIER_COUNTS; tier++)
+    {
+        if (capture->branches[tier].abr != NULL)
+        {
+            bitrate += abr_get_min_bitrate(capture->branches[tier].abr);
+        }
+    }
+
+    return bitrate;
+}
+
+const struct camera_t *capture_get_camera(const struct capture_t *capture)
+{
+    /* Check parameter(s) */
+    g_return_val_if_fail(capture != NULL, NULL);
+
+    return capture->camera;
+}
+
+void capture_set_keep_warm(struct capture_t *capture, const gboolean enabled)
+{
+    /* Check parameter(s) */
+    g_return_if_fail(capture != NULL);
+
+    g_mutex_lock(&capture->state_lock);
+
+    g_mutex_lock(&capture->lock);
+    capture->keep_warm = enabled;
+    g_mutex_unlock(&capture->lock);
+
+    capture_update_state(capture);
+
+    g_mutex_unlock(&capture->state_lock);
+}
+
+void capture_set_session_queue(struct capture_t *capture, const enum capture_overflow_t policy,
+                               const gsize size)
+{
+    /* Check parameter(s) */
+    g_return_if_fail((capture != NULL) && (policy < CAPTURE_OVERFLOW_UNKNOWN) && (size > 0));
+
+    g_mutex_lock(&capture->lock);
+    capture->overflow = policy;
+    capture->session_queue = size;
+    g_mutex_unlock(&capture->lock);
+}
+
+void capture_set_pacing(struct capture_t *capture, const guint spread, const guint batch)
+{
+    /* Check parameter(s) */
+    g_return_if_fail((capture != NULL) && (spread <= 100) && (batch <= RTPPACE_MAX_BATCH));
+
+    capture->pace_spread = spread;
+    capture->pace_batch = batch;
+}
+
+gboolean capture_get_counters(struct capture_t *capture, const enum capture_tier_t tier,
+                              struct capture_counters_t *counters)
+{
+    struct capture_branch_t *branch = NULL;
+    guint index = 0;
+
+    /* Check parameter(s) */
+    g_return_val_if_fail((capture != NULL) && (tier < CAPTURE_TIER_COUNTS) && (counters != NULL), FALSE);
+
+    if (!capture_has_tier(capture, tier))
+    {
+        return FALSE;
+    }
+
+    branch = &capture->branches[tier];
+
+    counters->unit_counts = (gsize)g_atomic_pointer_get(&branch->unit_counts);
+    counters->keyframe_counts = (gsize)g_atomic_pointer_get(&branch->keyframe_counts);
+    counters->unit_bytes = (gsize)g_atomic_pointer_get(&branch->unit_bytes);
+    counters->keyframe_interval = g_atomic_int_get(&branch->keyframe_interval);
+    counters->rtp_bytes = (gsize)g_atomic_pointer_get(&branch->rtp_bytes);
+    counters->dropped_counts = (gsize)g_atomic_pointer_get(&branch->dropped_counts);
+    counters->encoder_errors = (gsize)g_atomic_pointer_get(&branch->encoder_errors);
+    counters->vsp_errors = (gsize)g_atomic_pointer_get(&capture->vsp_errors);
+    counters->other_errors = (gsize)g_atomic_pointer_get(&capture->other_errors);
+
+    for (index = 0; index < CAPTURE_UNIT_SIZE_BUCKETS; index++)
+    {
+        counters->unit_sizes[index] = (gsize)g_atomic_pointer_get(&branch->unit_sizes[index]);
+    }
+
+    for (index = 0; index < CAPTURE_STAGE_COUNTS; index++)
+    {
+        counters->stale_counts[index] = (gsize)g_atomic_pointer_get(&branch->stale_counts[index]);
+    }
+
+    return TRUE;
+}
+
+const gchar *capture_get_mount(const struct capture_t *capture, const enum capture_tier_t tier)
+{
+    /* Check parameter(s) */
+    g_return_val_if_fail((capture != NULL) && (tier < CAPTURE_TIER_COUNTS), NULL);
+
+    if (capture->branches[tier].factory == NULL)
+    {
+        return NULL;
+    }
+
+    return g_object_get_data(G_OBJECT(capture->branches[tier].factory), SERVER_MOUNT_PATH_KEY);
+}
+
+gint capture_count_clients(struct capture_t *capture, const enum capture_tier_t tier,
+                           GHashTable *sessions)
+{
+    struct capture_branch_t *branch = NULL;
+    struct capture_consumer_t *consumer = NULL;
+    gint clients = 0;
+    guint index = 0;
+
+    /* Check parameter(s) */
+    g_return_val_if_fail((capture != NULL) && (tier < CAPTURE_TIER_COUNTS) && (sessions != NULL), 0);
+
+    branch = &capture->branches[tier];
+
+    /* Not "lock": streaming threads do not wait for metrics */
+    g_mutex_lock(&capture->clients_lock);
+
+    for (index = 0; (branch->consumers != NULL) && (index < branch->consumers->len); index++)
+    {
+        consumer = g_ptr_array_index(branch->consumers, index);
+        clients += GPOINTER_TO_INT(g_hash_table_lookup(sessions, consumer->media));
+    }
+
+    g_mutex_unlock(&capture->clients_lock);
+
+    return clients;
+}
+
+gboolean capture_has_tier(const struct capture_t *capture, const enum capture_tier_t tier)
+{
+    /* Check parameter(s) */
+    g_return_val_if_fail((capture != NULL) && (tier < CAPTURE_TIER_COUNTS), FALSE);
+
+    return (capture->branches[tier].appsink != NULL);
+}
+
+void capture_free(struct capture_t *capture)
+{
+    struct capture_branch_t *branch = NULL;
+    gint tier = 0;
+
+    /* Check parameter(s) */
+    g_return_if_fail(capture != NULL);
+
+    if (capture->bus_watch_id != 0)
+    {
+        g_source_remove(capture->bus_watch_id);
+    }
+
+    if (capture->burst_source_id != 0)
+    {
+        g_source_remove(capture->burst_source_id);
+    }
+
+    if (capture->abr_source_id != 0)
+    {
+        g_source_remove(capture->abr_source_id);
+    }
+
+    if (capture->stats_source_id != 0)
+    {
+        g_source_remove(capture->stats_source_id);
+    }
+
+    if (capture->pipeline != NULL)
+    {
+        gst_element_set_state(capture->pipeline, GST_STATE_NULL);
+    }
+
+    for (tier = 0; tier < CAPTURE_TIER_COUNTS; tier++)
+    {
+        branch = &capture->branches[tier];
+
+        if (branch->appsink != NULL)
+        {
+            gst_object_unref(branch->appsink);
+        }
+
+        if (branch->abr != NULL)
+        {
+            abr_free(branch->abr);
+        }
+
+        if (branch->encoder != NULL)
+        {
+            gst_object_unref(branch->encoder);
+        }
+
+        if (branch->consumers != NULL)
+        {
+            g_ptr_array_free(branch->consumers, TRUE);
+        }
+
+        gst_caps_replace(&branch->caps, NULL);
+        capture_clear_units(&branch->gop);
+    }
+
+    if (capture->pipeline != NULL)
+    {
+        gst_object_unref(capture->pipeline);
+    }
+
+    /* Pushed packets keep the arena of the cache */
+    if (capture->replay != NULL)
+    {
+        replay_free(capture->replay);
+    }
+
+    /* After the pipeline: "appsrc" calls back the clip until it is stopped */
+    if (capture->clip != NULL)
+    {
+        clip_free(capture->clip);
+    }
+
+    g_mutex_clear(&capture->lock);
+    g_mutex_clear(&capture->clients_lock);
+    g_mutex_clear(&capture->state_lock);
+
+    g_free(capture);
+}
+
+const gchar* capture_overflow_to_string(const enum capture_overflow_t policy)
+{
+    const gchar* result = "";
+
+    switch (policy)
+    {
+        case CAPTURE_OVERFLOW_DROP_NON_REFERENCE:
+            result = "drop-non-reference";
+        break;
+
+        case CAPTURE_OVERFLOW_SKIP_TO_IDR:
+            result = "skip-to-idr";
+        break;
+
+        case CAPTURE_OVERFLOW_DISCONNECT:
+            result = "disconnect";
+        break;
+
+        default:
+            result = "unknown";
+        break;
+    }
+
+    return result;
+}
+
+enum capture_overflow_t capture_overflow_from_string(const gchar *str)
+{
+    enum capture_overflow_t policy = CAPTURE_OVERFLOW_UNKNOWN;
+
+    /* Check parameter(s) */
+    g_return_val_if_fail(str != NULL, CAPTURE_OVERFLOW_UNKNOWN);
+
+    if (g_ascii_strcasecmp(str, "drop-non-reference") == 0)
+    {
+        policy = CAPTURE_OVERFLOW_DROP_NON_REFERENCE;
+    }
+    else if (g_ascii_strcasecmp(str, "skip-to-idr") == 0)
+    {
+        policy = CAPTURE_OVERFLOW_SKIP_TO_IDR;
+    }
+    else if (g_ascii_strcasecmp(str, "disconnect") == 0)
+    {
+        policy = CAPTURE_OVERFLOW_DISCONNECT;
+    }
+
+    return policy;
+}
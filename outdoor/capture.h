@@ -0,0 +1,452 @@
+/***********************************************************************
+ * FILENAME: capture.h
+ *
+ * DESCRIPTION:
+ *   Contains APIs to run camera pipelines and feed RTSP media from them.
+ *
+ *   A camera pipeline ("my_gst.h") captures and encodes frames once.
+ *   Encoded access units of each stream tier (main stream, substream) are
+ *   pushed to the "appsrc" element of every RTSP media created from
+ *   that tier's factory.
+ *
+ *   The latest GOP of each tier is cached. A new RTSP media receives it
+ *   first (in paced bursts), so it does not wait for the next keyframe.
+ *
+ *   Every unicast client has its own media. Access units queued in its "appsrc"
+ *   are bounded: when a slow client lets its queue fill up, access units of this
+ *   client only are dropped (or the client is disconnected), so the camera
+ *   pipeline and the other clients never wait for its network.
+ *
+ * PUBLIC FUNCTIONS:
+ *   struct capture_t *capture_create(const struct camera_t *camera, const gchar *pipeline);
+ *
+ *   GstRTSPMediaFactory *capture_create_factory(struct capture_t *capture,
+ *                                               const enum capture_tier_t tier);
+ *
+ *   void capture_enable_abr(struct capture_t *capture, const enum abr_policy_t policy,
+ *                           const guint min_bitrate, const guint max_bitrate);
+ *
+ *   gboolean capture_enable_replay(struct capture_t *capture);
+ *
+ *   void capture_enable_stats(struct capture_t *capture, const guint interval);
+ *
+ *   void capture_enable_profile(struct capture_t *capture, struct profile_t *profile);
+ *
+ *   void capture_enable_stamp(struct capture_t *capture);
+ *
+ *   void capture_set_bitrate_budget(struct capture_t *capture, const guint bitrate);
+ *
+ *   guint capture_get_bitrate(const struct capture_t *capture);
+ *
+ *   guint capture_get_min_bitrate(const struct capture_t *capture);
+ *
+ *   const struct camera_t *capture_get_camera(const struct capture_t *capture);
+ *
+ *   void capture_set_keep_warm(struct capture_t *capture, const gboolean enabled);
+ *
+ *   void capture_set_session_queue(struct capture_t *capture, const enum capture_overflow_t policy,
+ *                                  const gsize size);
+ *
+ *   void capture_set_pacing(struct capture_t *capture, const guint spread, const guint batch);
+ *
+ *   gboolean capture_get_counters(struct capture_t *capture, const enum capture_tier_t tier,
+ *                                 struct capture_counters_t *counters);
+ *
+ *   const gchar *capture_get_mount(const struct capture_t *capture, const enum capture_tier_t tier);
+ *
+ *   gint capture_count_clients(struct capture_t *capture, const enum capture_tier_t tier,
+ *                              GHashTable *sessions);
+ *
+ *   gboolean capture_has_tier(const struct capture_t *capture, const enum capture_tier_t tier);
+ *
+ *   void capture_free(struct capture_t *capture);
+ *
+ *   const gchar* capture_overflow_to_string(const enum capture_overflow_t policy);
+ *
+ *   enum capture_overflow_t capture_overflow_from_string(const gchar *str);
+ *
+ * AUTHOR: RVC       START DATE: 16/10/2026
+ *
+ * CHANGES:
+ *
+ ***********************************************************************/
+
+#ifndef _CAPTURE_H_
+#define _CAPTURE_H_
+
+/* ---------- Macros ---------- */
+
+/* Upper bounds (bytes) of access unit size buckets, the last bucket has no bound */
+#define CAPTURE_UNIT_SIZE_BOUNDS { 1024, 4096, 16384, 65536, 262144, 1048576 }
+#define CAPTURE_UNIT_SIZE_BUCKETS 7
+
+/* Access units queued for an RTSP session before it is a slow client (bytes) */
+#define CAPTURE_DEFAULT_SESSION_QUEUE (1024 * 1024)
+
+/* ---------- Datatypes ---------- */
+
+/*
+ * Enum: capture_tier_t
+ * ---
+ *   Represents stream tiers of a camera:
+ *     - CAPTURE_TIER_MAIN: Full resolution stream.
+ *     - CAPTURE_TIER_SUB: Low resolution/low bitrate stream.
+ *     - CAPTURE_TIER_COUNTS: The number of tiers.
+ */
+enum capture_tier_t
+{
+    CAPTURE_TIER_MAIN,
+    CAPTURE_TIER_SUB,
+    CAPTURE_TIER_COUNTS
+};
+
+/*
+ * Enum: capture_stage_t
+ * ---
+ *   Represents stages of an encoding branch, behind their leaky queue (see GST_LEAKY_QUEUE_FMT_STR):
+ *     - CAPTURE_STAGE_SCALE: Scaler.
+ *     - CAPTURE_STAGE_ENCODE: Encoder.
+ *     - CAPTURE_STAGE_COUNTS: The number of stages.
+ */
+enum capture_stage_t
+{
+    CAPTURE_STAGE_SCALE,
+    CAPTURE_STAGE_ENCODE,
+    CAPTURE_STAGE_COUNTS
+};
+
+/*
+ * Enum: capture_overflow_t
+ * ---
+ *   Represents what happens to a slow client, whose session queue is full:
+ *     - CAPTURE_OVERFLOW_DROP_NON_REFERENCE: Drop access units which no other frame
+ *       refers to (nal_ref_idc is 0). A reference frame is handled as CAPTURE_OVERFLOW_SKIP_TO_IDR.
+ *     - CAPTURE_OVERFLOW_SKIP_TO_IDR: Drop access units until the next keyframe.
+ *     - CAPTURE_OVERFLOW_DISCONNECT: Drop access units and close the connection of the client.
+ *     - CAPTURE_OVERFLOW_UNKNOWN: Indicate that the policy is invalid.
+ */
+enum capture_overflow_t
+{
+    CAPTURE_OVERFLOW_DROP_NON_REFERENCE,
+    CAPTURE_OVERFLOW_SKIP_TO_IDR,
+    CAPTURE_OVERFLOW_DISCONNECT,
+    CAPTURE_OVERFLOW_UNKNOWN
+};
+
+/*
+ * Struct: capture_t
+ * ---
+ *   Represents a running camera pipeline:
+ *     - camera (struct camera_t): The camera.
+ *     - pipeline (GstElement): Camera pipeline.
+ *     - branches (array of "capture_branch_t"): One "appsink" and its consumers per tier.
+ *     - consumer_counts (gint): The number of RTSP media fed by the pipeline.
+ *       The pipeline only runs while it has consumers (or is kept warm).
+ *     - keep_warm (gboolean): Keep the pipeline running without consumers.
+ *     - running (gboolean): Set while the pipeline is in PLAYING state.
+ *     - start_time (gint64): When the pipeline was started (used to log its first frame).
+ *     - clip (struct clip_t): Clip looped by the pipeline of a fake camera (see "clip.h").
+ *     - replay (struct replay_t): RTP packets of the clip (see "replay.h"), NULL if disabled.
+ *     - overflow (enum capture_overflow_t), session_queue (gsize): Policy and size (bytes)
+ *       of session queues.
+ *     - pace_spread, pace_batch (guint): Pacing of media ("capture_set_pacing()"),
+ *       "pace_batch" is 0 if disabled.
+ */
+struct capture_t;
+
+/*
+ * Struct: capture_counters_t
+ * ---
+ *   Represents counters of a stream tier since the pipeline was created:
+ *     - unit_counts, keyframe_counts (gsize): The number of encoded access units and keyframes.
+ *     - unit_bytes (gsize): Size of encoded access units (bytes).
+ *     - unit_sizes (array of gsize): The number of access units per size bucket
+ *       (see CAPTURE_UNIT_SIZE_BOUNDS).
+ *     - keyframe_interval (gint): The number of access units between the latest two keyframes.
+ *     - rtp_bytes (gsize): Size of RTP packets sent to clients (bytes, RTP headers included).
+ *     - dropped_counts (gsize): Access units not pushed to a media (waiting for a keyframe,
+ *       refused by the media, dropped for a slow client).
+ *     - stale_counts (array of gsize): Stale frames dropped by the leaky queue in front of
+ *       each stage ("enum capture_stage_t"), because the stage was late.
+ *     - encoder_errors (gsize): Errors of the encoder of the tier.
+ *     - vsp_errors, other_errors (gsize): Errors of VSP elements and of other elements
+ *       of the pipeline (shared by tiers).
+ *
+ *   Counters are updated by streaming threads without lock (atomic operations).
+ */
+struct capture_counters_t
+{
+    gsize unit_counts;
+    gsize keyframe_counts;
+    gsize unit_bytes;
+    gsize unit_sizes[CAPTURE_UNIT_SIZE_BUCKETS];
+    gint keyframe_interval;
+    gsize rtp_bytes;
+    gsize dropped_counts;
+    gsize stale_counts[CAPTURE_STAGE_COUNTS];
+    gsize encoder_errors;
+    gsize vsp_errors;
+    gsize other_errors;
+};
+
+/* ---------- Functions ---------- */
+
+/*
+ * Function: capture_create
+ * ---
+ *   Creates "capture_t" object from camera pipeline "pipeline" (see "gst_get_camera_pipeline").
+ *
+ *   camera: Reference to "camera_t" object.
+ *   pipeline: Camera pipeline.
+ *
+ *   return: NULL (unable to create the pipeline).
+ *           not NULL (successfully create "capture_t" object).
+ *
+ *   Note: Should use "capture_free()" to deallocate if it is not used anymore.
+ */
+struct capture_t *capture_create(const struct camera_t *camera, const gchar *pipeline);
+
+/*
+ * Function: capture_create_factory
+ * ---
+ *   Creates a "GstRTSPMediaFactory" whose media are fed from "tier", one media per
+ *   client (multicast mount points share theirs, see "server_add_multicast()").
+ *   If the camera pipeline has no "tier" branch, media are fed from the main stream.
+ *
+ *   capture: Reference to "capture_t" object.
+ *   tier: Stream tier.
+ *
+ *   return: Pointer to "GstRTSPMediaFactory" (full reference).
+ */
+GstRTSPMediaFactory *capture_create_factory(struct capture_t *capture,
+                                            const enum capture_tier_t tier);
+
+/*
+ * Function: capture_enable_abr
+ * ---
+ *   Adjusts the bitrate of every encoder of the camera pipeline to the RTCP receiver
+ *   reports of its clients (see "abr.h"). Clients of a tier share one encoder,
+ *   "policy" decides which of them the bitrate follows.
+ *
+ *   capture: Reference to "capture_t" object.
+ *   policy: Adaptive bitrate policy. With ABR_POLICY_OFF, bitrates do not follow
+ *           clients but can still be changed by "capture_set_bitrate_budget".
+ *   min_bitrate, max_bitrate: Floor and ceiling of the main stream (bps). The substream
+ *                             uses the same range scaled to its nominal bitrate.
+ *
+ *   return: void.
+ */
+void capture_enable_abr(struct capture_t *capture, const enum abr_policy_t policy,
+                        const guint min_bitrate, const guint max_bitrate);
+
+/*
+ * Function: capture_enable_replay
+ * ---
+ *   Feeds the RTSP media of a fake camera from the RTP packet cache of its clip
+ *   (see "replay.h") instead of packetizing the clip with "rtph264pay" on every loop.
+ *
+ *   Note: Must be called before "capture_create_factory".
+ *
+ *   return: TRUE (the RTP cache is used).
+ *           FALSE (not a fake camera, or the clip cannot be cached).
+ */
+gboolean capture_enable_replay(struct capture_t *capture);
+
+/*
+ * Function: capture_enable_stats
+ * ---
+ *   Logs the frame rate of every stream tier of the camera and the latency of its access
+ *   units (from capture to the end of the branch: scaling and encoding) every "interval"
+ *   seconds, while the pipeline runs.
+ *
+ *   Note: Latencies are only meaningful for live sources (cameras, synthetic cameras).
+ *
+ *   return: void.
+ */
+void capture_enable_stats(struct capture_t *capture, const guint interval);
+
+/*
+ * Function: capture_enable_profile
+ * ---
+ *   Attaches the camera pipeline to "profile" (see "profile.h"), and the RTSP media
+ *   of every client of its streams as soon as they are configured.
+ *
+ *   Note: "profile" must be freed after "capture".
+ *
+ *   return: void.
+ */
+void capture_enable_profile(struct capture_t *capture, struct profile_t *profile);
+
+/*
+ * Function: capture_enable_stamp
+ * ---
+ *   Stamps every access unit of the camera with its capture and encode times
+ *   (see "stamp.h"), to measure glass-to-glass latency on the basephone.
+ *
+ *   Note: Media fed by the RTP cache (sample videos) are not stamped.
+ *
+ *   return: void.
+ */
+void capture_enable_stamp(struct capture_t *capture);
+
+/*
+ * Function: capture_set_bitrate_budget
+ * ---
+ *   Sets the bitrate ceiling of the camera (all tiers). The budget is split between
+ *   the main stream and the substream in proportion to their nominal bitrates, without
+ *   going below the floor of a tier (see "abr_split_budget").
+ *
+ *   Note: "capture_enable_abr" must be called first.
+ *
+ *   return: void.
+ */
+void capture_set_bitrate_budget(struct capture_t *capture, const guint bitrate);
+
+/*
+ * Function: capture_get_bitrate
+ * ---
+ *   Get the current target bitrate of the camera (sum of all tiers, bps).
+ *
+ *   return: 0 if the camera has no encoder.
+ */
+guint capture_get_bitrate(const struct capture_t *capture);
+
+/*
+ * Function: capture_get_min_bitrate
+ * ---
+ *   Get the lowest budget of the camera (sum of the floors of all tiers, bps).
+ *
+ *   return: 0 if the camera has no encoder.
+ */
+guint capture_get_min_bitrate(const struct capture_t *capture);
+
+/*
+ * Function: capture_get_camera
+ * ---
+ *   Get the camera of "capture".
+ *
+ *   return: Pointer to "camera_t".
+ */
+const struct camera_t *capture_get_camera(const struct capture_t *capture);
+
+/*
+ * Function: capture_set_keep_warm
+ * ---
+ *   Keeps the camera pipeline running (device opened, encoders initialized) even if
+ *   there is no client. New clients then start from the cached GOP immediately.
+ *
+ *   capture: Reference to "capture_t" object.
+ *   enabled: TRUE to start the pipeline now and keep it running.
+ *            FALSE to stop it after the last client.
+ *
+ *   return: void.
+ */
+void capture_set_keep_warm(struct capture_t *capture, const gboolean enabled);
+
+/*
+ * Function: capture_set_session_queue
+ * ---
+ *   Bounds the access units queued for every RTSP session (CAPTURE_DEFAULT_SESSION_QUEUE
+ *   and CAPTURE_OVERFLOW_SKIP_TO_IDR if not called). A client whose queue is full is
+ *   handled by "policy", the others are not affected.
+ *
+ *   capture: Reference to "capture_t" object.
+ *   policy: What to do with slow clients.
+ *   size: Size of each session queue (bytes).
+ *
+ *   return: void.
+ */
+void capture_set_session_queue(struct capture_t *capture, const enum capture_overflow_t policy,
+                               const gsize size);
+
+/*
+ * Function: capture_set_pacing
+ * ---
+ *   Sends the RTP packets of media through "rtppace" (see "rtppace.h"): in batches of
+ *   "batch" packets, spread over "spread" % of the frame interval. Must be called before
+ *   "capture_create_factory()". Media send one packet per system call if not called.
+ *
+ *   capture: Reference to "capture_t" object.
+ *   spread: Part of the frame interval over which an access unit is sent (%, 0 to send
+ *           its batches back to back).
+ *   batch: Maximum number of packets sent at once (0 to disable batching and pacing).
+ *
+ *   return: void.
+ */
+void capture_set_pacing(struct capture_t *capture, const guint spread, const guint batch);
+
+/*
+ * Function: capture_get_counters
+ * ---
+ *   Get the counters of "tier" (see "capture_counters_t"), without blocking streaming threads.
+ *
+ *   counters: Counters (output).
+ *
+ *   return: TRUE (success).
+ *           FALSE (the pipeline has no such tier).
+ */
+gboolean capture_get_counters(struct capture_t *capture, const enum capture_tier_t tier,
+                              struct capture_counters_t *counters);
+
+/*
+ * Function: capture_get_mount
+ * ---
+ *   Get the mount point path of "tier" (see "capture_create_factory()").
+ *
+ *   return: NULL (the pipeline has no such tier, or its factory is not created yet),
+ *           not NULL (owned by the factory).
+ */
+const gchar *capture_get_mount(const struct capture_t *capture, const enum capture_tier_t tier);
+
+/*
+ * Function: capture_count_clients
+ * ---
+ *   Count RTSP sessions of the media fed from "tier".
+ *
+ *   sessions: The number of sessions of every media (see "server_count_sessions()").
+ *
+ *   return: The number of clients.
+ */
+gint capture_count_clients(struct capture_t *capture, const enum capture_tier_t tier,
+                           GHashTable *sessions);
+
+/*
+ * Function: capture_has_tier
+ * ---
+ *   Check if the camera pipeline has a branch for "tier" or not?
+ *
+ *   return: TRUE (the branch exists).
+ *           FALSE (the branch does not exist).
+ */
+gboolean capture_has_tier(const struct capture_t *capture, const enum capture_tier_t tier);
+
+/*
+ * Function: capture_free
+ * ---
+ *   Stops the camera pipeline and frees "capture_t" object.
+ *
+ *   return: void.
+ */
+void capture_free(struct capture_t *capture);
+
+/*
+ * Function: capture_overflow_to_string
+ * ---
+ *   Convert "enum capture_overflow_t" to string.
+ *
+ *   Note: The output string must not be de-allocated or modified.
+ *
+ *   return: String (policy).
+ */
+const gchar* capture_overflow_to_string(const enum capture_overflow_t policy);
+
+/*
+ * Function: capture_overflow_from_string
+ * ---
+ *   Convert string to "enum capture_overflow_t".
+ *
+ *   return: CAPTURE_OVERFLOW_UNKNOWN if "str" is not a valid policy.
+ */
+enum capture_overflow_t capture_overflow_from_string(const gchar *str);
+
+#endif
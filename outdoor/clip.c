@@ -0,0 +1,918 @@
+/***********************************************************************
+ * FILENAME: clip.c
+ *
+ * DESCRIPTION:
+ *   Looping playback of sample videos (fake cameras).
+ *
+ * NOTE:
+ *   For more further information about datatypes and function usages,
+ *   please refer to "clip.h".
+ *
+ * AUTHOR: RVC       START DATE: 17/10/2026
+ *
+ * CHANGES:
+ *
+ ***********************************************************************/
+
+/* ---------- Header files ---------- */
+
+#include <glib.h>
+#include <glib/gprintf.h>
+#include <string.h>
+#include <errno.h>
+
+#include <gst/gst.h>
+#include <gst/app/gstappsrc.h>
+
+#include "clip.h"
+
+/* ---------- Macros ---------- */
+
+#define CLIP_ERROR g_quark_from_static_string("clip-error")
+
+/* Access units pushed each time "appsrc" needs data */
+#define CLIP_PUSH_UNITS 8
+
+/* Size of box headers (32-bit size and type), and of the 64-bit size which may follow */
+#define CLIP_BOX_HEADER_SIZE 8
+#define CLIP_BOX_LARGE_SIZE 8
+
+/* Size of the fields of "VisualSampleEntry" before its child boxes (such as: "avcC") */
+#define CLIP_VISUAL_SAMPLE_ENTRY_SIZE 78
+
+/* H.264 NAL unit types (ITU-T H.264, table 7-1) */
+#define H264_NAL_SLICE 1
+#define H264_NAL_IDR 5
+#define H264_NAL_SEI 6
+#define H264_NAL_AUD 9
+
+/* ---------- Datatypes ---------- */
+
+/*
+ * Enum: clip_format_t
+ * ---
+ *   Represents the container of a clip:
+ *     - CLIP_FORMAT_MP4: ISO base media file (first H.264 video track), access
+ *       units are in AVC format (length-prefixed NAL units, SPS/PPS in "avcC").
+ *     - CLIP_FORMAT_H264: Raw H.264 (Annex B byte stream, 00 00 01 start codes).
+ */
+enum clip_format_t
+{
+    CLIP_FORMAT_MP4,
+    CLIP_FORMAT_H264,
+    CLIP_FORMAT_UNKNOWN
+};
+
+/*
+ * Struct: clip_unit_t
+ * ---
+ *   Represents an entry of the access unit index:
+ *     - offset (guint64): Position of the access unit in the file.
+ *     - size (guint32): Size of the access unit (bytes).
+ *     - pts, dts (GstClockTime): Timestamps in the first loop.
+ *     - keyframe (gboolean): Set if the access unit can be decoded alone.
+ */
+struct clip_unit_t
+{
+    guint64 offset;
+
+    guint32 size;
+
+    GstClockTime pts;
+
+    GstClockTime dts;
+
+    gboolean keyframe;
+};
+
+/*
+ * Struct: clip_table_t
+ * ---
+ *   Represents a sample table box of MP4 files ("stsz", "stco", "stts"...):
+ *     - entries (guint8): First entry.
+ *     - counts (guint32): The number of entries.
+ *     - version (guint8): Version of the box.
+ */
+struct clip_table_t
+{
+    const guint8 *entries;
+
+    guint32 counts;
+
+    guint8 version;
+};
+
+struct clip_t
+{
+    gchar *path;
+
+    enum clip_format_t format;
+
+    GMappedFile *file;
+
+    GArray *units;
+
+    guint keyframe_counts;
+
+    GstClockTime duration;
+
+    GstCaps *caps;
+
+    GstElement *appsrc;
+
+    guint position;
+
+    guint64 loops;
+};
+
+/* ---------- Private functions ---------- */
+
+/*
+ * Function: clip_find_box
+ * ---
+ *   Find the "index"-th box of "type" (such as: "trak") among the boxes of "data".
+ *
+ *   payload, payload_size: Content of the box, after its header (output).
+ *
+ *   return: TRUE (found), FALSE (not found or truncated).
+ */
+static gboolean clip_find_box(const guint8 *data, const gsize size, const gchar *type,
+                              const guint index, const guint8 **payload, gsize *payload_size);
+
+/*
+ * Function: clip_get_table
+ * ---
+ *   Find sample table box "type" in "stbl" and check that its "entry_size" byte entries fit in it.
+ *
+ *   return: TRUE (found), FALSE (not found or truncated).
+ */
+static gboolean clip_get_table(const guint8 *stbl, const gsize stbl_size, const gchar *type,
+                               const gsize entry_size, struct clip_table_t *table);
+
+/*
+ * Function: clip_parse_mp4
+ * ---
+ *   Build the index of the first H.264 video track of an MP4 file from its sample
+ *   tables: sizes ("stsz"), chunk offsets ("stco"/"co64"), samples per chunk ("stsc"),
+ *   decoding times ("stts"), composition offsets ("ctts") and sync samples ("stss").
+ *
+ *   return: TRUE (success), FALSE ("error" is set).
+ */
+static gboolean clip_parse_mp4(struct clip_t *clip, GError **error);
+
+/*
+ * Function: clip_parse_track
+ * ---
+ *   Same as "clip_parse_mp4()" for track "trak".
+ *
+ *   return: TRUE (success), FALSE (not an H.264 video track, or "error" is set).
+ */
+static gboolean clip_parse_track(struct clip_t *clip, const guint8 *trak, const gsize trak_size,
+                                 GError **error);
+
+/*
+ * Function: clip_parse_h264
+ * ---
+ *   Build the index of a raw H.264 file. Access units start at an access unit delimiter,
+ *   SPS, PPS or SEI following a slice, or at a slice whose "first_mb_in_slice" is 0.
+ *   Access units containing an IDR slice are keyframes.
+ *
+ *   return: TRUE (success), FALSE ("error" is set).
+ */
+static gboolean clip_parse_h264(struct clip_t *clip, GError **error);
+
+/*
+ * Function: clip_find_start_code
+ * ---
+ *   Find the next "00 00 01" start code from "offset".
+ *
+ *   return: Position of the start code ("size" if there is none).
+ */
+static gsize clip_find_start_code(const guint8 *data, const gsize size, gsize offset);
+
+/*
+ * Function: clip_add_unit
+ * ---
+ *   Append an access unit to the index.
+ *
+ *   return: void.
+ */
+static void clip_add_unit(struct clip_t *clip, const guint64 offset, const guint32 size,
+                          const GstClockTime pts, const GstClockTime dts, const gboolean keyframe);
+
+/*
+ * Function: clip_trim
+ * ---
+ *   Remove access units before the first keyframe, and make timestamps start at 0.
+ *
+ *   return: TRUE (success), FALSE (the clip has no keyframe, "error" is set).
+ */
+static gboolean clip_trim(struct clip_t *clip, GError **error);
+
+/*
+ * Function: clip_on_need_data
+ * ---
+ *   Callback of "appsrc". Pushes the next access units, starting a new loop after the last one.
+ */
+static void clip_on_need_data(GstAppSrc *appsrc, guint length, gpointer user_data);
+
+/* ---------- Private functions ---------- */
+
+gboolean clip_find_box(const guint8 *data, const gsize size, const gchar *type,
+                       const guint index, const guint8 **payload, gsize *payload_size)
+{
+    gsize offset = 0;
+    guint64 box_size = 0;
+    gsize header_size = 0;
+    guint found = 0;
+
+    while (offset + CLIP_BOX_HEADER_SIZE <= size)
+    {
+        box_size = GST_READ_UINT32_BE(data + offset);
+        header_size = CLIP_BOX_HEADER_SIZE;
+
+        if (box_size == 1)
+        {
+            /* 64-bit size */
+            if (offset + CLIP_BOX_HEADER_SIZE + CLIP_BOX_LARGE_SIZE > size)
+            {
+                return FALSE;
+            }
+
+            box_size = GST_READ_UINT64_BE(data + offset + CLIP_BOX_HEADER_SIZE);
+            header_size += CLIP_BOX_LARGE_SIZE;
+        }
+        else if (box_size == 0)
+        {
+            /* The box extends to the end */
+            box_size = size - offset;
+        }
+
+        if ((box_size < header_size) || (box_size > size - offset))
+        {
+            return FALSE;
+        }
+
+        if (memcmp(data + offset + 4, type, 4) == 0)
+        {
+            if (found == index)
+            {
+                *payload = data + offset + header_size;
+                *payload_size = (gsize)box_size - header_size;
+
+                return TRUE;
+            }
+
+            found++;
+        }
+
+        offset += (gsize)box_size;
+    }
+
+    return FALSE;
+}
+
+gboolean clip_get_table(const guint8 *stbl, const gsize stbl_size, const gchar *type,
+                        const gsize entry_size, struct clip_table_t *table)
+{
+    const guint8 *payload = NULL;
+    gsize payload_size = 0;
+
+    /* Full box: version (1 byte), flags (3 bytes), then the number of entries */
+    if ((!clip_find_box(stbl, stbl_size, type, 0, &payload, &payload_size)) || (payload_size < 8))
+    {
+        return FALSE;
+    }
+
+    table->version = payload[0];
+    table->counts = GST_READ_UINT32_BE(payload + 4);
+    table->entries = payload + 8;
+
+    return ((guint64)table->counts * entry_size <= payload_size - 8);
+}
+
+gboolean clip_parse_mp4(struct clip_t *clip, GError **error)
+{
+    const guint8 *data = (const guint8*)g_mapped_file_get_contents(clip->file);
+    gsize size = g_mapped_file_get_length(clip->file);
+
+    const guint8 *moov = NULL;
+    const guint8 *trak = NULL;
+    gsize moov_size = 0;
+    gsize trak_size = 0;
+
+    guint index = 0;
+
+    if (!clip_find_box(data, size, "moov", 0, &moov, &moov_size))
+    {
+        g_set_error(error, CLIP_ERROR, EINVAL, "No 'moov' box (truncated or fragmented file)");
+        return FALSE;
+    }
+
+    for (index = 0; clip_find_box(moov, moov_size, "trak", index, &trak, &trak_size); index++)
+    {
+        if (clip_parse_track(clip, trak, trak_size, error))
+        {
+            return TRUE;
+        }
+
+        /* A broken H.264 track is an error, other tracks are skipped */
+        if ((error != NULL) && (*error != NULL))
+        {
+            return FALSE;
+        }
+    }
+
+    g_set_error(error, CLIP_ERROR, ENOENT, "No H.264 video track");
+
+    return FALSE;
+}
+
+gboolean clip_parse_track(struct clip_t *clip, const guint8 *trak, const gsize trak_size,
+                          GError **error)
+{
+    const guint8 *mdia = NULL;
+    const guint8 *box = NULL;
+    const guint8 *stbl = NULL;
+    const guint8 *entry = NULL;
+    const guint8 *avcc = NULL;
+
+    gsize mdia_size = 0;
+    gsize box_size = 0;
+    gsize stbl_size = 0;
+    gsize entry_size = 0;
+    gsize avcc_size = 0;
+
+    struct clip_table_t stsz, stco, stsc, stts, ctts, stss;
+    gboolean large_offsets = FALSE;
+    gboolean has_ctts = FALSE;
+    gboolean has_stss = FALSE;
+
+    const gchar *stream_format = NULL;
+    GstBuffer *codec_data = NULL;
+
+    guint32 timescale = 0;
+    guint32 uniform_size = 0;
+    guint32 sample_size = 0;
+    guint32 samples_per_chunk = 0;
+    guint32 chunk = 0;
+    guint32 stsc_index = 0;
+    guint32 sample = 0;
+    guint32 index = 0;
+    guint32 repeat = 0;
+    guint64 offset = 0;
+    guint64 time = 0;
+    gint64 composition = 0;
+    gint64 shift = 0;
+
+    struct clip_unit_t *unit = NULL;
+
+    /* Video track ("hdlr" handler type "vide") */
+    if ((!clip_find_box(trak, trak_size, "mdia", 0, &mdia, &mdia_size)) ||
+        (!clip_find_box(mdia, mdia_size, "hdlr", 0, &box, &box_size)) ||
+        (box_size < 12) || (memcmp(box + 8, "vide", 4) != 0))
+    {
+        return FALSE;
+    }
+
+    /* Time scale of the track ("mdhd" version 0 or 1) */
+    if ((!clip_find_box(mdia, mdia_size, "mdhd", 0, &box, &box_size)) ||
+        (box_size < ((box[0] == 1) ? 24 : 16)))
+    {
+        return FALSE;
+    }
+
+    timescale = GST_READ_UINT32_BE(box + ((box[0] == 1) ? 20 : 12));
+
+    if ((!clip_find_box(mdia, mdia_size, "minf", 0, &box, &box_size)) ||
+        (!clip_find_box(box, box_size, "stbl", 0, &stbl, &stbl_size)) ||
+        (!clip_find_box(stbl, stbl_size, "stsd", 0, &box, &box_size)) ||
+        (box_size < 8))
+    {
+        return FALSE;
+    }
+
+    /* H.264 sample entry ("avc1" or "avc3"), its "avcC" box is the codec data */
+    if (clip_find_box(box + 8, box_size - 8, "avc1", 0, &entry, &entry_size))
+    {
+        stream_format = "avc";
+    }
+    else if (clip_find_box(box + 8, box_size - 8, "avc3", 0, &entry, &entry_size))
+    {
+        stream_format = "avc3";
+    }
+    else
+    {
+        return FALSE;
+    }
+
+    if ((entry_size < CLIP_VISUAL_SAMPLE_ENTRY_SIZE) ||
+        (!clip_find_box(entry + CLIP_VISUAL_SAMPLE_ENTRY_SIZE, entry_size - CLIP_VISUAL_SAMPLE_ENTRY_SIZE,
+                        "avcC", 0, &avcc, &avcc_size)))
+    {
+        g_set_error(error, CLIP_ERROR, EINVAL, "H.264 track has no 'avcC' box");
+        return FALSE;
+    }
+
+    if (timescale == 0)
+    {
+        g_set_error(error, CLIP_ERROR, EINVAL, "H.264 track has no time scale");
+        return FALSE;
+    }
+
+    /* Sample tables. "stsz" has the uniform sample size before the number of entries */
+    if ((!clip_find_box(stbl, stbl_size, "stsz", 0, &box, &box_size)) || (box_size < 12))
+    {
+        g_set_error(error, CLIP_ERROR, EINVAL, "H.264 track has no valid 'stsz' box");
+        return FALSE;
+    }
+
+    uniform_size = GST_READ_UINT32_BE(box + 4);
+    stsz.counts = GST_READ_UINT32_BE(box + 8);
+    stsz.entries = box + 12;
+
+    if ((uniform_size == 0) && ((guint64)stsz.counts * 4 > box_size - 12))
+    {
+        g_set_error(error, CLIP_ERROR, EINVAL, "Truncated 'stsz' box");
+        return FALSE;
+    }
+
+    large_offsets = !clip_get_table(stbl, stbl_size, "stco", 4, &stco);
+    if (large_offsets && (!clip_get_table(stbl, stbl_size, "co64", 8, &stco)))
+    {
+        g_set_error(error, CLIP_ERROR, EINVAL, "H.264 track has no valid 'stco'/'co64' box");
+        return FALSE;
+    }
+
+    if ((!clip_get_table(stbl, stbl_size, "stsc", 12, &stsc)) || (stsc.counts == 0) ||
+        (!clip_get_table(stbl, stbl_size, "stts", 8, &stts)))
+    {
+        g_set_error(error, CLIP_ERROR, EINVAL, "H.264 track has no valid 'stsc'/'stts' box");
+        return FALSE;
+    }
+
+    has_ctts = clip_get_table(stbl, stbl_size, "ctts", 8, &ctts);
+    has_stss = clip_get_table(stbl, stbl_size, "stss", 4, &stss);
+
+    /* Positions and sizes: samples are stored in chunks */
+    for (chunk = 0; (chunk < stco.counts) && (sample < stsz.counts); chunk++)
+    {
+        /* "stsc" entries apply from their first chunk (1-based) to the next entry */
+        while ((stsc_index + 1 < stsc.counts) &&
+               (chunk + 1 >= GST_READ_UINT32_BE(stsc.entries + (stsc_index + 1) * 12)))
+        {
+            stsc_index++;
+        }
+
+        samples_per_chunk = GST_READ_UINT32_BE(stsc.entries + stsc_index * 12 + 4);
+        offset = (large_offsets) ? GST_READ_UINT64_BE(stco.entries + (gsize)chunk * 8)
+                                 : GST_READ_UINT32_BE(stco.entries + (gsize)chunk * 4);
+
+        for (index = 0; (index < samples_per_chunk) && (sample < stsz.counts); index++, sample++)
+        {
+            sample_size = (uniform_size != 0) ? uniform_size : GST_READ_UINT32_BE(stsz.entries + (gsize)sample * 4);
+
+            if (offset + sample_size > g_mapped_file_get_length(clip->file))
+            {
+                g_set_error(error, CLIP_ERROR, EINVAL, "Sample %u is beyond the end of the file", sample);
+                return FALSE;
+            }
+
+            /* Keyframes are listed in "stss", all samples are keyframes without it */
+            clip_add_unit(clip, offset, sample_size, 0, 0, !has_stss);
+            offset += sample_size;
+        }
+    }
+
+    if (clip->units->len != stsz.counts)
+    {
+        g_set_error(error, CLIP_ERROR, EINVAL, "Chunks hold %u of %u samples", clip->units->len, stsz.counts);
+        return FALSE;
+    }
+
+    /* Decoding times, then presentation times */
+    sample = 0;
+    time = 0;
+
+    for (index = 0; index < stts.counts; index++)
+    {
+        for (repeat = GST_READ_UINT32_BE(stts.entries + (gsize)index * 8);
+             (repeat > 0) && (sample < clip->units->len); repeat--, sample++)
+        {
+            unit = &g_array_index(clip->units, struct clip_unit_t, sample);
+            unit->dts = gst_util_uint64_scale(time, GST_SECOND, timescale);
+            unit->pts = unit->dts;
+
+            time += GST_READ_UINT32_BE(stts.entries + (gsize)index * 8 + 4);
+        }
+    }
+
+    clip->duration = gst_util_uint64_scale(time, GST_SECOND, timescale);
+
+    sample = 0;
+
+    for (index = 0; has_ctts && (index < ctts.counts); index++)
+    {
+        /* Offsets are signed in version 1 */
+        composition = (ctts.version == 1) ? (gint64)(gint32)GST_READ_UINT32_BE(ctts.entries + (gsize)index * 8 + 4)
+                                          : (gint64)GST_READ_UINT32_BE(ctts.entries + (gsize)index * 8 + 4);
+
+        shift = (composition >= 0) ? (gint64)gst_util_uint64_scale(composition, GST_SECOND, timescale)
+                                   : -(gint64)gst_util_uint64_scale(-composition, GST_SECOND, timescale);
+
+        for (repeat = GST_READ_UINT32_BE(ctts.entries + (gsize)index * 8);
+             (repeat > 0) && (sample < clip->units->len); repeat--, sample++)
+        {
+            unit = &g_array_index(clip->units, struct clip_unit_t, sample);
+            unit->pts = ((gint64)unit->dts + shift > 0) ? (GstClockTime)((gint64)unit->dts + shift) : 0;
+        }
+    }
+
+    for (index = 0; has_stss && (index < stss.counts); index++)
+    {
+        /* Sample numbers are 1-based */
+        sample = GST_READ_UINT32_BE(stss.entries + (gsize)index * 4);
+
+        if ((sample >= 1) && (sample <= clip->units->len))
+        {
+            g_array_index(clip->units, struct clip_unit_t, sample - 1).keyframe = TRUE;
+        }
+    }
+
+    /* SPS/PPS are given to "h264parse" as codec data */
+    codec_data = gst_buffer_new_allocate(NULL, avcc_size, NULL);
+    gst_buffer_fill(codec_data, 0, avcc, avcc_size);
+
+    clip->caps = gst_caps_new_simple("video/x-h264",
+                                     "stream-format", G_TYPE_STRING, stream_format,
+                                     "alignment", G_TYPE_STRING, "au",
+                                     "codec_data", GST_TYPE_BUFFER, codec_data,
+                                     NULL);
+    gst_buffer_unref(codec_data);
+
+    return TRUE;
+}
+
+gsize clip_find_start_code(const guint8 *data, const gsize size, gsize offset)
+{
+    while (offset + 3 <= size)
+    {
+        /* Skip 3 bytes at once if the third one cannot end a start code */
+        if (data[offset + 2] > 1)
+        {
+            offset += 3;
+        }
+        else if ((data[offset] == 0) && (data[offset + 1] == 0) && (data[offset + 2] == 1))
+        {
+            return offset;
+        }
+        else
+        {
+            offset++;
+        }
+    }
+
+    return size;
+}
+
+gboolean clip_parse_h264(struct clip_t *clip, GError **error)
+{
+    const guint8 *data = (const guint8*)g_mapped_file_get_contents(clip->file);
+    gsize size = g_mapped_file_get_length(clip->file);
+
+    gsize position = 0;
+    gsize next = 0;
+    gsize start = 0;
+    gsize unit_start = 0;
+
+    guint8 type = 0;
+    gboolean vcl = FALSE;
+    gboolean has_vcl = FALSE;
+    gboolean keyframe = FALSE;
+    gboolean in_unit = FALSE;
+
+    GstClockTime time = 0;
+
+    for (position = clip_find_start_code(data, size, 0); position + 3 < size; position = next)
+    {
+        next = clip_find_start_code(data, size, position + 3);
+
+        /* 4-byte start codes belong to the NAL unit */
+        start = ((position > 0) && (data[position - 1] == 0)) ? position - 1 : position;
+
+        type = data[position + 3] & 0x1F;
+        vcl = (type >= H264_NAL_SLICE) && (type <= H264_NAL_IDR);
+
+        /* New access unit (H.264 7.4.1.2.3): after a slice, a non-VCL unit which precedes
+         * slices, or a slice with first_mb_in_slice = 0 (ue(v) "1" bit) */
+        if (in_unit && has_vcl &&
+            (((type >= H264_NAL_SEI) && (type <= H264_NAL_AUD)) || ((type >= 14) && (type <= 18)) ||
+             (vcl && (position + 4 < size) && ((data[position + 4] & 0x80) != 0))))
+        {
+            clip_add_unit(clip, unit_start, (guint32)(start - unit_start), time, time, keyframe);
+            time = gst_util_uint64_scale(clip->units->len, GST_SECOND, CLIP_DEFAULT_FPS);
+
+            in_unit = FALSE;
+        }
+
+        if (!in_unit)
+        {
+            unit_start = start;
+            has_vcl = FALSE;
+            keyframe = FALSE;
+            in_unit = TRUE;
+        }
+
+        has_vcl = has_vcl || vcl;
+        keyframe = keyframe || (type == H264_NAL_IDR);
+    }
+
+    if (in_unit && has_vcl)
+    {
+        clip_add_unit(clip, unit_start, (guint32)(size - unit_start), time, time, keyframe);
+    }
+
+    if (clip->units->len == 0)
+    {
+        g_set_error(error, CLIP_ERROR, EINVAL, "No H.264 access unit");
+        return FALSE;
+    }
+
+    clip->duration = gst_util_uint64_scale(clip->units->len, GST_SECOND, CLIP_DEFAULT_FPS);
+    clip->caps = gst_caps_new_simple("video/x-h264",
+                                     "stream-format", G_TYPE_STRING, "byte-stream",
+                                     "alignment", G_TYPE_STRING, "au",
+                                     NULL);
+
+    return TRUE;
+}
+
+void clip_add_unit(struct clip_t *clip, const guint64 offset, const guint32 size,
+                   const GstClockTime pts, const GstClockTime dts, const gboolean keyframe)
+{
+    struct clip_unit_t unit;
+
+    unit.offset = offset;
+    unit.size = size;
+    unit.pts = pts;
+    unit.dts = dts;
+    unit.keyframe = keyframe;
+
+    g_array_append_val(clip->units, unit);
+}
+
+gboolean clip_trim(struct clip_t *clip, GError **error)
+{
+    struct clip_unit_t *unit = NULL;
+    GstClockTime base = 0;
+    guint first = 0;
+    guint index = 0;
+
+    while ((first < clip->units->len) && (!g_array_index(clip->units, struct clip_unit_t, first).keyframe))
+    {
+        first++;
+    }
+
+    if (first == clip->units->len)
+    {
+        g_set_error(error, CLIP_ERROR, EINVAL, "No keyframe in %u access units", clip->units->len);
+        return FALSE;
+    }
+
+    if (first > 0)
+    {
+        g_message("Warning: Clip '%s' does not start with a keyframe, %u access units skipped",
+                  clip->path, first);
+    }
+
+    base = g_array_index(clip->units, struct clip_unit_t, first).dts;
+    g_array_remove_range(clip->units, 0, first);
+
+    for (index = 0; index < clip->units->len; index++)
+    {
+        unit = &g_array_index(clip->units, struct clip_unit_t, index);
+        unit->pts = (unit->pts > base) ? unit->pts - base : 0;
+        unit->dts -= base;
+
+        if (unit->keyframe)
+        {
+            clip->keyframe_counts++;
+        }
+    }
+
+    clip->duration = (clip->duration > base) ? clip->duration - base : 0;
+
+    if (clip->duration == 0)
+    {
+        g_set_error(error, CLIP_ERROR, EINVAL, "Clip has no duration");
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+void clip_on_need_data(GstAppSrc *appsrc, guint length, gpointer user_data)
+{
+    struct clip_t *clip = (struct clip_t*)user_data;
+    const struct clip_unit_t *unit = NULL;
+
+    GstBuffer *buffer = NULL;
+    GstClockTime offset = 0;
+    gchar *data = g_mapped_file_get_contents(clip->file);
+
+    gint counts = 0;
+
+    for (counts = 0; counts < CLIP_PUSH_UNITS; counts++)
+    {
+        unit = &g_array_index(clip->units, struct clip_unit_t, clip->position);
+        offset = clip->loops * clip->duration;
+
+        /* No copy: the buffer points to the mapped file and keeps it mapped */
+        buffer = gst_buffer_new_wrapped_full(GST_MEMORY_FLAG_READONLY, data + unit->offset,
+                                             unit->size, 0, unit->size,
+                                             g_mapped_file_ref(clip->file),
+                                             (GDestroyNotify)g_mapped_file_unref);
+
+        GST_BUFFER_PTS(buffer) = offset + unit->pts;
+        GST_BUFFER_DTS(buffer) = offset + unit->dts;
+        GST_BUFFER_OFFSET(buffer) = clip->position;
+
+        if (!unit->keyframe)
+        {
+            GST_BUFFER_FLAG_SET(buffer, GST_BUFFER_FLAG_DELTA_UNIT);
+        }
+
+        /* Stop when "appsrc" is flushing or stopped */
+        if (gst_app_src_push_buffer(appsrc, buffer) != GST_FLOW_OK)
+        {
+            break;
+        }
+
+        clip->position++;
+
+        if (clip->position == clip->units->len)
+        {
+            clip->position = 0;
+            clip->loops++;
+
+            g_debug("Info: Clip '%s' starts loop %" G_GUINT64_FORMAT, clip->path, clip->loops + 1);
+        }
+    }
+}
+
+/* ---------- Public functions ---------- */
+
+struct clip_t *clip_create(const gchar *path, GError **error)
+{
+    struct clip_t *clip = NULL;
+    const guint8 *data = NULL;
+    gsize size = 0;
+    gboolean result = FALSE;
+
+    gint64 start_time = g_get_monotonic_time();
+
+    /* Check parameter(s) */
+    g_return_val_if_fail(path != NULL, NULL);
+
+    clip = g_new0(struct clip_t, 1);
+    clip->path = g_strdup(path);
+    clip->units = g_array_new(FALSE, FALSE, sizeof(struct clip_unit_t));
+
+    clip->file = g_mapped_file_new(path, FALSE, error);
+    if (clip->file == NULL)
+    {
+        clip_free(clip);
+        return NULL;
+    }
+
+    data = (const guint8*)g_mapped_file_get_contents(clip->file);
+    size = g_mapped_file_get_length(clip->file);
+
+    /* MP4 files start with an "ftyp" box, raw H.264 with a start code */
+    if ((size >= CLIP_BOX_HEADER_SIZE) && (memcmp(data + 4, "ftyp", 4) == 0))
+    {
+        clip->format = CLIP_FORMAT_MP4;
+        result = clip_parse_mp4(clip, error);
+    }
+    else if ((size >= 4) && (clip_find_start_code(data, MIN(size, 4), 0) < 2))
+    {
+        clip->format = CLIP_FORMAT_H264;
+        result = clip_parse_h264(clip, error);
+    }
+    else
+    {
+        clip->format = CLIP_FORMAT_UNKNOWN;
+        g_set_error(error, CLIP_ERROR, EINVAL, "Neither an MP4 nor a raw H.264 file");
+    }
+
+    if ((!result) || (!clip_trim(clip, error)))
+    {
+        clip_free(clip);
+        return NULL;
+    }
+
+    g_message("Info: Clip '%s': %s, %u access units (%u keyframes), %.2f s per loop, indexed in %.1f ms",
+              path, (clip->format == CLIP_FORMAT_MP4) ? "MP4" : "raw H.264",
+              clip->units->len, clip->keyframe_counts, (gdouble)clip->duration / GST_SECOND,
+              (g_get_monotonic_time() - start_time) / 1000.0);
+
+    return clip;
+}
+
+void clip_attach(struct clip_t *clip, GstElement *appsrc)
+{
+    GstAppSrcCallbacks callbacks =
+    {
+        .need_data = clip_on_need_data,
+        .enough_data = NULL,
+        .seek_data = NULL
+    };
+
+    /* Check parameter(s) */
+    g_return_if_fail((clip != NULL) && (appsrc != NULL));
+
+    clip->appsrc = gst_object_ref(appsrc);
+
+    g_object_set(appsrc, "format", GST_FORMAT_TIME, "stream-type", GST_APP_STREAM_TYPE_STREAM, NULL);
+    gst_app_src_set_caps(GST_APP_SRC(appsrc), clip->caps);
+    gst_app_src_set_callbacks(GST_APP_SRC(appsrc), &callbacks, clip, NULL);
+}
+
+void clip_rewind(struct clip_t *clip)
+{
+    /* Check parameter(s) */
+    g_return_if_fail(clip != NULL);
+
+    clip->position = 0;
+    clip->loops = 0;
+}
+
+const gchar *clip_get_path(const struct clip_t *clip)
+{
+    /* Check parameter(s) */
+    g_return_val_if_fail(clip != NULL, NULL);
+
+    return clip->path;
+}
+
+const GstCaps *clip_get_caps(const struct clip_t *clip)
+{
+    /* Check parameter(s) */
+    g_return_val_if_fail(clip != NULL, NULL);
+
+    return clip->caps;
+}
+
+guint clip_get_unit_counts(const struct clip_t *clip)
+{
+    /* Check parameter(s) */
+    g_return_val_if_fail(clip != NULL, 0);
+
+    return clip->units->len;
+}
+
+const guint8 *clip_get_unit(const struct clip_t *clip, const guint index,
+                            gsize *size, gboolean *keyframe)
+{
+    const struct clip_unit_t *unit = NULL;
+
+    /* Check parameter(s) */
+    g_return_val_if_fail((clip != NULL) && (size != NULL) && (keyframe != NULL), NULL);
+
+    if (index >= clip->units->len)
+    {
+        return NULL;
+    }
+
+    unit = &g_array_index(clip->units, struct clip_unit_t, index);
+
+    *size = unit->size;
+    *keyframe = unit->keyframe;
+
+    return (const guint8*)g_mapped_file_get_contents(clip->file) + unit->offset;
+}
+
+void clip_free(struct clip_t *clip)
+{
+    /* Check parameter(s) */
+    g_return_if_fail(clip != NULL);
+
+    if (clip->appsrc != NULL)
+    {
+        gst_object_unref(clip->appsrc);
+    }
+
+    if (clip->caps != NULL)
+    {
+        gst_caps_unref(clip->caps);
+    }
+
+    if (clip->file != NULL)
+    {
+        g_mapped_file_unref(clip->file);
+    }
+
+    g_array_free(clip->units, TRUE);
+    g_free(clip->path);
+    g_free(clip);
+}
@@ -0,0 +1,164 @@
+/***********************************************************************
+ * FILENAME: clip.h
+ *
+ * DESCRIPTION:
+ *   Contains APIs to play sample videos as fake cameras.
+ *
+ *   A clip (MP4 or raw H.264 file) is mapped in memory and parsed once
+ *   into an index of access units. The clip is then pushed to an "appsrc"
+ *   element in a loop, without re-opening or re-demuxing the file: buffers
+ *   point to the mapped file, and timestamps keep increasing from one loop
+ *   to the next.
+ *
+ * PUBLIC FUNCTIONS:
+ *   struct clip_t *clip_create(const gchar *path, GError **error);
+ *
+ *   void clip_attach(struct clip_t *clip, GstElement *appsrc);
+ *
+ *   void clip_rewind(struct clip_t *clip);
+ *
+ *   const gchar *clip_get_path(const struct clip_t *clip);
+ *
+ *   const GstCaps *clip_get_caps(const struct clip_t *clip);
+ *
+ *   guint clip_get_unit_counts(const struct clip_t *clip);
+ *
+ *   const guint8 *clip_get_unit(const struct clip_t *clip, const guint index,
+ *                               gsize *size, gboolean *keyframe);
+ *
+ *   void clip_free(struct clip_t *clip);
+ *
+ * AUTHOR: RVC       START DATE: 17/10/2026
+ *
+ * CHANGES:
+ *
+ ***********************************************************************/
+
+#ifndef _CLIP_H_
+#define _CLIP_H_
+
+/* ---------- Macros ---------- */
+
+/* Frame rate of raw H.264 clips (they have no timestamps) */
+#define CLIP_DEFAULT_FPS 30
+
+/* ---------- Datatypes ---------- */
+
+/*
+ * Struct: clip_t
+ * ---
+ *   Represents a clip:
+ *     - path (string): Path of the file.
+ *     - format (enum clip_format_t): Container of the file.
+ *     - file (GMappedFile): The file, mapped read-only (shared with pushed buffers).
+ *     - units (array of "clip_unit_t"): Access units, from the first keyframe.
+ *     - keyframe_counts (guint): The number of keyframes in "units".
+ *     - duration (GstClockTime): Duration of a loop.
+ *     - caps (GstCaps): Caps of access units (with "codec_data" for MP4).
+ *     - appsrc (GstElement): "appsrc" element fed by the clip (NULL if not attached).
+ *     - position (guint): Index of the next access unit.
+ *     - loops (guint64): The number of completed loops (timestamp offset).
+ */
+struct clip_t;
+
+/* ---------- Functions ---------- */
+
+/*
+ * Function: clip_create
+ * ---
+ *   Maps "path" in memory and builds its access unit index. The format is detected
+ *   from the content ("ftyp" box for MP4, a start code for raw H.264). The index starts
+ *   at the first keyframe, so that every loop can be decoded from its first access unit.
+ *
+ *   path: Path of an MP4 or raw H.264 file.
+ *   error: Error (output), such as: no H.264 video track, truncated sample tables.
+ *
+ *   return: NULL (the file cannot be used, "error" is set).
+ *           not NULL (the clip, see "clip_free()").
+ */
+struct clip_t *clip_create(const gchar *path, GError **error);
+
+/*
+ * Function: clip_attach
+ * ---
+ *   Sets the caps of "appsrc" and feeds it with the clip, looping forever. Access units
+ *   are pushed when "appsrc" needs data, with their timestamps plus the duration of the
+ *   completed loops, and with their index in the clip as offset (GST_BUFFER_OFFSET, see
+ *   "clip_get_unit()"). The element keeps a reference on the clip's mapped file for every
+ *   buffer in flight.
+ *
+ *   appsrc: "appsrc" element (GST_CLIP_SOURCE_NAME in the fake camera pipeline).
+ *
+ *   return: void.
+ */
+void clip_attach(struct clip_t *clip, GstElement *appsrc);
+
+/*
+ * Function: clip_rewind
+ * ---
+ *   Starts the clip again from its first access unit, with timestamps starting at 0.
+ *   Must be called while the pipeline is stopped (before it is started again),
+ *   because running time starts at 0 for every run of the pipeline.
+ *
+ *   return: void.
+ */
+void clip_rewind(struct clip_t *clip);
+
+/*
+ * Function: clip_get_path
+ * ---
+ *   Get the path of "clip".
+ *
+ *   Note: The output string must not be de-allocated or modified.
+ *
+ *   return: String (such as: "/home/root/videos/1280x720/h264-hd-30.mp4").
+ */
+const gchar *clip_get_path(const struct clip_t *clip);
+
+/*
+ * Function: clip_get_caps
+ * ---
+ *   Get the caps of the access units of "clip" ("video/x-h264", "stream-format" is
+ *   "byte-stream" for raw H.264, "avc" or "avc3" with "codec_data" for MP4).
+ *
+ *   Note: The output caps must not be unreferenced or modified.
+ *
+ *   return: Caps.
+ */
+const GstCaps *clip_get_caps(const struct clip_t *clip);
+
+/*
+ * Function: clip_get_unit_counts
+ * ---
+ *   Get the number of access units of a loop.
+ *
+ *   return: guint (the number of access units).
+ */
+guint clip_get_unit_counts(const struct clip_t *clip);
+
+/*
+ * Function: clip_get_unit
+ * ---
+ *   Get access unit "index" (from 0 to "clip_get_unit_counts()" - 1) of "clip".
+ *
+ *   size: Size of the access unit (output, bytes).
+ *   keyframe: Set if the access unit can be decoded alone (output).
+ *
+ *   Note: The output data must not be modified. It is valid until "clip" is freed.
+ *
+ *   return: NULL ("index" is out of range).
+ *           not NULL (the access unit, in the format of "clip_get_caps()").
+ */
+const guint8 *clip_get_unit(const struct clip_t *clip, const guint index,
+                            gsize *size, gboolean *keyframe);
+
+/*
+ * Function: clip_free
+ * ---
+ *   Frees "clip". The file stays mapped until the last pushed buffer is freed.
+ *
+ *   return: void.
+ */
+void clip_free(struct clip_t *clip);
+
+#endif
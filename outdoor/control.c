@@ -0,0 +1,215 @@
+/***********************************************************************
+ * FILENAME: control.c
+ *
+ * DESCRIPTION:
+ *   Local control socket.
+ *
+ * NOTE:
+ *   For more further information about datatypes and function usages,
+ *   please refer to "control.h".
+ *
+ * AUTHOR: RVC       START DATE: 16/10/2026
+ *
+ * CHANGES:
+ *
+ ***********************************************************************/
+
+/* ---------- Header files ---------- */
+
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <glib/gprintf.h>
+
+#include <gio/gio.h>
+#include <gio/gunixsocketaddress.h>
+
+#include "helper.h"
+#include "control.h"
+
+/* ---------- Macros ---------- */
+
+/* Maximum number of connections handled at the same time */
+#define CONTROL_MAX_CONNECTIONS 4
+
+/* Answer to a line of CONTROL_MAX_LINE_LENGTH or more, like a command refused by the handler */
+#define CONTROL_REPLY_TOO_LONG "Line too long\nERROR\n"
+
+/* ---------- Datatypes ---------- */
+
+struct control_t
+{
+    gchar *path;
+
+    GSocketService *service;
+
+    control_handler_t handler;
+
+    gpointer user_data;
+};
+
+/*
+ * Struct: control_request_t
+ * ---
+ *   Represents a command passed from a connection thread to the main context:
+ *     - control (struct control_t): Control socket (handler and its user data).
+ *     - command (string): Command line.
+ *     - reply (GString): Answer of the handler.
+ *     - result (gboolean): Result of the handler.
+ */
+struct control_request_t
+{
+    struct control_t *control;
+
+    const gchar *command;
+
+    GString *reply;
+
+    gboolean result;
+};
+
+/* ---------- Private functions ---------- */
+
+/*
+ * Function: control_on_run
+ * ---
+ *   Callback of "GThreadedSocketService::run". Reads commands of a connection
+ *   line by line until the client closes it.
+ */
+static gboolean control_on_run(GThreadedSocketService *service, GSocketConnection *connection,
+                               GObject *source_object, gpointer user_data);
+
+/*
+ * Function: control_dispatch
+ * ---
+ *   Runs the handler of a request in the default main context (see "main_context_call").
+ */
+static void control_dispatch(gpointer user_data);
+
+/* ---------- Private functions ---------- */
+
+void control_dispatch(gpointer user_data)
+{
+    struct control_request_t *request = (struct control_request_t*)user_data;
+
+    request->result = request->control->handler(request->command, request->reply,
+                                                request->control->user_data);
+}
+
+gboolean control_on_run(GThreadedSocketService *service, GSocketConnection *connection,
+                        GObject *source_object, gpointer user_data)
+{
+    struct control_t *control = (struct control_t*)user_data;
+    struct control_request_t request;
+
+    GDataInputStream *input = NULL;
+    GOutputStream *output = NULL;
+
+    gchar *line = NULL;
+    gsize length = 0;
+
+    input = g_data_input_stream_new(g_io_stream_get_input_stream(G_IO_STREAM(connection)));
+    output = g_io_stream_get_output_stream(G_IO_STREAM(connection));
+
+    g_data_input_stream_set_newline_type(input, G_DATA_STREAM_NEWLINE_TYPE_ANY);
+
+    while ((line = g_data_input_stream_read_line(input, &length, NULL, NULL)) != NULL)
+    {
+        g_strstrip(line);
+
+        if (length >= CONTROL_MAX_LINE_LENGTH)
+        {
+            g_output_stream_write_all(output, CONTROL_REPLY_TOO_LONG, sizeof(CONTROL_REPLY_TOO_LONG) - 1,
+                                      NULL, NULL, NULL);
+        }
+        else if (line[0] != '\0')
+        {
+            /* Handlers (and the objects they control) live in the main context */
+            request.control = control;
+            request.command = line;
+            request.reply = g_string_new(NULL);
+            request.result = FALSE;
+
+            main_context_call(control_dispatch, &request);
+
+            g_string_append(request.reply, (request.result) ? "OK\n" : "ERROR\n");
+            g_output_stream_write_all(output, request.reply->str, request.reply->len,
+                                      NULL, NULL, NULL);
+
+            /* Free resources */
+            g_string_free(request.reply, TRUE);
+        }
+
+        g_free(line);
+    }
+
+    g_object_unref(input);
+
+    return TRUE;
+}
+
+/* ---------- Public functions ---------- */
+
+struct control_t *control_create(const gchar *path, control_handler_t handler,
+                                 gpointer user_data)
+{
+    struct control_t *control = NULL;
+
+    GSocketAddress *address = NULL;
+    GError *error = NULL;
+
+    /* Check parameter(s) */
+    g_return_val_if_fail((path != NULL) && (handler != NULL), NULL);
+
+    control = g_new0(struct control_t, 1);
+
+    control->path = g_strdup(path);
+    control->handler = handler;
+    control->user_data = user_data;
+
+    /* Remove the socket file of a previous run */
+    g_unlink(path);
+
+    control->service = g_threaded_socket_service_new(CONTROL_MAX_CONNECTIONS);
+    address = g_unix_socket_address_new(path);
+
+    if (!g_socket_listener_add_address(G_SOCKET_LISTENER(control->service), address,
+                                       G_SOCKET_TYPE_STREAM, G_SOCKET_PROTOCOL_DEFAULT,
+                                       NULL, NULL, &error))
+    {
+        g_message("Error: Failed to create control socket '%s': %s", path, error->message);
+
+        /* Free resources */
+        g_clear_error(&error);
+        g_object_unref(address);
+        control_free(control);
+
+        return NULL;
+    }
+
+    g_object_unref(address);
+
+    g_signal_connect(control->service, "run", G_CALLBACK(control_on_run), control);
+    g_socket_service_start(control->service);
+
+    g_message("Control socket is ready at: \"%s\"", path);
+
+    return control;
+}
+
+void control_free(struct control_t *control)
+{
+    /* Check parameter(s) */
+    g_return_if_fail(control != NULL);
+
+    if (control->service != NULL)
+    {
+        g_socket_service_stop(control->service);
+        g_socket_listener_close(G_SOCKET_LISTENER(control->service));
+        g_object_unref(control->service);
+
+        g_unlink(control->path);
+    }
+
+    g_free(control->path);
+    g_free(control);
+}
@@ -0,0 +1,80 @@
+/***********************************************************************
+ * FILENAME: control.h
+ *
+ * DESCRIPTION:
+ *   Contains APIs to receive text commands from a local control socket
+ *   (Unix domain socket), such as: doorbell/motion events.
+ *
+ * PUBLIC FUNCTIONS:
+ *   struct control_t *control_create(const gchar *path, control_handler_t handler,
+ *                                    gpointer user_data);
+ *
+ *   void control_free(struct control_t *control);
+ *
+ * AUTHOR: RVC       START DATE: 16/10/2026
+ *
+ * CHANGES:
+ *
+ ***********************************************************************/
+
+#ifndef _CONTROL_H_
+#define _CONTROL_H_
+
+/* ---------- Macros ---------- */
+
+/* Maximum length of a command line */
+#define CONTROL_MAX_LINE_LENGTH 256
+
+/* ---------- Datatypes ---------- */
+
+/*
+ * Type: control_handler_t
+ * ---
+ *   Handles command line "command" (without line terminator) and writes
+ *   the answer to "reply". It is called in the default main context.
+ *
+ *   return: TRUE (the command succeeded, "OK" is sent after "reply").
+ *           FALSE (the command failed, "ERROR" is sent after "reply").
+ */
+typedef gboolean (*control_handler_t)(const gchar *command, GString *reply, gpointer user_data);
+
+/*
+ * Struct: control_t
+ * ---
+ *   Represents a control socket:
+ *     - path (string): Path of the Unix domain socket.
+ *     - service (GSocketService): Socket service (one thread per connection).
+ *     - handler (control_handler_t): Command handler.
+ *     - user_data (gpointer): Data passed to "handler".
+ */
+struct control_t;
+
+/* ---------- Functions ---------- */
+
+/*
+ * Function: control_create
+ * ---
+ *   Creates a Unix domain socket at "path" and starts accepting connections.
+ *   Every line received from a connection is passed to "handler". Lines of
+ *   CONTROL_MAX_LINE_LENGTH or more are answered with "ERROR" without calling it.
+ *
+ *   Example: echo "event 1 doorbell" | socat - UNIX-CONNECT:<path>
+ *
+ *   return: NULL (unable to create the socket).
+ *           not NULL (successfully create "control_t" object).
+ *
+ *   Note: Should use "control_free()" to deallocate if it is not used anymore.
+ */
+struct control_t *control_create(const gchar *path, control_handler_t handler,
+                                 gpointer user_data);
+
+/*
+ * Function: control_free
+ * ---
+ *   Stops the socket service, removes the socket file and frees "control_t" object.
+ *
+ *   return: void.
+ */
+void control_free(struct control_t *control);
+
+#endif
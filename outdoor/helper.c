@@ -26,6 +26,57 @@
 
 #include "helper.h"
 
+/* ---------- Datatypes ---------- */
+
+/*
+ * Struct: main_context_call_t
+ * ---
+ *   Represents a call passed from a thread to the default main context:
+ *     - func (main_context_func_t): Function to call.
+ *     - user_data (gpointer): Argument of "func".
+ *     - done (gboolean): Set when "func" returns.
+ *     - lock, cond (GMutex, GCond): Wait of the calling thread for "done".
+ */
+struct main_context_call_t
+{
+    main_context_func_t func;
+
+    gpointer user_data;
+
+    gboolean done;
+
+    GMutex lock;
+
+    GCond cond;
+};
+
+/* ---------- Private functions ---------- */
+
+/*
+ * Function: main_context_dispatch
+ * ---
+ *   Runs a call in the default main context, then wakes up the calling thread.
+ *
+ *   return: G_SOURCE_REMOVE.
+ */
+static gboolean main_context_dispatch(gpointer user_data);
+
+/* ---------- Private functions ---------- */
+
+gboolean main_context_dispatch(gpointer user_data)
+{
+    struct main_context_call_t *call = (struct main_context_call_t*)user_data;
+
+    call->func(call->user_data);
+
+    g_mutex_lock(&call->lock);
+    call->done = TRUE;
+    g_cond_signal(&call->cond);
+    g_mutex_unlock(&call->lock);
+
+    return G_SOURCE_REMOVE;
+}
+
 /* ---------- Functions ---------- */
 
 gboolean kernel_module_is_loaded(const gchar *module_name)
@@ -197,3 +248,31 @@ const char* file_get_extension(const gchar *file_name)
 
     return file_ext;
 }
+
+void main_context_call(main_context_func_t func, gpointer user_data)
+{
+    struct main_context_call_t call;
+
+    /* Check parameter(s) */
+    g_return_if_fail(func != NULL);
+
+    call.func = func;
+    call.user_data = user_data;
+    call.done = FALSE;
+
+    g_mutex_init(&call.lock);
+    g_cond_init(&call.cond);
+
+    g_main_context_invoke(NULL, main_context_dispatch, &call);
+
+    g_mutex_lock(&call.lock);
+    while (!call.done)
+    {
+        g_cond_wait(&call.cond, &call.lock);
+    }
+    g_mutex_unlock(&call.lock);
+
+    /* Free resources */
+    g_mutex_clear(&call.lock);
+    g_cond_clear(&call.cond);
+}
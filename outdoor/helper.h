@@ -15,6 +15,8 @@
  *
  *   const char* file_get_extension(const gchar *file_name);
  *
+ *   void main_context_call(main_context_func_t func, gpointer user_data);
+ *
  * AUTHOR: RVC       START DATE: 03/01/2020
  *
  * CHANGES:
@@ -24,6 +26,15 @@
 #ifndef _HELPER_H_
 #define _HELPER_H_
 
+/* ---------- Datatypes ---------- */
+
+/*
+ * Type: main_context_func_t
+ * ---
+ *   Function called in the default main context by "main_context_call".
+ */
+typedef void (*main_context_func_t)(gpointer user_data);
+
 /* ---------- Functions ---------- */
 
 /*
@@ -97,4 +108,17 @@ void string_array_free(GArray *array, const gint size);
  */
 const char* file_get_extension(const gchar *file_name);
 
+/*
+ * Function: main_context_call
+ * ---
+ *   Calls "func" in the default main context and waits until it returns. Used by
+ *   threads of socket services to reach objects which live in the main context.
+ *
+ *   Note: Must not be called from the default main context, it would never return
+ *         if the context is not owned by the calling thread.
+ *
+ *   return: void.
+ */
+void main_context_call(main_context_func_t func, gpointer user_data);
+
 #endif
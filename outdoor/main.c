@@ -19,21 +19,32 @@
 
 #include <gst/rtsp-server/rtsp-server.h>
 
+#include "media.h"
 #include "camera.h"
+#include "abr.h"
+#include "profile.h"
+#include "capture.h"
+#include "rtppace.h"
+#include "allocator.h"
+#include "control.h"
 #include "my_gst.h"
 #include "helper.h"
+#include "server.h"
+#include "metrics.h"
 #include "param.h"
 
 /*
  * Function: main
  * ----------------------------
  *   I. Purpose: 
- *     1. Setup RTSP server.
- *     2. Send camera streams (MIPI/USB camera) to client.
+ *     1. Setup RTSP server (one server for all cameras, or one server per port).
+ *     2. Send camera streams (MIPI/USB camera) to client. Each camera is captured once
+ *        and published as a main stream and a low resolution substream (".../sub").
  *
  *   II. Notes:
  *     1. If MIPI camera is detected, it will be the main camera.
- *     2. By default, it will accept up to 4 cameras. MIPI will always be accepted if detected.
+ *     2. By default, it will accept 4 cameras (see option "--cameras"). MIPI will always be accepted if detected.
+ *        Cameras which do not fit the board's resources are downgraded or refused (see "budget.h").
  *     3. If the number of camera is not enough, it will:
  *       - Raises a warning, then continue to stream detected cameras.
  *       - If not enough, it will find and stream video samples inside a pre-defined directory.
@@ -57,32 +68,51 @@ int main(int argc, char *argv[])
     /* Main loop */
     GMainLoop *loop = NULL;
 
-    /* RTSP server */
-    GstRTSPServer *server = NULL;
+    /* RTSP server(s) */
+    struct server_t *server = NULL;
 
-    /* Used to set port for RTSP servers */
-    gchar *port_str = NULL;
+    /* Camera pipelines (one per camera) */
+    struct capture_t **captures = NULL;
+
+    /* Bitrate allocator and its control socket (NULL if disabled) */
+    struct allocator_t *allocator = NULL;
+    struct control_t *control = NULL;
+
+    /* Metrics endpoint (NULL if disabled) */
+    struct metrics_t *metrics = NULL;
+
+    /* Profiler of camera pipelines (NULL if disabled) */
+    struct profile_t *profile = NULL;
+    GError *profile_error = NULL;
 
     /* List of ports for RTSP servers */
     gint *ports = NULL;
     gint port_counts = 0;
 
+    /* Multicast transport of mount points */
+    const struct server_multicast_t *multicasts = NULL;
+    gint multicast_counts = 0;
+
+    /* Forward error correction of mount points */
+    const struct server_fec_t *fecs = NULL;
+    gint fec_counts = 0;
+
     /* List of collected cameras */
     struct camera_t **cameras = NULL;
     gint camera_size = 0;
 
-    /* Camera resolution */
-    gchar *width = (char *) malloc(sizeof(char*) * 10);
-    gchar *height = (char *) malloc(sizeof(char*) * 10);;
-
     gint index = 0;
+    gint result = 0;
 
-    /* GStreamer pipeline */
-    gchar pipeline[500];
+    /* RTP packets sent at once by media (0: no batching and pacing) */
+    gint egress_batch = 0;
+
+    /* Adaptive bitrate range of main streams */
+    gint min_bitrate = 0;
+    gint max_bitrate = 0;
 
-    /* RTSP server's objects */
-    GstRTSPMountPoints *mounts = NULL;
-    GstRTSPMediaFactory *factory = NULL;
+    /* GStreamer pipeline */
+    gchar pipeline[GST_PIPELINE_MAX_LENGTH];
 
     /* Try to parse parameters */
     if (!param_parse(&argc, &argv, error))
@@ -108,6 +138,19 @@ int main(int argc, char *argv[])
     /* Create main loop */
     loop = g_main_loop_new(NULL, FALSE);
 
+    /* Profile camera pipelines. Without trace file, summaries are still logged */
+    if (param_is_profile_enabled())
+    {
+        profile = profile_create(param_get_profile_trace(), &profile_error);
+        if (profile == NULL)
+        {
+            g_message("Warning: %s", profile_error->message);
+            g_clear_error(&profile_error);
+
+            profile = profile_create("", NULL);
+        }
+    }
+
     /* Get ports for RTSP servers */
     param_get_rtsp_server_ports(&ports, &port_counts);
 
@@ -115,65 +158,191 @@ int main(int argc, char *argv[])
      * The output of this function will always be reliable at this point. */
     param_get_cameras(&cameras, &camera_size);
 
-    /* Get resolution of camera */
-    param_get_resolution(width, height);
+    /* Create RTSP server(s). In single-server mode, all cameras are published as
+     * mount points of one server. Otherwise, each camera has its own server */
+    server = server_create(param_get_server_mode(), ports, port_counts, param_get_rtsp_threads());
 
-    /* For each camera, create a pipeline from it, then attach it to "GstRTSPMountPoints" */
-    for (index = 0; index < camera_size; index++)
+    /* Multicast groups of mount points, before the streams are published */
+    param_get_multicasts(&multicasts, &multicast_counts);
+
+    for (index = 0; (index < multicast_counts) && (result == 0); index++)
+    {
+        if (!server_add_multicast(server, &multicasts[index]))
+        {
+            result = -1;
+        }
+    }
+
+    /* Packet loss recovery of streams: retransmissions (NACK) and ULPFEC */
+    server_set_retransmission(server, param_get_retransmission());
+
+    param_get_fecs(&fecs, &fec_counts);
+
+    for (index = 0; index < fec_counts; index++)
+    {
+        server_add_fec(server, &fecs[index]);
+    }
+
+    /* Latency budget of encoding branches (leaky queues), before pipelines are created */
+    gst_set_frame_budget(param_get_frame_budget());
+
+    /* Batching and pacing of RTP packets, before media factories are created */
+    egress_batch = param_get_egress_batch();
+    if ((egress_batch > 0) && !rtppace_register())
     {
-        /* Create RTSP server */
-        server = gst_rtsp_server_new();
+        g_message("Warning: Failed to register '%s', RTP packets are not paced", RTPPACE_ELEMENT_NAME);
+        egress_batch = 0;
+    }
+
+    /* For each camera, create a pipeline from it, then publish its stream(s) */
+    captures = g_new0(struct capture_t*, camera_size);
+
+    for (index = 0; (index < camera_size) && (result == 0); index++)
+    {
+        /* Create pipeline (at the resolution admitted by the resource budget) */
+        if (gst_get_camera_pipeline(cameras[index], pipeline,
+                                    camera_get_width(cameras[index]),
+                                    camera_get_height(cameras[index])) == TRUE)
+        {
+            captures[index] = capture_create(cameras[index], pipeline);
+        }
+
+        /* Follow network conditions reported by clients */
+        if (captures[index] != NULL)
+        {
+            param_get_bitrate_range(&min_bitrate, &max_bitrate);
+            capture_enable_abr(captures[index], param_get_abr_policy(),
+                               (guint)min_bitrate, (guint)max_bitrate);
+        }
+
+        /* Isolate slow clients: bounded queue per RTSP session */
+        if (captures[index] != NULL)
+        {
+            capture_set_session_queue(captures[index], param_get_slow_client_policy(),
+                                      (gsize)param_get_session_queue() * 1024);
+        }
+
+        /* Send RTP packets of media in paced batches (see "rtppace.h") */
+        if ((captures[index] != NULL) && (egress_batch > 0))
+        {
+            capture_set_pacing(captures[index], (guint)param_get_pacing(), (guint)egress_batch);
+        }
+
+        /* Log frame rate and latency of streams (see "script/bench_outdoor.sh") */
+        if ((captures[index] != NULL) && (param_get_stats_interval() > 0))
+        {
+            capture_enable_stats(captures[index], (guint)param_get_stats_interval());
+        }
 
-        /* Set port for RTSP server
-         *
-         * We needn't set IP address for it. By default, it will listen for incoming
-         * connecting from address 0.0.0.0. In the context of servers, 0.0.0.0 means all
-         * IPv4 addresses on the local machine. If a host has two IP addresses, 192.168.1.1
-         * and 10.1.2.1, and a server running on the host listens on 0.0.0.0,
-         * it will be reachable at both of those IPs.*/
-        port_str = g_strdup_printf("%d", ports[index]);
-        gst_rtsp_server_set_service(server, port_str);
+        /* Stamp capture times of frames (glass-to-glass latency, see "basephone/latency.h") */
+        if ((captures[index] != NULL) && param_is_latency_stamp_enabled())
+        {
+            capture_enable_stamp(captures[index]);
+        }
 
-        /* Get default GstRTSPMountPoints from "server" */
-        mounts = gst_rtsp_server_get_mount_points(server);
+        /* Instrument the camera pipeline and the RTSP media of its clients (see "profile.h") */
+        if ((captures[index] != NULL) && (profile != NULL))
+        {
+            capture_enable_profile(captures[index], profile);
+        }
 
-        /* Create pipeline */
-        if(gst_get_camera_pipeline(cameras[index], pipeline, width, height) == TRUE)
+        /* Packetize sample videos once (before their media factories are created) */
+        if ((captures[index] != NULL) && param_is_rtp_cache_enabled())
         {
-            /* Create a new GstRTSPMediaFactory instance */
-            factory = gst_rtsp_media_factory_new();
+            capture_enable_replay(captures[index]);
+        }
 
-            /* Create an RTP feed of a camera playback */
-            gst_rtsp_media_factory_set_launch(factory, pipeline);
+        /* Pre-roll the camera so that the first client does not wait for it */
+        if ((captures[index] != NULL) && param_is_keep_warm_enabled())
+        {
+            capture_set_keep_warm(captures[index], TRUE);
+        }
+
+        /* Publish main stream and substream. Cameras without substream
+         * serve their main stream at the substream's URL as well */
+        if ((captures[index] == NULL) ||
+            (server_add_stream(server, capture_create_factory(captures[index], CAPTURE_TIER_MAIN),
+                               capture_create_factory(captures[index], CAPTURE_TIER_SUB)) != TRUE))
+        {
+            result = -1;
+        }
+    }
 
-            /* Share the pipeline between clients. If it is not set, both USB and
-             * MIPI camera will fail if a client tries to access their URLs when they are
-             * being used by other client */
-            gst_rtsp_media_factory_set_shared(factory, TRUE);
+    /* Split the uplink bitrate between cameras */
+    if ((result == 0) && (param_get_uplink_bitrate() > 0))
+    {
+        allocator = allocator_create((guint)param_get_uplink_bitrate(), (guint)min_bitrate,
+                                     (guint)max_bitrate, (guint)param_get_boost_cooldown());
 
-            /* Attach the pipeline to new URL */
-            gst_rtsp_mount_points_add_factory(mounts, "/camera", factory);
+        for (index = 0; index < camera_size; index++)
+        {
+            allocator_add(allocator, captures[index]);
+        }
 
-            /* Attach the server to the default main context */
-            gst_rtsp_server_attach (server, NULL);
+        allocator_rebalance(allocator, "startup");
 
-            g_message("Stream is ready at: \"rtsp://<IP address>:%s/camera\"", port_str);
-        } else {
-            return -1;
+        /* Receive doorbell/motion events */
+        if (param_get_control_socket()[0] != '\0')
+        {
+            control = control_create(param_get_control_socket(), allocator_handle_command, allocator);
         }
+    }
 
-        /* Don't need the ref to the mapper anymore */
-        g_object_unref (mounts);
+    /* Publish metrics of streams (see "metrics.h") */
+    if ((result == 0) && (param_get_metrics_port() > 0))
+    {
+        metrics = metrics_create(param_get_metrics_port(), server);
 
-        /* Free resources */
-        g_free(port_str);
+        for (index = 0; (metrics != NULL) && (index < camera_size); index++)
+        {
+            metrics_add(metrics, captures[index]);
+        }
     }
 
-    /* Start main loop */
-    g_main_loop_run (loop);
+    if (result == 0)
+    {
+        /* Attach the server(s) to the default main context */
+        server_attach(server, NULL);
+
+        /* Start main loop */
+        g_main_loop_run (loop);
+    }
 
     /* De-initialize variables */
+    if (metrics != NULL)
+    {
+        metrics_free(metrics);
+    }
+
+    if (control != NULL)
+    {
+        control_free(control);
+    }
+
+    if (allocator != NULL)
+    {
+        allocator_free(allocator);
+    }
+
+    server_free(server);
+
+    for (index = 0; index < camera_size; index++)
+    {
+        if (captures[index] != NULL)
+        {
+            capture_free(captures[index]);
+        }
+    }
+
+    g_free(captures);
+
+    /* After pipelines: they use the profiler */
+    if (profile != NULL)
+    {
+        profile_free(profile);
+    }
+
     param_free();
 
-    return 0;
+    return result;
 }
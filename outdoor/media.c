@@ -0,0 +1,709 @@
+/***********************************************************************
+ * FILENAME: media.c
+ *
+ * DESCRIPTION:
+ *   Media controller pipeline setup.
+ *
+ * NOTE:
+ *   For more further information about datatypes and function usages,
+ *   please refer to "media.h".
+ *
+ * AUTHOR: RVC       START DATE: 17/10/2026
+ *
+ * CHANGES:
+ *
+ ***********************************************************************/
+
+/* ---------- Header files ---------- */
+
+#include <glib.h>
+#include <glib/gprintf.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+
+#include <linux/media.h>
+#include <linux/media-bus-format.h>
+#include <linux/videodev2.h>
+#include <linux/v4l2-subdev.h>
+
+#include "media.h"
+#include "media_mock.h"
+
+/* ---------- Macros ---------- */
+
+/* Error domain of "media_setup()". Error codes are "errno" values */
+#define MEDIA_ERROR g_quark_from_static_string("media-error")
+
+/* Maximum length of the description of a step (used in logs and errors) */
+#define MEDIA_STEP_STR_LENGTH 128
+
+/* ---------- Datatypes ---------- */
+
+/*
+ * Struct: media_context_t
+ * ---
+ *   Represents an opened media device:
+ *     - backend (struct media_backend_t): System calls (real or mock).
+ *     - fd (gint): File descriptor of the media device.
+ *     - entities (array of "struct media_entity_desc"): Entities of the media device.
+ */
+struct media_context_t
+{
+    const struct media_backend_t *backend;
+
+    gint fd;
+
+    GArray *entities;
+};
+
+/*
+ * Struct: media_bus_format_t
+ * ---
+ *   Represents the name of a media bus format (as used by "media-ctl"):
+ *     - code (guint32): Media bus format code.
+ *     - name (string): Name without "MEDIA_BUS_FMT_" prefix.
+ */
+struct media_bus_format_t
+{
+    guint32 code;
+
+    const gchar *name;
+};
+
+/* ---------- Private functions ---------- */
+
+/*
+ * Function: media_sys_open, media_sys_ioctl, media_sys_close, media_sys_get_devnode
+ * ---
+ *   System calls of the real backend. "media_sys_ioctl" retries on EINTR.
+ *   "media_sys_get_devnode" follows "/sys/dev/char/<major>:<minor>".
+ */
+static gint media_sys_open(const gchar *path, gint flags);
+static gint media_sys_ioctl(gint fd, gulong request, gpointer arg);
+static gint media_sys_close(gint fd);
+static gchar *media_sys_get_devnode(guint major, guint minor);
+
+/*
+ * Function: media_step_to_string
+ * ---
+ *   Describe "step" in "media-ctl" syntax (such as: "'ov5645 3-003c':0 [fmt:UYVY8_2X8/1280x960]").
+ *
+ *   return: void.
+ */
+static void media_step_to_string(const struct media_step_t *step, gchar *str, const gsize size);
+
+/*
+ * Function: media_bus_format_to_string
+ * ---
+ *   Get the "media-ctl" name of a media bus format.
+ *
+ *   return: NULL if the format is not in "media_bus_formats" array.
+ */
+static const gchar* media_bus_format_to_string(const guint32 code);
+
+/*
+ * Function: media_enum_entities
+ * ---
+ *   Collect all entities of the media device into "media_context_t::entities".
+ *
+ *   return: TRUE (success), FALSE ("error" is set).
+ */
+static gboolean media_enum_entities(struct media_context_t *context, GError **error);
+
+/*
+ * Function: media_find_entity
+ * ---
+ *   Find an entity by name.
+ *
+ *   return: NULL if not found.
+ */
+static const struct media_entity_desc *media_find_entity(const struct media_context_t *context,
+                                                         const gchar *name);
+
+/*
+ * Function: media_reset_links
+ * ---
+ *   Disable all enabled links which are not immutable (MEDIA_STEP_RESET).
+ *
+ *   return: TRUE (success), FALSE ("error" is set).
+ */
+static gboolean media_reset_links(struct media_context_t *context, const gint index,
+                                  GError **error);
+
+/*
+ * Function: media_enable_link
+ * ---
+ *   Enable the link of "step" (MEDIA_STEP_LINK).
+ *
+ *   return: TRUE (success), FALSE ("error" is set).
+ */
+static gboolean media_enable_link(struct media_context_t *context, const struct media_step_t *step,
+                                  const gint index, GError **error);
+
+/*
+ * Function: media_set_format
+ * ---
+ *   Set the active format of the pad of "step" through its subdevice node (MEDIA_STEP_FORMAT).
+ *   If the driver adjusts the format, a warning is logged.
+ *
+ *   return: TRUE (success), FALSE ("error" is set).
+ */
+static gboolean media_set_format(struct media_context_t *context, const struct media_step_t *step,
+                                 const gint index, GError **error);
+
+/*
+ * Function: media_setup_ioctl
+ * ---
+ *   Applies "steps" with media controller and V4L2 subdev ioctls.
+ *
+ *   return: TRUE (success), FALSE ("error" is set).
+ */
+static gboolean media_setup_ioctl(const gchar *device, const struct media_step_t *steps,
+                                  const struct media_backend_t *backend, GError **error);
+
+/*
+ * Function: media_setup_media_ctl
+ * ---
+ *   Applies "steps" with one "media-ctl" command per step.
+ *
+ *   return: TRUE (success), FALSE ("error" is set).
+ */
+static gboolean media_setup_media_ctl(const gchar *device, const struct media_step_t *steps,
+                                      GError **error);
+
+/* ---------- Private variables ---------- */
+
+const struct media_backend_t media_sys_backend =
+{
+    .name = "ioctl",
+    .open = media_sys_open,
+    .ioctl = media_sys_ioctl,
+    .close = media_sys_close,
+    .get_devnode = media_sys_get_devnode
+};
+
+const struct media_bus_format_t media_bus_formats[] =
+{
+    { MEDIA_BUS_FMT_UYVY8_2X8, "UYVY8_2X8" },
+    { MEDIA_BUS_FMT_YUYV8_2X8, "YUYV8_2X8" },
+    { MEDIA_BUS_FMT_UYVY8_1X16, "UYVY8_1X16" },
+    { MEDIA_BUS_FMT_YUYV8_1X16, "YUYV8_1X16" },
+    { MEDIA_BUS_FMT_RGB888_1X24, "RGB888_1X24" }
+};
+
+/* ---------- Private functions ---------- */
+
+gint media_sys_open(const gchar *path, gint flags)
+{
+    return open(path, flags);
+}
+
+gint media_sys_ioctl(gint fd, gulong request, gpointer arg)
+{
+    gint result = 0;
+
+    do
+    {
+        result = ioctl(fd, request, arg);
+    }
+    while ((result == -1) && (errno == EINTR));
+
+    return result;
+}
+
+gint media_sys_close(gint fd)
+{
+    return close(fd);
+}
+
+gchar *media_sys_get_devnode(guint major, guint minor)
+{
+    gchar sys_path[50];
+    gchar *target = NULL;
+    gchar *name = NULL;
+    gchar *devnode = NULL;
+
+    /* Such as: "/sys/dev/char/81:3" -> "../../devices/.../video4linux/v4l-subdev3" */
+    g_snprintf(sys_path, sizeof(sys_path), "/sys/dev/char/%u:%u", major, minor);
+
+    target = g_file_read_link(sys_path, NULL);
+    if (target != NULL)
+    {
+        name = g_path_get_basename(target);
+        devnode = g_strdup_printf("/dev/%s", name);
+
+        /* Free resources */
+        g_free(name);
+        g_free(target);
+    }
+
+    return devnode;
+}
+
+const gchar* media_bus_format_to_string(const guint32 code)
+{
+    guint index = 0;
+
+    for (index = 0; index < G_N_ELEMENTS(media_bus_formats); index++)
+    {
+        if (media_bus_formats[index].code == code)
+        {
+            return media_bus_formats[index].name;
+        }
+    }
+
+    return NULL;
+}
+
+void media_step_to_string(const struct media_step_t *step, gchar *str, const gsize size)
+{
+    const gchar *code = NULL;
+
+    switch (step->type)
+    {
+        case MEDIA_STEP_RESET:
+            g_snprintf(str, size, "reset");
+        break;
+
+        case MEDIA_STEP_LINK:
+            g_snprintf(str, size, "'%s':%u -> '%s':%u [1]",
+                       step->entity, step->pad, step->sink, step->sink_pad);
+        break;
+
+        case MEDIA_STEP_FORMAT:
+            code = media_bus_format_to_string(step->code);
+
+            if (code != NULL)
+            {
+                g_snprintf(str, size, "'%s':%u [fmt:%s/%ux%u field:none]",
+                           step->entity, step->pad, code, step->width, step->height);
+            }
+            else
+            {
+                g_snprintf(str, size, "'%s':%u [fmt:0x%04x/%ux%u field:none]",
+                           step->entity, step->pad, step->code, step->width, step->height);
+            }
+        break;
+
+        default:
+            g_snprintf(str, size, "end");
+        break;
+    }
+}
+
+gboolean media_enum_entities(struct media_context_t *context, GError **error)
+{
+    struct media_entity_desc entity;
+    guint32 id = 0;
+
+    while (TRUE)
+    {
+        memset(&entity, 0, sizeof(entity));
+        entity.id = id | MEDIA_ENT_ID_FLAG_NEXT;
+
+        if (context->backend->ioctl(context->fd, MEDIA_IOC_ENUM_ENTITIES, &entity) == -1)
+        {
+            /* EINVAL means that there is no entity after "id" */
+            if (errno == EINVAL)
+            {
+                break;
+            }
+
+            g_set_error(error, MEDIA_ERROR, errno, "Failed to enumerate entities after %u: %s",
+                        id, g_strerror(errno));
+            return FALSE;
+        }
+
+        id = entity.id;
+        g_array_append_val(context->entities, entity);
+    }
+
+    g_debug("Info: Media device has %u entities", context->entities->len);
+
+    return TRUE;
+}
+
+const struct media_entity_desc *media_find_entity(const struct media_context_t *context,
+                                                  const gchar *name)
+{
+    const struct media_entity_desc *entity = NULL;
+    guint index = 0;
+
+    for (index = 0; index < context->entities->len; index++)
+    {
+        entity = &g_array_index(context->entities, struct media_entity_desc, index);
+
+        if (strncmp(entity->name, name, sizeof(entity->name)) == 0)
+        {
+            return entity;
+        }
+    }
+
+    return NULL;
+}
+
+gboolean media_reset_links(struct media_context_t *context, const gint index, GError **error)
+{
+    const struct media_entity_desc *entity = NULL;
+    struct media_links_enum links_enum;
+    struct media_link_desc *link = NULL;
+
+    gboolean result = TRUE;
+    guint entity_index = 0;
+    guint link_index = 0;
+
+    for (entity_index = 0; result && (entity_index < context->entities->len); entity_index++)
+    {
+        entity = &g_array_index(context->entities, struct media_entity_desc, entity_index);
+        if (entity->links == 0)
+        {
+            continue;
+        }
+
+        memset(&links_enum, 0, sizeof(links_enum));
+        links_enum.entity = entity->id;
+        links_enum.pads = g_new0(struct media_pad_desc, MAX(entity->pads, 1));
+        links_enum.links = g_new0(struct media_link_desc, entity->links);
+
+        if (context->backend->ioctl(context->fd, MEDIA_IOC_ENUM_LINKS, &links_enum) == -1)
+        {
+            g_set_error(error, MEDIA_ERROR, errno, "Step %d (reset): failed to enumerate links of '%s': %s",
+                        index, entity->name, g_strerror(errno));
+            result = FALSE;
+        }
+
+        /* Outbound links only, so that every link is seen once */
+        for (link_index = 0; result && (link_index < entity->links); link_index++)
+        {
+            link = &links_enum.links[link_index];
+
+            if ((link->source.entity != entity->id) ||
+                ((link->flags & MEDIA_LNK_FL_ENABLED) == 0) ||
+                ((link->flags & MEDIA_LNK_FL_IMMUTABLE) != 0))
+            {
+                continue;
+            }
+
+            link->flags &= ~MEDIA_LNK_FL_ENABLED;
+
+            if (context->backend->ioctl(context->fd, MEDIA_IOC_SETUP_LINK, link) == -1)
+            {
+                g_set_error(error, MEDIA_ERROR, errno, "Step %d (reset): failed to disable link '%s':%u -> %u:%u: %s",
+                            index, entity->name, link->source.index, link->sink.entity,
+                            link->sink.index, g_strerror(errno));
+                result = FALSE;
+            }
+            else
+            {
+                g_debug("Info: Disabled link '%s':%u -> %u:%u", entity->name, link->source.index,
+                        link->sink.entity, link->sink.index);
+            }
+        }
+
+        /* Free resources */
+        g_free(links_enum.pads);
+        g_free(links_enum.links);
+    }
+
+    return result;
+}
+
+gboolean media_enable_link(struct media_context_t *context, const struct media_step_t *step,
+                           const gint index, GError **error)
+{
+    const struct media_entity_desc *source = NULL;
+    const struct media_entity_desc *sink = NULL;
+    struct media_link_desc link;
+
+    gchar step_str[MEDIA_STEP_STR_LENGTH];
+
+    media_step_to_string(step, step_str, sizeof(step_str));
+
+    source = media_find_entity(context, step->entity);
+    sink = media_find_entity(context, step->sink);
+
+    if ((source == NULL) || (sink == NULL))
+    {
+        g_set_error(error, MEDIA_ERROR, ENOENT, "Step %d (link %s): entity '%s' not found",
+                    index, step_str, (source == NULL) ? step->entity : step->sink);
+        return FALSE;
+    }
+
+    memset(&link, 0, sizeof(link));
+    link.source.entity = source->id;
+    link.source.index = step->pad;
+    link.source.flags = MEDIA_PAD_FL_SOURCE;
+    link.sink.entity = sink->id;
+    link.sink.index = step->sink_pad;
+    link.sink.flags = MEDIA_PAD_FL_SINK;
+    link.flags = MEDIA_LNK_FL_ENABLED;
+
+    if (context->backend->ioctl(context->fd, MEDIA_IOC_SETUP_LINK, &link) == -1)
+    {
+        g_set_error(error, MEDIA_ERROR, errno, "Step %d (link %s): %s",
+                    index, step_str, g_strerror(errno));
+        return FALSE;
+    }
+
+    g_debug("Info: Enabled link %s", step_str);
+
+    return TRUE;
+}
+
+gboolean media_set_format(struct media_context_t *context, const struct media_step_t *step,
+                          const gint index, GError **error)
+{
+    const struct media_entity_desc *entity = NULL;
+    struct v4l2_subdev_format format;
+
+    gchar step_str[MEDIA_STEP_STR_LENGTH];
+    gchar *devnode = NULL;
+    gint fd = -1;
+    gint err_code = 0;
+
+    media_step_to_string(step, step_str, sizeof(step_str));
+
+    entity = media_find_entity(context, step->entity);
+    if (entity == NULL)
+    {
+        g_set_error(error, MEDIA_ERROR, ENOENT, "Step %d (format %s): entity '%s' not found",
+                    index, step_str, step->entity);
+        return FALSE;
+    }
+
+    /* Formats are set on the subdevice node of the entity (such as: "/dev/v4l-subdev2") */
+    devnode = context->backend->get_devnode(entity->dev.major, entity->dev.minor);
+    if (devnode == NULL)
+    {
+        g_set_error(error, MEDIA_ERROR, ENODEV, "Step %d (format %s): no subdevice node for %u:%u",
+                    index, step_str, entity->dev.major, entity->dev.minor);
+        return FALSE;
+    }
+
+    fd = context->backend->open(devnode, O_RDWR);
+    if (fd == -1)
+    {
+        err_code = errno;
+        g_set_error(error, MEDIA_ERROR, err_code, "Step %d (format %s): failed to open '%s': %s",
+                    index, step_str, devnode, g_strerror(err_code));
+        g_free(devnode);
+        return FALSE;
+    }
+
+    memset(&format, 0, sizeof(format));
+    format.which = V4L2_SUBDEV_FORMAT_ACTIVE;
+    format.pad = step->pad;
+    format.format.code = step->code;
+    format.format.width = step->width;
+    format.format.height = step->height;
+    format.format.field = V4L2_FIELD_NONE;
+
+    if (context->backend->ioctl(fd, VIDIOC_SUBDEV_S_FMT, &format) == -1)
+    {
+        err_code = errno;
+        g_set_error(error, MEDIA_ERROR, err_code, "Step %d (format %s on '%s'): %s",
+                    index, step_str, devnode, g_strerror(err_code));
+    }
+    else if ((format.format.code != step->code) || (format.format.width != step->width) ||
+             (format.format.height != step->height))
+    {
+        /* Same as "media-ctl": the driver chose the closest format, keep going */
+        g_message("Warning: Format %s adjusted by the driver to 0x%04x/%ux%u",
+                  step_str, format.format.code, format.format.width, format.format.height);
+    }
+    else
+    {
+        g_debug("Info: Set format %s (%s)", step_str, devnode);
+    }
+
+    /* Free resources */
+    context->backend->close(fd);
+    g_free(devnode);
+
+    return (err_code == 0);
+}
+
+gboolean media_setup_ioctl(const gchar *device, const struct media_step_t *steps,
+                           const struct media_backend_t *backend, GError **error)
+{
+    struct media_context_t context;
+    gboolean result = TRUE;
+    gint index = 0;
+
+    context.backend = backend;
+    context.fd = backend->open(device, O_RDWR);
+
+    if (context.fd == -1)
+    {
+        g_set_error(error, MEDIA_ERROR, errno, "Failed to open '%s': %s",
+                    device, g_strerror(errno));
+        return FALSE;
+    }
+
+    context.entities = g_array_new(FALSE, TRUE, sizeof(struct media_entity_desc));
+
+    result = media_enum_entities(&context, error);
+
+    for (index = 0; result && (steps[index].type != MEDIA_STEP_END); index++)
+    {
+        switch (steps[index].type)
+        {
+            case MEDIA_STEP_RESET:
+                result = media_reset_links(&context, index, error);
+            break;
+
+            case MEDIA_STEP_LINK:
+                result = media_enable_link(&context, &steps[index], index, error);
+            break;
+
+            case MEDIA_STEP_FORMAT:
+                result = media_set_format(&context, &steps[index], index, error);
+            break;
+
+            default:
+                g_set_error(error, MEDIA_ERROR, EINVAL, "Step %d: unknown type %d",
+                            index, steps[index].type);
+                result = FALSE;
+            break;
+        }
+    }
+
+    /* Free resources */
+    g_array_free(context.entities, TRUE);
+    backend->close(context.fd);
+
+    return result;
+}
+
+gboolean media_setup_media_ctl(const gchar *device, const struct media_step_t *steps,
+                               GError **error)
+{
+    gchar step_str[MEDIA_STEP_STR_LENGTH];
+    gchar *command = NULL;
+    gint exec_code = 0;
+    gint index = 0;
+
+    for (index = 0; steps[index].type != MEDIA_STEP_END; index++)
+    {
+        media_step_to_string(&steps[index], step_str, sizeof(step_str));
+
+        switch (steps[index].type)
+        {
+            case MEDIA_STEP_RESET:
+                command = g_strdup_printf("media-ctl -d %s -r", device);
+            break;
+
+            case MEDIA_STEP_LINK:
+                command = g_strdup_printf("media-ctl -d %s -l \"%s\"", device, step_str);
+            break;
+
+            default:
+                command = g_strdup_printf("media-ctl -d %s -V \"%s\"", device, step_str);
+            break;
+        }
+
+        exec_code = system(command);
+        if (exec_code != 0)
+        {
+            g_set_error(error, MEDIA_ERROR, exec_code, "Step %d: command '%s' failed (status %d)",
+                        index, command, exec_code);
+            g_free(command);
+
+            return FALSE;
+        }
+
+        g_free(command);
+    }
+
+    return TRUE;
+}
+
+/* ---------- Public functions ---------- */
+
+gboolean media_setup(const gchar *device, const struct media_step_t *steps,
+                     const enum media_method_t method, GError **error)
+{
+    const struct media_backend_t *backend = &media_sys_backend;
+    const gchar *mock_platform = media_get_mock_platform();
+
+    /* Check parameter(s) */
+    g_return_val_if_fail((device != NULL) && (steps != NULL), FALSE);
+
+    if (mock_platform != NULL)
+    {
+        backend = media_mock_get_backend(mock_platform);
+
+        if (backend == NULL)
+        {
+            g_set_error(error, MEDIA_ERROR, ENODEV, "No mock media device for platform '%s'",
+                        mock_platform);
+            return FALSE;
+        }
+
+        if (method != MEDIA_METHOD_IOCTL)
+        {
+            g_set_error(error, MEDIA_ERROR, ENOTSUP, "Mock media device does not support %s",
+                        media_method_to_string(method));
+            return FALSE;
+        }
+    }
+
+    if (method == MEDIA_METHOD_MEDIA_CTL)
+    {
+        return media_setup_media_ctl(device, steps, error);
+    }
+
+    return media_setup_ioctl(device, steps, backend, error);
+}
+
+const gchar* media_get_mock_platform()
+{
+    const gchar *platform = g_getenv(MEDIA_MOCK_ENV);
+
+    return ((platform != NULL) && (platform[0] != '\0')) ? platform : NULL;
+}
+
+const gchar* media_method_to_string(const enum media_method_t method)
+{
+    const gchar* result = "";
+
+    switch (method)
+    {
+        case MEDIA_METHOD_IOCTL:
+            result = "ioctl";
+        break;
+
+        case MEDIA_METHOD_MEDIA_CTL:
+            result = "media-ctl";
+        break;
+
+        default:
+            result = "unknown";
+        break;
+    }
+
+    return result;
+}
+
+enum media_method_t media_method_from_string(const gchar *str)
+{
+    enum media_method_t method = MEDIA_METHOD_UNKNOWN;
+
+    /* Check parameter(s) */
+    g_return_val_if_fail(str != NULL, MEDIA_METHOD_UNKNOWN);
+
+    if (g_ascii_strcasecmp(str, "ioctl") == 0)
+    {
+        method = MEDIA_METHOD_IOCTL;
+    }
+    else if (g_ascii_strcasecmp(str, "media-ctl") == 0)
+    {
+        method = MEDIA_METHOD_MEDIA_CTL;
+    }
+
+    return method;
+}
@@ -0,0 +1,177 @@
+/***********************************************************************
+ * FILENAME: media.h
+ *
+ * DESCRIPTION:
+ *   Contains APIs to configure the media controller pipeline of a
+ *   camera (links and formats of V4L2 subdevices).
+ *
+ * PUBLIC FUNCTIONS:
+ *   gboolean media_setup(const gchar *device, const struct media_step_t *steps,
+ *                        const enum media_method_t method, GError **error);
+ *
+ *   const gchar* media_get_mock_platform();
+ *
+ *   const gchar* media_method_to_string(const enum media_method_t method);
+ *
+ *   enum media_method_t media_method_from_string(const gchar *str);
+ *
+ * AUTHOR: RVC       START DATE: 17/10/2026
+ *
+ * CHANGES:
+ *
+ ***********************************************************************/
+
+#ifndef _MEDIA_H_
+#define _MEDIA_H_
+
+/* ---------- Macros ---------- */
+
+/* Environment variable which replaces the media device by an in-memory mock.
+ * Its value is the platform to emulate (such as: "ek874", "hihope-rzg2m") */
+#define MEDIA_MOCK_ENV "OUTDOOR_MEDIA_MOCK"
+
+/* Maximum length of entity names (see "struct media_entity_desc") */
+#define MEDIA_ENTITY_NAME_LENGTH 32
+
+/* ---------- Datatypes ---------- */
+
+/*
+ * Enum: media_method_t
+ * ---
+ *   Represents how the steps are applied:
+ *     - MEDIA_METHOD_IOCTL: Media controller and V4L2 subdev ioctls (in-process).
+ *     - MEDIA_METHOD_MEDIA_CTL: One "media-ctl" command per step (forks a shell).
+ *     - MEDIA_METHOD_UNKNOWN: Indicate that the method is invalid.
+ */
+enum media_method_t
+{
+    MEDIA_METHOD_IOCTL,
+    MEDIA_METHOD_MEDIA_CTL,
+    MEDIA_METHOD_UNKNOWN
+};
+
+/*
+ * Enum: media_step_type_t
+ * ---
+ *   Represents a step of the media pipeline setup:
+ *     - MEDIA_STEP_RESET: Disable all links which are not immutable ("media-ctl -r").
+ *     - MEDIA_STEP_LINK: Enable a link ("media-ctl -l").
+ *     - MEDIA_STEP_FORMAT: Set the format of a subdevice pad ("media-ctl -V").
+ *     - MEDIA_STEP_END: Indicate the end of a step array.
+ */
+enum media_step_type_t
+{
+    MEDIA_STEP_RESET,
+    MEDIA_STEP_LINK,
+    MEDIA_STEP_FORMAT,
+    MEDIA_STEP_END
+};
+
+/*
+ * Struct: media_step_t
+ * ---
+ *   Represents a step of the media pipeline setup:
+ *     - type (enum media_step_type_t): What the step does.
+ *     - entity (string), pad (guint): Source pad of the link, or pad of the format.
+ *     - sink (string), sink_pad (guint): Sink pad of the link (MEDIA_STEP_LINK only).
+ *     - code (guint32): Media bus format, such as: MEDIA_BUS_FMT_UYVY8_2X8 (MEDIA_STEP_FORMAT only).
+ *     - width, height (guint): Frame size (MEDIA_STEP_FORMAT only). The field order is "none".
+ */
+struct media_step_t
+{
+    enum media_step_type_t type;
+
+    const gchar *entity;
+
+    guint pad;
+
+    const gchar *sink;
+
+    guint sink_pad;
+
+    guint32 code;
+
+    guint width;
+
+    guint height;
+};
+
+/*
+ * Struct: media_backend_t
+ * ---
+ *   Represents the system calls used to access media and subdevice nodes,
+ *   so that they can be replaced by a mock (see "media_mock.h"):
+ *     - name (string): Name of the backend (used in logs).
+ *     - open, ioctl, close (functions): Same as the system calls ("errno" is set on failure).
+ *     - get_devnode (function): Path of the device node of a character device
+ *       (such as: "/dev/v4l-subdev2"), NULL if not found. Should be freed by "g_free()".
+ */
+struct media_backend_t
+{
+    const gchar *name;
+
+    gint (*open)(const gchar *path, gint flags);
+
+    gint (*ioctl)(gint fd, gulong request, gpointer arg);
+
+    gint (*close)(gint fd);
+
+    gchar *(*get_devnode)(guint major, guint minor);
+};
+
+/* ---------- Functions ---------- */
+
+/*
+ * Function: media_setup
+ * ---
+ *   Applies "steps" to media device "device" (such as: "/dev/media0"), in order.
+ *   Entities are found by name. The pipeline is left as it is at the failed step.
+ *
+ *   device: Path of the media device.
+ *   steps: Array of steps, terminated by MEDIA_STEP_END.
+ *   method: In-process ioctls or "media-ctl" commands.
+ *   error: Which step failed, on which entity, and why. Its code is "errno" (ioctls)
+ *          or the exit status of the command ("media-ctl").
+ *
+ *   Note: If "MEDIA_MOCK_ENV" is set, ioctls are sent to an in-memory media device
+ *         (only MEDIA_METHOD_IOCTL is supported).
+ *
+ *   return: TRUE (all steps succeeded).
+ *           FALSE (a step failed, "error" is set).
+ */
+gboolean media_setup(const gchar *device, const struct media_step_t *steps,
+                     const enum media_method_t method, GError **error);
+
+/*
+ * Function: media_get_mock_platform
+ * ---
+ *   Get the platform emulated by the mock media device.
+ *
+ *   Note: The output string must not be de-allocated or modified.
+ *
+ *   return: NULL (the real media device is used).
+ *           not NULL (value of "MEDIA_MOCK_ENV").
+ */
+const gchar* media_get_mock_platform();
+
+/*
+ * Function: media_method_to_string
+ * ---
+ *   Convert "enum media_method_t" to string.
+ *
+ *   Note: The output string must not be de-allocated or modified.
+ *
+ *   return: String (method).
+ */
+const gchar* media_method_to_string(const enum media_method_t method);
+
+/*
+ * Function: media_method_from_string
+ * ---
+ *   Convert string to "enum media_method_t".
+ *
+ *   return: MEDIA_METHOD_UNKNOWN if "str" is not a valid method.
+ */
+enum media_method_t media_method_from_string(const gchar *str);
+
+#endif
@@ -0,0 +1,455 @@
+/***********************************************************************
+ * FILENAME: media_mock.c
+ *
+ * DESCRIPTION:
+ *   In-memory media device.
+ *
+ * NOTE:
+ *   For more further information about datatypes and function usages,
+ *   please refer to "media_mock.h".
+ *
+ * AUTHOR: RVC       START DATE: 17/10/2026
+ *
+ * CHANGES:
+ *
+ ***********************************************************************/
+
+/* ---------- Header files ---------- */
+
+#include <glib.h>
+#include <glib/gprintf.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+
+#include <linux/media.h>
+#include <linux/media-bus-format.h>
+#include <linux/videodev2.h>
+#include <linux/v4l2-subdev.h>
+
+#include "media.h"
+#include "media_mock.h"
+
+/* ---------- Macros ---------- */
+
+/* File descriptors returned by the mock: the media device, and subdevices (base + entity ID) */
+#define MEDIA_MOCK_MEDIA_FD 100
+#define MEDIA_MOCK_SUBDEV_FD 200
+
+/* Major number of V4L2 devices. Minor numbers of the mock are entity IDs */
+#define MEDIA_MOCK_MAJOR 81
+
+/* Sizes of the topology */
+#define MEDIA_MOCK_ENTITY_COUNTS 4
+#define MEDIA_MOCK_LINK_COUNTS 3
+#define MEDIA_MOCK_MAX_PADS 5
+
+/* Largest frame of the "ov5645" sensor */
+#define MEDIA_MOCK_MAX_WIDTH 2592
+#define MEDIA_MOCK_MAX_HEIGHT 1944
+
+/* ---------- Datatypes ---------- */
+
+/*
+ * Struct: media_mock_entity_t
+ * ---
+ *   Represents an entity of the mock:
+ *     - name (string): Entity name.
+ *     - function (guint32): Entity function (MEDIA_ENT_F_*).
+ *     - pad_counts (guint): The number of pads.
+ *     - sink_pads (guint): Bitmask of sink pads (the others are source pads).
+ *     - formats (array of "struct v4l2_mbus_framefmt"): Active format of each pad.
+ */
+struct media_mock_entity_t
+{
+    gchar name[MEDIA_ENTITY_NAME_LENGTH];
+
+    guint32 function;
+
+    guint pad_counts;
+
+    guint sink_pads;
+
+    struct v4l2_mbus_framefmt formats[MEDIA_MOCK_MAX_PADS];
+};
+
+/*
+ * Struct: media_mock_link_t
+ * ---
+ *   Represents a link of the mock (entity IDs start from 1):
+ *     - source, source_pad (guint): Source entity and pad.
+ *     - sink, sink_pad (guint): Sink entity and pad.
+ *     - flags (guint32): MEDIA_LNK_FL_* flags.
+ */
+struct media_mock_link_t
+{
+    guint source;
+
+    guint source_pad;
+
+    guint sink;
+
+    guint sink_pad;
+
+    guint32 flags;
+};
+
+/* ---------- Private functions ---------- */
+
+/*
+ * Function: media_mock_open, media_mock_ioctl, media_mock_close, media_mock_get_devnode
+ * ---
+ *   System calls of the mock backend (see "media_backend_t").
+ */
+static gint media_mock_open(const gchar *path, gint flags);
+static gint media_mock_ioctl(gint fd, gulong request, gpointer arg);
+static gint media_mock_close(gint fd);
+static gchar *media_mock_get_devnode(guint major, guint minor);
+
+/*
+ * Function: media_mock_enum_entities, media_mock_enum_links,
+ *           media_mock_setup_link, media_mock_set_format
+ * ---
+ *   Handlers of ioctls.
+ *
+ *   return: 0 (success), -1 ("errno" is set).
+ */
+static gint media_mock_enum_entities(struct media_entity_desc *desc);
+static gint media_mock_enum_links(struct media_links_enum *links_enum);
+static gint media_mock_setup_link(struct media_link_desc *desc);
+static gint media_mock_set_format(const guint id, struct v4l2_subdev_format *format);
+
+/*
+ * Function: media_mock_reset
+ * ---
+ *   Create the topology of "platform".
+ *
+ *   return: FALSE if the platform is unknown.
+ */
+static gboolean media_mock_reset(const gchar *platform);
+
+/* ---------- Private variables ---------- */
+
+const struct media_backend_t media_mock_backend =
+{
+    .name = "ioctl (mock)",
+    .open = media_mock_open,
+    .ioctl = media_mock_ioctl,
+    .close = media_mock_close,
+    .get_devnode = media_mock_get_devnode
+};
+
+/* Entity with ID "N" is at index "N - 1" */
+struct media_mock_entity_t media_mock_entities[MEDIA_MOCK_ENTITY_COUNTS];
+
+struct media_mock_link_t media_mock_links[MEDIA_MOCK_LINK_COUNTS];
+
+/* ---------- Private functions ---------- */
+
+gboolean media_mock_reset(const gchar *platform)
+{
+    const gchar *sensor = NULL;
+    const gchar *csi2 = NULL;
+    guint index = 0;
+
+    /* Same entity names as the device trees of the boards */
+    if (g_strcmp0(platform, "ek874") == 0)
+    {
+        sensor = "ov5645 3-003c";
+        csi2 = "rcar_csi2 feaa0000.csi2";
+    }
+    else if ((g_strcmp0(platform, "hihope-rzg2m") == 0) ||
+             (g_strcmp0(platform, "hihope-rzg2n") == 0) ||
+             (g_strcmp0(platform, "hihope-rzg2h") == 0))
+    {
+        sensor = "ov5645 2-003c";
+        csi2 = "rcar_csi2 fea80000.csi2";
+    }
+    else
+    {
+        return FALSE;
+    }
+
+    memset(media_mock_entities, 0, sizeof(media_mock_entities));
+
+    g_strlcpy(media_mock_entities[0].name, sensor, MEDIA_ENTITY_NAME_LENGTH);
+    media_mock_entities[0].function = MEDIA_ENT_F_CAM_SENSOR;
+    media_mock_entities[0].pad_counts = 1;
+    media_mock_entities[0].sink_pads = 0;
+
+    g_strlcpy(media_mock_entities[1].name, csi2, MEDIA_ENTITY_NAME_LENGTH);
+    media_mock_entities[1].function = MEDIA_ENT_F_VID_IF_BRIDGE;
+    media_mock_entities[1].pad_counts = 5;
+    media_mock_entities[1].sink_pads = 1 << 0;
+
+    g_strlcpy(media_mock_entities[2].name, "VIN4 output", MEDIA_ENTITY_NAME_LENGTH);
+    media_mock_entities[2].function = MEDIA_ENT_F_IO_V4L;
+    media_mock_entities[2].pad_counts = 1;
+    media_mock_entities[2].sink_pads = 1 << 0;
+
+    g_strlcpy(media_mock_entities[3].name, "VIN5 output", MEDIA_ENTITY_NAME_LENGTH);
+    media_mock_entities[3].function = MEDIA_ENT_F_IO_V4L;
+    media_mock_entities[3].pad_counts = 1;
+    media_mock_entities[3].sink_pads = 1 << 0;
+
+    /* Default format of the sensor after probing */
+    for (index = 0; index < MEDIA_MOCK_ENTITY_COUNTS; index++)
+    {
+        media_mock_entities[index].formats[0].code = MEDIA_BUS_FMT_UYVY8_2X8;
+        media_mock_entities[index].formats[0].width = 1920;
+        media_mock_entities[index].formats[0].height = 1080;
+        media_mock_entities[index].formats[0].field = V4L2_FIELD_NONE;
+    }
+
+    /* The sensor is wired to the receiver. "VIN5" was enabled by a previous run */
+    media_mock_links[0] = (struct media_mock_link_t){ 1, 0, 2, 0, MEDIA_LNK_FL_ENABLED | MEDIA_LNK_FL_IMMUTABLE };
+    media_mock_links[1] = (struct media_mock_link_t){ 2, 1, 3, 0, 0 };
+    media_mock_links[2] = (struct media_mock_link_t){ 2, 1, 4, 0, MEDIA_LNK_FL_ENABLED };
+
+    return TRUE;
+}
+
+gint media_mock_open(const gchar *path, gint flags)
+{
+    guint id = 0;
+
+    if (g_strcmp0(path, "/dev/media0") == 0)
+    {
+        return MEDIA_MOCK_MEDIA_FD;
+    }
+
+    if ((sscanf(path, "/dev/v4l-subdev%u", &id) == 1) &&
+        (id >= 1) && (id <= MEDIA_MOCK_ENTITY_COUNTS))
+    {
+        return MEDIA_MOCK_SUBDEV_FD + id;
+    }
+
+    errno = ENOENT;
+    return -1;
+}
+
+gint media_mock_close(gint fd)
+{
+    return 0;
+}
+
+gchar *media_mock_get_devnode(guint major, guint minor)
+{
+    if ((major != MEDIA_MOCK_MAJOR) || (minor < 1) || (minor > MEDIA_MOCK_ENTITY_COUNTS))
+    {
+        return NULL;
+    }
+
+    return g_strdup_printf("/dev/v4l-subdev%u", minor);
+}
+
+gint media_mock_enum_entities(struct media_entity_desc *desc)
+{
+    const struct media_mock_entity_t *entity = NULL;
+    guint id = desc->id & ~MEDIA_ENT_ID_FLAG_NEXT;
+    guint index = 0;
+
+    /* With MEDIA_ENT_ID_FLAG_NEXT, get the entity after "id" */
+    if ((desc->id & MEDIA_ENT_ID_FLAG_NEXT) != 0)
+    {
+        id++;
+    }
+
+    if ((id < 1) || (id > MEDIA_MOCK_ENTITY_COUNTS))
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    entity = &media_mock_entities[id - 1];
+
+    memset(desc, 0, sizeof(*desc));
+    desc->id = id;
+    g_strlcpy(desc->name, entity->name, sizeof(desc->name));
+    desc->type = entity->function;
+    desc->pads = entity->pad_counts;
+    desc->dev.major = MEDIA_MOCK_MAJOR;
+    desc->dev.minor = id;
+
+    /* Outbound links only, as the kernel does */
+    for (index = 0; index < MEDIA_MOCK_LINK_COUNTS; index++)
+    {
+        if (media_mock_links[index].source == id)
+        {
+            desc->links++;
+        }
+    }
+
+    return 0;
+}
+
+gint media_mock_enum_links(struct media_links_enum *links_enum)
+{
+    const struct media_mock_entity_t *entity = NULL;
+    guint id = links_enum->entity;
+    guint index = 0;
+    guint counts = 0;
+
+    if ((id < 1) || (id > MEDIA_MOCK_ENTITY_COUNTS))
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    entity = &media_mock_entities[id - 1];
+
+    for (index = 0; (links_enum->pads != NULL) && (index < entity->pad_counts); index++)
+    {
+        links_enum->pads[index].entity = id;
+        links_enum->pads[index].index = index;
+        links_enum->pads[index].flags = ((entity->sink_pads & (1 << index)) != 0) ? MEDIA_PAD_FL_SINK
+                                                                                   : MEDIA_PAD_FL_SOURCE;
+    }
+
+    for (index = 0; (links_enum->links != NULL) && (index < MEDIA_MOCK_LINK_COUNTS); index++)
+    {
+        if (media_mock_links[index].source != id)
+        {
+            continue;
+        }
+
+        memset(&links_enum->links[counts], 0, sizeof(struct media_link_desc));
+        links_enum->links[counts].source.entity = id;
+        links_enum->links[counts].source.index = media_mock_links[index].source_pad;
+        links_enum->links[counts].source.flags = MEDIA_PAD_FL_SOURCE;
+        links_enum->links[counts].sink.entity = media_mock_links[index].sink;
+        links_enum->links[counts].sink.index = media_mock_links[index].sink_pad;
+        links_enum->links[counts].sink.flags = MEDIA_PAD_FL_SINK;
+        links_enum->links[counts].flags = media_mock_links[index].flags;
+        counts++;
+    }
+
+    return 0;
+}
+
+gint media_mock_setup_link(struct media_link_desc *desc)
+{
+    struct media_mock_link_t *link = NULL;
+    gboolean enable = ((desc->flags & MEDIA_LNK_FL_ENABLED) != 0);
+    guint index = 0;
+
+    for (index = 0; index < MEDIA_MOCK_LINK_COUNTS; index++)
+    {
+        if ((media_mock_links[index].source == desc->source.entity) &&
+            (media_mock_links[index].source_pad == desc->source.index) &&
+            (media_mock_links[index].sink == desc->sink.entity) &&
+            (media_mock_links[index].sink_pad == desc->sink.index))
+        {
+            link = &media_mock_links[index];
+        }
+    }
+
+    if ((link == NULL) ||
+        (((link->flags & MEDIA_LNK_FL_IMMUTABLE) != 0) &&
+         (enable != ((link->flags & MEDIA_LNK_FL_ENABLED) != 0))))
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    /* A VIN captures from one source only */
+    for (index = 0; enable && (index < MEDIA_MOCK_LINK_COUNTS); index++)
+    {
+        if ((&media_mock_links[index] != link) &&
+            (media_mock_links[index].sink == link->sink) &&
+            ((media_mock_links[index].flags & MEDIA_LNK_FL_ENABLED) != 0))
+        {
+            errno = EBUSY;
+            return -1;
+        }
+    }
+
+    link->flags = (enable) ? (link->flags | MEDIA_LNK_FL_ENABLED) : (link->flags & ~MEDIA_LNK_FL_ENABLED);
+
+    g_debug("Info: [mock] Link %u:%u -> %u:%u %s", link->source, link->source_pad,
+            link->sink, link->sink_pad, (enable) ? "enabled" : "disabled");
+
+    return 0;
+}
+
+gint media_mock_set_format(const guint id, struct v4l2_subdev_format *format)
+{
+    struct media_mock_entity_t *entity = NULL;
+
+    if ((id < 1) || (id > MEDIA_MOCK_ENTITY_COUNTS))
+    {
+        errno = ENOTTY;
+        return -1;
+    }
+
+    entity = &media_mock_entities[id - 1];
+
+    if ((format->pad >= entity->pad_counts) || (format->which != V4L2_SUBDEV_FORMAT_ACTIVE))
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    /* Like the drivers: adjust what is not supported instead of failing */
+    if (format->format.code != MEDIA_BUS_FMT_UYVY8_2X8)
+    {
+        format->format.code = MEDIA_BUS_FMT_UYVY8_2X8;
+    }
+
+    format->format.width = CLAMP(format->format.width, 1, MEDIA_MOCK_MAX_WIDTH);
+    format->format.height = CLAMP(format->format.height, 1, MEDIA_MOCK_MAX_HEIGHT);
+    format->format.field = V4L2_FIELD_NONE;
+
+    entity->formats[format->pad] = format->format;
+
+    g_debug("Info: [mock] Format of '%s':%u set to 0x%04x/%ux%u", entity->name, format->pad,
+            format->format.code, format->format.width, format->format.height);
+
+    return 0;
+}
+
+gint media_mock_ioctl(gint fd, gulong request, gpointer arg)
+{
+    if (fd == MEDIA_MOCK_MEDIA_FD)
+    {
+        switch (request)
+        {
+            case MEDIA_IOC_ENUM_ENTITIES:
+                return media_mock_enum_entities((struct media_entity_desc*)arg);
+
+            case MEDIA_IOC_ENUM_LINKS:
+                return media_mock_enum_links((struct media_links_enum*)arg);
+
+            case MEDIA_IOC_SETUP_LINK:
+                return media_mock_setup_link((struct media_link_desc*)arg);
+
+            default:
+            break;
+        }
+    }
+    else if ((fd > MEDIA_MOCK_SUBDEV_FD) && (request == VIDIOC_SUBDEV_S_FMT))
+    {
+        return media_mock_set_format(fd - MEDIA_MOCK_SUBDEV_FD, (struct v4l2_subdev_format*)arg);
+    }
+
+    errno = ENOTTY;
+    return -1;
+}
+
+/* ---------- Public functions ---------- */
+
+const struct media_backend_t *media_mock_get_backend(const gchar *platform)
+{
+    /* Check parameter(s) */
+    g_return_val_if_fail(platform != NULL, NULL);
+
+    /* Every bring-up starts from a freshly booted board */
+    if (!media_mock_reset(platform))
+    {
+        return NULL;
+    }
+
+    g_message("Info: Using mock media device of '%s'", platform);
+
+    return &media_mock_backend;
+}
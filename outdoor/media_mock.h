@@ -0,0 +1,40 @@
+/***********************************************************************
+ * FILENAME: media_mock.h
+ *
+ * DESCRIPTION:
+ *   Contains an in-memory media device which emulates the camera
+ *   pipeline of RZ/G2 boards, to test "media.h" without the board.
+ *
+ * PUBLIC FUNCTIONS:
+ *   const struct media_backend_t *media_mock_get_backend(const gchar *platform);
+ *
+ * AUTHOR: RVC       START DATE: 17/10/2026
+ *
+ * CHANGES:
+ *
+ ***********************************************************************/
+
+#ifndef _MEDIA_MOCK_H_
+#define _MEDIA_MOCK_H_
+
+/* ---------- Functions ---------- */
+
+/*
+ * Function: media_mock_get_backend
+ * ---
+ *   Get the mock backend emulating "platform" (such as: "ek874", "hihope-rzg2m").
+ *   The topology is the one of the board: "ov5645" sensor -> "rcar_csi2" receiver
+ *   -> "VIN4 output" and "VIN5 output", with the VIN5 link enabled (as left by
+ *   a previous run) so that MEDIA_STEP_RESET has work to do.
+ *
+ *   The mock checks ioctls like the kernel: unknown entities, pads or links and
+ *   changes of immutable links fail with EINVAL, enabling a second link to a VIN
+ *   fails with EBUSY, and unsupported bus formats are replaced by UYVY8_2X8 (as
+ *   the drivers do). Link and format changes are logged (debug level).
+ *
+ *   return: NULL (unknown platform).
+ *           not NULL (backend, see "media_backend_t").
+ */
+const struct media_backend_t *media_mock_get_backend(const gchar *platform);
+
+#endif
@@ -0,0 +1,726 @@
+/***********************************************************************
+ * FILENAME: metrics.c
+ *
+ * DESCRIPTION:
+ *   Metrics endpoint implementations.
+ *
+ * NOTE:
+ *   For more further information about datatypes and function usages,
+ *   please refer to "metrics.h".
+ *
+ * AUTHOR: RVC       START DATE: 17/10/2026
+ *
+ * CHANGES:
+ *
+ ***********************************************************************/
+
+/* ---------- Header files ---------- */
+
+#include <glib.h>
+#include <glib/gprintf.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <gio/gio.h>
+#include <gst/rtsp-server/rtsp-server.h>
+
+#include "media.h"
+#include "camera.h"
+#include "my_gst.h"
+#include "server.h"
+#include "abr.h"
+#include "profile.h"
+#include "capture.h"
+#include "helper.h"
+#include "metrics.h"
+
+/* ---------- Macros ---------- */
+
+/* Maximum number of scrapes handled at the same time */
+#define METRICS_MAX_CONNECTIONS 2
+
+/* Maximum number of header lines of a request */
+#define METRICS_MAX_HEADER_LINES 64
+
+/* Content type of the Prometheus text format */
+#define METRICS_CONTENT_TYPE "text/plain; version=0.0.4; charset=utf-8"
+
+/* ---------- Datatypes ---------- */
+
+/*
+ * Enum: metrics_stream_family_t
+ * ---
+ *   Represents metrics with one sample per stream (see "metrics_stream_families").
+ */
+enum metrics_stream_family_t
+{
+    METRICS_STREAM_CLIENTS,
+    METRICS_STREAM_FRAMES,
+    METRICS_STREAM_KEYFRAMES,
+    METRICS_STREAM_ENCODED_BYTES,
+    METRICS_STREAM_FPS,
+    METRICS_STREAM_BITRATE,
+    METRICS_STREAM_KEYFRAME_INTERVAL,
+    METRICS_STREAM_RTP_BYTES,
+    METRICS_STREAM_DROPPED_FRAMES,
+    METRICS_STREAM_FAMILY_COUNTS
+};
+
+/*
+ * Struct: metrics_family_t
+ * ---
+ *   Represents a metric: its name, type ("counter", "gauge") and help text.
+ */
+struct metrics_family_t
+{
+    const gchar *name;
+
+    const gchar *type;
+
+    const gchar *help;
+};
+
+struct metrics_t
+{
+    GSocketService *service;
+
+    struct server_t *server;
+
+    GPtrArray *streams;
+
+    gint camera_counts;
+
+    guint rate_source_id;
+};
+
+/*
+ * Struct: metrics_stream_t
+ * ---
+ *   Represents a stream tier of a camera:
+ *     - capture (struct capture_t): Camera pipeline.
+ *     - tier (enum capture_tier_t): Tier of the pipeline.
+ *     - number (gint): Number of the camera (from 1).
+ *     - previous (struct capture_counters_t): Counters of the previous measurement.
+ *     - previous_time (gint64): Monotonic time (us) of the previous measurement.
+ *     - fps, bitrate (gdouble): Frame rate and bitrate (bps) of the latest interval.
+ */
+struct metrics_stream_t
+{
+    struct capture_t *capture;
+
+    enum capture_tier_t tier;
+
+    gint number;
+
+    struct capture_counters_t previous;
+
+    gint64 previous_time;
+
+    gdouble fps;
+
+    gdouble bitrate;
+};
+
+/*
+ * Struct: metrics_request_t
+ * ---
+ *   Represents a scrape passed from a connection thread to the main context:
+ *     - metrics (struct metrics_t): Metrics server.
+ *     - body (GString): Rendered metrics.
+ */
+struct metrics_request_t
+{
+    struct metrics_t *metrics;
+
+    GString *body;
+};
+
+/* ---------- Private variables ---------- */
+
+/* Label values of tiers */
+const gchar *metrics_tier_names[] = { GST_MAIN_STREAM_NAME, GST_SUB_STREAM_NAME };
+
+/* Upper bounds of access unit size buckets */
+const gsize metrics_unit_size_bounds[] = CAPTURE_UNIT_SIZE_BOUNDS;
+
+/* Label values of stages, indexed by "enum capture_stage_t" */
+const gchar *metrics_stage_names[] = { GST_SCALE_STAGE_NAME, GST_ENCODE_STAGE_NAME };
+
+/* Metrics with one sample per stream, in the order of "metrics_stream_family_t" */
+const struct metrics_family_t metrics_stream_families[] =
+{
+    { "outdoor_stream_clients", "gauge", "Connected RTSP clients." },
+    { "outdoor_stream_frames_total", "counter", "Encoded frames." },
+    { "outdoor_stream_keyframes_total", "counter", "Encoded keyframes." },
+    { "outdoor_stream_encoded_bytes_total", "counter", "Size of encoded frames in bytes." },
+    { "outdoor_stream_fps", "gauge", "Encoded frames per second." },
+    { "outdoor_stream_bitrate_bps", "gauge", "Encoded bitrate in bits per second." },
+    { "outdoor_stream_keyframe_interval_frames", "gauge", "Frames between the latest two keyframes." },
+    { "outdoor_stream_rtp_bytes_total", "counter", "Size of RTP packets sent to clients in bytes." },
+    { "outdoor_stream_dropped_frames_total", "counter", "Frames not sent to a client." }
+};
+
+/* ---------- Private functions ---------- */
+
+/*
+ * Function: metrics_on_run
+ * ---
+ *   Callback of "GThreadedSocketService::run". Reads an HTTP request, then answers
+ *   with the metrics (METRICS_PATH) or "404 Not Found", and closes the connection.
+ */
+static gboolean metrics_on_run(GThreadedSocketService *service, GSocketConnection *connection,
+                               GObject *source_object, gpointer user_data);
+
+/*
+ * Function: metrics_dispatch
+ * ---
+ *   Renders the metrics of a request in the default main context (see "main_context_call").
+ */
+static void metrics_dispatch(gpointer user_data);
+
+/*
+ * Function: metrics_on_rate_timeout
+ * ---
+ *   Measures the frame rate and bitrate of every stream every METRICS_RATE_INTERVAL seconds.
+ *
+ *   return: G_SOURCE_CONTINUE.
+ */
+static gboolean metrics_on_rate_timeout(gpointer user_data);
+
+/*
+ * Function: metrics_render
+ * ---
+ *   Appends all metrics to "body".
+ */
+static void metrics_render(struct metrics_t *metrics, GString *body);
+
+/*
+ * Function: metrics_render_process
+ * ---
+ *   Appends CPU time, memory and threads of the process (from "/proc/self/stat").
+ */
+static void metrics_render_process(GString *body);
+
+/*
+ * Function: metrics_append_family
+ * ---
+ *   Appends the "HELP" and "TYPE" lines of metric "name".
+ */
+static void metrics_append_family(GString *body, const gchar *name, const gchar *type,
+                                  const gchar *help);
+
+/*
+ * Function: metrics_append_sample
+ * ---
+ *   Appends sample "value" of metric "name" for "stream".
+ *
+ *   label: Additional label ("name=\"value\""), NULL if none.
+ */
+static void metrics_append_sample(GString *body, const gchar *name,
+                                  const struct metrics_stream_t *stream, const gchar *label,
+                                  const gdouble value);
+
+/*
+ * Function: metrics_append_labels
+ * ---
+ *   Appends the labels of "stream" (without braces), with escaped values.
+ */
+static void metrics_append_labels(GString *body, const struct metrics_stream_t *stream);
+
+/*
+ * Function: metrics_append_escaped
+ * ---
+ *   Appends label value "value" with backslashes, double quotes and line feeds escaped.
+ */
+static void metrics_append_escaped(GString *body, const gchar *value);
+
+/* ---------- Private functions ---------- */
+
+void metrics_dispatch(gpointer user_data)
+{
+    struct metrics_request_t *request = (struct metrics_request_t*)user_data;
+
+    metrics_render(request->metrics, request->body);
+}
+
+gboolean metrics_on_run(GThreadedSocketService *service, GSocketConnection *connection,
+                        GObject *source_object, gpointer user_data)
+{
+    struct metrics_t *metrics = (struct metrics_t*)user_data;
+    struct metrics_request_t request;
+
+    GDataInputStream *input = NULL;
+    GOutputStream *output = NULL;
+    GString *response = NULL;
+
+    gchar *line = NULL;
+    gchar **fields = NULL;
+    gboolean found = FALSE;
+    guint index = 0;
+
+    input = g_data_input_stream_new(g_io_stream_get_input_stream(G_IO_STREAM(connection)));
+    output = g_io_stream_get_output_stream(G_IO_STREAM(connection));
+
+    g_data_input_stream_set_newline_type(input, G_DATA_STREAM_NEWLINE_TYPE_ANY);
+
+    /* Request line: "GET /metrics HTTP/1.1" (a query string is ignored) */
+    line = g_data_input_stream_read_line(input, NULL, NULL, NULL);
+    if (line == NULL)
+    {
+        g_object_unref(input);
+
+        return TRUE;
+    }
+
+    fields = g_strsplit(g_strstrip(line), " ", 3);
+    if ((g_strv_length(fields) >= 2) && (g_strcmp0(fields[0], "GET") == 0))
+    {
+        g_strdelimit(fields[1], "?", '\0');
+        found = (g_strcmp0(fields[1], METRICS_PATH) == 0);
+    }
+
+    g_strfreev(fields);
+    g_free(line);
+
+    /* Skip headers until the empty line */
+    for (index = 0; index < METRICS_MAX_HEADER_LINES; index++)
+    {
+        line = g_data_input_stream_read_line(input, NULL, NULL, NULL);
+        if ((line == NULL) || (g_strstrip(line)[0] == '\0'))
+        {
+            g_free(line);
+            break;
+        }
+
+        g_free(line);
+    }
+
+    response = g_string_new(NULL);
+
+    if (found)
+    {
+        /* Counters and their objects are read in the main context, like the RTSP server(s) */
+        request.metrics = metrics;
+        request.body = g_string_new(NULL);
+
+        main_context_call(metrics_dispatch, &request);
+
+        g_string_append_printf(response, "HTTP/1.0 200 OK\r\nContent-Type: %s\r\n"
+                               "Content-Length: %" G_GSIZE_FORMAT "\r\nConnection: close\r\n\r\n%s",
+                               METRICS_CONTENT_TYPE, request.body->len, request.body->str);
+
+        /* Free resources */
+        g_string_free(request.body, TRUE);
+    }
+    else
+    {
+        g_string_append(response, "HTTP/1.0 404 Not Found\r\nContent-Type: text/plain\r\n"
+                                  "Content-Length: 10\r\nConnection: close\r\n\r\nNot Found\n");
+    }
+
+    g_output_stream_write_all(output, response->str, response->len, NULL, NULL, NULL);
+
+    g_string_free(response, TRUE);
+    g_object_unref(input);
+
+    return TRUE;
+}
+
+gboolean metrics_on_rate_timeout(gpointer user_data)
+{
+    struct metrics_t *metrics = (struct metrics_t*)user_data;
+    struct metrics_stream_t *stream = NULL;
+    struct capture_counters_t counters;
+
+    gint64 now = g_get_monotonic_time();
+    gdouble elapsed = 0;
+    guint index = 0;
+
+    for (index = 0; index < metrics->streams->len; index++)
+    {
+        stream = g_ptr_array_index(metrics->streams, index);
+
+        if (!capture_get_counters(stream->capture, stream->tier, &counters))
+        {
+            continue;
+        }
+
+        elapsed = (gdouble)(now - stream->previous_time) / G_USEC_PER_SEC;
+        if (elapsed > 0)
+        {
+            stream->fps = (counters.unit_counts - stream->previous.unit_counts) / elapsed;
+            stream->bitrate = (counters.unit_bytes - stream->previous.unit_bytes) * 8 / elapsed;
+        }
+
+        stream->previous = counters;
+        stream->previous_time = now;
+    }
+
+    return G_SOURCE_CONTINUE;
+}
+
+void metrics_append_escaped(GString *body, const gchar *value)
+{
+    for (; *value != '\0'; value++)
+    {
+        switch (*value)
+        {
+            case '\\':
+                g_string_append(body, "\\\\");
+                break;
+
+            case '"':
+                g_string_append(body, "\\\"");
+                break;
+
+            case '\n':
+                g_string_append(body, "\\n");
+                break;
+
+            default:
+                g_string_append_c(body, *value);
+                break;
+        }
+    }
+}
+
+void metrics_append_labels(GString *body, const struct metrics_stream_t *stream)
+{
+    const struct camera_t *camera = capture_get_camera(stream->capture);
+    const gchar *mount = capture_get_mount(stream->capture, stream->tier);
+
+    g_string_append_printf(body, "camera=\"%d\",type=\"", stream->number);
+    metrics_append_escaped(body, camera_get_type_str(camera));
+
+    g_string_append_printf(body, "\",tier=\"%s\",mount=\"", metrics_tier_names[stream->tier]);
+    metrics_append_escaped(body, (mount != NULL) ? mount : "");
+
+    g_string_append_c(body, '"');
+}
+
+void metrics_append_sample(GString *body, const gchar *name,
+                           const struct metrics_stream_t *stream, const gchar *label,
+                           const gdouble value)
+{
+    g_string_append_printf(body, "%s{", name);
+    metrics_append_labels(body, stream);
+
+    if (label != NULL)
+    {
+        g_string_append_printf(body, ",%s", label);
+    }
+
+    /* Integers (counters) are printed without exponent */
+    g_string_append_printf(body, "} %.15g\n", value);
+}
+
+void metrics_append_family(GString *body, const gchar *name, const gchar *type,
+                           const gchar *help)
+{
+    g_string_append_printf(body, "# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+}
+
+void metrics_render_process(GString *body)
+{
+    gchar *content = NULL;
+    gchar *fields = NULL;
+
+    gulong user_ticks = 0;
+    gulong system_ticks = 0;
+    glong threads = 0;
+    gulong virtual_bytes = 0;
+    glong resident_pages = 0;
+
+    if (!g_file_get_contents("/proc/self/stat", &content, NULL, NULL))
+    {
+        return;
+    }
+
+    /* Fields after the command name (which may contain spaces): state is the 3rd field */
+    fields = strrchr(content, ')');
+
+    if ((fields != NULL) &&
+        (sscanf(fields + 2, "%*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %lu %lu %*d %*d %*d %*d "
+                            "%ld %*d %*u %lu %ld", &user_ticks, &system_ticks, &threads,
+                            &virtual_bytes, &resident_pages) == 5))
+    {
+        metrics_append_family(body, "process_cpu_seconds_total", "counter",
+                              "Total user and system CPU time spent in seconds.");
+        g_string_append_printf(body, "process_cpu_seconds_total %.2f\n",
+                               (gdouble)(user_ticks + system_ticks) / sysconf(_SC_CLK_TCK));
+
+        metrics_append_family(body, "process_resident_memory_bytes", "gauge",
+                              "Resident memory size in bytes.");
+        g_string_append_printf(body, "process_resident_memory_bytes %ld\n",
+                               resident_pages * sysconf(_SC_PAGESIZE));
+
+        metrics_append_family(body, "process_virtual_memory_bytes", "gauge",
+                              "Virtual memory size in bytes.");
+        g_string_append_printf(body, "process_virtual_memory_bytes %lu\n", virtual_bytes);
+
+        metrics_append_family(body, "process_threads", "gauge", "Number of OS threads in the process.");
+        g_string_append_printf(body, "process_threads %ld\n", threads);
+    }
+
+    g_free(content);
+}
+
+void metrics_render(struct metrics_t *metrics, GString *body)
+{
+    struct metrics_stream_t *stream = NULL;
+    struct capture_counters_t *counters = NULL;
+    GHashTable *sessions = NULL;
+
+    gchar label[32];
+    gdouble value = 0;
+    gsize cumulative = 0;
+    guint family = 0;
+    guint index = 0;
+    guint bucket = 0;
+    guint stage = 0;
+
+    /* Read counters once, so that all families of a scrape agree */
+    counters = g_new0(struct capture_counters_t, MAX(metrics->streams->len, 1));
+
+    for (index = 0; index < metrics->streams->len; index++)
+    {
+        stream = g_ptr_array_index(metrics->streams, index);
+        capture_get_counters(stream->capture, stream->tier, &counters[index]);
+    }
+
+    /* Clients of every media */
+    sessions = g_hash_table_new(g_direct_hash, g_direct_equal);
+    if (metrics->server != NULL)
+    {
+        server_count_sessions(metrics->server, sessions);
+    }
+
+    for (family = 0; family < METRICS_STREAM_FAMILY_COUNTS; family++)
+    {
+        metrics_append_family(body, metrics_stream_families[family].name,
+                              metrics_stream_families[family].type, metrics_stream_families[family].help);
+
+        for (index = 0; index < metrics->streams->len; index++)
+        {
+            stream = g_ptr_array_index(metrics->streams, index);
+
+            switch (family)
+            {
+                case METRICS_STREAM_CLIENTS:
+                    value = capture_count_clients(stream->capture, stream->tier, sessions);
+                    break;
+
+                case METRICS_STREAM_FRAMES:
+                    value = counters[index].unit_counts;
+                    break;
+
+                case METRICS_STREAM_KEYFRAMES:
+                    value = counters[index].keyframe_counts;
+                    break;
+
+                case METRICS_STREAM_ENCODED_BYTES:
+                    value = counters[index].unit_bytes;
+                    break;
+
+                case METRICS_STREAM_FPS:
+                    value = stream->fps;
+                    break;
+
+                case METRICS_STREAM_BITRATE:
+                    value = stream->bitrate;
+                    break;
+
+                case METRICS_STREAM_KEYFRAME_INTERVAL:
+                    value = counters[index].keyframe_interval;
+                    break;
+
+                case METRICS_STREAM_RTP_BYTES:
+                    value = counters[index].rtp_bytes;
+                    break;
+
+                case METRICS_STREAM_DROPPED_FRAMES:
+                default:
+                    value = counters[index].dropped_counts;
+                    break;
+            }
+
+            metrics_append_sample(body, metrics_stream_families[family].name, stream, NULL, value);
+        }
+    }
+
+    /* Histogram: cumulative buckets, then sum and count */
+    metrics_append_family(body, "outdoor_stream_frame_size_bytes", "histogram",
+                          "Size of encoded frames in bytes.");
+
+    for (index = 0; index < metrics->streams->len; index++)
+    {
+        stream = g_ptr_array_index(metrics->streams, index);
+
+        for (cumulative = 0, bucket = 0; bucket < CAPTURE_UNIT_SIZE_BUCKETS; bucket++)
+        {
+            cumulative += counters[index].unit_sizes[bucket];
+
+            if (bucket < CAPTURE_UNIT_SIZE_BUCKETS - 1)
+            {
+                g_snprintf(label, sizeof(label), "le=\"%" G_GSIZE_FORMAT "\"", metrics_unit_size_bounds[bucket]);
+            }
+            else
+            {
+                g_snprintf(label, sizeof(label), "le=\"+Inf\"");
+            }
+
+            metrics_append_sample(body, "outdoor_stream_frame_size_bytes_bucket", stream, label, cumulative);
+        }
+
+        metrics_append_sample(body, "outdoor_stream_frame_size_bytes_sum", stream, NULL,
+                              counters[index].unit_bytes);
+        metrics_append_sample(body, "outdoor_stream_frame_size_bytes_count", stream, NULL, cumulative);
+    }
+
+    /* Stale frames dropped in front of every stage of the encoding branch */
+    metrics_append_family(body, "outdoor_stream_stale_frames_total", "counter",
+                          "Stale frames dropped before a late stage (scale, encode).");
+
+    for (index = 0; index < metrics->streams->len; index++)
+    {
+        stream = g_ptr_array_index(metrics->streams, index);
+
+        for (stage = 0; stage < CAPTURE_STAGE_COUNTS; stage++)
+        {
+            g_snprintf(label, sizeof(label), "stage=\"%s\"", metrics_stage_names[stage]);
+            metrics_append_sample(body, "outdoor_stream_stale_frames_total", stream, label,
+                                  counters[index].stale_counts[stage]);
+        }
+    }
+
+    /* Errors: the encoder of every tier, VSP and other elements once per camera (main tier) */
+    metrics_append_family(body, "outdoor_camera_errors_total", "counter",
+                          "Errors of camera pipelines by kind (encoder, vsp, other).");
+
+    for (index = 0; index < metrics->streams->len; index++)
+    {
+        stream = g_ptr_array_index(metrics->streams, index);
+
+        metrics_append_sample(body, "outdoor_camera_errors_total", stream, "kind=\"encoder\"",
+                              counters[index].encoder_errors);
+
+        if (stream->tier == CAPTURE_TIER_MAIN)
+        {
+            metrics_append_sample(body, "outdoor_camera_errors_total", stream, "kind=\"vsp\"",
+                                  counters[index].vsp_errors);
+            metrics_append_sample(body, "outdoor_camera_errors_total", stream, "kind=\"other\"",
+                                  counters[index].other_errors);
+        }
+    }
+
+    metrics_render_process(body);
+
+    /* Free resources */
+    g_hash_table_unref(sessions);
+    g_free(counters);
+}
+
+/* ---------- Public functions ---------- */
+
+struct metrics_t *metrics_create(const gint port, struct server_t *server)
+{
+    struct metrics_t *metrics = NULL;
+
+    GInetAddress *inet_address = NULL;
+    GSocketAddress *address = NULL;
+    GError *error = NULL;
+
+    /* Check parameter(s) */
+    g_return_val_if_fail((port > 0) && (port <= G_MAXUINT16), NULL);
+
+    metrics = g_new0(struct metrics_t, 1);
+
+    metrics->server = server;
+    metrics->streams = g_ptr_array_new_with_free_func(g_free);
+
+    /* Local only: metrics are collected by an agent running on the board */
+    metrics->service = g_threaded_socket_service_new(METRICS_MAX_CONNECTIONS);
+
+    inet_address = g_inet_address_new_loopback(G_SOCKET_FAMILY_IPV4);
+    address = g_inet_socket_address_new(inet_address, (guint16)port);
+
+    if (!g_socket_listener_add_address(G_SOCKET_LISTENER(metrics->service), address,
+                                       G_SOCKET_TYPE_STREAM, G_SOCKET_PROTOCOL_TCP,
+                                       NULL, NULL, &error))
+    {
+        g_message("Error: Failed to listen on metrics port %d: %s", port, error->message);
+
+        /* Free resources */
+        g_clear_error(&error);
+        g_object_unref(address);
+        g_object_unref(inet_address);
+        metrics_free(metrics);
+
+        return NULL;
+    }
+
+    g_object_unref(address);
+    g_object_unref(inet_address);
+
+    g_signal_connect(metrics->service, "run", G_CALLBACK(metrics_on_run), metrics);
+    g_socket_service_start(metrics->service);
+
+    metrics->rate_source_id = g_timeout_add_seconds(METRICS_RATE_INTERVAL, metrics_on_rate_timeout,
+                                                    metrics);
+
+    g_message("Metrics are ready at: \"http://127.0.0.1:%d%s\"", port, METRICS_PATH);
+
+    return metrics;
+}
+
+void metrics_add(struct metrics_t *metrics, struct capture_t *capture)
+{
+    struct metrics_stream_t *stream = NULL;
+    gint tier = 0;
+
+    /* Check parameter(s) */
+    g_return_if_fail((metrics != NULL) && (capture != NULL));
+
+    metrics->camera_counts++;
+
+    for (tier = 0; tier < CAPTURE_TIER_COUNTS; tier++)
+    {
+        if (!capture_has_tier(capture, tier))
+        {
+            continue;
+        }
+
+        stream = g_new0(struct metrics_stream_t, 1);
+
+        stream->capture = capture;
+        stream->tier = tier;
+        stream->number = metrics->camera_counts;
+        stream->previous_time = g_get_monotonic_time();
+
+        capture_get_counters(capture, tier, &stream->previous);
+
+        g_ptr_array_add(metrics->streams, stream);
+    }
+}
+
+void metrics_free(struct metrics_t *metrics)
+{
+    /* Check parameter(s) */
+    g_return_if_fail(metrics != NULL);
+
+    if (metrics->rate_source_id != 0)
+    {
+        g_source_remove(metrics->rate_source_id);
+    }
+
+    if (metrics->service != NULL)
+    {
+        g_socket_service_stop(metrics->service);
+        g_socket_listener_close(G_SOCKET_LISTENER(metrics->service));
+        g_object_unref(metrics->service);
+    }
+
+    g_ptr_array_free(metrics->streams, TRUE);
+    g_free(metrics);
+}
@@ -0,0 +1,97 @@
+/***********************************************************************
+ * FILENAME: metrics.h
+ *
+ * DESCRIPTION:
+ *   Contains APIs to publish metrics of streams on a local HTTP endpoint
+ *   (option "--metrics-port"), in the Prometheus text format:
+ *
+ *     curl http://127.0.0.1:<port>/metrics
+ *
+ *   Per mount point (labels: camera, type, tier, mount):
+ *     - encoded frames, keyframes and bytes, frame rate and bitrate,
+ *       keyframe interval, histogram of access unit sizes,
+ *     - connected clients, RTP bytes sent, dropped frames, stale frames dropped
+ *       before the scaler and the encoder,
+ *     - errors of the encoder, of VSP elements and of other elements.
+ *   Per process: CPU time, resident and virtual memory, threads.
+ *
+ *   Counters are read from "capture_get_counters()": streaming threads
+ *   only update them with atomic operations, scrapes never block them.
+ *
+ * PUBLIC FUNCTIONS:
+ *   struct metrics_t *metrics_create(const gint port, struct server_t *server);
+ *
+ *   void metrics_add(struct metrics_t *metrics, struct capture_t *capture);
+ *
+ *   void metrics_free(struct metrics_t *metrics);
+ *
+ * AUTHOR: RVC       START DATE: 17/10/2026
+ *
+ * CHANGES:
+ *
+ ***********************************************************************/
+
+#ifndef _METRICS_H_
+#define _METRICS_H_
+
+/* ---------- Macros ---------- */
+
+/* Path of the endpoint */
+#define METRICS_PATH "/metrics"
+
+/* Interval of frame rate and bitrate measurements (seconds) */
+#define METRICS_RATE_INTERVAL 2
+
+/* ---------- Datatypes ---------- */
+
+/*
+ * Struct: metrics_t
+ * ---
+ *   Represents the metrics endpoint:
+ *     - service (GSocketService): HTTP socket service (one thread per connection).
+ *     - server (struct server_t): RTSP server(s), to count clients.
+ *     - streams (array of "metrics_stream_t"): Every tier of the added cameras,
+ *       with its latest frame rate and bitrate.
+ *     - camera_counts (gint): The number of added cameras.
+ *     - rate_source_id (guint): Timer of frame rate and bitrate measurements.
+ */
+struct metrics_t;
+
+/* ---------- Functions ---------- */
+
+/*
+ * Function: metrics_create
+ * ---
+ *   Listens on 127.0.0.1:"port" and starts serving METRICS_PATH.
+ *   Scrapes are rendered in the default main context.
+ *
+ *   return: NULL (unable to listen on "port").
+ *           not NULL (successfully create "metrics_t" object).
+ *
+ *   Note: Should use "metrics_free()" to deallocate if it is not used anymore.
+ */
+struct metrics_t *metrics_create(const gint port, struct server_t *server);
+
+/*
+ * Function: metrics_add
+ * ---
+ *   Adds the stream tiers of a camera. Cameras are numbered from 1, in the order
+ *   they are added (the same as their mount points "/camera-N").
+ *
+ *   capture: Camera pipeline, its mount points must be published.
+ *
+ *   return: void.
+ */
+void metrics_add(struct metrics_t *metrics, struct capture_t *capture);
+
+/*
+ * Function: metrics_free
+ * ---
+ *   Stops the endpoint and frees "metrics_t" object (before the added pipelines and
+ *   the RTSP server(s)).
+ *
+ *   return: void.
+ */
+void metrics_free(struct metrics_t *metrics);
+
+#endif
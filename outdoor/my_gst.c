@@ -16,8 +16,16 @@
 /* ---------- Header files ---------- */
 #include <glib.h>
 #include <glib/gprintf.h>
+#include <stdio.h>
+#include <string.h>
 
+#include <gst/gst.h>
+
+#include "media.h"
 #include "camera.h"
+#include "probe.h"
+#include "scale.h"
+#include "nv12scale.h"
 #include "my_gst.h"
 
 /* ---------- Variables ---------- */
@@ -35,12 +43,334 @@ const gchar *usb_resolutions[] = {
   "640x480",
   "800x600",
   "1280x720",
+  "1920x1080",
   NULL,
 };
 
+/* Patterns of synthetic cameras, indexed by "enum camera_motion_t" */
+const gchar *synthetic_patterns[] = {
+    SYNTHETIC_CAM_STATIC_PATTERN_STR,
+    SYNTHETIC_CAM_LOW_PATTERN_STR,
+    SYNTHETIC_CAM_MEDIUM_PATTERN_STR,
+    SYNTHETIC_CAM_HIGH_PATTERN_STR,
+};
+
+/*
+ * Enum: gst_encoder_t
+ * ---
+ *   H.264 encoders of camera pipelines, in order of preference (see GST_*_ENCODER_FMT_STR):
+ *     - GST_ENCODER_OMX: "omxh264enc" (hardware).
+ *     - GST_ENCODER_X264: "x264enc" (software).
+ *     - GST_ENCODER_OPENH264: "openh264enc" (software).
+ *     - GST_ENCODER_NONE: None of them is installed.
+ */
+enum gst_encoder_t
+{
+    GST_ENCODER_OMX,
+    GST_ENCODER_X264,
+    GST_ENCODER_OPENH264,
+    GST_ENCODER_NONE
+};
+
+/* Element names, indexed by "enum gst_encoder_t" */
+const gchar *gst_encoder_names[] = { "omxh264enc", "x264enc", "openh264enc", "none" };
+
+/* Encoding path, detected once by "gst_detect_encode_path" */
+gboolean encode_path_detected = FALSE;
+gboolean vsp_available = FALSE;
+gboolean nv12scale_available = FALSE;
+enum gst_encoder_t encoder_available = GST_ENCODER_NONE;
+
+/* Frames which may wait in front of each stage of encoding branches */
+gint frame_budget = GST_DEFAULT_FRAME_BUDGET;
+
+/* ---------- Private functions ---------- */
+
+/*
+ * Function: gst_append_pipeline
+ * ---
+ *   Append a formatted segment to "pipeline" (at least GST_PIPELINE_MAX_LENGTH characters).
+ *   A segment which does not fit is not appended.
+ *
+ *   return: TRUE (success).
+ *           FALSE (the pipeline would be too long).
+ */
+static gboolean gst_append_pipeline(gchar *pipeline, const gchar *format, ...);
+
+/*
+ * Function: gst_get_jpeg_decoder
+ * ---
+ *   Get the best JPEG decoder available (see GST_JPEG_*_DECODER_* in "my_gst.h").
+ *
+ *   decoder: Pipeline segment of the decoder (output).
+ *   size: Size of "decoder".
+ *
+ *   return: TRUE (hardware decoder), FALSE (software decoder).
+ */
+static gboolean gst_get_jpeg_decoder(gchar *decoder, const gsize size);
+
+/*
+ * Function: gst_get_h264_pipeline
+ * ---
+ *   Get the passthrough pipeline of USB camera "device" (see USB_CAM_*H264_PIPELINE_FMT_STR
+ *   in "my_gst.h") for an output of "width"x"height". It is appended to "pipeline"
+ *   (see "gst_append_pipeline()").
+ *
+ *   return: TRUE (success).
+ *           FALSE (the camera has no H.264 output, it must be encoded by the pipeline).
+ */
+static gboolean gst_get_h264_pipeline(const gchar *device, const gint width, const gint height,
+                                      gchar *pipeline);
+
+/*
+ * Function: gst_element_is_available
+ * ---
+ *   Check if GStreamer element "name" is installed.
+ */
+static gboolean gst_element_is_available(const gchar *name);
+
+/*
+ * Function: gst_detect_encode_path
+ * ---
+ *   Look for the scaler (VSP or software) and the best H.264 encoder installed, once.
+ *   Without VSP, "nv12scale" is registered (see "nv12scale.h"). The result is logged.
+ */
+static void gst_detect_encode_path();
+
+/*
+ * Function: gst_add_encode_branch
+ * ---
+ *   Append the encoding branch of tier "name" (see CAMERA_ENCODE_FMT_STR in "my_gst.h")
+ *   to "pipeline", with the detected scaler and encoder. The path is logged.
+ *
+ *   input_format: Format of captured frames (such as: "YUY2"), NULL if they are decoded.
+ *                 Software scaling of YUY2 and UYVY is done by "nv12scale".
+ *   dmabuf: Set if frames are dmabuf, which VSP imports without a copy.
+ *
+ *   return: TRUE (success).
+ *           FALSE (no H.264 encoder is installed, or the pipeline would be too long).
+ */
+static gboolean gst_add_encode_branch(const struct camera_t *camera, gchar *pipeline,
+                                      const gchar *input_format, const gboolean dmabuf,
+                                      const gint width, const gint height,
+                                      const gchar *name, const gint bitrate);
+
+gboolean gst_append_pipeline(gchar *pipeline, const gchar *format, ...)
+{
+    va_list args;
+    gsize length = strlen(pipeline);
+    gint written = 0;
+
+    va_start(args, format);
+    written = g_vsnprintf(pipeline + length, GST_PIPELINE_MAX_LENGTH - length, format, args);
+    va_end(args);
+
+    if ((written < 0) || ((gsize)written >= GST_PIPELINE_MAX_LENGTH - length))
+    {
+        pipeline[length] = '\0';
+
+        g_message("Error: Pipeline is longer than %d characters", GST_PIPELINE_MAX_LENGTH - 1);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+gboolean gst_element_is_available(const gchar *name)
+{
+    GstElementFactory *factory = gst_element_factory_find(name);
+
+    if (factory == NULL)
+    {
+        return FALSE;
+    }
+
+    gst_object_unref(factory);
+
+    return TRUE;
+}
+
+void gst_detect_encode_path()
+{
+    if (encode_path_detected)
+    {
+        return;
+    }
+
+    vsp_available = gst_element_is_available("vspmfilter");
+
+    if (!vsp_available)
+    {
+        nv12scale_available = nv12scale_register();
+    }
+
+    if (gst_element_is_available(gst_encoder_names[GST_ENCODER_OMX]))
+    {
+        encoder_available = GST_ENCODER_OMX;
+    }
+    else if (gst_element_is_available(gst_encoder_names[GST_ENCODER_X264]))
+    {
+        encoder_available = GST_ENCODER_X264;
+    }
+    else if (gst_element_is_available(gst_encoder_names[GST_ENCODER_OPENH264]))
+    {
+        encoder_available = GST_ENCODER_OPENH264;
+    }
+    else
+    {
+        encoder_available = GST_ENCODER_NONE;
+    }
+
+    if (vsp_available && (encoder_available == GST_ENCODER_OMX))
+    {
+        g_message("Info: Encoding path: vspmfilter and omxh264enc (hardware)");
+    }
+    else
+    {
+        g_message("Warning: Encoding path: %s and %s (software fallback, %u CPU cores)",
+                  (vsp_available) ? "vspmfilter" :
+                  (nv12scale_available) ? NV12SCALE_ELEMENT_NAME " (YUY2/UYVY) or videoscale/videoconvert" :
+                                          "videoscale/videoconvert",
+                  gst_encoder_names[encoder_available], g_get_num_processors());
+    }
+
+    encode_path_detected = TRUE;
+}
+
+gboolean gst_add_encode_branch(const struct camera_t *camera, gchar *pipeline,
+                               const gchar *input_format, const gboolean dmabuf,
+                               const gint width, const gint height,
+                               const gchar *name, const gint bitrate)
+{
+    gchar scaler[100];
+    gchar encoder[300];
+    gchar scale_queue[150];
+    gchar encode_queue[150];
+    const gchar *format = "NV12";
+    const gchar *scaler_name = "vspmfilter";
+    gint threads = (gint)g_get_num_processors();
+
+    gst_detect_encode_path();
+
+    if (vsp_available)
+    {
+        g_snprintf(scaler, sizeof(scaler), GST_VSP_SCALER_FMT_STR, (dmabuf) ? "true" : "false");
+    }
+    else if (nv12scale_available && (scale_format_from_string(input_format) != SCALE_FORMAT_UNKNOWN))
+    {
+        /* "openh264enc" needs I420 (see below), NV12 is converted after scaling */
+        g_strlcpy(scaler, (encoder_available == GST_ENCODER_OPENH264) ? GST_NV12_SCALER_I420_STR :
+                                                                        GST_NV12_SCALER_STR, sizeof(scaler));
+        scaler_name = NV12SCALE_ELEMENT_NAME;
+    }
+    else
+    {
+        g_snprintf(scaler, sizeof(scaler), GST_SW_SCALER_FMT_STR, threads);
+        scaler_name = "videoscale/videoconvert";
+    }
+
+    switch (encoder_available)
+    {
+        case GST_ENCODER_OMX:
+            g_snprintf(encoder, sizeof(encoder), GST_OMX_ENCODER_FMT_STR, name, bitrate);
+        break;
+
+        case GST_ENCODER_X264:
+            g_snprintf(encoder, sizeof(encoder), GST_X264_ENCODER_FMT_STR, name, bitrate / 1000,
+                       threads, GST_SW_ENCODER_KEYFRAME_INTERVAL);
+        break;
+
+        case GST_ENCODER_OPENH264:
+            /* "openh264enc" only takes I420 */
+            format = "I420";
+            g_snprintf(encoder, sizeof(encoder), GST_OPENH264_ENCODER_FMT_STR, name, bitrate,
+                       threads, GST_SW_ENCODER_KEYFRAME_INTERVAL);
+        break;
+
+        default:
+            g_message("Error: Cannot encode %s '%s': no H.264 encoder (omxh264enc, x264enc or openh264enc)",
+                      camera_get_type_str(camera), camera_get_id(camera));
+            return FALSE;
+    }
+
+    g_snprintf(scale_queue, sizeof(scale_queue), GST_LEAKY_QUEUE_FMT_STR,
+               name, GST_SCALE_STAGE_NAME, frame_budget);
+    g_snprintf(encode_queue, sizeof(encode_queue), GST_LEAKY_QUEUE_FMT_STR,
+               name, GST_ENCODE_STAGE_NAME, frame_budget);
+
+    if (!gst_append_pipeline(pipeline, CAMERA_ENCODE_FMT_STR,
+                             scale_queue, scaler, format, width, height, encode_queue, encoder, name))
+    {
+        return FALSE;
+    }
+
+    g_message("Info: Encoding of %s '%s' (%s, %dx%d): %s, %s",
+              camera_get_type_str(camera), camera_get_id(camera), name, width, height,
+              scaler_name, gst_encoder_names[encoder_available]);
+
+    return TRUE;
+}
+
+gboolean gst_get_jpeg_decoder(gchar *decoder, const gsize size)
+{
+    gboolean hardware = FALSE;
+
+    if (gst_element_is_available("v4l2jpegdec"))
+    {
+        g_strlcpy(decoder, GST_JPEG_HW_DECODER_STR, size);
+        hardware = TRUE;
+    }
+    else if (gst_element_is_available("avdec_mjpeg"))
+    {
+        /* One thread per CPU core */
+        g_snprintf(decoder, size, GST_JPEG_SW_DECODER_FMT_STR, (gint)g_get_num_processors());
+    }
+    else
+    {
+        g_strlcpy(decoder, GST_JPEG_FALLBACK_DECODER_STR, size);
+    }
+
+    return hardware;
+}
+
+gboolean gst_get_h264_pipeline(const gchar *device, const gint width, const gint height,
+                               gchar *pipeline)
+{
+    struct probe_mode_t mode;
+    gboolean result = TRUE;
+
+    switch (probe_get_h264_support(device))
+    {
+        case PROBE_H264_FORMAT:
+            result = probe_select_mode(device, PROBE_MEDIA_TYPE_H264, width, height,
+                                       CAMERA_DEFAULT_FPS, &mode);
+            if (result)
+            {
+                result = gst_append_pipeline(pipeline, USB_CAM_H264_PIPELINE_FMT_STR, device,
+                                             MAIN_STREAM_BITRATE,
+                                             CAMERA_DEFAULT_FPS * H264_PASSTHROUGH_IFRAME_PERIOD_MS / 1000,
+                                             mode.width, mode.height, mode.fps_n, mode.fps_d);
+            }
+        break;
+
+        case PROBE_H264_UVC_XU:
+            /* "uvch264src" negotiates the frame size with the camera */
+            result = gst_append_pipeline(pipeline, USB_CAM_UVCH264_PIPELINE_FMT_STR, device,
+                                         MAIN_STREAM_BITRATE, MAIN_STREAM_BITRATE, H264_PASSTHROUGH_IFRAME_PERIOD_MS,
+                                         width, height, CAMERA_DEFAULT_FPS);
+        break;
+
+        default:
+            result = FALSE;
+        break;
+    }
+
+    return result;
+}
+
 /* ---------- Functions ---------- */
 
-void print_supported_resolutions (gchar *resolution, const gchar* supported_resolutions[]) {
+void print_supported_resolutions (const gchar *resolution, const gchar* supported_resolutions[]) {
   int index = 0;
   g_message ("%s is unsupported resolution.", resolution);
   g_message ("Please try one of the following resolutions:");
@@ -52,7 +382,7 @@ void print_supported_resolutions (gchar *resolution, const gchar* supported_reso
   }
 }
 
-gboolean check_resolution (gchar *resolution, const gchar *supported_resolutions[]) {
+gboolean check_resolution (const gchar *resolution, const gchar *supported_resolutions[]) {
   gint index = 0;
   gboolean ret = FALSE;
 
@@ -72,67 +402,240 @@ gboolean check_resolution (gchar *resolution, const gchar *supported_resolutions
   return ret;
 }
 
+const gchar** gst_get_supported_resolutions(const enum camera_type_t type)
+{
+    const gchar **result = NULL;
+
+    switch (type)
+    {
+        case MIPI_CAMERA:
+            result = mipi_resolutions;
+        break;
+
+        case USB_CAMERA:
+        case SYNTHETIC_CAMERA:
+            result = usb_resolutions;
+        break;
+
+        default:
+            /* Fake cameras are streamed as they are */
+            result = NULL;
+        break;
+    }
+
+    return result;
+}
+
+gboolean gst_camera_has_h264_passthrough(const gchar *device)
+{
+    enum probe_h264_t h264 = PROBE_H264_NONE;
+
+    /* Check parameter(s) */
+    g_return_val_if_fail(device != NULL, FALSE);
+
+    h264 = probe_get_h264_support(device);
+    if (h264 == PROBE_H264_NONE)
+    {
+        g_debug("Info: '%s' has no on-board H.264 encoder", device);
+        return FALSE;
+    }
+
+    if ((h264 == PROBE_H264_UVC_XU) && (!gst_element_is_available("uvch264src")))
+    {
+        g_message("Warning: '%s' encodes H.264 (%s), but \"uvch264src\" is not installed",
+                  device, probe_h264_to_string(h264));
+        return FALSE;
+    }
+
+    g_message("Info: '%s' encodes H.264 (%s)", device, probe_h264_to_string(h264));
+
+    return TRUE;
+}
+
 gboolean gst_get_camera_pipeline(const struct camera_t *camera, gchar *pipeline,
-                                 gchar *width, gchar *height)
+                                 const gchar *width, const gchar *height)
 {
     gboolean result = TRUE;
     gchar resolution[20];
 
+    struct probe_mode_t mode;
+    gchar decoder[100];
+    gboolean hardware = FALSE;
+    gboolean dmabuf = TRUE;
+    const gchar *input_format = NULL;
+
+    gint output_width = 0;
+    gint output_height = 0;
+    gint sub_width = 0;
+    gint sub_height = 0;
+
     g_return_val_if_fail((camera != NULL) && (pipeline != NULL), FALSE);
 
+    /* Segments are appended (see "gst_append_pipeline()") */
+    pipeline[0] = '\0';
+
     /* Get camera pipeline */
     enum camera_type_t camera_type = camera_get_type(camera);
 
     switch (camera_type)
     {
         case MIPI_CAMERA:
-            if (!g_strcmp0 (width,"")) {
-                g_sprintf(pipeline, MIPI_CAM_PIPELINE_FMT_STR_DEFAULT, camera_get_id(camera));
+            /* The sensor always captures 1280x960, VSP scales frames to the output resolution */
+            output_width = MIPI_CAM_DEFAULT_WIDTH;
+            output_height = MIPI_CAM_DEFAULT_HEIGHT;
+
+            sub_width = MIPI_CAM_SUB_WIDTH;
+            sub_height = MIPI_CAM_SUB_HEIGHT;
 
-                /* Print debug message */
-                g_debug("Info: Pipeline of camera '%s': \"%s\"", camera_get_type_str(camera), pipeline);
-            } else {
+            if (g_strcmp0 (width, "")) {
                 sprintf (resolution, "%sx%s", width, height);
                 if (check_resolution (resolution, mipi_resolutions)) {
-                    g_sprintf(pipeline, MIPI_CAM_PIPELINE_FMT_STR, camera_get_id(camera), width, height);
+                    g_debug("Camera resolution: %s", resolution);
 
-                    /* Print debug message */
-                    g_debug("Camera resolution: %s",resolution);
-                    g_debug("Info: Pipeline of camera '%s': \"%s\"", camera_get_type_str(camera), pipeline);
+                    output_width = (gint)g_ascii_strtoll(width, NULL, 10);
+                    output_height = (gint)g_ascii_strtoll(height, NULL, 10);
                 } else {
                     result = FALSE;
                 }
             }
 
+            if (!gst_append_pipeline(pipeline, MIPI_CAM_CAPTURE_FMT_STR, camera_get_id(camera)))
+            {
+                result = FALSE;
+            }
+
+            input_format = "UYVY";
         break;
 
         case USB_CAMERA:
-            if (!g_strcmp0 (width,"")) {
-                g_sprintf(pipeline, USB_CAM_PIPELINE_FMT_STR_DEFAULT, camera_get_id(camera));
+            /* By default, output 1280x720 */
+            output_width = USB_CAM_DEFAULT_WIDTH;
+            output_height = USB_CAM_DEFAULT_HEIGHT;
+
+            sub_width = USB_CAM_SUB_WIDTH;
+            sub_height = USB_CAM_SUB_HEIGHT;
 
-                /* Print debug message */
-                g_debug("Info: Pipeline of camera '%s': \"%s\"", camera_get_type_str(camera), pipeline);
-            } else {
+            if (g_strcmp0 (width, "")) {
                 sprintf (resolution, "%sx%s", width, height);
-                if (check_resolution (resolution, usb_resolutions)) {
-                    g_sprintf(pipeline, USB_CAM_PIPELINE_FMT_STR, camera_get_id(camera), width, height);
 
-                    /* Print debug message */
-                    g_debug("Camera resolution: %s",resolution);
-                    g_debug("Info: Pipeline of camera '%s': \"%s\"", camera_get_type_str(camera), pipeline);
+                output_width = (gint)g_ascii_strtoll(width, NULL, 10);
+                output_height = (gint)g_ascii_strtoll(height, NULL, 10);
+
+                /* Frame sizes of the device are valid as well as the ones of the table */
+                if (probe_has_frame_size(camera_get_id(camera), output_width, output_height) ||
+                    check_resolution (resolution, usb_resolutions)) {
+                    g_debug("Camera resolution: %s", resolution);
                 } else {
                     result = FALSE;
                 }
             }
 
+            /* Stream H.264 of the camera, there is nothing to encode */
+            if (camera_is_passthrough(camera))
+            {
+                if (gst_get_h264_pipeline(camera_get_id(camera), output_width, output_height, pipeline))
+                {
+                    g_message("Info: H.264 passthrough for '%s' (on-board encoder, no VSP or omxh264enc)",
+                              camera_get_id(camera));
+
+                    output_width = 0;
+                    output_height = 0;
+                    break;
+                }
+
+                g_message("Warning: H.264 passthrough failed for '%s', frames are encoded by omxh264enc",
+                          camera_get_id(camera));
+            }
+
+            /* Capture the cheapest mode of the device which gives the output resolution.
+             * The resource budget may have probed it already */
+            if (camera_get_capture_mode(camera) != NULL)
+            {
+                mode = *camera_get_capture_mode(camera);
+            }
+            else if (!probe_select_mode(camera_get_id(camera), NULL, output_width, output_height,
+                                        CAMERA_DEFAULT_FPS, &mode))
+            {
+                g_strlcpy(mode.media_type, PROBE_MEDIA_TYPE_RAW, sizeof(mode.media_type));
+                g_strlcpy(mode.format, USB_CAM_DEFAULT_CAPTURE_FORMAT, sizeof(mode.format));
+                mode.fps_n = CAMERA_DEFAULT_FPS;
+                mode.fps_d = 1;
+
+                /* Same as the user-defined resolution, or 800x600 upscaled to 1280x720 */
+                mode.width = (g_strcmp0(width, "")) ? output_width : USB_CAM_DEFAULT_CAPTURE_WIDTH;
+                mode.height = (g_strcmp0(width, "")) ? output_height : USB_CAM_DEFAULT_CAPTURE_HEIGHT;
+
+                g_message("Info: Default capture mode of '%s': %s %dx%d@%d/%d", camera_get_id(camera),
+                          mode.format, mode.width, mode.height, mode.fps_n, mode.fps_d);
+            }
+
+            if (g_strcmp0(mode.media_type, PROBE_MEDIA_TYPE_JPEG) == 0)
+            {
+                hardware = gst_get_jpeg_decoder(decoder, sizeof(decoder));
+
+                g_message("Info: MJPEG decoder of '%s': %s (%s)", camera_get_id(camera), decoder,
+                          (hardware) ? "hardware" : "software");
+
+                /* The JPEG unit imports captured frames, software decoders read them */
+                if (!gst_append_pipeline(pipeline, USB_CAM_JPEG_CAPTURE_FMT_STR, camera_get_id(camera),
+                                         (hardware) ? "dmabuf" : "mmap",
+                                         mode.width, mode.height, mode.fps_n, mode.fps_d, decoder))
+                {
+                    result = FALSE;
+                }
+
+                dmabuf = hardware;
+            }
+            else
+            {
+                if (!gst_append_pipeline(pipeline, USB_CAM_CAPTURE_FMT_STR, camera_get_id(camera),
+                                         mode.format, mode.width, mode.height, mode.fps_n, mode.fps_d))
+                {
+                    result = FALSE;
+                }
+
+                input_format = mode.format;
+            }
         break;
 
         case FAKE_CAMERA:
-            g_sprintf(pipeline, FAKE_CAM_PIPELINE_FMT_STR, camera_get_id(camera));
+            /* The clip ("camera_get_id()") is opened by "capture_create()" */
+            g_strlcpy(pipeline, FAKE_CAM_PIPELINE_STR, GST_PIPELINE_MAX_LENGTH);
+        break;
+
+        case SYNTHETIC_CAMERA:
+            /* Same outputs as USB cameras. Patterns are generated at the output resolution */
+            output_width = USB_CAM_DEFAULT_WIDTH;
+            output_height = USB_CAM_DEFAULT_HEIGHT;
+
+            sub_width = USB_CAM_SUB_WIDTH;
+            sub_height = USB_CAM_SUB_HEIGHT;
 
-            /* Print debug message */
-            g_debug("Info: Pipeline of camera '%s': \"%s\"", camera_get_type_str(camera), pipeline);
+            if (g_strcmp0 (width, "")) {
+                output_width = (gint)g_ascii_strtoll(width, NULL, 10);
+                output_height = (gint)g_ascii_strtoll(height, NULL, 10);
+
+                /* Any size can be generated, YUY2 and NV12 need even ones */
+                if ((output_width < 2) || (output_height < 2) ||
+                    (output_width % 2 != 0) || (output_height % 2 != 0)) {
+                    g_message("Error: Resolution %sx%s of '%s' is not even", width, height,
+                              camera_get_id(camera));
+                    result = FALSE;
+                    break;
+                }
+            }
+
+            if (!gst_append_pipeline(pipeline, SYNTHETIC_CAM_CAPTURE_FMT_STR,
+                                     synthetic_patterns[camera_get_motion(camera)],
+                                     output_width, output_height, camera_get_fps(camera)))
+            {
+                result = FALSE;
+            }
 
+            input_format = "YUY2";
+
+            /* "videotestsrc" generates frames in system memory */
+            dmabuf = FALSE;
         break;
 
         default:
@@ -141,6 +644,27 @@ gboolean gst_get_camera_pipeline(const struct camera_t *camera, gchar *pipeline,
         break;
     }
 
+    if (result && (output_width > 0))
+    {
+        /* Add main stream branch */
+        result = gst_add_encode_branch(camera, pipeline, input_format, dmabuf, output_width, output_height,
+                                       GST_MAIN_STREAM_NAME, MAIN_STREAM_BITRATE);
+
+        /* Add substream branch. It is useless if the main stream is not larger */
+        if (result && camera_has_substream(camera) &&
+            ((sub_width * sub_height) < (output_width * output_height)))
+        {
+            result = gst_add_encode_branch(camera, pipeline, input_format, dmabuf, sub_width, sub_height,
+                                           GST_SUB_STREAM_NAME, SUB_STREAM_BITRATE);
+        }
+    }
+
+    if (result)
+    {
+        /* Print debug message */
+        g_debug("Info: Pipeline of camera '%s': \"%s\"", camera_get_type_str(camera), pipeline);
+    }
+
     return result;
 }
 
@@ -165,3 +689,11 @@ GArray* gst_create_urls(const gchar *prefix, const gint count)
 
     return urls;
 }
+
+void gst_set_frame_budget(const gint frames)
+{
+    /* Check parameter(s) */
+    g_return_if_fail((frames >= 1) && (frames <= GST_MAX_FRAME_BUDGET));
+
+    frame_budget = frames;
+}
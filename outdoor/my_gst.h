@@ -5,7 +5,14 @@
  *   Contains APIs related to GStreamer framework.
  *
  * PUBLIC FUNCTIONS:
- *   gboolean gst_get_camera_pipeline(const struct camera_t *camera, gchar *pipeline);
+ *   gboolean gst_get_camera_pipeline(const struct camera_t *camera, gchar *pipeline,
+ *                                    const gchar *width, const gchar *height);
+ *
+ *   const gchar** gst_get_supported_resolutions(const enum camera_type_t type);
+ *
+ *   gboolean gst_camera_has_h264_passthrough(const gchar *device);
+ *
+ *   void gst_set_frame_budget(const gint frames);
  *
  * AUTHOR: RVC       START DATE: 09/01/2020
  *
@@ -18,49 +25,206 @@
 
 /* ---------- Macros ---------- */
 
-#define USB_CAM_PIPELINE_FMT_STR_DEFAULT "( v4l2src device=\"%s\" io-mode=dmabuf "               \
-                                         "! video/x-raw, format=YUY2, width=800, height=600 "    \
-                                         "! vspmfilter dmabuf-use=true "                         \
-                                         "! video/x-raw, format=NV12, width=1280, height=720 "   \
-                                         "! omxh264enc target-bitrate=4000000 quant-p-frames=0 " \
-                                         "! video/x-h264, profile=high "                         \
-                                         "! h264parse "                                          \
-                                         "! video/x-h264, stream-format=avc, alignment=au "      \
-                                         "! rtph264pay pt=96 name=pay0 config-interval=3 )"
-
-#define USB_CAM_PIPELINE_FMT_STR "( v4l2src device=\"%s\" io-mode=dmabuf "               \
-                                 "! video/x-raw, format=YUY2, width=%s, height=%s "      \
-                                 "! vspmfilter dmabuf-use=true "                         \
-                                 "! video/x-raw, format=NV12 "                           \
-                                 "! omxh264enc target-bitrate=4000000 quant-p-frames=0 " \
-                                 "! video/x-h264, profile=high "                         \
-                                 "! h264parse "                                          \
-                                 "! video/x-h264, stream-format=avc, alignment=au "      \
-                                 "! rtph264pay pt=96 name=pay0 config-interval=3 )"
-
-#define MIPI_CAM_PIPELINE_FMT_STR_DEFAULT "( v4l2src device=\"%s\" io-mode=dmabuf "                             \
-                                          "! video/x-raw, format=UYVY, width=1280, height=960, framerate=30/1 " \
-                                          "! vspmfilter dmabuf-use=true "                                       \
-                                          "! video/x-raw, format=NV12 "                                         \
-                                          "! omxh264enc target-bitrate=4000000 quant-p-frames=0 "               \
-                                          "! video/x-h264, profile=high "                                       \
-                                          "! h264parse ! video/x-h264, stream-format=avc, alignment=au "        \
-                                          "! rtph264pay pt=96 name=pay0 config-interval=3 )"
-
-#define MIPI_CAM_PIPELINE_FMT_STR "( v4l2src device=\"%s\" io-mode=dmabuf-import "                      \
-                                  "! video/x-raw, format=UYVY, width=1280, height=960, framerate=30/1 " \
-                                  "! vspfilter "                                                        \
-                                  "! video/x-raw, format=NV12, width=%s, height=%s "                    \
-                                  "! omxh264enc target-bitrate=4000000 quant-p-frames=0 "               \
-                                  "! video/x-h264, profile=high "                                       \
-                                  "! h264parse ! video/x-h264, stream-format=avc, alignment=au "        \
-                                  "! rtph264pay pt=96 name=pay0 config-interval=3 )"
-
-#define FAKE_CAM_PIPELINE_FMT_STR "( filesrc location=\"%s\" "                            \
-                                  "! qtdemux "                                            \
-                                  "! h264parse "                                          \
-                                  "! video/x-h264, stream-format=avc, alignment=au "      \
-                                  "! rtph264pay pt=96 name=pay0 config-interval=3 )"
+/* Capture/output resolutions of the default pipelines below (used to estimate stream costs).
+ * USB cameras capture the cheapest mode reported by the device (see "probe.h"), the
+ * default capture mode is only used if the device cannot be probed */
+#define USB_CAM_DEFAULT_CAPTURE_FORMAT "YUY2"
+#define USB_CAM_DEFAULT_CAPTURE_WIDTH 800
+#define USB_CAM_DEFAULT_CAPTURE_HEIGHT 600
+#define USB_CAM_DEFAULT_WIDTH 1280
+#define USB_CAM_DEFAULT_HEIGHT 720
+
+#define MIPI_CAM_CAPTURE_WIDTH 1280
+#define MIPI_CAM_CAPTURE_HEIGHT 960
+#define MIPI_CAM_DEFAULT_WIDTH 1280
+#define MIPI_CAM_DEFAULT_HEIGHT 960
+
+#define CAMERA_DEFAULT_FPS 30
+
+/* Output resolutions of substreams (low resolution copies of camera streams) */
+#define USB_CAM_SUB_WIDTH 640
+#define USB_CAM_SUB_HEIGHT 360
+
+#define MIPI_CAM_SUB_WIDTH 640
+#define MIPI_CAM_SUB_HEIGHT 480
+
+#define MAIN_STREAM_BITRATE 4000000
+#define SUB_STREAM_BITRATE 800000
+
+/* Key frame interval of cameras with an on-board encoder (1 second, as "config-interval"
+ * of RTSP_PIPELINE_STR and GOP caches need regular key frames) */
+#define H264_PASSTHROUGH_IFRAME_PERIOD_MS 1000
+
+/* Names of "appsink" elements of camera pipelines (one per stream tier) */
+#define GST_MAIN_STREAM_NAME "main"
+#define GST_SUB_STREAM_NAME "sub"
+
+/* Names of encoders of camera pipelines ("main-enc", "sub-enc"), see CAMERA_ENCODE_FMT_STR */
+#define GST_ENCODER_NAME_FMT "%s-enc"
+
+/* Names of the leaky queues in front of the scaler and the encoder of encoding branches
+ * ("main-scale-queue", "sub-encode-queue"...), see GST_LEAKY_QUEUE_FMT_STR */
+#define GST_QUEUE_NAME_FMT "%s-%s-queue"
+#define GST_SCALE_STAGE_NAME "scale"
+#define GST_ENCODE_STAGE_NAME "encode"
+
+/* Latency budget of encoding branches: frames which may wait in front of each stage */
+#define GST_DEFAULT_FRAME_BUDGET 1
+#define GST_MAX_FRAME_BUDGET 30
+
+/* Maximum length of pipeline strings */
+#define GST_PIPELINE_MAX_LENGTH 2048
+
+/*
+ * Camera pipelines capture frames once, then split them (tee "t") into one
+ * encoding branch per stream tier. Each branch scales frames with VSP (dmabuf is
+ * kept from v4l2src to the encoder), encodes them and hands H.264 access units
+ * to an "appsink" element. RTSP media ("RTSP_PIPELINE_STR") are fed from these
+ * "appsink" elements (see "capture.h"). Hosts without VSP or the OMX encoder
+ * use software elements instead (see GST_*_SCALER_* and GST_*_ENCODER_* below).
+ *
+ * Capture, scaling and encoding run in their own threads, separated by leaky
+ * queues (GST_LEAKY_QUEUE_FMT_STR): a late stage drops stale frames instead of
+ * delaying all the next ones.
+ */
+#define USB_CAM_CAPTURE_FMT_STR "v4l2src device=\"%s\" io-mode=dmabuf "                             \
+                                "! video/x-raw, format=%s, width=%d, height=%d, framerate=%d/%d " \
+                                "! tee name=t "
+
+/*
+ * MJPEG capture of USB cameras (1920x1080 at 30 fps does not fit USB 2.0 in raw formats).
+ * Frames are decoded before the tee, by the JPEG unit ("v4l2jpegdec", NV12 exported as
+ * dmabuf to VSP) or by a multithreaded software decoder. The decoder is the "%s" argument
+ * (see GST_JPEG_*_DECODER_* below). Software decoders output system memory, which VSP
+ * reads with "dmabuf-use=false"
+ */
+#define USB_CAM_JPEG_CAPTURE_FMT_STR "v4l2src device=\"%s\" io-mode=%s "                              \
+                                     "! image/jpeg, width=%d, height=%d, framerate=%d/%d "           \
+                                     "! %s "                                                           \
+                                     "! tee name=t "
+
+/*
+ * H.264 passthrough of USB cameras with an on-board encoder (V4L2_PIX_FMT_H264).
+ * There is no tee, VSP or "omxh264enc": the stream of the camera goes to the "appsink"
+ * of the main stream. Bitrate and key frame interval (frames) are set by V4L2 controls
+ * when the camera starts (controls which the camera does not have are ignored)
+ */
+#define USB_CAM_H264_PIPELINE_FMT_STR "v4l2src device=\"%s\" "                                        \
+                                      "extra-controls=\"c,video_bitrate=%d,h264_i_frame_period=%d\" " \
+                                      "! video/x-h264, width=%d, height=%d, framerate=%d/%d "         \
+                                      "! h264parse "                                                   \
+                                      "! video/x-h264, stream-format=avc, alignment=au "               \
+                                      "! appsink name=" GST_MAIN_STREAM_NAME " sync=false "
+
+/*
+ * H.264 passthrough of UVC 1.1 cameras, through their H.264 extension unit ("uvch264src").
+ * The viewfinder pad must be linked for the element to start. Key frame interval is in ms
+ */
+#define USB_CAM_UVCH264_PIPELINE_FMT_STR "uvch264src device=\"%s\" name=src auto-start=true "    \
+                                         "average-bitrate=%d peak-bitrate=%d iframe-period=%d " \
+                                         "src.vfsrc ! queue ! fakesink sync=false "              \
+                                         "src.vidsrc ! queue "                                    \
+                                         "! video/x-h264, width=%d, height=%d, framerate=%d/1 " \
+                                         "! h264parse "                                           \
+                                         "! video/x-h264, stream-format=avc, alignment=au "       \
+                                         "! appsink name=" GST_MAIN_STREAM_NAME " sync=false "
+
+/* JPEG decoders, in order of preference: hardware, multithreaded software, single-threaded software */
+#define GST_JPEG_HW_DECODER_STR "v4l2jpegdec capture-io-mode=dmabuf ! video/x-raw, format=NV12"
+#define GST_JPEG_SW_DECODER_FMT_STR "avdec_mjpeg max-threads=%d"
+#define GST_JPEG_FALLBACK_DECODER_STR "jpegdec"
+
+#define MIPI_CAM_CAPTURE_FMT_STR "v4l2src device=\"%s\" io-mode=dmabuf "                               \
+                                 "! video/x-raw, format=UYVY, width=1280, height=960, framerate=30/1 " \
+                                 "! tee name=t "
+
+/*
+ * Synthetic cameras generate a live test pattern (no device) in the format of USB cameras,
+ * so that their frames take the same encoding branches. Arguments are: the pattern (see
+ * SYNTHETIC_CAM_*_PATTERN_STR below), frame size and frame rate
+ */
+#define SYNTHETIC_CAM_CAPTURE_FMT_STR "videotestsrc is-live=true %s "                              \
+                                      "! video/x-raw, format=YUY2, width=%d, height=%d, framerate=%d/1 " \
+                                      "! tee name=t "
+
+/* Patterns of synthetic cameras, by motion complexity (see "enum camera_motion_t") */
+#define SYNTHETIC_CAM_STATIC_PATTERN_STR "pattern=smpte"
+#define SYNTHETIC_CAM_LOW_PATTERN_STR "pattern=ball"
+#define SYNTHETIC_CAM_MEDIUM_PATTERN_STR "pattern=smpte horizontal-speed=4"
+#define SYNTHETIC_CAM_HIGH_PATTERN_STR "pattern=snow"
+
+/*
+ * Thread boundary in front of a stage of an encoding branch. Arguments are: tier name, stage
+ * name (see GST_QUEUE_NAME_FMT) and latency budget (frames). When the stage is late, the oldest
+ * frame is dropped for the new one ("leaky=downstream"), so latency never builds up
+ */
+#define GST_LEAKY_QUEUE_FMT_STR "queue name=" GST_QUEUE_NAME_FMT " leaky=downstream " \
+                                "max-size-buffers=%d max-size-bytes=0 max-size-time=0"
+
+/* Encoding branch: leaky queue, scaler, raw format, frame size, leaky queue, then encoder (see below) */
+#define CAMERA_ENCODE_FMT_STR "t. ! %s "                                         \
+                              "! %s "                                            \
+                              "! video/x-raw, format=%s, width=%d, height=%d "   \
+                              "! %s "                                            \
+                              "! %s "                                            \
+                              "! h264parse "                                     \
+                              "! video/x-h264, stream-format=avc, alignment=au " \
+                              "! appsink name=%s sync=false "
+
+/*
+ * Scalers, in order of preference: VSP (dmabuf), SIMD scaler of YUY2/UYVY captures (see "nv12scale.h",
+ * NV12 output, converted for encoders which take I420), software scaler and converter (one thread per CPU core)
+ */
+#define GST_VSP_SCALER_FMT_STR "vspmfilter dmabuf-use=%s"
+#define GST_NV12_SCALER_STR "nv12scale"
+#define GST_NV12_SCALER_I420_STR "nv12scale ! videoconvert"
+#define GST_SW_SCALER_FMT_STR "videoscale ! videoconvert n-threads=%d"
+
+/*
+ * H.264 encoders, in order of preference. Arguments are: tier name (see GST_ENCODER_NAME_FMT),
+ * bitrate (bps, kbps for "x264enc"), then for software encoders: threads and key frame interval
+ * (frames, GOP caches need regular key frames). Software encoders run in zero latency mode:
+ * no B-frames, no lookahead, frames are split in slices encoded by parallel threads
+ */
+#define GST_OMX_ENCODER_FMT_STR "omxh264enc name=%s-enc target-bitrate=%d quant-p-frames=0 " \
+                                "! video/x-h264, profile=high"
+
+#define GST_X264_ENCODER_FMT_STR "x264enc name=%s-enc bitrate=%d speed-preset=ultrafast tune=zerolatency " \
+                                 "threads=%d sliced-threads=true key-int-max=%d"
+
+#define GST_OPENH264_ENCODER_FMT_STR "openh264enc name=%s-enc bitrate=%d rate-control=bitrate complexity=low " \
+                                     "usage-type=camera multi-thread=%d gop-size=%d"
+
+/* Key frame interval of software encoders (frames) */
+#define GST_SW_ENCODER_KEYFRAME_INTERVAL CAMERA_DEFAULT_FPS
+
+/* Name of the "appsrc" element of fake camera pipelines, fed by their clip (see "clip.h") */
+#define GST_CLIP_SOURCE_NAME "clip"
+
+/* Videos are indexed once and looped by "clip.h" (no demuxer, no parser). They are not live
+ * sources, "appsink" must synchronize to the clock to play them in real time. Access units
+ * reach "appsink" as the clip pushed them, so their offset is their index (see "replay.h") */
+#define FAKE_CAM_PIPELINE_STR "appsrc name=" GST_CLIP_SOURCE_NAME " format=time " \
+                              "! appsink name=" GST_MAIN_STREAM_NAME " sync=true "
+
+/* Pipeline of RTSP media. Buffers are pushed to "appsrc" and timestamped on arrival */
+#define RTSP_PIPELINE_STR "( appsrc name=src is-live=true format=time do-timestamp=true " \
+                          "! rtph264pay pt=96 name=pay0 config-interval=3 )"
+
+/* Pipeline of RTSP media fed by an RTP cache ("replay.h"). Packets are pushed to "appsrc",
+ * which is the payloader of the media */
+#define RTSP_REPLAY_PIPELINE_STR "( appsrc name=pay0 is-live=true format=time do-timestamp=true )"
+
+/* Paced variants of the pipelines above: "rtppace" (see "rtppace.h") is the last element of
+ * the media, named "pay0" so that the RTSP server links its UDP sinks to it.
+ * Arguments: spread (%), batch (packets) */
+#define RTSP_PACE_STR "rtppace name=pay0 spread=%u batch=%u"
+
+#define RTSP_PACED_PIPELINE_FMT_STR "( appsrc name=src is-live=true format=time do-timestamp=true " \
+                                    "! rtph264pay pt=96 name=rtppay config-interval=3 ! " RTSP_PACE_STR " )"
+
+#define RTSP_PACED_REPLAY_PIPELINE_FMT_STR "( appsrc name=src is-live=true format=time do-timestamp=true " \
+                                           "! " RTSP_PACE_STR " )"
 
 /* ---------- Functions ---------- */
 
@@ -74,7 +238,7 @@
  *
  *   return: void.
  */
-void print_supported_resolutions (gchar *resolution, const gchar* supported_resolutions[]);
+void print_supported_resolutions (const gchar *resolution, const gchar* supported_resolutions[]);
 
 /*
  * Function: gboolean check_resolution
@@ -86,15 +250,47 @@ void print_supported_resolutions (gchar *resolution, const gchar* supported_reso
  *
  *   return: void.
  */
-gboolean check_resolution (gchar *resolution, const gchar *supported_resolutions[]);
+gboolean check_resolution (const gchar *resolution, const gchar *supported_resolutions[]);
+
+/*
+ * Function: gst_get_supported_resolutions
+ * ---
+ *   Get supported resolutions ("<width>x<height>", sorted in ascending order) of a camera type.
+ *
+ *   type: Camera type.
+ *
+ *   Note: The output array must not be de-allocated or modified.
+ *
+ *   return: NULL-terminated array of strings (NULL if "type" has no resolution settings).
+ */
+const gchar** gst_get_supported_resolutions(const enum camera_type_t type);
+
+/*
+ * Function: gst_camera_has_h264_passthrough
+ * ---
+ *   Check if H.264 of "device" can be streamed as it is: the camera encodes H.264
+ *   (see "probe_get_h264_support()") and the GStreamer element which captures it
+ *   is installed. The result is logged.
+ *
+ *   device: Video device (such as: "/dev/video8").
+ *
+ *   return: TRUE (the camera can be a passthrough camera).
+ *           FALSE (frames must be encoded by the pipeline).
+ */
+gboolean gst_camera_has_h264_passthrough(const gchar *device);
 
 /*
  * Function: gst_get_camera_pipeline
  * ---
- *   Creates camera pipeline.
+ *   Creates camera pipeline. The pipeline contains one "appsink" element named
+ *   GST_MAIN_STREAM_NAME, and another one named GST_SUB_STREAM_NAME if "camera"
+ *   has a substream.
+ *
+ *   Passthrough cameras ("camera_is_passthrough()") stream H.264 of the camera:
+ *   the pipeline has no encoder, so the bitrate is the one set at startup.
  *
  *   camera: Pointer to "struct camera_t".
- *   pipeline: Pipeline (output).
+ *   pipeline: Pipeline (output, at least GST_PIPELINE_MAX_LENGTH characters).
  *   width: Pointer to width of camera.
  *   height: Pointer to height of camera.
  *
@@ -104,7 +300,7 @@ gboolean check_resolution (gchar *resolution, const gchar *supported_resolutions
  *   Note: This function is not thread-safe.
  */
 gboolean gst_get_camera_pipeline(const struct camera_t *camera, gchar *pipeline,
-                                 gchar *width, gchar *height);
+                                 const gchar *width, const gchar *height);
 
 /*
  * Function: gst_create_urls
@@ -120,4 +316,17 @@ gboolean gst_get_camera_pipeline(const struct camera_t *camera, gchar *pipeline,
  */
 GArray* gst_create_urls(const gchar *prefix, const gint count);
 
+/*
+ * Function: gst_set_frame_budget
+ * ---
+ *   Sets the latency budget of the encoding branches of the next camera pipelines:
+ *   the number of frames which may wait in front of the scaler and of the encoder
+ *   (GST_DEFAULT_FRAME_BUDGET if not called). Older frames are dropped.
+ *
+ *   frames: 1 to GST_MAX_FRAME_BUDGET.
+ *
+ *   return: void.
+ */
+void gst_set_frame_budget(const gint frames);
+
 #endif
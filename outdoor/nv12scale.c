@@ -0,0 +1,254 @@
+/***********************************************************************
+ * FILENAME: nv12scale.c
+ *
+ * DESCRIPTION:
+ *   "nv12scale" GStreamer element (YUY2/UYVY to NV12 with scaling).
+ *
+ * NOTE:
+ *   For more further information about datatypes and function usages,
+ *   please refer to "nv12scale.h".
+ *
+ * AUTHOR: RVC       START DATE: 17/10/2026
+ *
+ * CHANGES:
+ *
+ ***********************************************************************/
+
+/* ---------- Header files ---------- */
+
+#include <glib.h>
+#include <glib/gprintf.h>
+
+#include <gst/gst.h>
+#include <gst/video/video.h>
+#include <gst/video/gstvideofilter.h>
+
+#include "scale.h"
+#include "nv12scale.h"
+
+/* ---------- Macros ---------- */
+
+/* Input formats are the ones of "scale.h", the output is always NV12 */
+#define NV12SCALE_SINK_FORMATS "{ YUY2, UYVY }"
+#define NV12SCALE_SRC_FORMAT "NV12"
+
+/* ---------- Datatypes ---------- */
+
+typedef struct
+{
+    GstVideoFilter parent;
+
+    struct scale_t *scale;
+} Nv12Scale;
+
+typedef struct
+{
+    GstVideoFilterClass parent_class;
+} Nv12ScaleClass;
+
+G_DEFINE_TYPE(Nv12Scale, nv12scale, GST_TYPE_VIDEO_FILTER);
+
+/* ---------- Variables ---------- */
+
+GstStaticPadTemplate nv12scale_sink_template = GST_STATIC_PAD_TEMPLATE("sink", GST_PAD_SINK, GST_PAD_ALWAYS,
+    GST_STATIC_CAPS(GST_VIDEO_CAPS_MAKE(NV12SCALE_SINK_FORMATS)));
+
+GstStaticPadTemplate nv12scale_src_template = GST_STATIC_PAD_TEMPLATE("src", GST_PAD_SRC, GST_PAD_ALWAYS,
+    GST_STATIC_CAPS(GST_VIDEO_CAPS_MAKE(NV12SCALE_SRC_FORMAT)));
+
+/* ---------- Private functions ---------- */
+
+/*
+ * Function: nv12scale_transform_caps
+ * ---
+ *   Virtual method of "GstBaseTransform". Caps of the other pad: the other format(s),
+ *   any size. Fields which differ between formats (colorimetry, chroma siting) are removed.
+ *
+ *   return: Caps.
+ */
+static GstCaps *nv12scale_transform_caps(GstBaseTransform *trans, GstPadDirection direction,
+                                         GstCaps *caps, GstCaps *filter);
+
+/*
+ * Function: nv12scale_fixate_caps
+ * ---
+ *   Virtual method of "GstBaseTransform". Without constraints from the other side,
+ *   the output size is the input size.
+ *
+ *   return: Fixed caps.
+ */
+static GstCaps *nv12scale_fixate_caps(GstBaseTransform *trans, GstPadDirection direction,
+                                      GstCaps *caps, GstCaps *othercaps);
+
+/*
+ * Function: nv12scale_set_info
+ * ---
+ *   Virtual method of "GstVideoFilter". Creates the conversion of the negotiated caps.
+ *   The kernel is logged.
+ *
+ *   return: TRUE (success), FALSE (sizes are not supported).
+ */
+static gboolean nv12scale_set_info(GstVideoFilter *filter, GstCaps *incaps, GstVideoInfo *in_info,
+                                   GstCaps *outcaps, GstVideoInfo *out_info);
+
+/*
+ * Function: nv12scale_transform_frame
+ * ---
+ *   Virtual method of "GstVideoFilter". Converts a frame.
+ *
+ *   return: GST_FLOW_OK.
+ */
+static GstFlowReturn nv12scale_transform_frame(GstVideoFilter *filter, GstVideoFrame *inframe,
+                                               GstVideoFrame *outframe);
+
+/*
+ * Function: nv12scale_finalize
+ * ---
+ *   Virtual method of "GObject". Frees the conversion.
+ */
+static void nv12scale_finalize(GObject *object);
+
+/* ---------- Private functions ---------- */
+
+GstCaps *nv12scale_transform_caps(GstBaseTransform *trans, GstPadDirection direction,
+                                  GstCaps *caps, GstCaps *filter)
+{
+    GstCaps *result = gst_caps_new_empty();
+    GstCaps *formats = NULL;
+    GstStructure *structure = NULL;
+    guint index = 0;
+
+    /* Formats of the other pad */
+    formats = gst_static_pad_template_get_caps((direction == GST_PAD_SINK) ? &nv12scale_src_template :
+                                                                             &nv12scale_sink_template);
+
+    for (index = 0; index < gst_caps_get_size(caps); index++)
+    {
+        structure = gst_structure_copy(gst_caps_get_structure(caps, index));
+
+        gst_structure_set(structure, "width", GST_TYPE_INT_RANGE, 1, G_MAXINT,
+                          "height", GST_TYPE_INT_RANGE, 1, G_MAXINT, NULL);
+        gst_structure_set_value(structure, "format",
+                                gst_structure_get_value(gst_caps_get_structure(formats, 0), "format"));
+        gst_structure_remove_fields(structure, "colorimetry", "chroma-site", NULL);
+
+        result = gst_caps_merge_structure(result, structure);
+    }
+
+    gst_caps_unref(formats);
+
+    if (filter != NULL)
+    {
+        formats = result;
+        result = gst_caps_intersect_full(filter, formats, GST_CAPS_INTERSECT_FIRST);
+        gst_caps_unref(formats);
+    }
+
+    return result;
+}
+
+GstCaps *nv12scale_fixate_caps(GstBaseTransform *trans, GstPadDirection direction,
+                               GstCaps *caps, GstCaps *othercaps)
+{
+    GstStructure *input = gst_caps_get_structure(caps, 0);
+    GstStructure *output = NULL;
+    gint width = 0;
+    gint height = 0;
+
+    othercaps = gst_caps_make_writable(gst_caps_truncate(othercaps));
+    output = gst_caps_get_structure(othercaps, 0);
+
+    if (gst_structure_get_int(input, "width", &width) && gst_structure_get_int(input, "height", &height))
+    {
+        gst_structure_fixate_field_nearest_int(output, "width", width);
+        gst_structure_fixate_field_nearest_int(output, "height", height);
+    }
+
+    return gst_caps_fixate(othercaps);
+}
+
+gboolean nv12scale_set_info(GstVideoFilter *filter, GstCaps *incaps, GstVideoInfo *in_info,
+                            GstCaps *outcaps, GstVideoInfo *out_info)
+{
+    Nv12Scale *element = (Nv12Scale *)filter;
+    GError *error = NULL;
+    enum scale_format_t format = SCALE_FORMAT_UNKNOWN;
+
+    format = scale_format_from_string(gst_video_format_to_string(GST_VIDEO_INFO_FORMAT(in_info)));
+
+    scale_free(element->scale);
+
+    element->scale = scale_create(format, SCALE_ISA_AUTO,
+                                  GST_VIDEO_INFO_WIDTH(in_info), GST_VIDEO_INFO_HEIGHT(in_info),
+                                  GST_VIDEO_INFO_WIDTH(out_info), GST_VIDEO_INFO_HEIGHT(out_info), &error);
+
+    if (element->scale == NULL)
+    {
+        g_message("Error: %s '%s': %s", NV12SCALE_ELEMENT_NAME, GST_ELEMENT_NAME(filter), error->message);
+        g_error_free(error);
+
+        return FALSE;
+    }
+
+    g_message("Info: %s '%s': %s %dx%d to NV12 %dx%d (%s)", NV12SCALE_ELEMENT_NAME, GST_ELEMENT_NAME(filter),
+              scale_format_to_string(format), GST_VIDEO_INFO_WIDTH(in_info), GST_VIDEO_INFO_HEIGHT(in_info),
+              GST_VIDEO_INFO_WIDTH(out_info), GST_VIDEO_INFO_HEIGHT(out_info), scale_get_kernel(element->scale));
+
+    return TRUE;
+}
+
+GstFlowReturn nv12scale_transform_frame(GstVideoFilter *filter, GstVideoFrame *inframe,
+                                        GstVideoFrame *outframe)
+{
+    Nv12Scale *element = (Nv12Scale *)filter;
+
+    scale_process(element->scale,
+                  GST_VIDEO_FRAME_PLANE_DATA(inframe, 0), GST_VIDEO_FRAME_PLANE_STRIDE(inframe, 0),
+                  GST_VIDEO_FRAME_PLANE_DATA(outframe, 0), GST_VIDEO_FRAME_PLANE_STRIDE(outframe, 0),
+                  GST_VIDEO_FRAME_PLANE_DATA(outframe, 1), GST_VIDEO_FRAME_PLANE_STRIDE(outframe, 1));
+
+    return GST_FLOW_OK;
+}
+
+void nv12scale_finalize(GObject *object)
+{
+    Nv12Scale *element = (Nv12Scale *)object;
+
+    scale_free(element->scale);
+    element->scale = NULL;
+
+    G_OBJECT_CLASS(nv12scale_parent_class)->finalize(object);
+}
+
+static void nv12scale_class_init(Nv12ScaleClass *klass)
+{
+    GObjectClass *object_class = G_OBJECT_CLASS(klass);
+    GstElementClass *element_class = GST_ELEMENT_CLASS(klass);
+    GstBaseTransformClass *transform_class = GST_BASE_TRANSFORM_CLASS(klass);
+    GstVideoFilterClass *filter_class = GST_VIDEO_FILTER_CLASS(klass);
+
+    object_class->finalize = nv12scale_finalize;
+
+    gst_element_class_add_static_pad_template(element_class, &nv12scale_sink_template);
+    gst_element_class_add_static_pad_template(element_class, &nv12scale_src_template);
+    gst_element_class_set_static_metadata(element_class, "NV12 scaler", "Filter/Converter/Video/Scaler",
+                                          "Converts YUY2/UYVY to NV12 with scaling (SIMD kernels)", "RVC");
+
+    transform_class->transform_caps = nv12scale_transform_caps;
+    transform_class->fixate_caps = nv12scale_fixate_caps;
+
+    filter_class->set_info = nv12scale_set_info;
+    filter_class->transform_frame = nv12scale_transform_frame;
+}
+
+static void nv12scale_init(Nv12Scale *element)
+{
+    element->scale = NULL;
+}
+
+/* ---------- Public functions ---------- */
+
+gboolean nv12scale_register()
+{
+    return gst_element_register(NULL, NV12SCALE_ELEMENT_NAME, GST_RANK_NONE, nv12scale_get_type());
+}
@@ -0,0 +1,50 @@
+/***********************************************************************
+ * FILENAME: nv12scale.h
+ *
+ * DESCRIPTION:
+ *   Contains APIs of the "nv12scale" GStreamer element: YUY2/UYVY to
+ *   NV12 conversion with scaling, by the SIMD kernels of "scale.h".
+ *
+ *   The element replaces "videoscale ! videoconvert" in encoding branches
+ *   of hosts without VSP, when cameras capture YUY2 or UYVY. It is built
+ *   in the application (no plugin to install).
+ *
+ * PUBLIC FUNCTIONS:
+ *   gboolean nv12scale_register();
+ *
+ * AUTHOR: RVC       START DATE: 17/10/2026
+ *
+ * CHANGES:
+ *
+ ***********************************************************************/
+
+#ifndef _NV12SCALE_H_
+#define _NV12SCALE_H_
+
+/* ---------- Macros ---------- */
+
+/* Name of the element in pipeline strings */
+#define NV12SCALE_ELEMENT_NAME "nv12scale"
+
+/* ---------- Datatypes ---------- */
+
+/*
+ * Struct: Nv12Scale
+ * ---
+ *   Represents the element (a "GstVideoFilter"):
+ *     - scale (struct scale_t): Conversion of the negotiated caps (NULL before negotiation).
+ */
+
+/* ---------- Functions ---------- */
+
+/*
+ * Function: nv12scale_register
+ * ---
+ *   Registers element NV12SCALE_ELEMENT_NAME, so that pipeline strings can use it.
+ *   GStreamer must be initialized.
+ *
+ *   return: TRUE (success), FALSE (failure).
+ */
+gboolean nv12scale_register();
+
+#endif
@@ -19,6 +19,7 @@
 
 #include <gst/gst.h>
 #include <stdlib.h>
+#include <string.h>
 #include <errno.h>
 
 #include <glib.h>
@@ -29,7 +30,15 @@
 #include <gmodule.h>
 #include <fcntl.h>
 
+#include "media.h"
 #include "camera.h"
+#include "my_gst.h"
+#include "budget.h"
+#include "server.h"
+#include "abr.h"
+#include "profile.h"
+#include "capture.h"
+#include "rtppace.h"
 #include "param.h"
 #include "helper.h"
 
@@ -39,13 +48,54 @@
 #define DEFAULT_CAMERAS 4
 
 #define DEFAULT_PORT_CAM1 5001
-#define DEFAULT_PORT_CAM2 5002
-#define DEFAULT_PORT_CAM3 5003
-#define DEFAULT_PORT_CAM4 5004
 
 #define REGISTERED_PORT_MIN 1024
 #define REGISTERED_PORT_MAX 49151
 
+#define DEFAULT_SERVER_MODE SERVER_MODE_SINGLE
+#define DEFAULT_RTSP_THREADS 4
+#define MAX_RTSP_THREADS 64
+
+#define DEFAULT_ABR_POLICY ABR_POLICY_OFF
+#define DEFAULT_MIN_BITRATE 1000000
+#define DEFAULT_MAX_BITRATE 8000000
+#define MIN_BITRATE 100000
+#define MAX_BITRATE 20000000
+
+#define DEFAULT_UPLINK_BITRATE 0
+#define MAX_UPLINK_BITRATE 1000000000
+
+#define DEFAULT_CONTROL_SOCKET ""
+#define DEFAULT_BOOST_COOLDOWN 30
+#define MAX_BOOST_COOLDOWN 3600
+
+#define DEFAULT_MIPI_INIT_METHOD MEDIA_METHOD_IOCTL
+
+#define DEFAULT_SYNTHETIC_FPS 30
+#define MAX_SYNTHETIC_FPS 120
+#define DEFAULT_SYNTHETIC_MOTION CAMERA_MOTION_MEDIUM
+
+#define MAX_STATS_INTERVAL 3600
+
+#define DEFAULT_PROFILE_TRACE "/tmp/doorphone-outdoor-trace.json"
+
+#define MAX_METRICS_PORT 65535
+
+#define DEFAULT_SESSION_QUEUE (CAPTURE_DEFAULT_SESSION_QUEUE / 1024)
+#define MIN_SESSION_QUEUE 16
+#define MAX_SESSION_QUEUE 65536
+#define DEFAULT_SLOW_CLIENT_POLICY CAPTURE_OVERFLOW_SKIP_TO_IDR
+
+#define DEFAULT_FRAME_BUDGET GST_DEFAULT_FRAME_BUDGET
+#define MAX_FRAME_BUDGET GST_MAX_FRAME_BUDGET
+
+#define DEFAULT_RETRANSMISSION SERVER_DEFAULT_RETRANSMISSION
+#define MAX_RETRANSMISSION SERVER_MAX_RETRANSMISSION
+
+#define DEFAULT_PACING RTPPACE_DEFAULT_SPREAD
+#define DEFAULT_EGRESS_BATCH 0
+#define MAX_EGRESS_BATCH RTPPACE_MAX_BATCH
+
 #define PROGRAM_VERSION "v1.0.0"
 
 #define MP4_VIDEO_EXT "mp4"
@@ -62,11 +112,16 @@
  *   Represents program arguments:
  *     - video_dir (string): Location to a directory which contains videos.
  *
- *     - port (array of integers): Contains ports for RTSP servers to listen to.
+ *     - port (gint): The first port for RTSP servers to listen to.
+ *
+ *     - ports (array of integers): Contains ports for RTSP servers to listen to
+ *       (one port per collected camera, starting from "param_t::port").
  *
  *     - version_enabled (gboolean): Set if user would like to know application's version.
  *
- *     - camera_devs (array of "camera_t" objects): Contains information of all cameras.
+ *     - cameras (array of "camera_t" objects): Contains information of all cameras.
+ *
+ *     - camera_counts (gint): The number of cameras (streams) to collect.
  *
  *     - usb_cam_fds (array of strings): Contains file descriptor of USB cameras
  *       (should not use while programming).
@@ -80,16 +135,77 @@
  *    - width (string): Set if user would like to change camera resolution
  *
  *    - width (height): Set if user would like to change camera resolution
+ *
+ *    - server_mode (enum server_mode_t): Publish all cameras from one RTSP server
+ *      or from one RTSP server per port (legacy layout).
+ *
+ *    - rtsp_threads (gint): Maximum number of worker threads which handle RTSP clients.
+ *
+ *    - substream_enabled (gboolean): Set to FALSE to publish main streams only.
+ *
+ *    - passthrough_enabled (gboolean): Set to FALSE to encode USB cameras which encode H.264 themselves.
+ *
+ *    - keep_warm_enabled (gboolean): Set to start cameras at startup and keep them running.
+ *
+ *    - rtp_cache_enabled (gboolean): Set to FALSE to packetize sample videos on every loop.
+ *
+ *    - abr_policy (enum abr_policy_t): How the bitrate of shared streams follows their clients.
+ *
+ *    - min_bitrate, max_bitrate (gint): Floor and ceiling of main stream bitrates (bps).
+ *
+ *    - uplink_bitrate (gint): Total bitrate shared by all cameras (bps, 0 to disable).
+ *
+ *    - control_socket (string): Path of the control socket (empty to disable).
+ *
+ *    - boost_cooldown (gint): Duration of a camera boost after an event (seconds).
+ *
+ *    - mipi_init_method (enum media_method_t): How the MIPI camera pipeline is configured.
+ *
+ *    - synthetic_counts (gint): The number of synthetic cameras (test patterns) to add.
+ *
+ *    - synthetic_fps (gint): Frame rate of synthetic cameras.
+ *
+ *    - synthetic_motion (enum camera_motion_t): Motion complexity of synthetic camera patterns.
+ *
+ *    - stats_interval (gint): Interval of stream statistics logs (seconds, 0 to disable).
+ *
+ *    - profile_enabled (gboolean): Profile elements of camera pipelines.
+ *
+ *    - profile_trace (string): Path of the trace file of the profiler (empty to disable).
+ *
+ *    - latency_stamp_enabled (gboolean): Stamp access units with their capture time.
+ *
+ *    - metrics_port (gint): Local port of the metrics endpoint (0 to disable).
+ *
+ *    - multicasts (array of "server_multicast_t"): Multicast transport of mount points.
+ *
+ *    - session_queue (gint): Size of the queue of every RTSP session (KB).
+ *
+ *    - slow_client_policy (enum capture_overflow_t): What happens to clients whose queue is full.
+ *
+ *    - frame_budget (gint): Frames which may wait in front of the scaler and the encoder.
+ *
+ *    - pacing (gint): Part of the frame interval over which access units are sent (%).
+ *
+ *    - egress_batch (gint): RTP packets sent at once (0 to send them one by one, unpaced).
+ *
+ *    - retransmission (gint): Retransmission buffer of streams (ms, 0 to disable).
+ *
+ *    - fecs (array of "server_fec_t"): Forward error correction of mount points.
  */
 struct param_t
 {
     gchar video_dir[100];
 
-    gint ports[DEFAULT_CAMERAS];
+    gint port;
+
+    GArray *ports;
 
     gboolean version_enabled;
 
-    struct camera_t *cameras[DEFAULT_CAMERAS];
+    GArray *cameras;
+
+    gint camera_counts;
 
     GArray *usb_cam_fds;
 
@@ -103,6 +219,63 @@ struct param_t
 
     gchar height[10];
 
+    enum server_mode_t server_mode;
+
+    gint rtsp_threads;
+
+    gboolean substream_enabled;
+
+    gboolean passthrough_enabled;
+
+    gboolean keep_warm_enabled;
+
+    gboolean rtp_cache_enabled;
+
+    enum abr_policy_t abr_policy;
+
+    gint min_bitrate;
+
+    gint max_bitrate;
+
+    gint uplink_bitrate;
+
+    gchar control_socket[100];
+
+    gint boost_cooldown;
+
+    enum media_method_t mipi_init_method;
+
+    gint synthetic_counts;
+
+    gint synthetic_fps;
+
+    enum camera_motion_t synthetic_motion;
+
+    gint stats_interval;
+
+    gboolean profile_enabled;
+
+    gchar profile_trace[100];
+
+    gboolean latency_stamp_enabled;
+
+    gint metrics_port;
+
+    GArray *multicasts;
+
+    gint session_queue;
+
+    enum capture_overflow_t slow_client_policy;
+
+    gint frame_budget;
+
+    gint pacing;
+
+    gint egress_batch;
+
+    gint retransmission;
+
+    GArray *fecs;
 };
 
 /* ---------- Private functions ---------- */
@@ -129,6 +302,17 @@ static gboolean param_set_video_dir(const gchar *option_name, const gchar *value
 static gboolean param_set_ports(const gchar *option_name, const gchar *value,
                                 gpointer data, GError **error);
 
+/*
+ * Function: param_set_camera_counts
+ * ---
+ *   Verifies and sets the number of cameras in "param_t" struct.
+ *
+ *   For further information related to parameters, please refer to
+ *   https://developer.gnome.org/glib/stable/glib-Commandline-option-parser.html#GOptionArgFunc
+ */
+static gboolean param_set_camera_counts(const gchar *option_name, const gchar *value,
+                                        gpointer data, GError **error);
+
 /*
  * Function: param_set_width
  * ---
@@ -151,6 +335,270 @@ static gboolean param_set_width(const gchar *option_name, const gchar *value,
 static gboolean param_set_height(const gchar *option_name, const gchar *value,
                                 gpointer data, GError **error);
 
+/*
+ * Function: param_set_server_mode
+ * ---
+ *   Verifies and sets RTSP server mode in "param_t" struct.
+ *
+ *   For further information related to parameters, please refer to
+ *   https://developer.gnome.org/glib/stable/glib-Commandline-option-parser.html#GOptionArgFunc
+ */
+static gboolean param_set_server_mode(const gchar *option_name, const gchar *value,
+                                      gpointer data, GError **error);
+
+/*
+ * Function: param_set_rtsp_threads
+ * ---
+ *   Verifies and sets the number of RTSP worker threads in "param_t" struct.
+ *
+ *   For further information related to parameters, please refer to
+ *   https://developer.gnome.org/glib/stable/glib-Commandline-option-parser.html#GOptionArgFunc
+ */
+static gboolean param_set_rtsp_threads(const gchar *option_name, const gchar *value,
+                                       gpointer data, GError **error);
+
+/*
+ * Function: param_set_abr_policy
+ * ---
+ *   Verifies and sets adaptive bitrate policy in "param_t" struct.
+ *
+ *   For further information related to parameters, please refer to
+ *   https://developer.gnome.org/glib/stable/glib-Commandline-option-parser.html#GOptionArgFunc
+ */
+static gboolean param_set_abr_policy(const gchar *option_name, const gchar *value,
+                                     gpointer data, GError **error);
+
+/*
+ * Function: param_set_min_bitrate
+ * ---
+ *   Verifies and sets the minimum bitrate in "param_t" struct.
+ *
+ *   For further information related to parameters, please refer to
+ *   https://developer.gnome.org/glib/stable/glib-Commandline-option-parser.html#GOptionArgFunc
+ */
+static gboolean param_set_min_bitrate(const gchar *option_name, const gchar *value,
+                                      gpointer data, GError **error);
+
+/*
+ * Function: param_set_max_bitrate
+ * ---
+ *   Verifies and sets the maximum bitrate in "param_t" struct.
+ *
+ *   For further information related to parameters, please refer to
+ *   https://developer.gnome.org/glib/stable/glib-Commandline-option-parser.html#GOptionArgFunc
+ */
+static gboolean param_set_max_bitrate(const gchar *option_name, const gchar *value,
+                                      gpointer data, GError **error);
+
+/*
+ * Function: param_set_uplink_bitrate
+ * ---
+ *   Verifies and sets the total bitrate of all cameras in "param_t" struct.
+ *
+ *   For further information related to parameters, please refer to
+ *   https://developer.gnome.org/glib/stable/glib-Commandline-option-parser.html#GOptionArgFunc
+ */
+static gboolean param_set_uplink_bitrate(const gchar *option_name, const gchar *value,
+                                         gpointer data, GError **error);
+
+/*
+ * Function: param_set_control_socket
+ * ---
+ *   Verifies and sets the path of the control socket in "param_t" struct.
+ *
+ *   For further information related to parameters, please refer to
+ *   https://developer.gnome.org/glib/stable/glib-Commandline-option-parser.html#GOptionArgFunc
+ */
+static gboolean param_set_control_socket(const gchar *option_name, const gchar *value,
+                                         gpointer data, GError **error);
+
+/*
+ * Function: param_set_boost_cooldown
+ * ---
+ *   Verifies and sets the duration of camera boosts in "param_t" struct.
+ *
+ *   For further information related to parameters, please refer to
+ *   https://developer.gnome.org/glib/stable/glib-Commandline-option-parser.html#GOptionArgFunc
+ */
+static gboolean param_set_boost_cooldown(const gchar *option_name, const gchar *value,
+                                         gpointer data, GError **error);
+
+/*
+ * Function: param_set_mipi_init_method
+ * ---
+ *   Verifies and sets how the MIPI camera is initialized in "param_t" struct.
+ *
+ *   For further information related to parameters, please refer to
+ *   https://developer.gnome.org/glib/stable/glib-Commandline-option-parser.html#GOptionArgFunc
+ */
+static gboolean param_set_mipi_init_method(const gchar *option_name, const gchar *value,
+                                           gpointer data, GError **error);
+
+/*
+ * Function: param_set_synthetic_counts
+ * ---
+ *   Verifies and sets the number of synthetic cameras in "param_t" struct.
+ *
+ *   For further information related to parameters, please refer to
+ *   https://developer.gnome.org/glib/stable/glib-Commandline-option-parser.html#GOptionArgFunc
+ */
+static gboolean param_set_synthetic_counts(const gchar *option_name, const gchar *value,
+                                           gpointer data, GError **error);
+
+/*
+ * Function: param_set_synthetic_fps
+ * ---
+ *   Verifies and sets the frame rate of synthetic cameras in "param_t" struct.
+ *
+ *   For further information related to parameters, please refer to
+ *   https://developer.gnome.org/glib/stable/glib-Commandline-option-parser.html#GOptionArgFunc
+ */
+static gboolean param_set_synthetic_fps(const gchar *option_name, const gchar *value,
+                                        gpointer data, GError **error);
+
+/*
+ * Function: param_set_synthetic_motion
+ * ---
+ *   Verifies and sets the motion complexity of synthetic cameras in "param_t" struct.
+ *
+ *   For further information related to parameters, please refer to
+ *   https://developer.gnome.org/glib/stable/glib-Commandline-option-parser.html#GOptionArgFunc
+ */
+static gboolean param_set_synthetic_motion(const gchar *option_name, const gchar *value,
+                                           gpointer data, GError **error);
+
+/*
+ * Function: param_set_stats_interval
+ * ---
+ *   Verifies and sets the interval of stream statistics in "param_t" struct.
+ *
+ *   For further information related to parameters, please refer to
+ *   https://developer.gnome.org/glib/stable/glib-Commandline-option-parser.html#GOptionArgFunc
+ */
+static gboolean param_set_stats_interval(const gchar *option_name, const gchar *value,
+                                         gpointer data, GError **error);
+
+/*
+ * Function: param_set_metrics_port
+ * ---
+ *   Verifies and sets the port of the metrics endpoint in "param_t" struct.
+ *
+ *   For further information related to parameters, please refer to
+ *   https://developer.gnome.org/glib/stable/glib-Commandline-option-parser.html#GOptionArgFunc
+ */
+static gboolean param_set_metrics_port(const gchar *option_name, const gchar *value,
+                                       gpointer data, GError **error);
+
+/*
+ * Function: param_add_multicast
+ * ---
+ *   Verifies and adds the multicast transport of a mount point in "param_t" struct.
+ *
+ *   For further information related to parameters, please refer to
+ *   https://developer.gnome.org/glib/stable/glib-Commandline-option-parser.html#GOptionArgFunc
+ */
+static gboolean param_add_multicast(const gchar *option_name, const gchar *value,
+                                    gpointer data, GError **error);
+
+/*
+ * Function: param_set_session_queue
+ * ---
+ *   Verifies and sets the size of session queues in "param_t" struct.
+ *
+ *   For further information related to parameters, please refer to
+ *   https://developer.gnome.org/glib/stable/glib-Commandline-option-parser.html#GOptionArgFunc
+ */
+static gboolean param_set_session_queue(const gchar *option_name, const gchar *value,
+                                        gpointer data, GError **error);
+
+/*
+ * Function: param_set_slow_client_policy
+ * ---
+ *   Verifies and sets the policy of slow clients in "param_t" struct.
+ *
+ *   For further information related to parameters, please refer to
+ *   https://developer.gnome.org/glib/stable/glib-Commandline-option-parser.html#GOptionArgFunc
+ */
+static gboolean param_set_slow_client_policy(const gchar *option_name, const gchar *value,
+                                             gpointer data, GError **error);
+
+/*
+ * Function: param_set_frame_budget
+ * ---
+ *   Verifies and sets the latency budget of encoding branches in "param_t" struct.
+ *
+ *   For further information related to parameters, please refer to
+ *   https://developer.gnome.org/glib/stable/glib-Commandline-option-parser.html#GOptionArgFunc
+ */
+static gboolean param_set_frame_budget(const gchar *option_name, const gchar *value,
+                                       gpointer data, GError **error);
+
+/*
+ * Function: param_set_pacing
+ * ---
+ *   Verifies and sets the pacing of RTP packets (percentage of frame intervals) in "param_t" struct.
+ *
+ *   For further information related to parameters, please refer to
+ *   https://developer.gnome.org/glib/stable/glib-Commandline-option-parser.html#GOptionArgFunc
+ */
+static gboolean param_set_pacing(const gchar *option_name, const gchar *value,
+                                 gpointer data, GError **error);
+
+/*
+ * Function: param_set_egress_batch
+ * ---
+ *   Verifies and sets the number of RTP packets sent at once in "param_t" struct.
+ *
+ *   For further information related to parameters, please refer to
+ *   https://developer.gnome.org/glib/stable/glib-Commandline-option-parser.html#GOptionArgFunc
+ */
+static gboolean param_set_egress_batch(const gchar *option_name, const gchar *value,
+                                       gpointer data, GError **error);
+
+/*
+ * Function: param_set_retransmission
+ * ---
+ *   Verifies and sets the retransmission buffer of streams in "param_t" struct.
+ *
+ *   For further information related to parameters, please refer to
+ *   https://developer.gnome.org/glib/stable/glib-Commandline-option-parser.html#GOptionArgFunc
+ */
+static gboolean param_set_retransmission(const gchar *option_name, const gchar *value,
+                                         gpointer data, GError **error);
+
+/*
+ * Function: param_add_fec
+ * ---
+ *   Verifies and adds the forward error correction of a mount point in "param_t" struct.
+ *
+ *   For further information related to parameters, please refer to
+ *   https://developer.gnome.org/glib/stable/glib-Commandline-option-parser.html#GOptionArgFunc
+ */
+static gboolean param_add_fec(const gchar *option_name, const gchar *value,
+                              gpointer data, GError **error);
+
+/*
+ * Function: param_set_profile_trace
+ * ---
+ *   Verifies and sets the path of the trace file of the profiler in "param_t" struct.
+ *
+ *   For further information related to parameters, please refer to
+ *   https://developer.gnome.org/glib/stable/glib-Commandline-option-parser.html#GOptionArgFunc
+ */
+static gboolean param_set_profile_trace(const gchar *option_name, const gchar *value,
+                                        gpointer data, GError **error);
+
+/*
+ * Function: param_parse_bitrate
+ * ---
+ *   Parses a bitrate (bps) of option "option_name".
+ *
+ *   returns: TRUE (the bitrate is valid, it is stored in "bitrate").
+ *            FALSE (the bitrate is invalid, "error" is set).
+ */
+static gboolean param_parse_bitrate(const gchar *option_name, const gchar *value,
+                                    gint *bitrate, GError **error);
+
 /*
  * Function: param_set_video_ext
  * ---
@@ -189,7 +637,7 @@ static gboolean param_set_usb_cam(const gchar *option_name, const gchar *value,
  * ---
  *   Check if "param_t::cameras" array is full or not?
  *
- *   returns: TRUE (if the array is full).
+ *   returns: TRUE (if the array already contains "param_t::camera_counts" cameras).
  *            FALSE (if the array still has some empty slots).
  *
  *   Note:
@@ -249,28 +697,68 @@ static void camera_array_init_mipi_cam();
 static void camera_array_init_usb_cam();
 
 /*
- * Function: camera_array_init_fake_cam
+ * Function: camera_array_init_synthetic_cam
  * ---
- *   Initializes fake cameras for "param_t::cameras" array.
+ *   Initializes synthetic cameras for "param_t::cameras" array.
  *
  *   returns: void.
  *
  *   Note: This function is only used for "param_t::cameras" and
  *         is apart of function "camera_array_init".
  */
-static void camera_array_init_fake_cam();
-
-/* ---------- Variables ---------- */
+static void camera_array_init_synthetic_cam();
 
-const gchar *supported_video_exts[] = { MP4_VIDEO_EXT, H264_VIDEO_EXT };
+/*
+ * Function: camera_array_init_fake_cam
+ * ---
+ *   Initializes fake cameras for "param_t::cameras" array.
+ *
+ *   returns: void.
+ *
+ *   Note: This function is only used for "param_t::cameras" and
+ *         is apart of function "camera_array_init".
+ */
+static void camera_array_init_fake_cam();
+
+/*
+ * Function: camera_array_admit
+ * ---
+ *   Checks every camera of "param_t::cameras" array against the resource budget
+ *   of the board ("budget.h"). Cameras which do not fit are downgraded to a lower
+ *   resolution, or removed from the array if no resolution fits. Substreams are
+ *   checked after all main streams, and disabled if they do not fit.
+ *
+ *   returns: void.
+ *
+ *   Note: This function is only used for "param_t::cameras".
+ */
+static void camera_array_admit();
+
+/*
+ * Function: port_array_init
+ * ---
+ *   Initializes "param_t::ports" array (one port per collected camera).
+ *
+ *   returns: TRUE (all ports are valid).
+ *            FALSE (some ports are out of range).
+ */
+static gboolean port_array_init();
+
+/* ---------- Variables ---------- */
+
+const gchar *supported_video_exts[] = { MP4_VIDEO_EXT, H264_VIDEO_EXT };
 
 struct param_t param =
 {
     .video_dir = DEFAULT_VIDEO_DIRECTORY,
 
-    .ports = { DEFAULT_PORT_CAM1, DEFAULT_PORT_CAM2, DEFAULT_PORT_CAM3, DEFAULT_PORT_CAM4 },
+    .port = DEFAULT_PORT_CAM1,
+
+    .ports = NULL,
 
-    .cameras = { NULL, NULL, NULL, NULL },
+    .cameras = NULL,
+
+    .camera_counts = DEFAULT_CAMERAS,
 
     .usb_cam_fds = NULL,
 
@@ -285,6 +773,64 @@ struct param_t param =
     .width[0] = '\0',
 
     .height[0] = '\0',
+
+    .server_mode = DEFAULT_SERVER_MODE,
+
+    .rtsp_threads = DEFAULT_RTSP_THREADS,
+
+    .substream_enabled = TRUE,
+
+    .passthrough_enabled = TRUE,
+
+    .keep_warm_enabled = FALSE,
+
+    .rtp_cache_enabled = TRUE,
+
+    .abr_policy = DEFAULT_ABR_POLICY,
+
+    .min_bitrate = DEFAULT_MIN_BITRATE,
+
+    .max_bitrate = DEFAULT_MAX_BITRATE,
+
+    .uplink_bitrate = DEFAULT_UPLINK_BITRATE,
+
+    .control_socket = DEFAULT_CONTROL_SOCKET,
+
+    .boost_cooldown = DEFAULT_BOOST_COOLDOWN,
+
+    .mipi_init_method = DEFAULT_MIPI_INIT_METHOD,
+
+    .synthetic_counts = 0,
+
+    .synthetic_fps = DEFAULT_SYNTHETIC_FPS,
+
+    .synthetic_motion = DEFAULT_SYNTHETIC_MOTION,
+
+    .stats_interval = 0,
+
+    .profile_enabled = FALSE,
+
+    .profile_trace = DEFAULT_PROFILE_TRACE,
+
+    .latency_stamp_enabled = FALSE,
+
+    .metrics_port = 0,
+
+    .multicasts = NULL,
+
+    .session_queue = DEFAULT_SESSION_QUEUE,
+
+    .slow_client_policy = DEFAULT_SLOW_CLIENT_POLICY,
+
+    .frame_budget = DEFAULT_FRAME_BUDGET,
+
+    .pacing = DEFAULT_PACING,
+
+    .egress_batch = DEFAULT_EGRESS_BATCH,
+
+    .retransmission = DEFAULT_RETRANSMISSION,
+
+    .fecs = NULL,
 };
 
 GOptionContext *context = NULL;
@@ -297,6 +843,9 @@ GOptionEntry entries[] =
     { "rtsp-port", 'p', G_OPTION_FLAG_NONE, G_OPTION_ARG_CALLBACK, param_set_ports,
       "Set RTSP server's port", STR(DEFAULT_PORT_CAM1) },
 
+    { "cameras", 'n', G_OPTION_FLAG_NONE, G_OPTION_ARG_CALLBACK, param_set_camera_counts,
+      "Set the number of camera streams", STR(DEFAULT_CAMERAS) },
+
     { "usb-cam", 'u', G_OPTION_FLAG_NONE, G_OPTION_ARG_CALLBACK, param_set_usb_cam,
       "Add USB camera", "video8" },
 
@@ -315,6 +864,102 @@ GOptionEntry entries[] =
     { "height", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_CALLBACK, param_set_height,
       "Set camera height", NULL },
 
+    { "server-mode", 's', G_OPTION_FLAG_NONE, G_OPTION_ARG_CALLBACK, param_set_server_mode,
+      "Set RTSP server mode: 'single' (one port, mount points /camera-N) "
+      "or 'per-port' (alias: 'legacy')", "single" },
+
+    { "rtsp-threads", 't', G_OPTION_FLAG_NONE, G_OPTION_ARG_CALLBACK, param_set_rtsp_threads,
+      "Set the number of worker threads handling RTSP clients", STR(DEFAULT_RTSP_THREADS) },
+
+    { "no-substream", 0, G_OPTION_FLAG_REVERSE, G_OPTION_ARG_NONE, &param.substream_enabled,
+      "Do not encode low resolution substreams (/camera-N/sub serves the main stream)", NULL },
+
+    { "no-passthrough", 0, G_OPTION_FLAG_REVERSE, G_OPTION_ARG_NONE, &param.passthrough_enabled,
+      "Encode USB cameras with omxh264enc even if they encode H.264 themselves", NULL },
+
+    { "keep-warm", 'w', G_OPTION_FLAG_NONE, G_OPTION_ARG_NONE, &param.keep_warm_enabled,
+      "Start cameras at startup and keep them running (instant first frame)", NULL },
+
+    { "no-rtp-cache", 0, G_OPTION_FLAG_REVERSE, G_OPTION_ARG_NONE, &param.rtp_cache_enabled,
+      "Packetize sample videos with rtph264pay on every loop instead of replaying RTP packets", NULL },
+
+    { "abr", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_CALLBACK, param_set_abr_policy,
+      "Set how the bitrate follows RTCP reports of clients: 'worst', 'median' or 'off'", "off" },
+
+    { "min-bitrate", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_CALLBACK, param_set_min_bitrate,
+      "Set the minimum bitrate of main streams (bps)", STR(DEFAULT_MIN_BITRATE) },
+
+    { "max-bitrate", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_CALLBACK, param_set_max_bitrate,
+      "Set the maximum bitrate of main streams (bps)", STR(DEFAULT_MAX_BITRATE) },
+
+    { "uplink-bitrate", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_CALLBACK, param_set_uplink_bitrate,
+      "Set the total bitrate shared by all cameras (bps, 0 to disable)", STR(DEFAULT_UPLINK_BITRATE) },
+
+    { "control-socket", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_CALLBACK, param_set_control_socket,
+      "Set the path of the control socket (empty to disable)", "<path>" },
+
+    { "boost-cooldown", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_CALLBACK, param_set_boost_cooldown,
+      "Set how long a camera keeps its boost after an event (seconds)", STR(DEFAULT_BOOST_COOLDOWN) },
+
+    { "mipi-init", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_CALLBACK, param_set_mipi_init_method,
+      "Set how the MIPI camera is initialized: 'ioctl' (in-process) or 'media-ctl'", "ioctl" },
+
+    { "synthetic", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_CALLBACK, param_set_synthetic_counts,
+      "Add synthetic cameras (generated test patterns, no device needed)", "0" },
+
+    { "synthetic-fps", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_CALLBACK, param_set_synthetic_fps,
+      "Set the frame rate of synthetic cameras", STR(DEFAULT_SYNTHETIC_FPS) },
+
+    { "synthetic-motion", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_CALLBACK, param_set_synthetic_motion,
+      "Set the motion of synthetic camera patterns: 'static', 'low', 'medium' or 'high'", "medium" },
+
+    { "stats", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_CALLBACK, param_set_stats_interval,
+      "Log frame rate and encode latency of every stream periodically (seconds, 0 to disable)", "0" },
+
+    { "profile", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_NONE, &param.profile_enabled,
+      "Profile every element of camera pipelines (processing time, rates, queue levels, drops)", NULL },
+
+    { "profile-trace", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_CALLBACK, param_set_profile_trace,
+      "Set the trace file of the profiler, for timeline viewers (empty to disable)", DEFAULT_PROFILE_TRACE },
+
+    { "latency-stamp", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_NONE, &param.latency_stamp_enabled,
+      "Stamp frames with their capture time (glass-to-glass latency on the basephone)", NULL },
+
+    { "metrics-port", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_CALLBACK, param_set_metrics_port,
+      "Serve stream metrics (Prometheus text format) on http://127.0.0.1:<port>/metrics (0 to disable)", "0" },
+
+    { "multicast", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_CALLBACK, param_add_multicast,
+      "Publish a mount point ('all' for every one) with multicast transport as well, can be repeated",
+      "<mount>=<first address>[-<last address>]:<first port>-<last port>[:<TTL>]" },
+
+    { "session-queue", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_CALLBACK, param_set_session_queue,
+      "Set the queue of every RTSP session, a client whose queue is full is a slow client (KB)",
+      STR(DEFAULT_SESSION_QUEUE) },
+
+    { "slow-client", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_CALLBACK, param_set_slow_client_policy,
+      "Set what happens to slow clients: 'drop-non-reference', 'skip-to-idr' or 'disconnect'",
+      "skip-to-idr" },
+
+    { "frame-budget", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_CALLBACK, param_set_frame_budget,
+      "Set the frames which may wait in front of scalers and encoders, older frames are dropped",
+      STR(DEFAULT_FRAME_BUDGET) },
+
+    { "pacing", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_CALLBACK, param_set_pacing,
+      "Set the part of frame intervals (%) over which RTP packets of a frame are spread, 0 to send them at once",
+      STR(DEFAULT_PACING) },
+
+    { "egress-batch", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_CALLBACK, param_set_egress_batch,
+      "Set the RTP packets sent per system call (such as: " STR(RTPPACE_DEFAULT_BATCH) "), 0 to send them one by one (no pacing)",
+      STR(DEFAULT_EGRESS_BATCH) },
+
+    { "retransmission", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_CALLBACK, param_set_retransmission,
+      "Set how long RTP packets are kept to answer NACKs of AVPF clients (ms, such as: 300), 0 to disable",
+      STR(DEFAULT_RETRANSMISSION) },
+
+    { "fec", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_CALLBACK, param_add_fec,
+      "Protect a mount point ('all' for every one) with ULPFEC packets (% of media packets), can be repeated",
+      "<mount>[=<percentage>]" },
+
     { NULL }
 };
 
@@ -437,7 +1082,6 @@ gboolean param_set_ports(const gchar *option_name, const gchar *value,
                          gpointer data, GError **error)
 {
     gboolean result = TRUE;
-    gint index = 0;
 
     /* Extract network port */
     gint64 origin_port = g_ascii_strtoll(value, NULL, 10);
@@ -454,16 +1098,40 @@ gboolean param_set_ports(const gchar *option_name, const gchar *value,
     {
         g_debug("Info: The RTSP server's port: %d", (gint)origin_port);
 
-        /* If it is valid, assign the values to "param_t::ports" variable */
-        for (index = 0; index < DEFAULT_CAMERAS; index++)
-        {
-            param.ports[index] = (gint)(origin_port + index);
-        }
+        /* If it is valid, assign the value to "param_t::port" variable.
+         * Ports of other cameras are assigned after collecting cameras */
+        param.port = (gint)origin_port;
     }
 
     return result;
 }
 
+gboolean param_set_camera_counts(const gchar *option_name, const gchar *value,
+                                 gpointer data, GError **error)
+{
+    gchar *end = NULL;
+
+    /* Extract the number of cameras */
+    gint64 counts = g_ascii_strtoll(value, &end, 10);
+
+    if ((end == value) || (*end != '\0') ||
+        (counts < 1) || (counts > (REGISTERED_PORT_MAX - REGISTERED_PORT_MIN + 1)))
+    {
+        /* If it is not valid, set error messages */
+        g_debug("Error: Failed to parse the number of cameras (%s %s)", option_name, value);
+        error_set(error, EINVAL, "%s (%s %s)", g_strerror(EINVAL), option_name, value);
+
+        return FALSE;
+    }
+
+    g_debug("Info: The number of cameras: %d", (gint)counts);
+
+    /* If it is valid, set "counts" to "param_t::camera_counts" variable */
+    param.camera_counts = (gint)counts;
+
+    return TRUE;
+}
+
 gboolean param_set_video_dir(const gchar *option_name, const gchar *value,
                              gpointer data, GError **error)
 {
@@ -515,55 +1183,585 @@ gboolean param_set_height(const gchar *option_name, const gchar *value,
     return TRUE;
 }
 
-gboolean camera_array_is_full()
+gboolean param_set_server_mode(const gchar *option_name, const gchar *value,
+                               gpointer data, GError **error)
+{
+    /* Extract server mode */
+    enum server_mode_t mode = server_mode_from_string(value);
+
+    if (mode == SERVER_MODE_UNKNOWN)
+    {
+        /* If it is not valid, set error messages */
+        g_debug("Error: RTSP server mode '%s' is not supported", value);
+        error_set(error, EINVAL, "%s (%s %s)", g_strerror(EINVAL), option_name, value);
+
+        return FALSE;
+    }
+
+    g_debug("Info: RTSP server mode: %s", server_mode_to_string(mode));
+
+    /* If it is valid, set "mode" to "param_t::server_mode" variable */
+    param.server_mode = mode;
+
+    return TRUE;
+}
+
+gboolean param_set_rtsp_threads(const gchar *option_name, const gchar *value,
+                                gpointer data, GError **error)
+{
+    gchar *end = NULL;
+
+    /* Extract the number of threads */
+    gint64 threads = g_ascii_strtoll(value, &end, 10);
+
+    if ((end == value) || (*end != '\0') || (threads < 0) || (threads > MAX_RTSP_THREADS))
+    {
+        /* If it is not valid, set error messages */
+        g_debug("Error: Failed to parse the number of RTSP threads (%s %s)", option_name, value);
+        error_set(error, EINVAL, "%s (%s %s)", g_strerror(EINVAL), option_name, value);
+
+        return FALSE;
+    }
+
+    g_debug("Info: The number of RTSP threads: %d", (gint)threads);
+
+    /* If it is valid, set "threads" to "param_t::rtsp_threads" variable */
+    param.rtsp_threads = (gint)threads;
+
+    return TRUE;
+}
+
+gboolean param_set_abr_policy(const gchar *option_name, const gchar *value,
+                              gpointer data, GError **error)
+{
+    /* Extract policy */
+    enum abr_policy_t policy = abr_policy_from_string(value);
+
+    if (policy == ABR_POLICY_UNKNOWN)
+    {
+        /* If it is not valid, set error messages */
+        g_debug("Error: Adaptive bitrate policy '%s' is not supported", value);
+        error_set(error, EINVAL, "%s (%s %s)", g_strerror(EINVAL), option_name, value);
+
+        return FALSE;
+    }
+
+    g_debug("Info: Adaptive bitrate policy: %s", abr_policy_to_string(policy));
+
+    /* If it is valid, set "policy" to "param_t::abr_policy" variable */
+    param.abr_policy = policy;
+
+    return TRUE;
+}
+
+gboolean param_parse_bitrate(const gchar *option_name, const gchar *value,
+                             gint *bitrate, GError **error)
+{
+    gchar *end = NULL;
+
+    /* Extract bitrate */
+    gint64 result = g_ascii_strtoll(value, &end, 10);
+
+    if ((end == value) || (*end != '\0') || (result < MIN_BITRATE) || (result > MAX_BITRATE))
+    {
+        /* If it is not valid, set error messages */
+        g_debug("Error: Failed to parse bitrate (%s %s)", option_name, value);
+        error_set(error, EINVAL, "%s (%s %s)", g_strerror(EINVAL), option_name, value);
+
+        return FALSE;
+    }
+
+    *bitrate = (gint)result;
+
+    return TRUE;
+}
+
+gboolean param_set_min_bitrate(const gchar *option_name, const gchar *value,
+                               gpointer data, GError **error)
+{
+    return param_parse_bitrate(option_name, value, &param.min_bitrate, error);
+}
+
+gboolean param_set_max_bitrate(const gchar *option_name, const gchar *value,
+                               gpointer data, GError **error)
+{
+    return param_parse_bitrate(option_name, value, &param.max_bitrate, error);
+}
+
+gboolean param_set_uplink_bitrate(const gchar *option_name, const gchar *value,
+                                  gpointer data, GError **error)
+{
+    gchar *end = NULL;
+
+    /* Extract bitrate (0 disables the allocator) */
+    gint64 bitrate = g_ascii_strtoll(value, &end, 10);
+
+    if ((end == value) || (*end != '\0') || (bitrate < 0) || (bitrate > MAX_UPLINK_BITRATE))
+    {
+        /* If it is not valid, set error messages */
+        g_debug("Error: Failed to parse uplink bitrate (%s %s)", option_name, value);
+        error_set(error, EINVAL, "%s (%s %s)", g_strerror(EINVAL), option_name, value);
+
+        return FALSE;
+    }
+
+    g_debug("Info: Uplink bitrate: %d", (gint)bitrate);
+
+    /* If it is valid, set "bitrate" to "param_t::uplink_bitrate" variable */
+    param.uplink_bitrate = (gint)bitrate;
+
+    return TRUE;
+}
+
+gboolean param_set_control_socket(const gchar *option_name, const gchar *value,
+                                  gpointer data, GError **error)
+{
+    if (strlen(value) >= sizeof(param.control_socket))
+    {
+        /* If it is not valid, set error messages */
+        g_debug("Error: Path of control socket is too long (%s %s)", option_name, value);
+        error_set(error, ENAMETOOLONG, "%s (%s %s)", g_strerror(ENAMETOOLONG), option_name, value);
+
+        return FALSE;
+    }
+
+    g_debug("Info: Control socket: %s", value);
+
+    /* If it is valid, set "value" to "param_t::control_socket" variable */
+    g_stpcpy(param.control_socket, value);
+
+    return TRUE;
+}
+
+gboolean param_set_boost_cooldown(const gchar *option_name, const gchar *value,
+                                  gpointer data, GError **error)
+{
+    gchar *end = NULL;
+
+    /* Extract duration */
+    gint64 cooldown = g_ascii_strtoll(value, &end, 10);
+
+    if ((end == value) || (*end != '\0') || (cooldown < 1) || (cooldown > MAX_BOOST_COOLDOWN))
+    {
+        /* If it is not valid, set error messages */
+        g_debug("Error: Failed to parse boost cooldown (%s %s)", option_name, value);
+        error_set(error, EINVAL, "%s (%s %s)", g_strerror(EINVAL), option_name, value);
+
+        return FALSE;
+    }
+
+    g_debug("Info: Boost cooldown: %d s", (gint)cooldown);
+
+    /* If it is valid, set "cooldown" to "param_t::boost_cooldown" variable */
+    param.boost_cooldown = (gint)cooldown;
+
+    return TRUE;
+}
+
+gboolean param_set_mipi_init_method(const gchar *option_name, const gchar *value,
+                                    gpointer data, GError **error)
+{
+    /* Extract method */
+    enum media_method_t method = media_method_from_string(value);
+
+    if (method == MEDIA_METHOD_UNKNOWN)
+    {
+        /* If it is not valid, set error messages */
+        g_debug("Error: MIPI initialization method '%s' is not supported", value);
+        error_set(error, EINVAL, "%s (%s %s)", g_strerror(EINVAL), option_name, value);
+
+        return FALSE;
+    }
+
+    g_debug("Info: MIPI initialization method: %s", media_method_to_string(method));
+
+    /* If it is valid, set "method" to "param_t::mipi_init_method" variable */
+    param.mipi_init_method = method;
+
+    return TRUE;
+}
+
+gboolean param_set_synthetic_counts(const gchar *option_name, const gchar *value,
+                                    gpointer data, GError **error)
+{
+    gchar *end = NULL;
+
+    /* Extract the number of synthetic cameras */
+    gint64 counts = g_ascii_strtoll(value, &end, 10);
+
+    if ((end == value) || (*end != '\0') ||
+        (counts < 0) || (counts > (REGISTERED_PORT_MAX - REGISTERED_PORT_MIN + 1)))
+    {
+        /* If it is not valid, set error messages */
+        g_debug("Error: Failed to parse the number of synthetic cameras (%s %s)", option_name, value);
+        error_set(error, EINVAL, "%s (%s %s)", g_strerror(EINVAL), option_name, value);
+
+        return FALSE;
+    }
+
+    g_debug("Info: The number of synthetic cameras: %d", (gint)counts);
+
+    /* If it is valid, set "counts" to "param_t::synthetic_counts" variable */
+    param.synthetic_counts = (gint)counts;
+
+    return TRUE;
+}
+
+gboolean param_set_synthetic_fps(const gchar *option_name, const gchar *value,
+                                 gpointer data, GError **error)
+{
+    gchar *end = NULL;
+
+    /* Extract frame rate */
+    gint64 fps = g_ascii_strtoll(value, &end, 10);
+
+    if ((end == value) || (*end != '\0') || (fps < 1) || (fps > MAX_SYNTHETIC_FPS))
+    {
+        /* If it is not valid, set error messages */
+        g_debug("Error: Failed to parse the frame rate of synthetic cameras (%s %s)", option_name, value);
+        error_set(error, EINVAL, "%s (%s %s)", g_strerror(EINVAL), option_name, value);
+
+        return FALSE;
+    }
+
+    g_debug("Info: Frame rate of synthetic cameras: %d fps", (gint)fps);
+
+    /* If it is valid, set "fps" to "param_t::synthetic_fps" variable */
+    param.synthetic_fps = (gint)fps;
+
+    return TRUE;
+}
+
+gboolean param_set_synthetic_motion(const gchar *option_name, const gchar *value,
+                                    gpointer data, GError **error)
+{
+    /* Extract motion complexity */
+    enum camera_motion_t motion = camera_motion_from_string(value);
+
+    if (motion == CAMERA_MOTION_UNKNOWN)
+    {
+        /* If it is not valid, set error messages */
+        g_debug("Error: Motion '%s' of synthetic cameras is not supported", value);
+        error_set(error, EINVAL, "%s (%s %s)", g_strerror(EINVAL), option_name, value);
+
+        return FALSE;
+    }
+
+    g_debug("Info: Motion of synthetic cameras: %s", camera_motion_to_string(motion));
+
+    /* If it is valid, set "motion" to "param_t::synthetic_motion" variable */
+    param.synthetic_motion = motion;
+
+    return TRUE;
+}
+
+gboolean param_set_stats_interval(const gchar *option_name, const gchar *value,
+                                  gpointer data, GError **error)
+{
+    gchar *end = NULL;
+
+    /* Extract interval */
+    gint64 interval = g_ascii_strtoll(value, &end, 10);
+
+    if ((end == value) || (*end != '\0') || (interval < 0) || (interval > MAX_STATS_INTERVAL))
+    {
+        /* If it is not valid, set error messages */
+        g_debug("Error: Failed to parse the interval of statistics (%s %s)", option_name, value);
+        error_set(error, EINVAL, "%s (%s %s)", g_strerror(EINVAL), option_name, value);
+
+        return FALSE;
+    }
+
+    g_debug("Info: Interval of statistics: %d s", (gint)interval);
+
+    /* If it is valid, set "interval" to "param_t::stats_interval" variable */
+    param.stats_interval = (gint)interval;
+
+    return TRUE;
+}
+
+gboolean param_set_metrics_port(const gchar *option_name, const gchar *value,
+                                gpointer data, GError **error)
+{
+    gchar *end = NULL;
+
+    /* Extract port */
+    gint64 port = g_ascii_strtoll(value, &end, 10);
+
+    if ((end == value) || (*end != '\0') || (port < 0) || (port > MAX_METRICS_PORT))
+    {
+        /* If it is not valid, set error messages */
+        g_debug("Error: Failed to parse the port of metrics (%s %s)", option_name, value);
+        error_set(error, EINVAL, "%s (%s %s)", g_strerror(EINVAL), option_name, value);
+
+        return FALSE;
+    }
+
+    g_debug("Info: Port of metrics: %d", (gint)port);
+
+    /* If it is valid, set "port" to "param_t::metrics_port" variable */
+    param.metrics_port = (gint)port;
+
+    return TRUE;
+}
+
+gboolean param_set_session_queue(const gchar *option_name, const gchar *value,
+                                 gpointer data, GError **error)
+{
+    gchar *end = NULL;
+
+    /* Extract size */
+    gint64 size = g_ascii_strtoll(value, &end, 10);
+
+    if ((end == value) || (*end != '\0') || (size < MIN_SESSION_QUEUE) || (size > MAX_SESSION_QUEUE))
+    {
+        /* If it is not valid, set error messages */
+        g_debug("Error: Session queue must be from %d to %d KB (%s %s)",
+                MIN_SESSION_QUEUE, MAX_SESSION_QUEUE, option_name, value);
+        error_set(error, EINVAL, "%s (%s %s)", g_strerror(EINVAL), option_name, value);
+
+        return FALSE;
+    }
+
+    g_debug("Info: Session queue: %d KB", (gint)size);
+
+    /* If it is valid, set "size" to "param_t::session_queue" variable */
+    param.session_queue = (gint)size;
+
+    return TRUE;
+}
+
+gboolean param_set_slow_client_policy(const gchar *option_name, const gchar *value,
+                                      gpointer data, GError **error)
+{
+    /* Extract policy */
+    enum capture_overflow_t policy = capture_overflow_from_string(value);
+
+    if (policy == CAPTURE_OVERFLOW_UNKNOWN)
+    {
+        /* If it is not valid, set error messages */
+        g_debug("Error: Slow client policy '%s' is not supported", value);
+        error_set(error, EINVAL, "%s (%s %s)", g_strerror(EINVAL), option_name, value);
+
+        return FALSE;
+    }
+
+    g_debug("Info: Slow client policy: %s", capture_overflow_to_string(policy));
+
+    /* If it is valid, set "policy" to "param_t::slow_client_policy" variable */
+    param.slow_client_policy = policy;
+
+    return TRUE;
+}
+
+gboolean param_set_frame_budget(const gchar *option_name, const gchar *value,
+                                gpointer data, GError **error)
+{
+    gchar *end = NULL;
+
+    /* Extract frames */
+    gint64 frames = g_ascii_strtoll(value, &end, 10);
+
+    if ((end == value) || (*end != '\0') || (frames < 1) || (frames > MAX_FRAME_BUDGET))
+    {
+        /* If it is not valid, set error messages */
+        g_debug("Error: Frame budget must be from 1 to %d (%s %s)", MAX_FRAME_BUDGET, option_name, value);
+        error_set(error, EINVAL, "%s (%s %s)", g_strerror(EINVAL), option_name, value);
+
+        return FALSE;
+    }
+
+    g_debug("Info: Frame budget: %d", (gint)frames);
+
+    /* If it is valid, set "frames" to "param_t::frame_budget" variable */
+    param.frame_budget = (gint)frames;
+
+    return TRUE;
+}
+
+gboolean param_set_pacing(const gchar *option_name, const gchar *value,
+                          gpointer data, GError **error)
+{
+    gchar *end = NULL;
+
+    /* Extract percentage */
+    gint64 percent = g_ascii_strtoll(value, &end, 10);
+
+    if ((end == value) || (*end != '\0') || (percent < 0) || (percent > 100))
+    {
+        /* If it is not valid, set error messages */
+        g_debug("Error: Pacing must be from 0 to 100 (%s %s)", option_name, value);
+        error_set(error, EINVAL, "%s (%s %s)", g_strerror(EINVAL), option_name, value);
+
+        return FALSE;
+    }
+
+    g_debug("Info: Pacing: %d%%", (gint)percent);
+
+    /* If it is valid, set "percent" to "param_t::pacing" variable */
+    param.pacing = (gint)percent;
+
+    return TRUE;
+}
+
+gboolean param_set_egress_batch(const gchar *option_name, const gchar *value,
+                                gpointer data, GError **error)
+{
+    gchar *end = NULL;
+
+    /* Extract packets */
+    gint64 packets = g_ascii_strtoll(value, &end, 10);
+
+    if ((end == value) || (*end != '\0') || (packets < 0) || (packets > MAX_EGRESS_BATCH))
+    {
+        /* If it is not valid, set error messages */
+        g_debug("Error: Egress batch must be from 0 to %d (%s %s)", MAX_EGRESS_BATCH, option_name, value);
+        error_set(error, EINVAL, "%s (%s %s)", g_strerror(EINVAL), option_name, value);
+
+        return FALSE;
+    }
+
+    g_debug("Info: Egress batch: %d", (gint)packets);
+
+    /* If it is valid, set "packets" to "param_t::egress_batch" variable */
+    param.egress_batch = (gint)packets;
+
+    return TRUE;
+}
+
+gboolean param_set_retransmission(const gchar *option_name, const gchar *value,
+                                  gpointer data, GError **error)
+{
+    gchar *end = NULL;
+
+    /* Extract time */
+    gint64 time = g_ascii_strtoll(value, &end, 10);
+
+    if ((end == value) || (*end != '\0') || (time < 0) || (time > MAX_RETRANSMISSION))
+    {
+        /* If it is not valid, set error messages */
+        g_debug("Error: Retransmission buffer must be from 0 to %d ms (%s %s)", MAX_RETRANSMISSION,
+                option_name, value);
+        error_set(error, EINVAL, "%s (%s %s)", g_strerror(EINVAL), option_name, value);
+
+        return FALSE;
+    }
+
+    g_debug("Info: Retransmission buffer: %d ms", (gint)time);
+
+    /* If it is valid, set "time" to "param_t::retransmission" variable */
+    param.retransmission = (gint)time;
+
+    return TRUE;
+}
+
+gboolean param_add_fec(const gchar *option_name, const gchar *value,
+                       gpointer data, GError **error)
+{
+    struct server_fec_t fec;
+
+    /* Extract mount point and percentage */
+    if (!server_parse_fec(value, &fec))
+    {
+        /* If it is not valid, set error messages */
+        g_debug("Error: Failed to parse forward error correction (%s %s)", option_name, value);
+        error_set(error, EINVAL, "%s (%s %s)", g_strerror(EINVAL), option_name, value);
+
+        return FALSE;
+    }
+
+    g_debug("Info: ULPFEC of %s: %d%%", fec.mount, fec.percentage);
+
+    /* If it is valid, append "fec" to "param_t::fecs" array */
+    if (param.fecs == NULL)
+    {
+        param.fecs = g_array_new(FALSE, FALSE, sizeof(struct server_fec_t));
+    }
+
+    g_array_append_val(param.fecs, fec);
+
+    return TRUE;
+}
+
+gboolean param_add_multicast(const gchar *option_name, const gchar *value,
+                             gpointer data, GError **error)
+{
+    struct server_multicast_t multicast;
+
+    /* Extract mount point, addresses, ports and TTL */
+    if (!server_parse_multicast(value, &multicast))
+    {
+        /* If it is not valid, set error messages */
+        g_debug("Error: Failed to parse multicast transport (%s %s)", option_name, value);
+        error_set(error, EINVAL, "%s (%s %s)", g_strerror(EINVAL), option_name, value);
+
+        return FALSE;
+    }
+
+    g_debug("Info: Multicast of %s: %s-%s, ports %d-%d, TTL %d", multicast.mount,
+            multicast.min_address, multicast.max_address, multicast.min_port,
+            multicast.max_port, multicast.ttl);
+
+    /* If it is valid, append "multicast" to "param_t::multicasts" array */
+    if (param.multicasts == NULL)
+    {
+        param.multicasts = g_array_new(FALSE, FALSE, sizeof(struct server_multicast_t));
+    }
+
+    g_array_append_val(param.multicasts, multicast);
+
+    return TRUE;
+}
+
+gboolean param_set_profile_trace(const gchar *option_name, const gchar *value,
+                                 gpointer data, GError **error)
 {
-    gint index = 0;
-
-    /* Try to find an available slot in "param_t::cameras" array */
-    for (index = 0; index < DEFAULT_CAMERAS; index++)
+    if (strlen(value) >= sizeof(param.profile_trace))
     {
-        /* If found, the array is not full */
-        if (param.cameras[index] == NULL)
-        {
-            return FALSE;
-        }
+        /* If it is not valid, set error messages */
+        g_debug("Error: Path of trace file is too long (%s %s)", option_name, value);
+        error_set(error, ENAMETOOLONG, "%s (%s %s)", g_strerror(ENAMETOOLONG), option_name, value);
+
+        return FALSE;
     }
 
+    g_debug("Info: Trace file of the profiler: %s", value);
+
+    /* If it is valid, set "value" to "param_t::profile_trace" variable */
+    g_stpcpy(param.profile_trace, value);
+
     return TRUE;
 }
 
-gboolean camera_array_add(struct camera_t *camera)
+gboolean camera_array_is_full()
 {
-    gboolean result = TRUE;
-    gint index = 0;
+    return ((param.cameras != NULL) && ((gint)param.cameras->len >= param.camera_counts));
+}
 
+gboolean camera_array_add(struct camera_t *camera)
+{
     /* Check parameter(s) */
     g_return_val_if_fail(camera != NULL, FALSE);
 
-    /* Look for an available slot. If found, add "camera" to "param_t::cameras" */
-    for (index = 0; index < DEFAULT_CAMERAS; index++)
+    /* Allocate new array for the first time */
+    if (param.cameras == NULL)
     {
-        if (param.cameras[index] != NULL)
-        {
-            g_debug("Info: param_t::cameras[%d] is occupied", index);
-        }
-        else
-        {
-            g_debug("Info: param_t::cameras[%d] is empty", index);
-
-            param.cameras[index] = camera;
-            break;
-        }
+        param.cameras = g_array_sized_new(FALSE, FALSE, sizeof(struct camera_t*), param.camera_counts);
     }
 
     /* Raise warning if the array is full */
-    if (index == DEFAULT_CAMERAS)
+    if (camera_array_is_full())
     {
         g_debug("Warning: 'param_t::cameras' array is full");
-        result = FALSE;
+        return FALSE;
     }
 
-    return result;
+    g_debug("Info: param_t::cameras[%d] is added", param.cameras->len);
+
+    /* Add "camera" to the end of "param_t::cameras" */
+    g_array_append_val(param.cameras, camera);
+
+    return TRUE;
 }
 
 void camera_array_init()
@@ -576,6 +1774,9 @@ void camera_array_init()
     /* Initialize USB camera(s) */
     camera_array_init_usb_cam();
 
+    /* Initialize synthetic camera(s) */
+    camera_array_init_synthetic_cam();
+
     /* Initialize fake camera(s) */
     camera_array_init_fake_cam();
 }
@@ -599,7 +1800,9 @@ void camera_array_init_fake_cam()
         /* Get files which have supported extension */
         file_get(param.video_dir, param.video_ext, &file_arr, &file_arr_size); 
 
-        for (index = 0; index < file_arr_size; index++)
+        /* Videos are reused (in the same order) until all slots are filled */
+        for (index = 0; (file_arr_size > 0) && !camera_array_is_full();
+             index = (index + 1) % file_arr_size)
         {
             /* Create an absolute path to the file "file_name" */
             file_name = g_array_index(file_arr, gchar*, index);
@@ -637,6 +1840,78 @@ void camera_array_init_fake_cam()
     }
 }
 
+void camera_array_admit()
+{
+    struct budget_t *budget = NULL;
+    struct camera_t *camera = NULL;
+
+    guint index = 0;
+
+    if (param.cameras == NULL)
+    {
+        return;
+    }
+
+    /* Get resources of the board */
+    budget = budget_create();
+
+    /* Cameras are checked in priority order (MIPI, USB, synthetic, then fake cameras) */
+    index = 0;
+    while (index < param.cameras->len)
+    {
+        camera = g_array_index(param.cameras, struct camera_t*, index);
+
+        /* Apply user-defined resolution and substream setting before checking the budget */
+        camera_set_resolution(camera, param.width, param.height);
+        camera_set_substream(camera, param.substream_enabled);
+
+        if (budget_admit(budget, camera))
+        {
+            index++;
+        }
+        else
+        {
+            /* Remove the camera so that it never reaches pipeline creation */
+            g_array_remove_index(param.cameras, index);
+            g_free(camera);
+        }
+    }
+
+    /* Then substreams, with what main streams left */
+    for (index = 0; index < param.cameras->len; index++)
+    {
+        budget_admit_substream(budget, g_array_index(param.cameras, struct camera_t*, index));
+    }
+
+    /* Print resources used by admitted cameras */
+    budget_print_all(budget);
+
+    budget_free(budget);
+}
+
+gboolean port_array_init()
+{
+    gint index = 0;
+    gint port = 0;
+
+    param.ports = g_array_sized_new(FALSE, FALSE, sizeof(gint), param.cameras->len);
+
+    for (index = 0; index < (gint)param.cameras->len; index++)
+    {
+        port = param.port + index;
+
+        if (port > REGISTERED_PORT_MAX)
+        {
+            g_debug("Error: RTSP server's port %d is out of range", port);
+            return FALSE;
+        }
+
+        g_array_append_val(param.ports, port);
+    }
+
+    return TRUE;
+}
+
 void camera_array_init_usb_cam()
 {
     gint index = 0;
@@ -655,6 +1930,14 @@ void camera_array_init_usb_cam()
 
             /* Create new "camera_t" object */
             struct camera_t *usb_cam = usb_camera_create(usb_cam_fd);
+
+            /* Stream H.264 of cameras with an on-board encoder (keeps omxh264enc and VSP free) */
+            if ((usb_cam != NULL) && param.passthrough_enabled &&
+                gst_camera_has_h264_passthrough(camera_get_id(usb_cam)))
+            {
+                camera_set_passthrough(usb_cam, TRUE);
+            }
+
             if (camera_array_add(usb_cam))
             {
                 g_message("Info: USB camera '%s' added", usb_cam_fd);
@@ -672,6 +1955,33 @@ void camera_array_init_usb_cam()
     }
 }
 
+void camera_array_init_synthetic_cam()
+{
+    struct camera_t *synthetic_cam = NULL;
+    gint index = 0;
+
+    for (index = 0; index < param.synthetic_counts; index++)
+    {
+        /* Create new "camera_t" object */
+        synthetic_cam = synthetic_camera_create(index + 1, param.synthetic_fps, param.synthetic_motion);
+
+        if (camera_array_add(synthetic_cam))
+        {
+            g_message("Info: Synthetic camera '%s' added", camera_get_id(synthetic_cam));
+        }
+        else
+        {
+            /* Free up "camera_t" object */
+            g_free(synthetic_cam);
+
+            /* Raise error message */
+            g_message("Error: Cannot add synthetic camera %d (%d camera(s) at most, see option -n)",
+                      index + 1, param.camera_counts);
+            break;
+        }
+    }
+}
+
 void camera_array_init_mipi_cam()
 {
     /* Add MIPI camera */
@@ -683,7 +1993,7 @@ void camera_array_init_mipi_cam()
     {
         g_debug("Info: MIPI camera option is enabled");
 
-        struct camera_t *mipi_camera = mipi_camera_init();
+        struct camera_t *mipi_camera = mipi_camera_init(param.mipi_init_method);
         if (mipi_camera != NULL)
         {
             g_debug("Info: Added MIPI camera");
@@ -714,7 +2024,24 @@ gboolean param_parse(int *argc, char ***argv, gchar *error_str)
     g_option_context_add_main_entries (context, entries, NULL);
     g_option_context_add_group (context, gst_init_get_option_group());
 
-    if (g_option_context_parse (context, argc, argv, &error))
+    if (!g_option_context_parse (context, argc, argv, &error))
+    {
+        /* Return error message if unable to parse */
+        g_stpcpy(error_str, error->message);
+
+        /* Free resources */
+        g_clear_error(&error);
+
+        result = FALSE;
+    }
+    else if (param.min_bitrate > param.max_bitrate)
+    {
+        /* Raise error if the bitrate range is empty */
+        g_stpcpy(error_str, "Minimum bitrate is higher than maximum bitrate");
+
+        result = FALSE;
+    }
+    else
     {
         /* Initialize "param_t::cameras" if parsing process has no problems.
          *
@@ -727,24 +2054,30 @@ gboolean param_parse(int *argc, char ***argv, gchar *error_str)
          */
         camera_array_init();
 
+        /* Drop or downgrade cameras which do not fit the board's resources */
+        camera_array_admit();
+
         /* Check if the app collects enough cameras */
-        if (!camera_array_is_full())
+        if ((param.cameras == NULL) || (param.cameras->len == 0))
         {
-            /* Raise error if there are not enough cameras */
+            /* Raise error if there are no cameras */
             g_stpcpy(error_str, "Not collect enough cameras");
 
             result = FALSE;
         }
-    }
-    else
-    {
-        /* Return error message if unable to parse */
-        g_stpcpy(error_str, error->message);
-
-        /* Free resources */
-        g_clear_error(&error);
+        else if (!port_array_init())
+        {
+            /* Raise error if some ports are out of range */
+            g_stpcpy(error_str, "Not enough RTSP server's ports");
 
-        result = FALSE;
+            result = FALSE;
+        }
+        else if (!camera_array_is_full())
+        {
+            /* Continue with admitted cameras */
+            g_message("Warning: Only %d of %d camera(s) collected",
+                      param.cameras->len, param.camera_counts);
+        }
     }
 
     return result;
@@ -758,12 +2091,32 @@ void param_free()
     g_option_context_free(context);
 
     /* Free "param_t::cameras" */
-    for (index = 0; index < DEFAULT_CAMERAS; index++)
+    if (param.cameras != NULL)
     {
-        if (param.cameras[index] != NULL)
+        for (index = 0; index < (gint)param.cameras->len; index++)
         {
-            g_free(param.cameras[index]);
+            g_free(g_array_index(param.cameras, struct camera_t*, index));
         }
+
+        g_array_free(param.cameras, TRUE);
+    }
+
+    /* Free "param_t::ports" */
+    if (param.ports != NULL)
+    {
+        g_array_free(param.ports, TRUE);
+    }
+
+    /* Free "param_t::multicasts" */
+    if (param.multicasts != NULL)
+    {
+        g_array_free(param.multicasts, TRUE);
+    }
+
+    /* Free "param_t::fecs" */
+    if (param.fecs != NULL)
+    {
+        g_array_free(param.fecs, TRUE);
     }
 
     /* Free "param_t::usb_cam_fds" */
@@ -776,25 +2129,45 @@ void param_free()
 void param_print_all()
 {
     gint index = 0;
-    gchar camera_info[100];
+    gchar camera_info[200];
+    struct server_multicast_t *multicast = NULL;
+    struct server_fec_t *fec = NULL;
 
     /* Print video directory */
     g_message("Video directory: %s", param.video_dir);
 
     /* Print RTSP ports */
-    for (index = 0; index < DEFAULT_CAMERAS; index++)
+    for (index = 0; (param.ports != NULL) && (index < (gint)param.ports->len); index++)
+    {
+        g_message("RTSP server's port %d: %d", index + 1, g_array_index(param.ports, gint, index));
+    }
+
+    /* Print multicast transports */
+    for (index = 0; (param.multicasts != NULL) && (index < (gint)param.multicasts->len); index++)
+    {
+        multicast = &g_array_index(param.multicasts, struct server_multicast_t, index);
+
+        g_message("Multicast of %s: %s-%s, ports %d-%d, TTL %d", multicast->mount,
+                  multicast->min_address, multicast->max_address, multicast->min_port,
+                  multicast->max_port, multicast->ttl);
+    }
+
+    /* Print packet loss recovery */
+    g_message("Retransmission buffer: %d ms%s", param.retransmission,
+              (param.retransmission > 0) ? " (AVPF clients)" : " (disabled)");
+
+    for (index = 0; (param.fecs != NULL) && (index < (gint)param.fecs->len); index++)
     {
-        g_message("RTSP server's port %d: %d", index + 1, param.ports[index]);
+        fec = &g_array_index(param.fecs, struct server_fec_t, index);
+
+        g_message("ULPFEC of %s: %d%%", fec->mount, fec->percentage);
     }
 
     /* Print cameras */
-    for (index = 0; index < DEFAULT_CAMERAS; index++)
+    for (index = 0; (param.cameras != NULL) && (index < (gint)param.cameras->len); index++)
     {
-        if (param.cameras[index] != NULL)
-        {
-            camera_print_all(param.cameras[index], camera_info);
-            g_message("Camera %d: %s", index + 1, camera_info);
-        }
+        camera_print_all(g_array_index(param.cameras, struct camera_t*, index), camera_info);
+        g_message("Camera %d: %s", index + 1, camera_info);
     }
 
     /* Print MIPI camera support status */
@@ -802,6 +2175,92 @@ void param_print_all()
 
     /* Print supported video extension */
     g_message("Supported video extension: %s", param.video_ext);
+
+    /* Print RTSP server mode */
+    g_message("RTSP server mode: %s", server_mode_to_string(param.server_mode));
+    g_message("RTSP worker threads: %d", param.rtsp_threads);
+
+    /* Print substream status */
+    g_message("Encode substreams: %s", (param.substream_enabled) ? "yes" : "no");
+
+    /* Print H.264 passthrough status */
+    g_message("H.264 passthrough of USB cameras: %s", (param.passthrough_enabled) ? "yes" : "no");
+
+    /* Print keep-warm status */
+    g_message("Keep cameras warm: %s", (param.keep_warm_enabled) ? "yes" : "no");
+
+    /* Print RTP cache status */
+    g_message("Replay sample videos from an RTP cache: %s", (param.rtp_cache_enabled) ? "yes" : "no");
+
+    /* Print adaptive bitrate settings */
+    g_message("Adaptive bitrate: %s (%d to %d bps)", abr_policy_to_string(param.abr_policy),
+              param.min_bitrate, param.max_bitrate);
+
+    /* Print bitrate allocation settings */
+    if (param.uplink_bitrate > 0)
+    {
+        g_message("Uplink bitrate: %d bps (boost cooldown: %d s)",
+                  param.uplink_bitrate, param.boost_cooldown);
+    }
+    else
+    {
+        g_message("Uplink bitrate: unlimited");
+    }
+
+    g_message("Control socket: %s",
+              (param.control_socket[0] != '\0') ? param.control_socket : "disabled");
+
+    /* Print statistics status */
+    if (param.stats_interval > 0)
+    {
+        g_message("Stream statistics: every %d s", param.stats_interval);
+    }
+    else
+    {
+        g_message("Stream statistics: disabled");
+    }
+
+    /* Print profiler status */
+    if (param.profile_enabled)
+    {
+        g_message("Profiler: enabled (trace file: %s)",
+                  (param.profile_trace[0] != '\0') ? param.profile_trace : "none");
+    }
+    else
+    {
+        g_message("Profiler: disabled");
+    }
+
+    /* Print latency stamp status */
+    g_message("Stamp capture time of frames: %s", (param.latency_stamp_enabled) ? "yes" : "no");
+
+    /* Print metrics status */
+    if (param.metrics_port > 0)
+    {
+        g_message("Metrics: http://127.0.0.1:%d/metrics", param.metrics_port);
+    }
+    else
+    {
+        g_message("Metrics: disabled");
+    }
+
+    /* Print slow client handling */
+    g_message("Session queue: %d KB, slow clients: %s", param.session_queue,
+              capture_overflow_to_string(param.slow_client_policy));
+
+    /* Print latency budget of encoding branches */
+    g_message("Frame budget: %d frame(s) in front of scalers and encoders", param.frame_budget);
+
+    /* Print egress of RTP packets */
+    if (param.egress_batch > 0)
+    {
+        g_message("Egress: %d packet(s) per batch, paced over %d%% of frame intervals",
+                  param.egress_batch, param.pacing);
+    }
+    else
+    {
+        g_message("Egress: one packet per system call, not paced");
+    }
 }
 
 const gchar* param_get_version()
@@ -818,8 +2277,8 @@ void param_get_rtsp_server_ports(int **ports, gint *size)
 {
     g_return_if_fail((ports != NULL) && (size != NULL));
 
-    *ports = param.ports;
-    *size = DEFAULT_CAMERAS;
+    *ports = (gint*)param.ports->data;
+    *size = param.ports->len;
 }
 
 gboolean param_get_cameras(struct camera_t ***cameras, gint *size)
@@ -828,12 +2287,12 @@ gboolean param_get_cameras(struct camera_t ***cameras, gint *size)
 
     g_return_val_if_fail((cameras != NULL) && (size != NULL), FALSE);
 
-    *cameras = param.cameras;
-    *size = DEFAULT_CAMERAS;
+    *cameras = (struct camera_t**)param.cameras->data;
+    *size = param.cameras->len;
 
     if (!camera_array_is_full())
     {
-        g_debug("Error: Cannot collect enough cameras");
+        g_debug("Warning: Cannot collect enough cameras");
         result = FALSE;
     }
 
@@ -851,4 +2310,123 @@ gboolean param_get_resolution(gchar *width, gchar *height)
     //height = g_strdup_printf("%s", param.height);
 
     return result;
-}
\ No newline at end of file
+}
+
+enum server_mode_t param_get_server_mode()
+{
+    return param.server_mode;
+}
+
+gint param_get_rtsp_threads()
+{
+    return param.rtsp_threads;
+}
+
+gboolean param_is_keep_warm_enabled()
+{
+    return param.keep_warm_enabled;
+}
+
+gboolean param_is_rtp_cache_enabled()
+{
+    return param.rtp_cache_enabled;
+}
+
+enum abr_policy_t param_get_abr_policy()
+{
+    return param.abr_policy;
+}
+
+void param_get_bitrate_range(gint *min_bitrate, gint *max_bitrate)
+{
+    g_return_if_fail((min_bitrate != NULL) && (max_bitrate != NULL));
+
+    *min_bitrate = param.min_bitrate;
+    *max_bitrate = param.max_bitrate;
+}
+
+gint param_get_uplink_bitrate()
+{
+    return param.uplink_bitrate;
+}
+
+const gchar* param_get_control_socket()
+{
+    return param.control_socket;
+}
+
+gint param_get_boost_cooldown()
+{
+    return param.boost_cooldown;
+}
+
+gint param_get_stats_interval()
+{
+    return param.stats_interval;
+}
+
+gboolean param_is_profile_enabled()
+{
+    return param.profile_enabled;
+}
+
+const gchar* param_get_profile_trace()
+{
+    return param.profile_trace;
+}
+
+gboolean param_is_latency_stamp_enabled()
+{
+    return param.latency_stamp_enabled;
+}
+
+gint param_get_metrics_port()
+{
+    return param.metrics_port;
+}
+
+void param_get_multicasts(const struct server_multicast_t **multicasts, gint *size)
+{
+    g_return_if_fail((multicasts != NULL) && (size != NULL));
+
+    *multicasts = (param.multicasts != NULL) ? (const struct server_multicast_t*)param.multicasts->data : NULL;
+    *size = (param.multicasts != NULL) ? (gint)param.multicasts->len : 0;
+}
+
+gint param_get_session_queue()
+{
+    return param.session_queue;
+}
+
+enum capture_overflow_t param_get_slow_client_policy()
+{
+    return param.slow_client_policy;
+}
+
+gint param_get_frame_budget()
+{
+    return param.frame_budget;
+}
+
+gint param_get_pacing()
+{
+    return param.pacing;
+}
+
+gint param_get_egress_batch()
+{
+    return param.egress_batch;
+}
+
+gint param_get_retransmission()
+{
+    return param.retransmission;
+}
+
+void param_get_fecs(const struct server_fec_t **fecs, gint *size)
+{
+    g_return_if_fail((fecs != NULL) && (size != NULL));
+
+    *fecs = (param.fecs != NULL) ? (const struct server_fec_t*)param.fecs->data : NULL;
+    *size = (param.fecs != NULL) ? (gint)param.fecs->len : 0;
+}
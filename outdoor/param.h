@@ -19,6 +19,52 @@
  *
  *   gboolean param_get_cameras(struct camera_t ***cameras, gint *size);
  *
+ *   gboolean param_get_resolution(gchar *width, gchar *height);
+ *
+ *   enum server_mode_t param_get_server_mode();
+ *
+ *   gint param_get_rtsp_threads();
+ *
+ *   gboolean param_is_keep_warm_enabled();
+ *
+ *   gboolean param_is_rtp_cache_enabled();
+ *
+ *   enum abr_policy_t param_get_abr_policy();
+ *
+ *   void param_get_bitrate_range(gint *min_bitrate, gint *max_bitrate);
+ *
+ *   gint param_get_uplink_bitrate();
+ *
+ *   const gchar* param_get_control_socket();
+ *
+ *   gint param_get_boost_cooldown();
+ *
+ *   gint param_get_stats_interval();
+ *
+ *   gboolean param_is_profile_enabled();
+ *
+ *   const gchar* param_get_profile_trace();
+ *
+ *   gboolean param_is_latency_stamp_enabled();
+ *
+ *   gint param_get_metrics_port();
+ *
+ *   void param_get_multicasts(const struct server_multicast_t **multicasts, gint *size);
+ *
+ *   gint param_get_session_queue();
+ *
+ *   enum capture_overflow_t param_get_slow_client_policy();
+ *
+ *   gint param_get_frame_budget();
+ *
+ *   gint param_get_pacing();
+ *
+ *   gint param_get_egress_batch();
+ *
+ *   gint param_get_retransmission();
+ *
+ *   void param_get_fecs(const struct server_fec_t **fecs, gint *size);
+ *
  * AUTHOR: RVC       START DATE: 25/12/2019
  *
  * CHANGES:
@@ -126,4 +172,219 @@ gboolean param_get_cameras(struct camera_t ***cameras, gint *size);
  *            FALSE (incorrect parameters).
  */
 gboolean param_get_resolution(gchar *width, gchar *height);
+
+/*
+ * Function: param_get_server_mode
+ * ---
+ *   Get RTSP server mode from "param_t::server_mode".
+ *
+ *   returns: SERVER_MODE_SINGLE (all cameras are published by one RTSP server).
+ *            SERVER_MODE_PER_PORT (each camera is published by its own RTSP server).
+ */
+enum server_mode_t param_get_server_mode();
+
+/*
+ * Function: param_get_rtsp_threads
+ * ---
+ *   Get the number of RTSP worker threads from "param_t::rtsp_threads".
+ *
+ *   returns: gint (the number of threads).
+ */
+gint param_get_rtsp_threads();
+
+/*
+ * Function: param_is_keep_warm_enabled
+ * ---
+ *   Check if cameras should be started at startup and kept running or not?
+ *
+ *   returns: TRUE (cameras are kept warm).
+ *            FALSE (cameras only run while they have clients).
+ */
+gboolean param_is_keep_warm_enabled();
+
+/*
+ * Function: param_is_rtp_cache_enabled
+ * ---
+ *   Check if sample videos should be replayed from an RTP packet cache or not?
+ *
+ *   returns: TRUE (sample videos are packetized once).
+ *            FALSE (sample videos are packetized by "rtph264pay" on every loop).
+ */
+gboolean param_is_rtp_cache_enabled();
+
+/*
+ * Function: param_get_abr_policy
+ * ---
+ *   Get adaptive bitrate policy from "param_t::abr_policy".
+ *
+ *   returns: ABR_POLICY_OFF (bitrates are fixed).
+ *            ABR_POLICY_WORST (bitrates follow the worst client).
+ *            ABR_POLICY_MEDIAN (bitrates follow the median client).
+ */
+enum abr_policy_t param_get_abr_policy();
+
+/*
+ * Function: param_get_bitrate_range
+ * ---
+ *   Get floor and ceiling of main stream bitrates (bps).
+ *
+ *   returns: void.
+ */
+void param_get_bitrate_range(gint *min_bitrate, gint *max_bitrate);
+
+/*
+ * Function: param_get_uplink_bitrate
+ * ---
+ *   Get the total bitrate shared by all cameras from "param_t::uplink_bitrate".
+ *
+ *   returns: gint (bitrate in bps, 0 if bitrates are not allocated).
+ */
+gint param_get_uplink_bitrate();
+
+/*
+ * Function: param_get_control_socket
+ * ---
+ *   Get the path of the control socket from "param_t::control_socket".
+ *
+ *   Note: The output string must not be modified or deallocated.
+ *
+ *   returns: gchar* (path, empty if the control socket is disabled).
+ */
+const gchar* param_get_control_socket();
+
+/*
+ * Function: param_get_boost_cooldown
+ * ---
+ *   Get the duration of camera boosts from "param_t::boost_cooldown".
+ *
+ *   returns: gint (seconds).
+ */
+gint param_get_boost_cooldown();
+
+/*
+ * Function: param_get_stats_interval
+ * ---
+ *   Get the interval of stream statistics logs from "param_t::stats_interval".
+ *
+ *   returns: gint (seconds, 0 if statistics are disabled).
+ */
+gint param_get_stats_interval();
+
+/*
+ * Function: param_is_profile_enabled
+ * ---
+ *   Check if elements of camera pipelines are profiled ("param_t::profile_enabled").
+ *
+ *   returns: TRUE (enabled), FALSE (disabled).
+ */
+gboolean param_is_profile_enabled();
+
+/*
+ * Function: param_get_profile_trace
+ * ---
+ *   Get the path of the trace file of the profiler from "param_t::profile_trace".
+ *
+ *   Note: The output string must not be modified or deallocated.
+ *
+ *   returns: gchar* (path, empty if no trace file is written).
+ */
+const gchar* param_get_profile_trace();
+
+/*
+ * Function: param_is_latency_stamp_enabled
+ * ---
+ *   Check if access units are stamped with their capture time ("param_t::latency_stamp_enabled").
+ *
+ *   returns: TRUE (enabled), FALSE (disabled).
+ */
+gboolean param_is_latency_stamp_enabled();
+
+/*
+ * Function: param_get_metrics_port
+ * ---
+ *   Get the local port of the metrics endpoint from "param_t::metrics_port".
+ *
+ *   returns: gint (port, 0 if disabled).
+ */
+gint param_get_metrics_port();
+
+/*
+ * Function: param_get_multicasts
+ * ---
+ *   Get the multicast transports of mount points from "param_t::multicasts".
+ *
+ *   multicasts: Multicast transport list (output, NULL if there is none).
+ *   size: Multicast transport counts (output).
+ *
+ *   returns: void.
+ */
+void param_get_multicasts(const struct server_multicast_t **multicasts, gint *size);
+
+/*
+ * Function: param_get_session_queue
+ * ---
+ *   Get the size of the queue of every RTSP session from "param_t::session_queue".
+ *
+ *   returns: gint (KB).
+ */
+gint param_get_session_queue();
+
+/*
+ * Function: param_get_slow_client_policy
+ * ---
+ *   Get what happens to slow clients from "param_t::slow_client_policy".
+ *
+ *   returns: CAPTURE_OVERFLOW_DROP_NON_REFERENCE (drop frames no other frame refers to).
+ *            CAPTURE_OVERFLOW_SKIP_TO_IDR (drop frames until the next keyframe).
+ *            CAPTURE_OVERFLOW_DISCONNECT (close the connection of the client).
+ */
+enum capture_overflow_t param_get_slow_client_policy();
+
+/*
+ * Function: param_get_frame_budget
+ * ---
+ *   Get the latency budget of encoding branches from "param_t::frame_budget".
+ *
+ *   returns: gint (frames which may wait in front of the scaler and the encoder).
+ */
+gint param_get_frame_budget();
+
+/*
+ * Function: param_get_pacing
+ * ---
+ *   Get the pacing of RTP packets from "param_t::pacing".
+ *
+ *   returns: gint (part of frame intervals over which access units are sent, %).
+ */
+gint param_get_pacing();
+
+/*
+ * Function: param_get_egress_batch
+ * ---
+ *   Get the number of RTP packets sent at once from "param_t::egress_batch".
+ *
+ *   returns: gint (packets, 0 if RTP packets are sent one by one and not paced).
+ */
+gint param_get_egress_batch();
+
+/*
+ * Function: param_get_retransmission
+ * ---
+ *   Get the retransmission buffer of streams from "param_t::retransmission".
+ *
+ *   returns: gint (ms, 0 if retransmissions are disabled).
+ */
+gint param_get_retransmission();
+
+/*
+ * Function: param_get_fecs
+ * ---
+ *   Get the forward error correction of mount points from "param_t::fecs".
+ *
+ *   fecs: Forward error correction list (output, NULL if there is none).
+ *   size: Forward error correction counts (output).
+ *
+ *   returns: void.
+ */
+void param_get_fecs(const struct server_fec_t **fecs, gint *size);
 #endif
@@ -0,0 +1,664 @@
+/***********************************************************************
+ * FILENAME: probe.c
+ *
+ * DESCRIPTION:
+ *   Capture mode probing of V4L2 cameras.
+ *
+ * NOTE:
+ *   For more further information about datatypes and function usages,
+ *   please refer to "probe.h".
+ *
+ * AUTHOR: RVC       START DATE: 17/10/2026
+ *
+ * CHANGES:
+ *
+ ***********************************************************************/
+
+/* ---------- Header files ---------- */
+
+#include <glib.h>
+#include <glib/gprintf.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+
+#include <linux/videodev2.h>
+
+#include "probe.h"
+
+/* ---------- Macros ---------- */
+
+/* UVC class-specific descriptors (USB Video Class 1.1, appendix A) */
+#define UVC_CS_INTERFACE 0x24
+#define UVC_VC_EXTENSION_UNIT 0x06
+
+/* Offset of "guidExtensionCode" in extension unit descriptors */
+#define UVC_XU_GUID_OFFSET 4
+#define UVC_XU_GUID_LENGTH 16
+
+/* ---------- Datatypes ---------- */
+
+/*
+ * Struct: probe_format_t
+ * ---
+ *   Represents a pixel format supported by camera pipelines:
+ *     - pixelformat (guint32): V4L2 pixel format.
+ *     - media_type (string): GStreamer media type of the format.
+ *     - name (string): GStreamer name of the format (raw formats) or a readable name.
+ *     - bits_per_pixel (gint): Memory bandwidth per pixel.
+ *     - dmabuf (gboolean): Set if VSP imports frames as they are.
+ */
+struct probe_format_t
+{
+    guint32 pixelformat;
+
+    const gchar *media_type;
+
+    const gchar *name;
+
+    gint bits_per_pixel;
+
+    gboolean dmabuf;
+};
+
+/* ---------- Private variables ---------- */
+
+/* Raw formats which VSP converts to NV12 for the encoder, compressed formats
+ * which are decoded first (bandwidth of the decoded frames, usually YUV 4:2:2),
+ * and H.264 which is streamed as it is (no VSP, no decoding) */
+const struct probe_format_t probe_formats[] =
+{
+    { V4L2_PIX_FMT_NV12, PROBE_MEDIA_TYPE_RAW, "NV12", 12, TRUE },
+    { V4L2_PIX_FMT_NV16, PROBE_MEDIA_TYPE_RAW, "NV16", 16, TRUE },
+    { V4L2_PIX_FMT_YUYV, PROBE_MEDIA_TYPE_RAW, "YUY2", 16, TRUE },
+    { V4L2_PIX_FMT_UYVY, PROBE_MEDIA_TYPE_RAW, "UYVY", 16, TRUE },
+    { V4L2_PIX_FMT_MJPEG, PROBE_MEDIA_TYPE_JPEG, "MJPEG", 16, FALSE },
+    { V4L2_PIX_FMT_H264, PROBE_MEDIA_TYPE_H264, "H264", 0, FALSE }
+};
+
+/* GUID of the UVC H.264 extension unit {A29E7641-DE04-47E3-8B2B-F4341AFF003B},
+ * as stored in descriptors (first three fields are little-endian) */
+const guint8 uvc_h264_xu_guid[UVC_XU_GUID_LENGTH] =
+{
+    0x41, 0x76, 0x9E, 0xA2, 0x04, 0xDE, 0xE3, 0x47,
+    0x8B, 0x2B, 0xF4, 0x34, 0x1A, 0xFF, 0x00, 0x3B
+};
+
+/* ---------- Private functions ---------- */
+
+/*
+ * Function: probe_ioctl
+ * ---
+ *   Same as "ioctl()", retries on EINTR.
+ */
+static gint probe_ioctl(gint fd, gulong request, gpointer arg);
+
+/*
+ * Function: probe_get_format
+ * ---
+ *   Get the pipeline settings of "pixelformat".
+ *
+ *   return: NULL if camera pipelines do not support "pixelformat".
+ */
+static const struct probe_format_t *probe_get_format(const guint32 pixelformat);
+
+/*
+ * Function: probe_enum_modes
+ * ---
+ *   Enumerates all modes of "fd" in formats supported by camera pipelines.
+ *   Stepwise and continuous ranges add their largest size and highest frame
+ *   rate, and the requested ones if they are in the range.
+ *
+ *   return: Array of "struct probe_mode_t" (NULL if the device cannot be probed).
+ */
+static GArray *probe_enum_modes(const gint fd, const gint width, const gint height, const gint fps);
+
+/*
+ * Function: probe_enum_intervals
+ * ---
+ *   Adds one mode per frame interval of "format" at "width"x"height" to "modes".
+ *
+ *   return: void.
+ */
+static void probe_enum_intervals(const gint fd, const struct probe_format_t *format,
+                                 const guint32 width, const guint32 height,
+                                 const gint fps, GArray *modes);
+
+/*
+ * Function: probe_add_mode
+ * ---
+ *   Adds a mode to "modes".
+ *
+ *   return: void.
+ */
+static void probe_add_mode(GArray *modes, const struct probe_format_t *format,
+                           const gint width, const gint height, const gint fps_n, const gint fps_d);
+
+/*
+ * Function: probe_get_bandwidth
+ * ---
+ *   Get the memory bandwidth of "mode" (bytes per second).
+ */
+static guint64 probe_get_bandwidth(const struct probe_mode_t *mode);
+
+/*
+ * Function: probe_is_better
+ * ---
+ *   Compare two modes for an output of "width"x"height" at "fps" (see "probe_select_mode()").
+ *
+ *   return: TRUE if "a" is cheaper than "b".
+ */
+static gboolean probe_is_better(const struct probe_mode_t *a, const struct probe_mode_t *b,
+                                const gint width, const gint height, const gint fps);
+
+/*
+ * Function: probe_is_selectable
+ * ---
+ *   Check if "mode" matches the "media_type" filter of "probe_select_mode()".
+ */
+static gboolean probe_is_selectable(const struct probe_mode_t *mode, const gchar *media_type);
+
+/*
+ * Function: probe_has_uvc_h264_xu
+ * ---
+ *   Look for the UVC H.264 extension unit in the USB descriptors of "device".
+ *   The descriptors are read from sysfs, so that the USB device is not opened.
+ *
+ *   return: TRUE (the extension unit is found).
+ *           FALSE (not found, or "device" is not a USB camera).
+ */
+static gboolean probe_has_uvc_h264_xu(const gchar *device);
+
+/* ---------- Private functions ---------- */
+
+gint probe_ioctl(gint fd, gulong request, gpointer arg)
+{
+    gint result = 0;
+
+    do
+    {
+        result = ioctl(fd, request, arg);
+    }
+    while ((result == -1) && (errno == EINTR));
+
+    return result;
+}
+
+const struct probe_format_t *probe_get_format(const guint32 pixelformat)
+{
+    guint index = 0;
+
+    for (index = 0; index < G_N_ELEMENTS(probe_formats); index++)
+    {
+        if (probe_formats[index].pixelformat == pixelformat)
+        {
+            return &probe_formats[index];
+        }
+    }
+
+    return NULL;
+}
+
+void probe_add_mode(GArray *modes, const struct probe_format_t *format,
+                    const gint width, const gint height, const gint fps_n, const gint fps_d)
+{
+    struct probe_mode_t mode;
+
+    memset(&mode, 0, sizeof(mode));
+
+    mode.pixelformat = format->pixelformat;
+    g_strlcpy(mode.media_type, format->media_type, sizeof(mode.media_type));
+    g_strlcpy(mode.format, format->name, sizeof(mode.format));
+    mode.width = width;
+    mode.height = height;
+    mode.fps_n = fps_n;
+    mode.fps_d = MAX(fps_d, 1);
+    mode.dmabuf = format->dmabuf;
+    mode.bits_per_pixel = format->bits_per_pixel;
+
+    g_array_append_val(modes, mode);
+}
+
+void probe_enum_intervals(const gint fd, const struct probe_format_t *format,
+                          const guint32 width, const guint32 height,
+                          const gint fps, GArray *modes)
+{
+    struct v4l2_frmivalenum interval;
+    const struct v4l2_fract *fastest = NULL;
+    const struct v4l2_fract *slowest = NULL;
+    guint mode_counts = modes->len;
+
+    memset(&interval, 0, sizeof(interval));
+    interval.pixel_format = format->pixelformat;
+    interval.width = width;
+    interval.height = height;
+
+    while (probe_ioctl(fd, VIDIOC_ENUM_FRAMEINTERVALS, &interval) == 0)
+    {
+        if (interval.type == V4L2_FRMIVAL_TYPE_DISCRETE)
+        {
+            /* Frame rate is the inverse of the frame interval */
+            probe_add_mode(modes, format, width, height,
+                           interval.discrete.denominator, interval.discrete.numerator);
+        }
+        else
+        {
+            fastest = &interval.stepwise.min;
+            slowest = &interval.stepwise.max;
+
+            probe_add_mode(modes, format, width, height, fastest->denominator, fastest->numerator);
+
+            /* Requested frame rate: fastest <= 1/fps <= slowest */
+            if (((guint64)fastest->numerator * fps <= fastest->denominator) &&
+                ((guint64)slowest->numerator * fps >= slowest->denominator))
+            {
+                probe_add_mode(modes, format, width, height, fps, 1);
+            }
+
+            /* There is only one range */
+            break;
+        }
+
+        interval.index++;
+    }
+
+    /* Some drivers do not report intervals: assume the requested frame rate */
+    if (modes->len == mode_counts)
+    {
+        probe_add_mode(modes, format, width, height, fps, 1);
+    }
+}
+
+GArray *probe_enum_modes(const gint fd, const gint width, const gint height, const gint fps)
+{
+    GArray *modes = NULL;
+    const struct probe_format_t *format = NULL;
+
+    struct v4l2_fmtdesc desc;
+    struct v4l2_frmsizeenum size;
+
+    memset(&desc, 0, sizeof(desc));
+    desc.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+
+    modes = g_array_new(FALSE, TRUE, sizeof(struct probe_mode_t));
+
+    for (desc.index = 0; probe_ioctl(fd, VIDIOC_ENUM_FMT, &desc) == 0; desc.index++)
+    {
+        format = probe_get_format(desc.pixelformat);
+        if (format == NULL)
+        {
+            g_debug("Info: Skipped format '%.32s' (not supported by camera pipelines)",
+                    (const gchar*)desc.description);
+            continue;
+        }
+
+        memset(&size, 0, sizeof(size));
+        size.pixel_format = desc.pixelformat;
+
+        while (probe_ioctl(fd, VIDIOC_ENUM_FRAMESIZES, &size) == 0)
+        {
+            if (size.type == V4L2_FRMSIZE_TYPE_DISCRETE)
+            {
+                probe_enum_intervals(fd, format, size.discrete.width, size.discrete.height,
+                                     fps, modes);
+            }
+            else
+            {
+                probe_enum_intervals(fd, format, size.stepwise.max_width, size.stepwise.max_height,
+                                     fps, modes);
+
+                /* Requested frame size, if it is in the range (continuous ranges have steps of 1) */
+                if ((width >= (gint)size.stepwise.min_width) && (width < (gint)size.stepwise.max_width) &&
+                    (height >= (gint)size.stepwise.min_height) && (height < (gint)size.stepwise.max_height) &&
+                    (((width - size.stepwise.min_width) % MAX(size.stepwise.step_width, 1)) == 0) &&
+                    (((height - size.stepwise.min_height) % MAX(size.stepwise.step_height, 1)) == 0))
+                {
+                    probe_enum_intervals(fd, format, width, height, fps, modes);
+                }
+
+                /* There is only one range */
+                break;
+            }
+
+            size.index++;
+        }
+    }
+
+    /* Not a capture device */
+    if (desc.index == 0)
+    {
+        g_array_free(modes, TRUE);
+        modes = NULL;
+    }
+
+    return modes;
+}
+
+guint64 probe_get_bandwidth(const struct probe_mode_t *mode)
+{
+    return (guint64)mode->width * mode->height * mode->bits_per_pixel / 8 * mode->fps_n / mode->fps_d;
+}
+
+gboolean probe_is_better(const struct probe_mode_t *a, const struct probe_mode_t *b,
+                         const gint width, const gint height, const gint fps)
+{
+    gboolean a_rate = ((guint64)a->fps_n >= (guint64)fps * a->fps_d);
+    gboolean b_rate = ((guint64)b->fps_n >= (guint64)fps * b->fps_d);
+
+    gboolean a_native = ((a->width == width) && (a->height == height));
+    gboolean b_native = ((b->width == width) && (b->height == height));
+
+    gboolean a_covers = ((a->width >= width) && (a->height >= height));
+    gboolean b_covers = ((b->width >= width) && (b->height >= height));
+
+    /* 1. Frame rate. If no mode is fast enough, the fastest one */
+    if (a_rate != b_rate)
+    {
+        return a_rate;
+    }
+
+    if ((!a_rate) && ((guint64)a->fps_n * b->fps_d != (guint64)b->fps_n * a->fps_d))
+    {
+        return ((guint64)a->fps_n * b->fps_d > (guint64)b->fps_n * a->fps_d);
+    }
+
+    /* 2. Downscaling rather than upscaling (upscaled frames look blurred) */
+    if (a_covers != b_covers)
+    {
+        return a_covers;
+    }
+
+    if ((!a_covers) && ((gint64)a->width * a->height != (gint64)b->width * b->height))
+    {
+        return ((gint64)a->width * a->height > (gint64)b->width * b->height);
+    }
+
+    /* 3. No decoding */
+    if (a->dmabuf != b->dmabuf)
+    {
+        return a->dmabuf;
+    }
+
+    /* 4. No scaling */
+    if (a_native != b_native)
+    {
+        return a_native;
+    }
+
+    /* 5. Memory bandwidth */
+    return (probe_get_bandwidth(a) < probe_get_bandwidth(b));
+}
+
+gboolean probe_is_selectable(const struct probe_mode_t *mode, const gchar *media_type)
+{
+    if (media_type == NULL)
+    {
+        return (g_strcmp0(mode->media_type, PROBE_MEDIA_TYPE_H264) != 0);
+    }
+
+    return (g_strcmp0(mode->media_type, media_type) == 0);
+}
+
+gboolean probe_has_uvc_h264_xu(const gchar *device)
+{
+    gchar *name = NULL;
+    gchar *path = NULL;
+    guint8 *descriptors = NULL;
+
+    gsize length = 0;
+    gsize offset = 0;
+    gboolean result = FALSE;
+
+    /* "device" links to the USB interface, its parent is the USB device */
+    name = g_path_get_basename(device);
+    path = g_strdup_printf("/sys/class/video4linux/%s/device/../descriptors", name);
+
+    if (!g_file_get_contents(path, (gchar**)&descriptors, &length, NULL))
+    {
+        g_debug("Info: Cannot read USB descriptors of '%s' (%s)", device, path);
+    }
+    else
+    {
+        /* Walk through descriptors: bLength, bDescriptorType, bDescriptorSubtype, bUnitID, GUID... */
+        while ((offset + 1 < length) && (descriptors[offset] != 0) && (!result))
+        {
+            result = (descriptors[offset + 1] == UVC_CS_INTERFACE) &&
+                     (offset + 2 < length) &&
+                     (descriptors[offset + 2] == UVC_VC_EXTENSION_UNIT) &&
+                     (descriptors[offset] >= UVC_XU_GUID_OFFSET + UVC_XU_GUID_LENGTH) &&
+                     (offset + UVC_XU_GUID_OFFSET + UVC_XU_GUID_LENGTH <= length) &&
+                     (memcmp(&descriptors[offset + UVC_XU_GUID_OFFSET],
+                             uvc_h264_xu_guid, UVC_XU_GUID_LENGTH) == 0);
+
+            offset += descriptors[offset];
+        }
+    }
+
+    /* Free resources */
+    g_free(descriptors);
+    g_free(path);
+    g_free(name);
+
+    return result;
+}
+
+/* ---------- Public functions ---------- */
+
+gboolean probe_select_mode(const gchar *device, const gchar *media_type,
+                           const gint width, const gint height,
+                           const gint fps, struct probe_mode_t *mode)
+{
+    GArray *modes = NULL;
+    const struct probe_mode_t *candidate = NULL;
+    const struct probe_mode_t *best = NULL;
+    const gchar *scaling = NULL;
+    const gchar *processing = NULL;
+
+    gint fd = -1;
+    guint index = 0;
+    guint selectable_counts = 0;
+
+    /* Check parameter(s) */
+    g_return_val_if_fail((device != NULL) && (mode != NULL) && (fps > 0), FALSE);
+
+    fd = open(device, O_RDWR);
+    if (fd == -1)
+    {
+        g_message("Warning: Cannot probe '%s': %s", device, g_strerror(errno));
+        return FALSE;
+    }
+
+    modes = probe_enum_modes(fd, width, height, fps);
+    close(fd);
+
+    if ((modes == NULL) || (modes->len == 0))
+    {
+        g_message("Warning: No capture mode of '%s' is supported by camera pipelines", device);
+
+        if (modes != NULL)
+        {
+            g_array_free(modes, TRUE);
+        }
+
+        return FALSE;
+    }
+
+    for (index = 0; index < modes->len; index++)
+    {
+        candidate = &g_array_index(modes, struct probe_mode_t, index);
+
+        g_debug("Info: Mode of '%s': %s %dx%d@%d/%d (%.1f MB/s)", device, candidate->format,
+                candidate->width, candidate->height, candidate->fps_n, candidate->fps_d,
+                probe_get_bandwidth(candidate) / 1000000.0);
+
+        if (!probe_is_selectable(candidate, media_type))
+        {
+            continue;
+        }
+
+        selectable_counts++;
+
+        if ((best == NULL) || probe_is_better(candidate, best, width, height, fps))
+        {
+            best = candidate;
+        }
+    }
+
+    if (best == NULL)
+    {
+        g_message("Warning: No %s capture mode of '%s'",
+                  (media_type != NULL) ? media_type : "raw or MJPEG", device);
+        g_array_free(modes, TRUE);
+
+        return FALSE;
+    }
+
+    *mode = *best;
+
+    /* Explain the choice */
+    if ((mode->width == width) && (mode->height == height))
+    {
+        scaling = "native size, no scaling";
+    }
+    else if (g_strcmp0(mode->media_type, PROBE_MEDIA_TYPE_H264) == 0)
+    {
+        scaling = "no native size, streamed at capture size";
+    }
+    else if ((mode->width >= width) && (mode->height >= height))
+    {
+        scaling = "no native size, downscaled by VSP";
+    }
+    else
+    {
+        scaling = "no larger size, upscaled by VSP";
+    }
+
+    if (mode->dmabuf)
+    {
+        processing = "imported by VSP with dmabuf";
+    }
+    else if (g_strcmp0(mode->media_type, PROBE_MEDIA_TYPE_H264) == 0)
+    {
+        processing = "encoded by the camera";
+    }
+    else
+    {
+        processing = "decoded before VSP";
+    }
+
+    g_snprintf(mode->reason, sizeof(mode->reason), "%s; %s %s; %d/%d fps%s; %.1f MB/s, best of %u modes",
+               scaling, mode->format, processing, mode->fps_n, mode->fps_d,
+               ((guint64)mode->fps_n >= (guint64)fps * mode->fps_d) ? "" : " (below the requested rate)",
+               probe_get_bandwidth(mode) / 1000000.0, selectable_counts);
+
+    g_message("Info: Capture mode of '%s' for %dx%d@%d: %s %dx%d@%d/%d (%s)",
+              device, width, height, fps, mode->format, mode->width, mode->height,
+              mode->fps_n, mode->fps_d, mode->reason);
+
+    /* Free resources */
+    g_array_free(modes, TRUE);
+
+    return TRUE;
+}
+
+gboolean probe_has_frame_size(const gchar *device, const gint width, const gint height)
+{
+    GArray *modes = NULL;
+    const struct probe_mode_t *mode = NULL;
+
+    gboolean result = FALSE;
+    gint fd = -1;
+    guint index = 0;
+
+    /* Check parameter(s) */
+    g_return_val_if_fail(device != NULL, FALSE);
+
+    fd = open(device, O_RDWR);
+    if (fd == -1)
+    {
+        return FALSE;
+    }
+
+    /* Any frame rate will do */
+    modes = probe_enum_modes(fd, width, height, 1);
+    close(fd);
+
+    for (index = 0; (modes != NULL) && (index < modes->len) && (!result); index++)
+    {
+        mode = &g_array_index(modes, struct probe_mode_t, index);
+        result = ((mode->width == width) && (mode->height == height));
+    }
+
+    if (modes != NULL)
+    {
+        g_array_free(modes, TRUE);
+    }
+
+    return result;
+}
+
+enum probe_h264_t probe_get_h264_support(const gchar *device)
+{
+    struct v4l2_fmtdesc desc;
+
+    enum probe_h264_t result = PROBE_H264_NONE;
+    gint fd = -1;
+
+    /* Check parameter(s) */
+    g_return_val_if_fail(device != NULL, PROBE_H264_NONE);
+
+    fd = open(device, O_RDWR);
+    if (fd == -1)
+    {
+        return PROBE_H264_NONE;
+    }
+
+    memset(&desc, 0, sizeof(desc));
+    desc.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+
+    for (desc.index = 0; (result == PROBE_H264_NONE) && (probe_ioctl(fd, VIDIOC_ENUM_FMT, &desc) == 0); desc.index++)
+    {
+        if (desc.pixelformat == V4L2_PIX_FMT_H264)
+        {
+            result = PROBE_H264_FORMAT;
+        }
+    }
+
+    close(fd);
+
+    /* The extension unit is only looked for if the device captures something */
+    if ((result == PROBE_H264_NONE) && (desc.index > 0) && probe_has_uvc_h264_xu(device))
+    {
+        result = PROBE_H264_UVC_XU;
+    }
+
+    return result;
+}
+
+const gchar *probe_h264_to_string(const enum probe_h264_t h264)
+{
+    const gchar* result = "";
+
+    switch (h264)
+    {
+        case PROBE_H264_NONE:
+            result = "none";
+        break;
+
+        case PROBE_H264_FORMAT:
+            result = "V4L2 H.264 format";
+        break;
+
+        case PROBE_H264_UVC_XU:
+            result = "UVC H.264 extension unit";
+        break;
+
+        default:
+            result = "unknown";
+        break;
+    }
+
+    return result;
+}
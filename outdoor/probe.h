@@ -0,0 +1,158 @@
+/***********************************************************************
+ * FILENAME: probe.h
+ *
+ * DESCRIPTION:
+ *   Contains APIs to probe capture modes (formats, frame sizes and
+ *   frame intervals) of V4L2 cameras and to choose the cheapest one.
+ *
+ * PUBLIC FUNCTIONS:
+ *   gboolean probe_select_mode(const gchar *device, const gchar *media_type,
+ *                              const gint width, const gint height,
+ *                              const gint fps, struct probe_mode_t *mode);
+ *
+ *   gboolean probe_has_frame_size(const gchar *device, const gint width, const gint height);
+ *
+ *   enum probe_h264_t probe_get_h264_support(const gchar *device);
+ *
+ *   const gchar *probe_h264_to_string(const enum probe_h264_t h264);
+ *
+ * AUTHOR: RVC       START DATE: 17/10/2026
+ *
+ * CHANGES:
+ *
+ ***********************************************************************/
+
+#ifndef _PROBE_H_
+#define _PROBE_H_
+
+/* ---------- Macros ---------- */
+
+/* Media types of capture modes (GStreamer caps) */
+#define PROBE_MEDIA_TYPE_RAW "video/x-raw"
+#define PROBE_MEDIA_TYPE_JPEG "image/jpeg"
+#define PROBE_MEDIA_TYPE_H264 "video/x-h264"
+
+/* Maximum length of GStreamer format names and of the reasons of a choice */
+#define PROBE_FORMAT_LENGTH 16
+#define PROBE_REASON_LENGTH 256
+
+/* ---------- Datatypes ---------- */
+
+/*
+ * Enum: probe_h264_t
+ * ---
+ *   How a camera outputs H.264 encoded by itself:
+ *     - PROBE_H264_NONE: It does not (raw or MJPEG only).
+ *     - PROBE_H264_FORMAT: As a V4L2 format (V4L2_PIX_FMT_H264, UVC 1.5 cameras).
+ *     - PROBE_H264_UVC_XU: Through the UVC H.264 extension unit (UVC 1.1 cameras,
+ *                          such as Logitech C920), which "uvch264src" drives.
+ */
+enum probe_h264_t
+{
+    PROBE_H264_NONE,
+    PROBE_H264_FORMAT,
+    PROBE_H264_UVC_XU,
+    PROBE_H264_UNKNOWN
+};
+
+/*
+ * Struct: probe_mode_t
+ * ---
+ *   Represents a capture mode of a camera:
+ *     - pixelformat (guint32): V4L2 pixel format (such as: V4L2_PIX_FMT_YUYV).
+ *     - media_type (string): PROBE_MEDIA_TYPE_RAW, PROBE_MEDIA_TYPE_JPEG or PROBE_MEDIA_TYPE_H264.
+ *     - format (string): GStreamer name of the format (such as: "YUY2"), "MJPEG" or "H264".
+ *     - width, height (gint): Frame size.
+ *     - fps_n, fps_d (gint): Frame rate (fraction).
+ *     - dmabuf (gboolean): Set if VSP imports frames as they are (dmabuf, no decoding).
+ *     - bits_per_pixel (gint): Memory bandwidth per pixel.
+ *     - reason (string): Why the mode is chosen (set by "probe_select_mode()").
+ */
+struct probe_mode_t
+{
+    guint32 pixelformat;
+
+    gchar media_type[PROBE_FORMAT_LENGTH];
+
+    gchar format[PROBE_FORMAT_LENGTH];
+
+    gint width;
+
+    gint height;
+
+    gint fps_n;
+
+    gint fps_d;
+
+    gboolean dmabuf;
+
+    gint bits_per_pixel;
+
+    gchar reason[PROBE_REASON_LENGTH];
+};
+
+/* ---------- Functions ---------- */
+
+/*
+ * Function: probe_select_mode
+ * ---
+ *   Enumerates the capture modes of "device" (VIDIOC_ENUM_FMT, VIDIOC_ENUM_FRAMESIZES
+ *   and VIDIOC_ENUM_FRAMEINTERVALS), then chooses the cheapest one which gives an
+ *   output of "width"x"height" at "fps", in this order of preference:
+ *     1. The frame rate is at least "fps".
+ *     2. The frame size covers the output size (downscaling rather than upscaling).
+ *     3. The format is imported by VSP with dmabuf (raw formats, no decoding).
+ *     4. The frame size is the output size (no scaling).
+ *     5. The lowest memory bandwidth (size x bits per pixel x frame rate).
+ *
+ *   So, raw formats are used when the USB bandwidth allows them, MJPEG otherwise
+ *   (such as: 1920x1080 at 30 fps).
+ *
+ *   All modes are logged (debug level), the chosen one is logged with its reasons.
+ *
+ *   device: Video device (such as: "/dev/video8").
+ *   media_type: Only modes of this media type (such as: PROBE_MEDIA_TYPE_H264).
+ *               NULL: modes which are encoded by the pipelines (raw and MJPEG).
+ *   width, height, fps: Requested output.
+ *   mode: Chosen mode (output).
+ *
+ *   return: TRUE (a mode is chosen).
+ *           FALSE (the device cannot be probed or has no format supported by the pipelines).
+ */
+gboolean probe_select_mode(const gchar *device, const gchar *media_type,
+                           const gint width, const gint height,
+                           const gint fps, struct probe_mode_t *mode);
+
+/*
+ * Function: probe_has_frame_size
+ * ---
+ *   Check if "device" captures "width"x"height" in a format supported by the pipelines.
+ *
+ *   return: TRUE (the frame size is supported).
+ *           FALSE (it is not, or the device cannot be probed).
+ */
+gboolean probe_has_frame_size(const gchar *device, const gint width, const gint height);
+
+/*
+ * Function: probe_get_h264_support
+ * ---
+ *   Check if "device" encodes H.264 by itself: it lists V4L2_PIX_FMT_H264, or the
+ *   USB descriptors of the camera (read from sysfs) have the UVC H.264 extension unit.
+ *
+ *   return: PROBE_H264_NONE (no on-board encoder, or the device cannot be probed).
+ *           PROBE_H264_FORMAT or PROBE_H264_UVC_XU (see "probe_h264_t").
+ */
+enum probe_h264_t probe_get_h264_support(const gchar *device);
+
+/*
+ * Function: probe_h264_to_string
+ * ---
+ *   Convert "enum probe_h264_t" to string.
+ *
+ *   Note: The output string must not be de-allocated or modified.
+ *
+ *   return: String (such as: "V4L2 H.264 format").
+ */
+const gchar *probe_h264_to_string(const enum probe_h264_t h264);
+
+#endif
@@ -0,0 +1,737 @@
+/***********************************************************************
+ * FILENAME: profile.c
+ *
+ * DESCRIPTION:
+ *   Pipeline profiler implementations.
+ *
+ * NOTE:
+ *   For more further information about datatypes and function usages,
+ *   please refer to "profile.h".
+ *
+ * AUTHOR: RVC       START DATE: 17/10/2026
+ *
+ * CHANGES:
+ *
+ ***********************************************************************/
+
+/* ---------- Header files ---------- */
+
+#include <glib.h>
+#include <glib/gprintf.h>
+#include <stdio.h>
+#include <errno.h>
+
+#include <gst/gst.h>
+
+#include "profile.h"
+
+/* ---------- Macros ---------- */
+
+#define PROFILE_ERROR g_quark_from_static_string("profile-error")
+
+/* Interval of summaries (seconds) and of trace file writes (ms) */
+#define PROFILE_SUMMARY_INTERVAL 5
+#define PROFILE_FLUSH_INTERVAL 200
+
+/* Buffers which entered an element and did not leave it yet (more than the default
+ * size of "queue" elements: 200 buffers) */
+#define PROFILE_PENDING_SLOTS 256
+
+/* Trace events waiting to be written (bytes). Beyond, new events are dropped */
+#define PROFILE_MAX_PENDING_EVENTS (16 * 1024 * 1024)
+
+/* ---------- Datatypes ---------- */
+
+/*
+ * Struct: profile_pending_t
+ * ---
+ *   Represents a buffer inside an element:
+ *     - pts (GstClockTime): Timestamp of the buffer (it identifies the buffer on src pads).
+ *     - time (gint64): Monotonic time (us) when it entered the element.
+ */
+struct profile_pending_t
+{
+    GstClockTime pts;
+
+    gint64 time;
+};
+
+/*
+ * Struct: profile_element_t
+ * ---
+ *   Represents an instrumented element:
+ *     - profile (struct profile_t): The profiler.
+ *     - element (GstElement): The element, not referenced (NULL once it is destroyed).
+ *     - name (string): Name of the pipeline and of the element (such as: "/camera-1/pay0").
+ *     - pid, tid (gint): Process (pipeline) and thread (element) IDs of trace events.
+ *     - is_source (gboolean): The element has no sink pad. Its processing time is the
+ *       running time when buffers leave it minus their timestamp (live sources).
+ *     - is_queue (gboolean): The element has property "current-level-buffers".
+ *     - pending (array of "profile_pending_t"): Ring of buffers inside the element,
+ *       from "pending_tail" (oldest) to "pending_head" (excluded).
+ *     - buffers_in, buffers_out, bytes_out (guint64): Counters since the last summary.
+ *     - latency_sum, latency_max (gint64), latency_counts (guint): Processing times (us)
+ *       since the last summary.
+ *     - level_sum (guint64), level_samples, level_max (guint): Queue fill levels (buffers)
+ *       since the last summary.
+ *     - dropped (guint64): Buffers which never left the element (in total).
+ *     - qos_dropped (guint64): Buffers dropped according to QoS messages (in total).
+ */
+struct profile_element_t
+{
+    struct profile_t *profile;
+
+    GstElement *element;
+
+    gchar *name;
+
+    gint pid;
+    gint tid;
+
+    gboolean is_source;
+    gboolean is_queue;
+
+    struct profile_pending_t pending[PROFILE_PENDING_SLOTS];
+    guint pending_head;
+    guint pending_tail;
+
+    guint64 buffers_in;
+    guint64 buffers_out;
+    guint64 bytes_out;
+
+    gint64 latency_sum;
+    gint64 latency_max;
+    guint latency_counts;
+
+    guint64 level_sum;
+    guint level_samples;
+    guint level_max;
+
+    guint64 dropped;
+    guint64 qos_dropped;
+};
+
+struct profile_t
+{
+    GPtrArray *elements;
+
+    gint pipelines;
+
+    FILE *trace;
+    GString *events;
+
+    guint summary_source_id;
+    guint flush_source_id;
+
+    gint64 summary_time;
+
+    GMutex lock;
+};
+
+/* ---------- Private functions ---------- */
+
+/*
+ * Function: profile_append_string
+ * ---
+ *   Appends "value" to "events" as a JSON string.
+ */
+static void profile_append_string(GString *events, const gchar *value);
+
+/*
+ * Function: profile_attach_element
+ * ---
+ *   Adds pad probes to every pad of "element" (thread "tid" of process "pid").
+ *
+ *   Note: "lock" must be held.
+ */
+static void profile_attach_element(struct profile_t *profile, GstElement *element,
+                                   const gchar *pipeline_name, const gint pid, const gint tid);
+
+/*
+ * Function: profile_get_buffer
+ * ---
+ *   Get the (first) buffer of the probe and the number of buffers ("counts") and bytes ("size").
+ *
+ *   return: The buffer (not referenced), NULL for empty buffer lists.
+ */
+static GstBuffer *profile_get_buffer(GstPadProbeInfo *info, guint *counts, gsize *size);
+
+/*
+ * Function: profile_on_sink
+ * ---
+ *   Probe of sink pads. Records buffers entering the element.
+ *
+ *   return: GST_PAD_PROBE_OK.
+ */
+static GstPadProbeReturn profile_on_sink(GstPad *pad, GstPadProbeInfo *info, gpointer user_data);
+
+/*
+ * Function: profile_on_src
+ * ---
+ *   Probe of src pads. Matches buffers leaving the element with the ones which entered it.
+ *
+ *   return: GST_PAD_PROBE_OK.
+ */
+static GstPadProbeReturn profile_on_src(GstPad *pad, GstPadProbeInfo *info, gpointer user_data);
+
+/*
+ * Function: profile_on_element_destroyed
+ * ---
+ *   Weak reference callback. The element is removed at the next summary.
+ */
+static void profile_on_element_destroyed(gpointer data, GObject *object);
+
+/*
+ * Function: profile_on_summary
+ * ---
+ *   Timer callback. Logs statistics of every element since the last call.
+ *
+ *   return: G_SOURCE_CONTINUE.
+ */
+static gboolean profile_on_summary(gpointer user_data);
+
+/*
+ * Function: profile_on_flush
+ * ---
+ *   Timer callback. Writes pending trace events to the trace file.
+ *
+ *   return: G_SOURCE_CONTINUE.
+ */
+static gboolean profile_on_flush(gpointer user_data);
+
+/*
+ * Function: profile_element_free
+ * ---
+ *   Frees "profile_element_t" object "data".
+ */
+static void profile_element_free(gpointer data);
+
+/* ---------- Private functions ---------- */
+
+void profile_append_string(GString *events, const gchar *value)
+{
+    const gchar *character = NULL;
+
+    g_string_append_c(events, '"');
+
+    for (character = value; *character != '\0'; character++)
+    {
+        if ((*character == '"') || (*character == '\\'))
+        {
+            g_string_append_printf(events, "\\%c", *character);
+        }
+        else if ((guchar)*character < 0x20)
+        {
+            g_string_append_printf(events, "\\u%04x", (guchar)*character);
+        }
+        else
+        {
+            g_string_append_c(events, *character);
+        }
+    }
+
+    g_string_append_c(events, '"');
+}
+
+void profile_attach_element(struct profile_t *profile, GstElement *element,
+                            const gchar *pipeline_name, const gint pid, const gint tid)
+{
+    struct profile_element_t *record = NULL;
+    GstIterator *iterator = NULL;
+    GValue item = G_VALUE_INIT;
+    GstPad *pad = NULL;
+
+    record = g_new0(struct profile_element_t, 1);
+    record->profile = profile;
+    record->element = element;
+    record->name = g_strdup_printf("%s/%s", pipeline_name, GST_ELEMENT_NAME(element));
+    record->pid = pid;
+    record->tid = tid;
+    record->is_source = (element->numsinkpads == 0);
+    record->is_queue = (g_object_class_find_property(G_OBJECT_GET_CLASS(element),
+                                                     "current-level-buffers") != NULL);
+
+    g_ptr_array_add(profile->elements, record);
+    g_object_weak_ref(G_OBJECT(element), profile_on_element_destroyed, record);
+
+    /* Trace: one thread per element */
+    if (profile->trace != NULL)
+    {
+        g_string_append_printf(profile->events, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,"
+                                                "\"tid\":%d,\"args\":{\"name\":", pid, tid);
+        profile_append_string(profile->events, GST_ELEMENT_NAME(element));
+        g_string_append(profile->events, "}}");
+    }
+
+    iterator = gst_element_iterate_pads(element);
+
+    while (gst_iterator_next(iterator, &item) == GST_ITERATOR_OK)
+    {
+        pad = GST_PAD(g_value_get_object(&item));
+
+        gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_BUFFER_LIST,
+                          (GST_PAD_IS_SINK(pad)) ? profile_on_sink : profile_on_src, record, NULL);
+
+        g_value_reset(&item);
+    }
+
+    g_value_unset(&item);
+    gst_iterator_free(iterator);
+}
+
+GstBuffer *profile_get_buffer(GstPadProbeInfo *info, guint *counts, gsize *size)
+{
+    GstBufferList *list = NULL;
+    guint index = 0;
+
+    if (info->type & GST_PAD_PROBE_TYPE_BUFFER_LIST)
+    {
+        list = GST_PAD_PROBE_INFO_BUFFER_LIST(info);
+
+        *counts = gst_buffer_list_length(list);
+        *size = 0;
+
+        for (index = 0; index < *counts; index++)
+        {
+            *size += gst_buffer_get_size(gst_buffer_list_get(list, index));
+        }
+
+        return (*counts > 0) ? gst_buffer_list_get(list, 0) : NULL;
+    }
+
+    *counts = 1;
+    *size = gst_buffer_get_size(GST_PAD_PROBE_INFO_BUFFER(info));
+
+    return GST_PAD_PROBE_INFO_BUFFER(info);
+}
+
+GstPadProbeReturn profile_on_sink(GstPad *pad, GstPadProbeInfo *info, gpointer user_data)
+{
+    struct profile_element_t *record = (struct profile_element_t*)user_data;
+    struct profile_t *profile = record->profile;
+    struct profile_pending_t *pending = NULL;
+
+    GstBuffer *buffer = NULL;
+    gint64 now = g_get_monotonic_time();
+    guint counts = 0;
+    gsize size = 0;
+    guint level = 0;
+
+    buffer = profile_get_buffer(info, &counts, &size);
+    if (buffer == NULL)
+    {
+        return GST_PAD_PROBE_OK;
+    }
+
+    /* The queue is not locked by its upstream thread here */
+    if (record->is_queue)
+    {
+        g_object_get(GST_PAD_PARENT(pad), "current-level-buffers", &level, NULL);
+    }
+
+    g_mutex_lock(&profile->lock);
+
+    record->buffers_in += counts;
+
+    /* Sinks do not output buffers */
+    if ((GST_PAD_PARENT(pad)->numsrcpads > 0) && GST_BUFFER_PTS_IS_VALID(buffer))
+    {
+        /* A full ring forgets its oldest buffer */
+        if (record->pending_head - record->pending_tail == PROFILE_PENDING_SLOTS)
+        {
+            record->pending_tail++;
+        }
+
+        pending = &record->pending[record->pending_head % PROFILE_PENDING_SLOTS];
+        pending->pts = GST_BUFFER_PTS(buffer);
+        pending->time = now;
+
+        record->pending_head++;
+    }
+
+    if (record->is_queue)
+    {
+        record->level_sum += level;
+        record->level_samples++;
+        record->level_max = MAX(record->level_max, level);
+
+        if ((profile->trace != NULL) && (profile->events->len < PROFILE_MAX_PENDING_EVENTS))
+        {
+            g_string_append_printf(profile->events, ",\n{\"name\":\"level\",\"ph\":\"C\",\"ts\":%" G_GINT64_FORMAT
+                                                    ",\"pid\":%d,\"args\":{", now, record->pid);
+            profile_append_string(profile->events, GST_ELEMENT_NAME(GST_PAD_PARENT(pad)));
+            g_string_append_printf(profile->events, ":%u}}", level);
+        }
+    }
+
+    g_mutex_unlock(&profile->lock);
+
+    return GST_PAD_PROBE_OK;
+}
+
+GstPadProbeReturn profile_on_src(GstPad *pad, GstPadProbeInfo *info, gpointer user_data)
+{
+    struct profile_element_t *record = (struct profile_element_t*)user_data;
+    struct profile_t *profile = record->profile;
+    struct profile_pending_t *pending = NULL;
+
+    GstBuffer *buffer = NULL;
+    GstClock *clock = NULL;
+    GstClockTime running_time = GST_CLOCK_TIME_NONE;
+
+    gint64 now = g_get_monotonic_time();
+    gint64 start = 0;
+    guint counts = 0;
+    gsize size = 0;
+    guint index = 0;
+
+    buffer = profile_get_buffer(info, &counts, &size);
+    if (buffer == NULL)
+    {
+        return GST_PAD_PROBE_OK;
+    }
+
+    /* Live sources timestamp buffers with the running time of their capture */
+    if (record->is_source && GST_BUFFER_PTS_IS_VALID(buffer))
+    {
+        clock = gst_element_get_clock(GST_PAD_PARENT(pad));
+        if (clock != NULL)
+        {
+            running_time = gst_clock_get_time(clock) - gst_element_get_base_time(GST_PAD_PARENT(pad));
+            gst_object_unref(clock);
+        }
+    }
+
+    g_mutex_lock(&profile->lock);
+
+    record->buffers_out += counts;
+    record->bytes_out += size;
+
+    if (GST_CLOCK_TIME_IS_VALID(running_time) && (running_time >= GST_BUFFER_PTS(buffer)))
+    {
+        start = now - (gint64)GST_TIME_AS_USECONDS(running_time - GST_BUFFER_PTS(buffer));
+    }
+    else if (!record->is_source && GST_BUFFER_PTS_IS_VALID(buffer))
+    {
+        /* Buffers leave elements in order: older buffers which did not leave were dropped.
+         * Other src pads of the element (such as: "tee") find nothing */
+        for (index = record->pending_tail; index != record->pending_head; index++)
+        {
+            pending = &record->pending[index % PROFILE_PENDING_SLOTS];
+
+            if (pending->pts == GST_BUFFER_PTS(buffer))
+            {
+                start = pending->time;
+                record->dropped += index - record->pending_tail;
+                record->pending_tail = index + 1;
+                break;
+            }
+        }
+    }
+
+    if (start != 0)
+    {
+        record->latency_sum += now - start;
+        record->latency_max = MAX(record->latency_max, now - start);
+        record->latency_counts++;
+
+        if ((profile->trace != NULL) && (profile->events->len < PROFILE_MAX_PENDING_EVENTS))
+        {
+            g_string_append_printf(profile->events, ",\n{\"name\":\"buffer\",\"ph\":\"X\",\"ts\":%" G_GINT64_FORMAT
+                                                    ",\"dur\":%" G_GINT64_FORMAT ",\"pid\":%d,\"tid\":%d,"
+                                                    "\"args\":{\"pts_ms\":%.3f,\"buffers\":%u,\"bytes\":%"
+                                                    G_GSIZE_FORMAT "}}",
+                                   start, now - start, record->pid, record->tid,
+                                   (gdouble)GST_BUFFER_PTS(buffer) / GST_MSECOND, counts, size);
+        }
+    }
+
+    g_mutex_unlock(&profile->lock);
+
+    return GST_PAD_PROBE_OK;
+}
+
+void profile_on_element_destroyed(gpointer data, GObject *object)
+{
+    struct profile_element_t *record = (struct profile_element_t*)data;
+
+    g_mutex_lock(&record->profile->lock);
+    record->element = NULL;
+    g_mutex_unlock(&record->profile->lock);
+}
+
+gboolean profile_on_summary(gpointer user_data)
+{
+    struct profile_t *profile = (struct profile_t*)user_data;
+    struct profile_element_t *record = NULL;
+    GString *line = g_string_new(NULL);
+
+    gint64 now = g_get_monotonic_time();
+    gdouble elapsed = (now - profile->summary_time) / (gdouble)G_USEC_PER_SEC;
+    guint index = 0;
+
+    profile->summary_time = now;
+
+    g_mutex_lock(&profile->lock);
+
+    index = 0;
+    while (index < profile->elements->len)
+    {
+        record = g_ptr_array_index(profile->elements, index);
+
+        if ((record->buffers_in > 0) || (record->buffers_out > 0))
+        {
+            g_string_printf(line, "Info: Profile of %s: %.1f/%.1f buffers/s in/out, %.1f KB/s",
+                            record->name, record->buffers_in / elapsed, record->buffers_out / elapsed,
+                            record->bytes_out / elapsed / 1024.0);
+
+            if (record->latency_counts > 0)
+            {
+                g_string_append_printf(line, ", latency %.2f ms (max %.2f ms)",
+                                       (gdouble)record->latency_sum / record->latency_counts / 1000.0,
+                                       record->latency_max / 1000.0);
+            }
+
+            if (record->level_samples > 0)
+            {
+                g_string_append_printf(line, ", level %.1f buffers (max %u)",
+                                       (gdouble)record->level_sum / record->level_samples, record->level_max);
+            }
+
+            if ((record->dropped > 0) || (record->qos_dropped > 0))
+            {
+                g_string_append_printf(line, ", dropped %" G_GUINT64_FORMAT,
+                                       record->dropped + record->qos_dropped);
+            }
+
+            g_message("%s", line->str);
+        }
+
+        record->buffers_in = 0;
+        record->buffers_out = 0;
+        record->bytes_out = 0;
+        record->latency_sum = 0;
+        record->latency_max = 0;
+        record->latency_counts = 0;
+        record->level_sum = 0;
+        record->level_samples = 0;
+        record->level_max = 0;
+
+        /* Elements of finished pipelines (such as: RTSP media) are reported one last time */
+        if (record->element == NULL)
+        {
+            g_ptr_array_remove_index(profile->elements, index);
+        }
+        else
+        {
+            index++;
+        }
+    }
+
+    g_mutex_unlock(&profile->lock);
+
+    g_string_free(line, TRUE);
+
+    return G_SOURCE_CONTINUE;
+}
+
+gboolean profile_on_flush(gpointer user_data)
+{
+    struct profile_t *profile = (struct profile_t*)user_data;
+    GString *events = NULL;
+
+    /* Write outside the lock: streaming threads keep appending to a new string */
+    g_mutex_lock(&profile->lock);
+    events = profile->events;
+    profile->events = g_string_sized_new(events->allocated_len);
+    g_mutex_unlock(&profile->lock);
+
+    if (events->len > 0)
+    {
+        fwrite(events->str, 1, events->len, profile->trace);
+        fflush(profile->trace);
+    }
+
+    g_string_free(events, TRUE);
+
+    return G_SOURCE_CONTINUE;
+}
+
+void profile_element_free(gpointer data)
+{
+    struct profile_element_t *record = (struct profile_element_t*)data;
+
+    g_free(record->name);
+    g_free(record);
+}
+
+/* ---------- Public functions ---------- */
+
+struct profile_t *profile_create(const gchar *trace_path, GError **error)
+{
+    struct profile_t *profile = NULL;
+
+    /* Check parameter(s) */
+    g_return_val_if_fail(trace_path != NULL, NULL);
+
+    profile = g_new0(struct profile_t, 1);
+    profile->elements = g_ptr_array_new_with_free_func(profile_element_free);
+    profile->events = g_string_new(NULL);
+
+    g_mutex_init(&profile->lock);
+
+    if (trace_path[0] != '\0')
+    {
+        profile->trace = fopen(trace_path, "w");
+        if (profile->trace == NULL)
+        {
+            g_set_error(error, PROFILE_ERROR, errno, "Cannot create trace file '%s': %s",
+                        trace_path, g_strerror(errno));
+
+            profile_free(profile);
+            return NULL;
+        }
+
+        /* Trace Event format (JSON array). Process 0 is the application */
+        g_string_append(profile->events, "[\n{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":0,"
+                                         "\"args\":{\"name\":\"outdoor\"}}");
+
+        profile->flush_source_id = g_timeout_add(PROFILE_FLUSH_INTERVAL, profile_on_flush, profile);
+    }
+
+    profile->summary_time = g_get_monotonic_time();
+    profile->summary_source_id = g_timeout_add_seconds(PROFILE_SUMMARY_INTERVAL, profile_on_summary, profile);
+
+    g_message("Info: Profiling pipelines (summary every %d s, trace file: %s)", PROFILE_SUMMARY_INTERVAL,
+              (profile->trace != NULL) ? trace_path : "none");
+
+    return profile;
+}
+
+void profile_attach(struct profile_t *profile, GstElement *pipeline, const gchar *name)
+{
+    GstIterator *iterator = NULL;
+    GValue item = G_VALUE_INIT;
+    GstElement *element = NULL;
+    gint tid = 0;
+
+    /* Check parameter(s) */
+    g_return_if_fail((profile != NULL) && (pipeline != NULL) && (name != NULL));
+
+    g_mutex_lock(&profile->lock);
+
+    /* Trace: one process per pipeline */
+    profile->pipelines++;
+
+    if (profile->trace != NULL)
+    {
+        g_string_append_printf(profile->events, ",\n{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,"
+                                                "\"args\":{\"name\":", profile->pipelines);
+        profile_append_string(profile->events, name);
+        g_string_append(profile->events, "}}");
+    }
+
+    /* Bins have no processing of their own, their children are instrumented */
+    iterator = gst_bin_iterate_recurse(GST_BIN(pipeline));
+
+    while (gst_iterator_next(iterator, &item) == GST_ITERATOR_OK)
+    {
+        element = GST_ELEMENT(g_value_get_object(&item));
+
+        if (!GST_IS_BIN(element))
+        {
+            profile_attach_element(profile, element, name, profile->pipelines, ++tid);
+        }
+
+        g_value_reset(&item);
+    }
+
+    g_value_unset(&item);
+    gst_iterator_free(iterator);
+
+    g_mutex_unlock(&profile->lock);
+
+    g_debug("Info: Profiling %d element(s) of '%s'", tid, name);
+}
+
+void profile_handle_message(struct profile_t *profile, GstMessage *message)
+{
+    struct profile_element_t *record = NULL;
+    GstFormat format = GST_FORMAT_UNDEFINED;
+    guint64 processed = 0;
+    guint64 dropped = 0;
+    guint index = 0;
+
+    /* Check parameter(s) */
+    g_return_if_fail((profile != NULL) && (message != NULL));
+
+    if (GST_MESSAGE_TYPE(message) != GST_MESSAGE_QOS)
+    {
+        return;
+    }
+
+    /* Totals of the element ("-1" if unknown) */
+    gst_message_parse_qos_stats(message, &format, &processed, &dropped);
+    if ((format != GST_FORMAT_BUFFERS) || (dropped == (guint64)-1))
+    {
+        return;
+    }
+
+    g_mutex_lock(&profile->lock);
+
+    for (index = 0; index < profile->elements->len; index++)
+    {
+        record = g_ptr_array_index(profile->elements, index);
+
+        if ((GstObject*)record->element == GST_MESSAGE_SRC(message))
+        {
+            record->qos_dropped = dropped;
+            break;
+        }
+    }
+
+    g_mutex_unlock(&profile->lock);
+}
+
+void profile_free(struct profile_t *profile)
+{
+    struct profile_element_t *record = NULL;
+    guint index = 0;
+
+    /* Check parameter(s) */
+    g_return_if_fail(profile != NULL);
+
+    if (profile->summary_source_id != 0)
+    {
+        g_source_remove(profile->summary_source_id);
+    }
+
+    if (profile->flush_source_id != 0)
+    {
+        g_source_remove(profile->flush_source_id);
+    }
+
+    /* Elements which are still alive must not notify a freed record */
+    for (index = 0; index < profile->elements->len; index++)
+    {
+        record = g_ptr_array_index(profile->elements, index);
+
+        if (record->element != NULL)
+        {
+            g_object_weak_unref(G_OBJECT(record->element), profile_on_element_destroyed, record);
+        }
+    }
+
+    if (profile->trace != NULL)
+    {
+        g_string_append(profile->events, "\n]\n");
+        profile_on_flush(profile);
+
+        fclose(profile->trace);
+    }
+
+    g_ptr_array_free(profile->elements, TRUE);
+    g_string_free(profile->events, TRUE);
+    g_mutex_clear(&profile->lock);
+    g_free(profile);
+}
@@ -0,0 +1,107 @@
+/***********************************************************************
+ * FILENAME: profile.h
+ *
+ * DESCRIPTION:
+ *   Contains APIs to profile GStreamer pipelines (option "--profile").
+ *
+ *   Every element of an attached pipeline gets pad probes which record,
+ *   for each buffer: when it enters the element (sink pads) and when the
+ *   buffer with the same timestamp leaves it (src pads). From these:
+ *     - processing time of the element (including the time spent waiting
+ *       in queues and encoder pipelines),
+ *     - buffer rates and throughput,
+ *     - fill levels of "queue" elements,
+ *     - dropped buffers: buffers which never left an element while later
+ *       ones did (elements keep the order of buffers), and drops reported
+ *       by QoS messages.
+ *
+ *   A summary of every element is logged periodically. Buffers can also
+ *   be written to a trace file in the Trace Event format (JSON), which
+ *   timeline viewers load (such as: Perfetto, chrome://tracing): one
+ *   process per pipeline, one thread per element.
+ *
+ *   Pipelines which are not attached have no probe: profiling costs
+ *   nothing when it is disabled.
+ *
+ * PUBLIC FUNCTIONS:
+ *   struct profile_t *profile_create(const gchar *trace_path, GError **error);
+ *
+ *   void profile_attach(struct profile_t *profile, GstElement *pipeline, const gchar *name);
+ *
+ *   void profile_handle_message(struct profile_t *profile, GstMessage *message);
+ *
+ *   void profile_free(struct profile_t *profile);
+ *
+ * AUTHOR: RVC       START DATE: 17/10/2026
+ *
+ * CHANGES:
+ *
+ ***********************************************************************/
+
+#ifndef _PROFILE_H_
+#define _PROFILE_H_
+
+/* ---------- Datatypes ---------- */
+
+/*
+ * Struct: profile_t
+ * ---
+ *   Represents the profiler:
+ *     - elements (array of "profile_element_t"): Statistics of every attached element.
+ *     - pipelines (gint): The number of attached pipelines (process IDs of the trace).
+ *     - trace (FILE): Trace file (NULL if disabled).
+ *     - events (GString): Trace events waiting to be written (by the main loop).
+ *     - summary_source_id, flush_source_id (guint): Timers of summaries and trace writes.
+ *     - summary_time (gint64): Monotonic time (us) of the last summary.
+ *     - lock (GMutex): Protects all of the above (used by streaming threads).
+ */
+struct profile_t;
+
+/* ---------- Functions ---------- */
+
+/*
+ * Function: profile_create
+ * ---
+ *   Creates the profiler. Summaries are logged every PROFILE_SUMMARY_INTERVAL seconds
+ *   from the default main context.
+ *
+ *   trace_path: Path of the trace file (empty: no trace file).
+ *   error: Error (output), such as: the trace file cannot be created.
+ *
+ *   return: NULL (failure, "error" is set), not NULL (the profiler, see "profile_free()").
+ */
+struct profile_t *profile_create(const gchar *trace_path, GError **error);
+
+/*
+ * Function: profile_attach
+ * ---
+ *   Instruments every element of "pipeline" (recursively). Elements which are
+ *   destroyed later (such as: RTSP media of a client) are removed from summaries.
+ *
+ *   name: Name of the pipeline in summaries and in the trace (such as: "/camera-1").
+ *
+ *   return: void.
+ */
+void profile_attach(struct profile_t *profile, GstElement *pipeline, const gchar *name);
+
+/*
+ * Function: profile_handle_message
+ * ---
+ *   Counts buffers dropped by elements from QoS message "message" of an attached
+ *   pipeline (other messages are ignored).
+ *
+ *   return: void.
+ */
+void profile_handle_message(struct profile_t *profile, GstMessage *message);
+
+/*
+ * Function: profile_free
+ * ---
+ *   Writes the end of the trace file, then frees "profile".
+ *   Attached pipelines must be stopped (or freed) first: probes use "profile".
+ *
+ *   return: void.
+ */
+void profile_free(struct profile_t *profile);
+
+#endif
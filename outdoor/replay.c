@@ -0,0 +1,583 @@
+/***********************************************************************
+ * FILENAME: replay.c
+ *
+ * DESCRIPTION:
+ *   RTP packet cache of sample videos (fake cameras).
+ *
+ * NOTE:
+ *   For more further information about datatypes and function usages,
+ *   please refer to "replay.h".
+ *
+ * AUTHOR: RVC       START DATE: 17/10/2026
+ *
+ * CHANGES:
+ *
+ ***********************************************************************/
+
+/* ---------- Header files ---------- */
+
+#include <glib.h>
+#include <glib/gprintf.h>
+#include <string.h>
+#include <errno.h>
+
+#include <gst/gst.h>
+#include <gst/app/gstappsrc.h>
+
+#include "clip.h"
+#include "replay.h"
+
+/* ---------- Macros ---------- */
+
+#define REPLAY_ERROR g_quark_from_static_string("replay-error")
+
+/* Size of RTP headers without CSRC and extension (RFC 3550, 5.1) */
+#define RTP_HEADER_SIZE 12
+
+/* Size of FU indicator and FU header (RFC 6184, 5.8) */
+#define FU_A_HEADER_SIZE 2
+
+/* H.264 NAL unit types (ITU-T H.264, table 7-1), and FU-A (RFC 6184, 5.2) */
+#define H264_NAL_SPS 7
+#define H264_NAL_PPS 8
+#define H264_NAL_AUD 9
+#define H264_NAL_FU_A 28
+
+/* ---------- Datatypes ---------- */
+
+/*
+ * Struct: replay_packet_t
+ * ---
+ *   Represents a cached packet (without RTP header):
+ *     - offset (gsize): Position of the payload in the arena.
+ *     - size (gsize): Size of the payload (bytes).
+ *     - marker (gboolean): Set on the last packet of an access unit.
+ *     - payload (GstMemory): The payload (shares the arena, NULL until the arena is complete).
+ */
+struct replay_packet_t
+{
+    gsize offset;
+
+    gsize size;
+
+    gboolean marker;
+
+    GstMemory *payload;
+};
+
+/*
+ * Struct: replay_unit_t
+ * ---
+ *   Represents the packets of an access unit:
+ *     - first (guint): Index of its first packet.
+ *     - counts (guint): The number of packets.
+ *     - size (gsize): Size of the access unit in the clip (checked when it is pushed).
+ */
+struct replay_unit_t
+{
+    guint first;
+
+    guint counts;
+
+    gsize size;
+};
+
+struct replay_t
+{
+    GstMemory *arena;
+
+    GArray *packets;
+
+    GArray *units;
+
+    GstCaps *caps;
+};
+
+/* ---------- Private functions ---------- */
+
+/*
+ * Function: replay_next_nal
+ * ---
+ *   Get the NAL unit at "position" of access unit "data", then move "position" after it.
+ *
+ *   length_size: Size of NAL unit lengths (AVC format), 0 for start codes (byte-stream).
+ *   nal, nal_size: The NAL unit, without its start code or length (output).
+ *
+ *   return: TRUE (found), FALSE (no more NAL unit).
+ */
+static gboolean replay_next_nal(const guint8 *data, const gsize size, const guint length_size,
+                                gsize *position, const guint8 **nal, gsize *nal_size);
+
+/*
+ * Function: replay_find_start_code
+ * ---
+ *   Find the next "00 00 01" start code from "offset".
+ *
+ *   return: Position of the start code ("size" if there is none).
+ */
+static gsize replay_find_start_code(const guint8 *data, const gsize size, gsize offset);
+
+/*
+ * Function: replay_add_packet
+ * ---
+ *   Append a packet made of "header" (may be NULL) and "data" to the arena.
+ *
+ *   return: void.
+ */
+static void replay_add_packet(struct replay_t *replay, GByteArray *arena,
+                              const guint8 *header, const gsize header_size,
+                              const guint8 *data, const gsize size);
+
+/*
+ * Function: replay_add_nal
+ * ---
+ *   Packetize NAL unit "nal": single NAL unit packet, or FU-A packets if it does not fit.
+ *
+ *   return: void.
+ */
+static void replay_add_nal(struct replay_t *replay, GByteArray *arena,
+                           const guint8 *nal, const gsize nal_size);
+
+/*
+ * Function: replay_set_caps
+ * ---
+ *   Create RTP caps from parameter sets "sps" and "pps".
+ *
+ *   return: void.
+ */
+static void replay_set_caps(struct replay_t *replay, const GByteArray *sps, const GByteArray *pps);
+
+/* ---------- Private functions ---------- */
+
+gboolean replay_next_nal(const guint8 *data, const gsize size, const guint length_size,
+                         gsize *position, const guint8 **nal, gsize *nal_size)
+{
+    gsize start = 0;
+    gsize end = 0;
+    gsize length = 0;
+    guint index = 0;
+
+    while (*position < size)
+    {
+        if (length_size == 0)
+        {
+            start = replay_find_start_code(data, size, *position);
+            if (start == size)
+            {
+                return FALSE;
+            }
+
+            start += 3;
+            end = replay_find_start_code(data, size, start);
+            *position = end;
+
+            /* Trailing zero bytes belong to the next start code */
+            while ((end > start) && (data[end - 1] == 0))
+            {
+                end--;
+            }
+        }
+        else
+        {
+            if (*position + length_size > size)
+            {
+                return FALSE;
+            }
+
+            for (length = 0, index = 0; index < length_size; index++)
+            {
+                length = (length << 8) | data[*position + index];
+            }
+
+            start = *position + length_size;
+            if (length > size - start)
+            {
+                return FALSE;
+            }
+
+            end = start + length;
+            *position = end;
+        }
+
+        if (end > start)
+        {
+            *nal = data + start;
+            *nal_size = end - start;
+
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+gsize replay_find_start_code(const guint8 *data, const gsize size, gsize offset)
+{
+    while (offset + 3 <= size)
+    {
+        /* Skip 3 bytes at once if the third one cannot end a start code */
+        if (data[offset + 2] > 1)
+        {
+            offset += 3;
+        }
+        else if ((data[offset] == 0) && (data[offset + 1] == 0) && (data[offset + 2] == 1))
+        {
+            return offset;
+        }
+        else
+        {
+            offset++;
+        }
+    }
+
+    return size;
+}
+
+void replay_add_packet(struct replay_t *replay, GByteArray *arena,
+                       const guint8 *header, const gsize header_size,
+                       const guint8 *data, const gsize size)
+{
+    struct replay_packet_t packet;
+
+    packet.offset = arena->len;
+    packet.size = header_size + size;
+    packet.marker = FALSE;
+    packet.payload = NULL;
+
+    if (header != NULL)
+    {
+        g_byte_array_append(arena, header, header_size);
+    }
+
+    g_byte_array_append(arena, data, size);
+    g_array_append_val(replay->packets, packet);
+}
+
+void replay_add_nal(struct replay_t *replay, GByteArray *arena,
+                    const guint8 *nal, const gsize nal_size)
+{
+    const gsize max_size = REPLAY_MTU - RTP_HEADER_SIZE;
+
+    guint8 header[FU_A_HEADER_SIZE];
+    gsize offset = 0;
+    gsize size = 0;
+
+    if (nal_size <= max_size)
+    {
+        replay_add_packet(replay, arena, NULL, 0, nal, nal_size);
+        return;
+    }
+
+    /* FU indicator: F and NRI bits of the NAL unit, type 28. FU header: start
+     * and end bits, type of the NAL unit. The NAL unit header is not repeated */
+    header[0] = (nal[0] & 0xE0) | H264_NAL_FU_A;
+
+    for (offset = 1; offset < nal_size; offset += size)
+    {
+        size = MIN(max_size - FU_A_HEADER_SIZE, nal_size - offset);
+
+        header[1] = nal[0] & 0x1F;
+        header[1] |= (offset == 1) ? 0x80 : 0x00;
+        header[1] |= (offset + size == nal_size) ? 0x40 : 0x00;
+
+        replay_add_packet(replay, arena, header, FU_A_HEADER_SIZE, nal + offset, size);
+    }
+}
+
+void replay_set_caps(struct replay_t *replay, const GByteArray *sps, const GByteArray *pps)
+{
+    gchar *encoded_sps = g_base64_encode(sps->data, sps->len);
+    gchar *encoded_pps = g_base64_encode(pps->data, pps->len);
+    gchar *sprop = g_strdup_printf("%s,%s", encoded_sps, encoded_pps);
+
+    /* Profile, constraints and level are the 3 bytes after the NAL unit header */
+    gchar *profile = g_strdup_printf("%02x%02x%02x", sps->data[1], sps->data[2], sps->data[3]);
+
+    replay->caps = gst_caps_new_simple("application/x-rtp",
+                                       "media", G_TYPE_STRING, "video",
+                                       "clock-rate", G_TYPE_INT, REPLAY_CLOCK_RATE,
+                                       "encoding-name", G_TYPE_STRING, "H264",
+                                       "payload", G_TYPE_INT, REPLAY_PAYLOAD_TYPE,
+                                       "packetization-mode", G_TYPE_STRING, "1",
+                                       "profile-level-id", G_TYPE_STRING, profile,
+                                       "sprop-parameter-sets", G_TYPE_STRING, sprop,
+                                       NULL);
+
+    /* Free resources */
+    g_free(encoded_sps);
+    g_free(encoded_pps);
+    g_free(sprop);
+    g_free(profile);
+}
+
+/* ---------- Public functions ---------- */
+
+struct replay_t *replay_create(const struct clip_t *clip, GError **error)
+{
+    struct replay_t *replay = NULL;
+    struct replay_unit_t unit;
+    struct replay_packet_t *packet = NULL;
+
+    const GstStructure *structure = NULL;
+    const GValue *value = NULL;
+    GstMapInfo map;
+
+    GByteArray *arena = NULL;
+    GByteArray *sps = NULL;
+    GByteArray *pps = NULL;
+
+    const guint8 *data = NULL;
+    const guint8 *nal = NULL;
+    gsize size = 0;
+    gsize nal_size = 0;
+    gsize position = 0;
+    gsize arena_size = 0;
+    gboolean keyframe = FALSE;
+    gboolean has_sps = FALSE;
+    guint length_size = 0;
+    guint counts = 0;
+    guint index = 0;
+    guint8 type = 0;
+
+    gint64 start_time = g_get_monotonic_time();
+
+    /* Check parameter(s) */
+    g_return_val_if_fail(clip != NULL, NULL);
+
+    replay = g_new0(struct replay_t, 1);
+    replay->packets = g_array_new(FALSE, FALSE, sizeof(struct replay_packet_t));
+    replay->units = g_array_new(FALSE, FALSE, sizeof(struct replay_unit_t));
+
+    arena = g_byte_array_new();
+    sps = g_byte_array_new();
+    pps = g_byte_array_new();
+
+    /* AVC clips: NAL units are prefixed by their length, SPS/PPS are in "avcC" */
+    structure = gst_caps_get_structure(clip_get_caps(clip), 0);
+    value = gst_structure_get_value(structure, "codec_data");
+
+    if ((value != NULL) && gst_buffer_map(gst_value_get_buffer(value), &map, GST_MAP_READ))
+    {
+        if (map.size >= 6)
+        {
+            length_size = (map.data[4] & 0x03) + 1;
+            position = 5;
+
+            /* Number of SPS (5 bits), then number of PPS (8 bits), each one prefixed by its size */
+            for (counts = map.data[position++] & 0x1F; counts > 0; counts--)
+            {
+                if (!replay_next_nal(map.data, map.size, 2, &position, &nal, &nal_size))
+                {
+                    break;
+                }
+
+                g_byte_array_set_size(sps, 0);
+                g_byte_array_append(sps, nal, nal_size);
+            }
+
+            for (counts = (position < map.size) ? map.data[position++] : 0; counts > 0; counts--)
+            {
+                if (!replay_next_nal(map.data, map.size, 2, &position, &nal, &nal_size))
+                {
+                    break;
+                }
+
+                g_byte_array_set_size(pps, 0);
+                g_byte_array_append(pps, nal, nal_size);
+            }
+        }
+
+        gst_buffer_unmap(gst_value_get_buffer(value), &map);
+    }
+
+    for (index = 0; index < clip_get_unit_counts(clip); index++)
+    {
+        data = clip_get_unit(clip, index, &size, &keyframe);
+
+        unit.first = replay->packets->len;
+        unit.size = size;
+
+        /* Keep the latest parameter sets, in case a keyframe comes without them */
+        has_sps = FALSE;
+
+        for (position = 0; replay_next_nal(data, size, length_size, &position, &nal, &nal_size); )
+        {
+            type = nal[0] & 0x1F;
+
+            if ((type == H264_NAL_SPS) || (type == H264_NAL_PPS))
+            {
+                g_byte_array_set_size((type == H264_NAL_SPS) ? sps : pps, 0);
+                g_byte_array_append((type == H264_NAL_SPS) ? sps : pps, nal, nal_size);
+
+                has_sps = has_sps || (type == H264_NAL_SPS);
+            }
+        }
+
+        /* Every keyframe can be decoded by a client which joins there */
+        if (keyframe && (!has_sps) && (sps->len > 0) && (pps->len > 0))
+        {
+            replay_add_nal(replay, arena, sps->data, sps->len);
+            replay_add_nal(replay, arena, pps->data, pps->len);
+        }
+
+        for (position = 0; replay_next_nal(data, size, length_size, &position, &nal, &nal_size); )
+        {
+            /* Delimiters are not needed with the marker bit */
+            if ((nal[0] & 0x1F) != H264_NAL_AUD)
+            {
+                replay_add_nal(replay, arena, nal, nal_size);
+            }
+        }
+
+        unit.counts = replay->packets->len - unit.first;
+
+        if (unit.counts > 0)
+        {
+            g_array_index(replay->packets, struct replay_packet_t, replay->packets->len - 1).marker = TRUE;
+        }
+
+        g_array_append_val(replay->units, unit);
+
+        /* The SDP gives the first parameter sets to clients */
+        if ((replay->caps == NULL) && (sps->len >= 4) && (pps->len > 0))
+        {
+            replay_set_caps(replay, sps, pps);
+        }
+    }
+
+    g_byte_array_free(sps, TRUE);
+    g_byte_array_free(pps, TRUE);
+
+    /* The arena is complete, its address does not change anymore */
+    arena_size = arena->len;
+    data = g_byte_array_free(arena, FALSE);
+    replay->arena = gst_memory_new_wrapped(GST_MEMORY_FLAG_READONLY, (gpointer)data, arena_size,
+                                           0, arena_size, (gpointer)data, g_free);
+
+    for (index = 0; index < replay->packets->len; index++)
+    {
+        packet = &g_array_index(replay->packets, struct replay_packet_t, index);
+        packet->payload = gst_memory_share(replay->arena, packet->offset, packet->size);
+    }
+
+    if (replay->caps == NULL)
+    {
+        g_set_error(error, REPLAY_ERROR, EINVAL, "No SPS/PPS in the clip");
+
+        replay_free(replay);
+        return NULL;
+    }
+
+    g_message("Info: RTP cache of '%s': %u packets (%.1f per access unit), %.1f KB, built in %.1f ms",
+              clip_get_path(clip), replay->packets->len,
+              (gdouble)replay->packets->len / MAX(replay->units->len, 1), arena_size / 1024.0,
+              (g_get_monotonic_time() - start_time) / 1000.0);
+
+    return replay;
+}
+
+const GstCaps *replay_get_caps(const struct replay_t *replay)
+{
+    /* Check parameter(s) */
+    g_return_val_if_fail(replay != NULL, NULL);
+
+    return replay->caps;
+}
+
+void replay_init_session(struct replay_session_t *session)
+{
+    /* Check parameter(s) */
+    g_return_if_fail(session != NULL);
+
+    session->ssrc = g_random_int();
+    session->seqnum = (guint16)g_random_int_range(0, G_MAXUINT16 + 1);
+    session->timestamp_offset = g_random_int();
+}
+
+void replay_push_unit(const struct replay_t *replay, struct replay_session_t *session,
+                      GstAppSrc *appsrc, GstBuffer *unit)
+{
+    const struct replay_unit_t *entry = NULL;
+    const struct replay_packet_t *packet = NULL;
+
+    GstBuffer *buffer = NULL;
+    guint8 header[RTP_HEADER_SIZE];
+    guint32 timestamp = 0;
+    guint index = 0;
+
+    /* Check parameter(s) */
+    g_return_if_fail((replay != NULL) && (session != NULL) && (appsrc != NULL) && (unit != NULL));
+
+    /* The offset of clip buffers is their index (see "clip_attach()") */
+    if (GST_BUFFER_OFFSET(unit) >= replay->units->len)
+    {
+        return;
+    }
+
+    entry = &g_array_index(replay->units, struct replay_unit_t, GST_BUFFER_OFFSET(unit));
+    if (gst_buffer_get_size(unit) != entry->size)
+    {
+        return;
+    }
+
+    timestamp = session->timestamp_offset +
+                (guint32)gst_util_uint64_scale(GST_BUFFER_PTS(unit), REPLAY_CLOCK_RATE, GST_SECOND);
+
+    for (index = entry->first; index < entry->first + entry->counts; index++)
+    {
+        packet = &g_array_index(replay->packets, struct replay_packet_t, index);
+
+        /* Version 2, no padding, no extension, no CSRC. Then marker bit and payload type */
+        header[0] = 0x80;
+        header[1] = ((packet->marker) ? 0x80 : 0x00) | REPLAY_PAYLOAD_TYPE;
+        GST_WRITE_UINT16_BE(header + 2, session->seqnum);
+        GST_WRITE_UINT32_BE(header + 4, timestamp);
+        GST_WRITE_UINT32_BE(header + 8, session->ssrc);
+
+        session->seqnum++;
+
+        /* Only the header is new, the payload is shared with other media */
+        buffer = gst_buffer_new_allocate(NULL, RTP_HEADER_SIZE, NULL);
+        gst_buffer_fill(buffer, 0, header, RTP_HEADER_SIZE);
+        gst_buffer_append_memory(buffer, gst_memory_ref(packet->payload));
+
+        /* Stop when "appsrc" is flushing or stopped */
+        if (gst_app_src_push_buffer(appsrc, buffer) != GST_FLOW_OK)
+        {
+            break;
+        }
+    }
+}
+
+void replay_free(struct replay_t *replay)
+{
+    struct replay_packet_t *packet = NULL;
+    guint index = 0;
+
+    /* Check parameter(s) */
+    g_return_if_fail(replay != NULL);
+
+    for (index = 0; index < replay->packets->len; index++)
+    {
+        packet = &g_array_index(replay->packets, struct replay_packet_t, index);
+
+        if (packet->payload != NULL)
+        {
+            gst_memory_unref(packet->payload);
+        }
+    }
+
+    if (replay->arena != NULL)
+    {
+        gst_memory_unref(replay->arena);
+    }
+
+    if (replay->caps != NULL)
+    {
+        gst_caps_unref(replay->caps);
+    }
+
+    g_array_free(replay->packets, TRUE);
+    g_array_free(replay->units, TRUE);
+    g_free(replay);
+}
@@ -0,0 +1,131 @@
+/***********************************************************************
+ * FILENAME: replay.h
+ *
+ * DESCRIPTION:
+ *   Contains APIs to replay sample videos from an RTP packet cache.
+ *
+ *   A clip (see "clip.h") is packetized into RTP (RFC 6184, packetization
+ *   mode 1) once, when the fake camera is created. Payloads are kept in one
+ *   memory arena. Each RTSP media then gets the cached packets of every
+ *   access unit with its own 12-byte header (sequence number, timestamp
+ *   and SSRC), payloads are shared: no demuxer, parser or payloader runs.
+ *
+ * PUBLIC FUNCTIONS:
+ *   struct replay_t *replay_create(const struct clip_t *clip, GError **error);
+ *
+ *   const GstCaps *replay_get_caps(const struct replay_t *replay);
+ *
+ *   void replay_init_session(struct replay_session_t *session);
+ *
+ *   void replay_push_unit(const struct replay_t *replay, struct replay_session_t *session,
+ *                         GstAppSrc *appsrc, GstBuffer *unit);
+ *
+ *   void replay_free(struct replay_t *replay);
+ *
+ * AUTHOR: RVC       START DATE: 17/10/2026
+ *
+ * CHANGES:
+ *
+ ***********************************************************************/
+
+#ifndef _REPLAY_H_
+#define _REPLAY_H_
+
+/* ---------- Macros ---------- */
+
+/* Maximum size of RTP packets, header included (same as "rtph264pay") */
+#define REPLAY_MTU 1400
+
+/* RTP payload type and clock rate of H.264 (same as RTSP_PIPELINE_STR) */
+#define REPLAY_PAYLOAD_TYPE 96
+#define REPLAY_CLOCK_RATE 90000
+
+/* ---------- Datatypes ---------- */
+
+/*
+ * Struct: replay_t
+ * ---
+ *   Represents the RTP packet cache of a clip:
+ *     - arena (GstMemory): Payloads of all packets, one after the other.
+ *     - packets (array of "replay_packet_t"): Payload (shares "arena") and marker bit of each packet.
+ *     - units (array of "replay_unit_t"): First packet and number of packets of each access unit.
+ *     - caps (GstCaps): RTP caps (with "sprop-parameter-sets" for the SDP).
+ */
+struct replay_t;
+
+/*
+ * Struct: replay_session_t
+ * ---
+ *   Represents the RTP header fields of a media fed from the cache:
+ *     - ssrc (guint32): SSRC of the media.
+ *     - seqnum (guint16): Sequence number of the next packet.
+ *     - timestamp_offset (guint32): Added to RTP timestamps of the clip.
+ */
+struct replay_session_t
+{
+    guint32 ssrc;
+
+    guint16 seqnum;
+
+    guint32 timestamp_offset;
+};
+
+/* ---------- Functions ---------- */
+
+/*
+ * Function: replay_create
+ * ---
+ *   Packetizes every access unit of "clip". NAL units which fit in REPLAY_MTU are
+ *   sent as they are, bigger ones are fragmented (FU-A). SPS and PPS are sent before
+ *   every keyframe (from "codec_data" for MP4 clips), access unit delimiters are dropped.
+ *   The marker bit is set on the last packet of each access unit.
+ *
+ *   return: NULL (the clip has no SPS/PPS, "error" is set).
+ *           not NULL (the cache, see "replay_free()").
+ */
+struct replay_t *replay_create(const struct clip_t *clip, GError **error);
+
+/*
+ * Function: replay_get_caps
+ * ---
+ *   Get the caps of the packets ("application/x-rtp"). They must be set on the "appsrc"
+ *   element fed by "replay_push_unit()".
+ *
+ *   Note: The output caps must not be unreferenced or modified.
+ *
+ *   return: Caps.
+ */
+const GstCaps *replay_get_caps(const struct replay_t *replay);
+
+/*
+ * Function: replay_init_session
+ * ---
+ *   Initializes "session" with a random SSRC, sequence number and timestamp offset
+ *   (RFC 3550, 5.1).
+ *
+ *   return: void.
+ */
+void replay_init_session(struct replay_session_t *session);
+
+/*
+ * Function: replay_push_unit
+ * ---
+ *   Pushes the packets of access unit "unit" (a buffer pushed by the clip, see
+ *   "clip_attach()") to "appsrc". The RTP timestamp is computed from the timestamp
+ *   of "unit", so it keeps increasing from one loop to the next.
+ *
+ *   return: void.
+ */
+void replay_push_unit(const struct replay_t *replay, struct replay_session_t *session,
+                      GstAppSrc *appsrc, GstBuffer *unit);
+
+/*
+ * Function: replay_free
+ * ---
+ *   Frees "replay". The arena is freed when the last pushed packet is freed.
+ *
+ *   return: void.
+ */
+void replay_free(struct replay_t *replay);
+
+#endif
@@ -0,0 +1,507 @@
+/***********************************************************************
+ * FILENAME: rtppace.c
+ *
+ * DESCRIPTION:
+ *   "rtppace" GStreamer element (batching and pacing of RTP packets).
+ *
+ * NOTE:
+ *   For more further information about datatypes and function usages,
+ *   please refer to "rtppace.h".
+ *
+ * AUTHOR: RVC       START DATE: 17/10/2026
+ *
+ * CHANGES:
+ *
+ ***********************************************************************/
+
+/* ---------- Header files ---------- */
+
+#include <glib.h>
+#include <glib/gprintf.h>
+
+#include <gst/gst.h>
+
+#include "rtppace.h"
+
+/* ---------- Macros ---------- */
+
+/* RTP clock rate of video (H.264) */
+#define RTPPACE_CLOCK_RATE 90000
+
+/* Marker bit and timestamp are in the first 8 bytes of RTP headers */
+#define RTPPACE_HEADER_SIZE 8
+
+/* ---------- Datatypes ---------- */
+
+typedef struct
+{
+    GstElement parent;
+
+    GstPad *sinkpad;
+    GstPad *srcpad;
+
+    guint spread;
+    guint batch;
+
+    GstBufferList *pending;
+    guint32 pending_timestamp;
+
+    guint32 timestamp;
+    gboolean has_timestamp;
+    gint64 time;
+
+    gboolean flushing;
+    GMutex lock;
+    GCond cond;
+} RtpPace;
+
+typedef struct
+{
+    GstElementClass parent_class;
+} RtpPaceClass;
+
+G_DEFINE_TYPE(RtpPace, rtppace, GST_TYPE_ELEMENT);
+
+/* Properties */
+enum
+{
+    RTPPACE_PROP_0,
+    RTPPACE_PROP_SPREAD,
+    RTPPACE_PROP_BATCH
+};
+
+/* ---------- Variables ---------- */
+
+GstStaticPadTemplate rtppace_sink_template = GST_STATIC_PAD_TEMPLATE("sink", GST_PAD_SINK, GST_PAD_ALWAYS,
+    GST_STATIC_CAPS("application/x-rtp"));
+
+GstStaticPadTemplate rtppace_src_template = GST_STATIC_PAD_TEMPLATE("src", GST_PAD_SRC, GST_PAD_ALWAYS,
+    GST_STATIC_CAPS("application/x-rtp"));
+
+/* ---------- Private functions ---------- */
+
+/*
+ * Function: rtppace_chain
+ * ---
+ *   Chain function of the sink pad. Adds an RTP packet to the current access unit.
+ *
+ *   return: Flow of the sent access unit(s), GST_FLOW_OK otherwise.
+ */
+static GstFlowReturn rtppace_chain(GstPad *pad, GstObject *parent, GstBuffer *buffer);
+
+/*
+ * Function: rtppace_chain_list
+ * ---
+ *   Chain list function of the sink pad. Adds every RTP packet of "list".
+ *
+ *   return: Flow of the sent access unit(s), GST_FLOW_OK otherwise.
+ */
+static GstFlowReturn rtppace_chain_list(GstPad *pad, GstObject *parent, GstBufferList *list);
+
+/*
+ * Function: rtppace_add_packet
+ * ---
+ *   Adds "buffer" to the pending access unit, and sends the access unit when it is
+ *   complete: the packet has the marker bit, or the next one has another timestamp.
+ *
+ *   return: Flow of the sent access unit, GST_FLOW_OK otherwise.
+ */
+static GstFlowReturn rtppace_add_packet(RtpPace *pace, GstBuffer *buffer);
+
+/*
+ * Function: rtppace_send_unit
+ * ---
+ *   Sends the pending access unit in batches, spread over the frame interval
+ *   (back to back if "spread" is 0).
+ *
+ *   return: Flow of the last batch (GST_FLOW_FLUSHING if a wait was aborted).
+ */
+static GstFlowReturn rtppace_send_unit(RtpPace *pace);
+
+/*
+ * Function: rtppace_wait
+ * ---
+ *   Waits until monotonic time "deadline" (us).
+ *
+ *   return: TRUE (the deadline is reached), FALSE (the element is flushing).
+ */
+static gboolean rtppace_wait(RtpPace *pace, const gint64 deadline);
+
+/*
+ * Function: rtppace_set_flushing
+ * ---
+ *   Sets "flushing", and aborts the current wait if it is set.
+ */
+static void rtppace_set_flushing(RtpPace *pace, const gboolean flushing);
+
+/*
+ * Function: rtppace_sink_event
+ * ---
+ *   Event function of the sink pad. Flushes abort waits, serialized events (such as:
+ *   EOS, caps) send the pending packets at once before they are forwarded.
+ *
+ *   return: TRUE (the event is handled), FALSE (otherwise).
+ */
+static gboolean rtppace_sink_event(GstPad *pad, GstObject *parent, GstEvent *event);
+
+/*
+ * Function: rtppace_change_state
+ * ---
+ *   Virtual method of "GstElement". Aborts waits before the element stops.
+ *
+ *   return: Result of the state change.
+ */
+static GstStateChangeReturn rtppace_change_state(GstElement *element, GstStateChange transition);
+
+/*
+ * Function: rtppace_set_property, rtppace_get_property
+ * ---
+ *   Virtual methods of "GObject". Properties "spread" and "batch".
+ */
+static void rtppace_set_property(GObject *object, guint id, const GValue *value, GParamSpec *pspec);
+static void rtppace_get_property(GObject *object, guint id, GValue *value, GParamSpec *pspec);
+
+/*
+ * Function: rtppace_finalize
+ * ---
+ *   Virtual method of "GObject". Frees pending packets.
+ */
+static void rtppace_finalize(GObject *object);
+
+/* ---------- Private functions ---------- */
+
+GstFlowReturn rtppace_chain(GstPad *pad, GstObject *parent, GstBuffer *buffer)
+{
+    return rtppace_add_packet((RtpPace *)parent, buffer);
+}
+
+GstFlowReturn rtppace_chain_list(GstPad *pad, GstObject *parent, GstBufferList *list)
+{
+    GstFlowReturn ret = GST_FLOW_OK;
+    guint index = 0;
+
+    for (index = 0; (index < gst_buffer_list_length(list)) && (ret == GST_FLOW_OK); index++)
+    {
+        ret = rtppace_add_packet((RtpPace *)parent, gst_buffer_ref(gst_buffer_list_get(list, index)));
+    }
+
+    gst_buffer_list_unref(list);
+
+    return ret;
+}
+
+GstFlowReturn rtppace_add_packet(RtpPace *pace, GstBuffer *buffer)
+{
+    GstFlowReturn ret = GST_FLOW_OK;
+    guint8 header[RTPPACE_HEADER_SIZE];
+    guint32 timestamp = pace->pending_timestamp;
+    gboolean marker = TRUE;
+
+    /* A packet too short to be parsed is sent with the current access unit */
+    if (gst_buffer_extract(buffer, 0, header, sizeof(header)) == sizeof(header))
+    {
+        marker = ((header[1] & 0x80) != 0);
+        timestamp = GST_READ_UINT32_BE(header + 4);
+    }
+
+    /* Senders which do not set the marker bit: a new timestamp starts a new access unit */
+    if ((gst_buffer_list_length(pace->pending) > 0) && (timestamp != pace->pending_timestamp))
+    {
+        ret = rtppace_send_unit(pace);
+    }
+
+    pace->pending_timestamp = timestamp;
+    gst_buffer_list_add(pace->pending, buffer);
+
+    if (marker && (ret == GST_FLOW_OK))
+    {
+        ret = rtppace_send_unit(pace);
+    }
+
+    return ret;
+}
+
+GstFlowReturn rtppace_send_unit(RtpPace *pace)
+{
+    GstFlowReturn ret = GST_FLOW_OK;
+    GstBufferList *unit = pace->pending;
+    GstBufferList *list = NULL;
+    GstClockTime interval = 0;
+    GstClockTime gap = 0;
+
+    gint64 start = g_get_monotonic_time();
+    guint counts = gst_buffer_list_length(unit);
+    gboolean paced = FALSE;
+    guint batches = 0;
+    guint index = 0;
+    guint packet = 0;
+
+    pace->pending = gst_buffer_list_new();
+
+    if (counts == 0)
+    {
+        gst_buffer_list_unref(unit);
+        return GST_FLOW_OK;
+    }
+
+    /* Frame interval: from the previous access unit (RTP timestamps wrap around),
+     * and the time it actually took to arrive */
+    if (pace->has_timestamp)
+    {
+        interval = gst_util_uint64_scale((guint32)(pace->pending_timestamp - pace->timestamp),
+                                         GST_SECOND, RTPPACE_CLOCK_RATE);
+        gap = (GstClockTime)(start - pace->time) * GST_USECOND;
+    }
+
+    pace->timestamp = pace->pending_timestamp;
+    pace->has_timestamp = TRUE;
+    pace->time = start;
+
+    batches = (counts + pace->batch - 1) / pace->batch;
+
+    /* Bursts of access units (such as: GOP cache) keep the frame interval in their
+     * timestamps but arrive faster: they are sent back to back. The first access unit of
+     * a media (the first one of its GOP cache burst) has no interval and is not paced,
+     * so the next ones are not held back by its pacing */
+    paced = (pace->spread > 0) && (interval >= RTPPACE_MIN_INTERVAL) &&
+            (gap >= interval / RTPPACE_BURST_DIVISOR);
+    interval = MIN(interval, RTPPACE_MAX_INTERVAL) * pace->spread / 100;
+
+    /* Batch "index" leaves at "index / batches" of the spread interval */
+    for (index = 0; (index < batches) && (ret == GST_FLOW_OK); index++)
+    {
+        if (paced && (index > 0) &&
+            !rtppace_wait(pace, start + (gint64)GST_TIME_AS_USECONDS(interval * index / batches)))
+        {
+            ret = GST_FLOW_FLUSHING;
+            break;
+        }
+
+        list = gst_buffer_list_new_sized(pace->batch);
+
+        for (packet = index * pace->batch; packet < MIN(counts, (index + 1) * pace->batch); packet++)
+        {
+            gst_buffer_list_add(list, gst_buffer_ref(gst_buffer_list_get(unit, packet)));
+        }
+
+        ret = gst_pad_push_list(pace->srcpad, list);
+    }
+
+    gst_buffer_list_unref(unit);
+
+    return ret;
+}
+
+gboolean rtppace_wait(RtpPace *pace, const gint64 deadline)
+{
+    gboolean result = FALSE;
+
+    g_mutex_lock(&pace->lock);
+
+    /* "g_cond_wait_until" returns FALSE when the deadline is reached */
+    while (!pace->flushing && g_cond_wait_until(&pace->cond, &pace->lock, deadline))
+    {
+    }
+
+    result = !pace->flushing;
+
+    g_mutex_unlock(&pace->lock);
+
+    return result;
+}
+
+void rtppace_set_flushing(RtpPace *pace, const gboolean flushing)
+{
+    g_mutex_lock(&pace->lock);
+
+    pace->flushing = flushing;
+    g_cond_broadcast(&pace->cond);
+
+    g_mutex_unlock(&pace->lock);
+}
+
+gboolean rtppace_sink_event(GstPad *pad, GstObject *parent, GstEvent *event)
+{
+    RtpPace *pace = (RtpPace *)parent;
+    GstBufferList *unit = NULL;
+    GstFlowReturn ret = GST_FLOW_OK;
+
+    switch (GST_EVENT_TYPE(event))
+    {
+        case GST_EVENT_FLUSH_START:
+            rtppace_set_flushing(pace, TRUE);
+        break;
+
+        case GST_EVENT_FLUSH_STOP:
+            /* The streaming thread is stopped: drop the pending access unit */
+            gst_buffer_list_unref(pace->pending);
+            pace->pending = gst_buffer_list_new();
+            pace->has_timestamp = FALSE;
+
+            rtppace_set_flushing(pace, FALSE);
+        break;
+
+        default:
+            /* Keep the order of packets and serialized events */
+            if (GST_EVENT_IS_SERIALIZED(event) && (gst_buffer_list_length(pace->pending) > 0))
+            {
+                unit = pace->pending;
+                pace->pending = gst_buffer_list_new();
+
+                ret = gst_pad_push_list(pace->srcpad, unit);
+            }
+
+            /* Events have no flow return: the access unit is lost, the event still goes
+             * downstream (such as: EOS). Flushing is not a failure */
+            if ((ret != GST_FLOW_OK) && (ret != GST_FLOW_FLUSHING))
+            {
+                g_message("Warning: %s failed to send an access unit before %s: %s",
+                          GST_OBJECT_NAME(pace), GST_EVENT_TYPE_NAME(event), gst_flow_get_name(ret));
+            }
+        break;
+    }
+
+    return gst_pad_event_default(pad, parent, event);
+}
+
+GstStateChangeReturn rtppace_change_state(GstElement *element, GstStateChange transition)
+{
+    RtpPace *pace = (RtpPace *)element;
+    GstStateChangeReturn ret = GST_STATE_CHANGE_SUCCESS;
+
+    switch (transition)
+    {
+        case GST_STATE_CHANGE_READY_TO_PAUSED:
+            pace->has_timestamp = FALSE;
+            rtppace_set_flushing(pace, FALSE);
+        break;
+
+        case GST_STATE_CHANGE_PAUSED_TO_READY:
+            /* Before the pads are deactivated: they wait for the streaming thread */
+            rtppace_set_flushing(pace, TRUE);
+        break;
+
+        default:
+        break;
+    }
+
+    ret = GST_ELEMENT_CLASS(rtppace_parent_class)->change_state(element, transition);
+
+    if (transition == GST_STATE_CHANGE_PAUSED_TO_READY)
+    {
+        gst_buffer_list_unref(pace->pending);
+        pace->pending = gst_buffer_list_new();
+    }
+
+    return ret;
+}
+
+void rtppace_set_property(GObject *object, guint id, const GValue *value, GParamSpec *pspec)
+{
+    RtpPace *pace = (RtpPace *)object;
+
+    switch (id)
+    {
+        case RTPPACE_PROP_SPREAD:
+            pace->spread = g_value_get_uint(value);
+        break;
+
+        case RTPPACE_PROP_BATCH:
+            pace->batch = g_value_get_uint(value);
+        break;
+
+        default:
+            G_OBJECT_WARN_INVALID_PROPERTY_ID(object, id, pspec);
+        break;
+    }
+}
+
+void rtppace_get_property(GObject *object, guint id, GValue *value, GParamSpec *pspec)
+{
+    RtpPace *pace = (RtpPace *)object;
+
+    switch (id)
+    {
+        case RTPPACE_PROP_SPREAD:
+            g_value_set_uint(value, pace->spread);
+        break;
+
+        case RTPPACE_PROP_BATCH:
+            g_value_set_uint(value, pace->batch);
+        break;
+
+        default:
+            G_OBJECT_WARN_INVALID_PROPERTY_ID(object, id, pspec);
+        break;
+    }
+}
+
+void rtppace_finalize(GObject *object)
+{
+    RtpPace *pace = (RtpPace *)object;
+
+    gst_buffer_list_unref(pace->pending);
+    g_mutex_clear(&pace->lock);
+    g_cond_clear(&pace->cond);
+
+    G_OBJECT_CLASS(rtppace_parent_class)->finalize(object);
+}
+
+static void rtppace_class_init(RtpPaceClass *klass)
+{
+    GObjectClass *object_class = G_OBJECT_CLASS(klass);
+    GstElementClass *element_class = GST_ELEMENT_CLASS(klass);
+
+    object_class->set_property = rtppace_set_property;
+    object_class->get_property = rtppace_get_property;
+    object_class->finalize = rtppace_finalize;
+
+    g_object_class_install_property(object_class, RTPPACE_PROP_SPREAD,
+        g_param_spec_uint("spread", "Spread", "Part of the frame interval over which an access unit is sent "
+                          "(%, 0 to send it at once)", 0, 100, RTPPACE_DEFAULT_SPREAD,
+                          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+    g_object_class_install_property(object_class, RTPPACE_PROP_BATCH,
+        g_param_spec_uint("batch", "Batch", "Maximum number of packets sent at once", 1, RTPPACE_MAX_BATCH,
+                          RTPPACE_DEFAULT_BATCH, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+    gst_element_class_add_static_pad_template(element_class, &rtppace_sink_template);
+    gst_element_class_add_static_pad_template(element_class, &rtppace_src_template);
+    gst_element_class_set_static_metadata(element_class, "RTP pacer", "Filter/Network/RTP",
+                                          "Sends RTP packets in batches spread over the frame interval", "RVC");
+
+    element_class->change_state = rtppace_change_state;
+}
+
+static void rtppace_init(RtpPace *pace)
+{
+    pace->sinkpad = gst_pad_new_from_static_template(&rtppace_sink_template, "sink");
+    gst_pad_set_chain_function(pace->sinkpad, rtppace_chain);
+    gst_pad_set_chain_list_function(pace->sinkpad, rtppace_chain_list);
+    gst_pad_set_event_function(pace->sinkpad, rtppace_sink_event);
+    GST_PAD_SET_PROXY_CAPS(pace->sinkpad);
+    GST_PAD_SET_PROXY_ALLOCATION(pace->sinkpad);
+    gst_element_add_pad(GST_ELEMENT(pace), pace->sinkpad);
+
+    pace->srcpad = gst_pad_new_from_static_template(&rtppace_src_template, "src");
+    GST_PAD_SET_PROXY_CAPS(pace->srcpad);
+    gst_element_add_pad(GST_ELEMENT(pace), pace->srcpad);
+
+    pace->spread = RTPPACE_DEFAULT_SPREAD;
+    pace->batch = RTPPACE_DEFAULT_BATCH;
+    pace->pending = gst_buffer_list_new();
+    pace->pending_timestamp = 0;
+    pace->timestamp = 0;
+    pace->has_timestamp = FALSE;
+    pace->flushing = FALSE;
+
+    g_mutex_init(&pace->lock);
+    g_cond_init(&pace->cond);
+}
+
+/* ---------- Public functions ---------- */
+
+gboolean rtppace_register()
+{
+    return gst_element_register(NULL, RTPPACE_ELEMENT_NAME, GST_RANK_NONE, rtppace_get_type());
+}
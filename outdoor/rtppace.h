@@ -0,0 +1,84 @@
+/***********************************************************************
+ * FILENAME: rtppace.h
+ *
+ * DESCRIPTION:
+ *   Contains APIs of the "rtppace" GStreamer element: batching and pacing
+ *   of RTP packets before the UDP sinks of RTSP media.
+ *
+ *   The packets of an access unit (up to the one with the marker bit)
+ *   are collected, then pushed as buffer lists of at most "batch" packets.
+ *   The UDP sinks of the RTSP server send a buffer list with one system
+ *   call per client ("sendmmsg()"), instead of one per packet. Batches
+ *   are spread evenly over "spread" % of the frame interval (measured
+ *   from RTP timestamps), so that a keyframe does not leave at line rate.
+ *
+ *   Access units are always sent before the next one arrives: pacing never
+ *   adds more than one frame interval of latency. Access units arriving
+ *   sooner than their frame interval allows (less than 1/RTPPACE_BURST_DIVISOR
+ *   of it after the previous one, such as: GOP cache bursts), or closer than
+ *   RTPPACE_MIN_INTERVAL, are sent at once.
+ *
+ *   The element is built in the application (no plugin to install).
+ *
+ * PUBLIC FUNCTIONS:
+ *   gboolean rtppace_register();
+ *
+ * AUTHOR: RVC       START DATE: 17/10/2026
+ *
+ * CHANGES:
+ *
+ ***********************************************************************/
+
+#ifndef _RTPPACE_H_
+#define _RTPPACE_H_
+
+/* ---------- Macros ---------- */
+
+/* Name of the element in pipeline strings */
+#define RTPPACE_ELEMENT_NAME "rtppace"
+
+/* Default and maximum values of properties */
+#define RTPPACE_DEFAULT_SPREAD 80
+#define RTPPACE_DEFAULT_BATCH 8
+#define RTPPACE_MAX_BATCH 64
+
+/* Access units closer than this (ns) are sent at once, longer intervals are capped */
+#define RTPPACE_MIN_INTERVAL (2 * GST_MSECOND)
+#define RTPPACE_MAX_INTERVAL (100 * GST_MSECOND)
+
+/* An access unit arriving less than 1/RTPPACE_BURST_DIVISOR of its frame interval
+ * after the previous one is part of a burst (it is catching up with the live stream) */
+#define RTPPACE_BURST_DIVISOR 2
+
+/* ---------- Datatypes ---------- */
+
+/*
+ * Struct: RtpPace
+ * ---
+ *   Represents the element:
+ *     - sinkpad, srcpad (GstPad): Pads (RTP packets in, buffer lists out).
+ *     - spread (guint): Part of the frame interval over which an access unit is sent (%),
+ *       0 to send access units at once (batching only). Property "spread".
+ *     - batch (guint): Maximum number of packets per buffer list. Property "batch".
+ *     - pending (GstBufferList): Packets of the current access unit.
+ *     - pending_timestamp (guint32): RTP timestamp of the current access unit.
+ *     - timestamp (guint32): RTP timestamp of the previous access unit.
+ *     - has_timestamp (gboolean): Set once an access unit has been sent.
+ *     - time (gint64): Monotonic time (us) when the previous access unit was complete.
+ *     - flushing (gboolean): Set while the element is flushing or stopping (waits are aborted).
+ *     - lock, cond: Protect "flushing" and wake up waits.
+ */
+
+/* ---------- Functions ---------- */
+
+/*
+ * Function: rtppace_register
+ * ---
+ *   Registers element RTPPACE_ELEMENT_NAME, so that pipeline strings can use it.
+ *   GStreamer must be initialized.
+ *
+ *   return: TRUE (success), FALSE (failure).
+ */
+gboolean rtppace_register();
+
+#endif
@@ -0,0 +1,1128 @@
+/***********************************************************************
+ * FILENAME: rtsp_load.c
+ *
+ * DESCRIPTION:
+ *   RTSP load generator: opens many concurrent RTSP sessions against
+ *   outdoor and reports the quality of service of every session.
+ *
+ *   Sessions use UDP, TCP (interleaved) or multicast transport, and are
+ *   spread over the mount points of the server (/camera-N or /camera-N/sub).
+ *   RTP packets are inspected when "rtspsrc" outputs them (no decoding):
+ *     - setup time: from the first RTSP request to the first RTP packet.
+ *     - time to first keyframe: to the first packet of an IDR access unit.
+ *     - received frame rate: RTP packets with the marker bit (end of access unit).
+ *     - packet loss: gaps in sequence numbers (RFC 3550, A.3).
+ *     - jitter: interarrival jitter (RFC 3550, A.8), in ms.
+ *     - inter-arrival gaps: longest silence between two packets, and the
+ *       number of gaps longer than LOAD_STALL_GAP (stalls).
+ *     - broken frames: access units with a packet missing after the jitter buffer.
+ *     - frame delay: from the first packet of an access unit received by the
+ *       jitter buffer to its last packet out of "rtspsrc".
+ *
+ *   With "--recovery <ms>", sessions ask for the AVPF profile: lost packets are
+ *   asked again with NACKs (retransmissions of outdoor "--retransmission"), and
+ *   ULPFEC packets advertised in the SDP (outdoor "--fec") repair them. The jitter
+ *   buffer waits up to <ms> for them: broken frames and frame delay show the
+ *   recovered frames and the latency cost.
+ *
+ *   The report is written in JSON (machine-readable), a summary is logged.
+ *
+ * AUTHOR: RVC       START DATE: 17/10/2026
+ *
+ * CHANGES:
+ *
+ ***********************************************************************/
+
+/* ---------- Header files ---------- */
+#include <glib.h>
+#include <glib/gprintf.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#include <gst/gst.h>
+#include <gst/rtp/gstrtpbuffer.h>
+
+/* ---------- Macros ---------- */
+
+#define LOAD_DEFAULT_SERVER "rtsp://127.0.0.1:5001"
+#define LOAD_DEFAULT_CAMERAS 1
+#define LOAD_DEFAULT_CLIENTS 4
+#define LOAD_DEFAULT_DURATION 30
+#define LOAD_DEFAULT_RAMP 100
+
+/* Gaps between two RTP packets longer than this (ms) are counted as stalls */
+#define LOAD_STALL_GAP 200
+
+/* Clock rate of H.264 RTP streams, used if caps do not tell it */
+#define LOAD_DEFAULT_CLOCK_RATE 90000
+
+/* Session pipeline: RTP packets are taken from "rtspsrc" without jitter buffer latency,
+ * unless lost packets are recovered (arguments: URL, protocols, latency, recovery options) */
+#define LOAD_SESSION_PIPELINE_FMT_STR "rtspsrc name=src location=\"%s\" protocols=%s latency=%d %s" \
+                                      "! fakesink sync=false"
+
+/* Options of "rtspsrc" to recover lost packets (RTCP feedback profile, NACKs) */
+#define LOAD_RECOVERY_STR "profiles=avpf do-retransmission=true "
+
+/* First arrivals of recent RTP timestamps kept to measure frame delays */
+#define LOAD_MAX_ARRIVALS 64
+
+/* H.264 NAL unit types in RTP payloads (RFC 6184) */
+#define LOAD_NAL_TYPE_IDR 5
+#define LOAD_NAL_TYPE_STAP_A 24
+#define LOAD_NAL_TYPE_FU_A 28
+
+/* ---------- Datatypes ---------- */
+
+/*
+ * Enum: load_protocol_t
+ * ---
+ *   Represents the transport of RTP packets:
+ *     - LOAD_PROTOCOL_UDP: Unicast UDP.
+ *     - LOAD_PROTOCOL_TCP: Interleaved in the RTSP connection.
+ *     - LOAD_PROTOCOL_MULTICAST: Multicast UDP (the server chooses the group).
+ *     - LOAD_PROTOCOL_MIXED: Sessions use the three transports in turn (option only).
+ *     - LOAD_PROTOCOL_UNKNOWN: Invalid transport.
+ */
+enum load_protocol_t
+{
+    LOAD_PROTOCOL_UDP,
+    LOAD_PROTOCOL_TCP,
+    LOAD_PROTOCOL_MULTICAST,
+    LOAD_PROTOCOL_MIXED,
+    LOAD_PROTOCOL_UNKNOWN
+};
+
+/*
+ * Struct: load_session_t
+ * ---
+ *   Represents an RTSP session and its statistics. Statistics are only written by the
+ *   streaming thread of the session, and read once its pipeline is stopped:
+ *     - index (gint): Number of the session (from 1).
+ *     - url (string): URL of the session.
+ *     - protocol (enum load_protocol_t): Transport of RTP packets.
+ *     - pipeline (GstElement): "rtspsrc" and "fakesink".
+ *     - bus_watch_id (guint): Watch of errors of the pipeline.
+ *     - start_time, sdp_time, first_packet_time, first_keyframe_time, last_time (gint64):
+ *       Monotonic times (us) of: the start of the session, the SDP of the server,
+ *       the first RTP packet, the first packet of a keyframe, the latest packet (0: not yet).
+ *     - packets, bytes, frames (guint64): Received RTP packets, payload bytes and access units.
+ *     - base_seq, highest_seq (gint64): First and highest extended sequence numbers.
+ *     - clock_rate (gint): Clock rate of RTP timestamps.
+ *     - transit (guint32): Relative transit time of the latest packet (RTP units).
+ *     - jitter (gdouble): Interarrival jitter (RTP units).
+ *     - max_gap (gint64): Longest time between two packets (us).
+ *     - stalls (guint): Gaps longer than LOAD_STALL_GAP.
+ *     - broken_frames (guint64): Access units with missing packets.
+ *     - frame_broken (gboolean): Set if a packet of the current access unit is missing.
+ *     - arrival_timestamps, arrival_times, arrival_index: Ring of the first arrivals
+ *       (monotonic, us) of recent RTP timestamps in the jitter buffer (protected by "lock").
+ *     - delayed_frames (guint64), delay_sum, delay_max (gint64): Frame delays (us).
+ *     - jitterbuffer (GstElement): Jitter buffer of the session (NULL until it is created).
+ *     - error (string): Error of the session (NULL if none).
+ */
+struct load_session_t
+{
+    gint index;
+    gchar *url;
+    enum load_protocol_t protocol;
+
+    GstElement *pipeline;
+    guint bus_watch_id;
+
+    gint64 start_time;
+    gint64 sdp_time;
+    gint64 first_packet_time;
+    gint64 first_keyframe_time;
+    gint64 last_time;
+
+    guint64 packets;
+    guint64 bytes;
+    guint64 frames;
+
+    gint64 base_seq;
+    gint64 highest_seq;
+
+    gint clock_rate;
+    guint32 transit;
+    gdouble jitter;
+
+    gint64 max_gap;
+    guint stalls;
+
+    guint64 broken_frames;
+    gboolean frame_broken;
+
+    GMutex lock;
+    guint32 arrival_timestamps[LOAD_MAX_ARRIVALS];
+    gint64 arrival_times[LOAD_MAX_ARRIVALS];
+    guint arrival_index;
+
+    guint64 delayed_frames;
+    gint64 delay_sum;
+    gint64 delay_max;
+
+    GstElement *jitterbuffer;
+
+    gchar *error;
+};
+
+/*
+ * Struct: load_t
+ * ---
+ *   Represents the load test:
+ *     - sessions (array of "load_session_t"): All sessions, started in turn.
+ *     - started (guint): The number of started sessions.
+ *     - loop (GMainLoop): Main loop, stopped at the end of the test.
+ *     - end_time (gint64): Monotonic time (us) when sessions were stopped.
+ */
+struct load_t
+{
+    GPtrArray *sessions;
+    guint started;
+
+    GMainLoop *loop;
+
+    gint64 end_time;
+};
+
+/* ---------- Variables ---------- */
+
+/* Names of "enum load_protocol_t" (the same order), and their value of "rtspsrc::protocols" */
+const gchar *load_protocol_names[] = { "udp", "tcp", "multicast", "mixed" };
+const gchar *load_rtspsrc_protocols[] = { "udp", "tcp", "udp-mcast" };
+
+gchar *option_server = NULL;
+gchar *option_protocol = NULL;
+gchar *option_tier = NULL;
+gchar *option_output = NULL;
+gint option_cameras = LOAD_DEFAULT_CAMERAS;
+gint option_clients = LOAD_DEFAULT_CLIENTS;
+gint option_duration = LOAD_DEFAULT_DURATION;
+gint option_ramp = LOAD_DEFAULT_RAMP;
+gint option_recovery = 0;
+
+GOptionEntry entries[] =
+{
+    { "server", 's', G_OPTION_FLAG_NONE, G_OPTION_ARG_STRING, &option_server,
+      "Set the RTSP server (one port, mount points /camera-N)", LOAD_DEFAULT_SERVER },
+
+    { "cameras", 'n', G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &option_cameras,
+      "Set the number of cameras of the server (sessions are spread over them)", "1" },
+
+    { "clients", 'c', G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &option_clients,
+      "Set the number of concurrent sessions", "4" },
+
+    { "protocol", 'p', G_OPTION_FLAG_NONE, G_OPTION_ARG_STRING, &option_protocol,
+      "Set the transport: 'udp', 'tcp' (interleaved), 'multicast' or 'mixed' (in turn)", "udp" },
+
+    { "tier", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_STRING, &option_tier,
+      "Set the stream of cameras: 'main' or 'sub'", "main" },
+
+    { "duration", 'd', G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &option_duration,
+      "Set how long sessions play after the last one started (seconds)", "30" },
+
+    { "ramp", 'r', G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &option_ramp,
+      "Set the delay between two session starts (ms)", "100" },
+
+    { "recovery", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &option_recovery,
+      "Recover lost packets (AVPF: NACKs and ULPFEC), waiting up to this time in the jitter buffer (ms)", "0" },
+
+    { "output", 'o', G_OPTION_FLAG_NONE, G_OPTION_ARG_FILENAME, &option_output,
+      "Write the JSON report to a file instead of the standard output", NULL },
+
+    { NULL }
+};
+
+/* ---------- Private functions ---------- */
+
+/*
+ * Function: load_protocol_from_string
+ * ---
+ *   Convert string "protocol" (such as: "udp", "mixed") to "enum load_protocol_t".
+ *
+ *   return: The transport (LOAD_PROTOCOL_UNKNOWN if "protocol" is invalid).
+ */
+static enum load_protocol_t load_protocol_from_string(const gchar *protocol);
+
+/*
+ * Function: load_session_create
+ * ---
+ *   Creates (but does not start) session "index" of "url".
+ *
+ *   return: NULL (the pipeline cannot be created), not NULL (the session).
+ */
+static struct load_session_t *load_session_create(const gint index, const gchar *url,
+                                                  const enum load_protocol_t protocol);
+
+/*
+ * Function: load_session_add_packet
+ * ---
+ *   Updates statistics of "session" with RTP packet "buffer", received at "now" (us).
+ */
+static void load_session_add_packet(struct load_session_t *session, GstBuffer *buffer, const gint64 now);
+
+/*
+ * Function: load_session_free
+ * ---
+ *   Stops and frees "session".
+ */
+static void load_session_free(gpointer data);
+
+/*
+ * Function: load_on_sdp
+ * ---
+ *   Callback of "rtspsrc::on-sdp". The server answered DESCRIBE.
+ */
+static void load_on_sdp(GstElement *rtspsrc, gpointer sdp, gpointer user_data);
+
+/*
+ * Function: load_on_new_manager
+ * ---
+ *   Callback of "rtspsrc::new-manager". Follows the jitter buffer of the session.
+ */
+static void load_on_new_manager(GstElement *rtspsrc, GstElement *manager, gpointer user_data);
+
+/*
+ * Function: load_on_new_jitterbuffer
+ * ---
+ *   Callback of "rtpbin::new-jitterbuffer". Records arrivals of RTP packets.
+ */
+static void load_on_new_jitterbuffer(GstElement *rtpbin, GstElement *jitterbuffer, guint session_id,
+                                     guint ssrc, gpointer user_data);
+
+/*
+ * Function: load_on_arrival
+ * ---
+ *   Probe of RTP packets entering the jitter buffer. Records the first arrival of
+ *   every RTP timestamp (the first packet of every access unit).
+ *
+ *   return: GST_PAD_PROBE_OK.
+ */
+static GstPadProbeReturn load_on_arrival(GstPad *pad, GstPadProbeInfo *info, gpointer user_data);
+
+/*
+ * Function: load_get_rtx_stats
+ * ---
+ *   Get the retransmissions asked by the jitter buffer of "session", and those which arrived.
+ */
+static void load_get_rtx_stats(const struct load_session_t *session, guint64 *requests, guint64 *successes);
+
+/*
+ * Function: load_on_pad_added
+ * ---
+ *   Callback of "rtspsrc::pad-added". Gets the clock rate of the stream and
+ *   inspects its RTP packets.
+ */
+static void load_on_pad_added(GstElement *rtspsrc, GstPad *pad, gpointer user_data);
+
+/*
+ * Function: load_on_rtp
+ * ---
+ *   Probe of RTP packets (buffers and buffer lists) of a session.
+ *
+ *   return: GST_PAD_PROBE_OK.
+ */
+static GstPadProbeReturn load_on_rtp(GstPad *pad, GstPadProbeInfo *info, gpointer user_data);
+
+/*
+ * Function: load_on_bus_message
+ * ---
+ *   Keeps the first error of a session (such as: transport refused by the server).
+ */
+static gboolean load_on_bus_message(GstBus *bus, GstMessage *message, gpointer user_data);
+
+/*
+ * Function: load_on_start
+ * ---
+ *   Timer callback. Starts the next session, then stops the test "option_duration"
+ *   seconds after the last one.
+ *
+ *   return: G_SOURCE_CONTINUE (some sessions are not started), G_SOURCE_REMOVE.
+ */
+static gboolean load_on_start(gpointer user_data);
+
+/*
+ * Function: load_on_end
+ * ---
+ *   Timer callback. Stops the main loop.
+ *
+ *   return: G_SOURCE_REMOVE.
+ */
+static gboolean load_on_end(gpointer user_data);
+
+/*
+ * Function: load_print_string
+ * ---
+ *   Writes "value" as a JSON string (NULL: null).
+ */
+static void load_print_string(FILE *file, const gchar *value);
+
+/*
+ * Function: load_print_time
+ * ---
+ *   Writes the time (ms) from "start" to "time" (monotonic, us) as a JSON number
+ *   (null if "time" is 0).
+ */
+static void load_print_time(FILE *file, const gint64 start, const gint64 time);
+
+/*
+ * Function: load_print_report
+ * ---
+ *   Writes the JSON report of "load" and logs its summary.
+ *
+ *   return: The number of failed sessions (errors or no packet).
+ */
+static guint load_print_report(const struct load_t *load, FILE *file);
+
+/* ---------- Private functions ---------- */
+
+enum load_protocol_t load_protocol_from_string(const gchar *protocol)
+{
+    enum load_protocol_t result = LOAD_PROTOCOL_UDP;
+
+    for (result = LOAD_PROTOCOL_UDP; result < LOAD_PROTOCOL_UNKNOWN; result++)
+    {
+        if (g_strcmp0(load_protocol_names[result], protocol) == 0)
+        {
+            break;
+        }
+    }
+
+    return result;
+}
+
+struct load_session_t *load_session_create(const gint index, const gchar *url,
+                                           const enum load_protocol_t protocol)
+{
+    struct load_session_t *session = NULL;
+    GstElement *rtspsrc = NULL;
+    GstBus *bus = NULL;
+    GError *error = NULL;
+    gchar *description = NULL;
+
+    session = g_new0(struct load_session_t, 1);
+    session->index = index;
+    session->url = g_strdup(url);
+    session->protocol = protocol;
+    session->clock_rate = LOAD_DEFAULT_CLOCK_RATE;
+    g_mutex_init(&session->lock);
+
+    description = g_strdup_printf(LOAD_SESSION_PIPELINE_FMT_STR, url, load_rtspsrc_protocols[protocol],
+                                  option_recovery, (option_recovery > 0) ? LOAD_RECOVERY_STR : "");
+    session->pipeline = gst_parse_launch(description, &error);
+    g_free(description);
+
+    if (session->pipeline == NULL)
+    {
+        g_message("Error: Session %d: %s", index, error->message);
+        g_error_free(error);
+        load_session_free(session);
+
+        return NULL;
+    }
+
+    g_clear_error(&error);
+
+    rtspsrc = gst_bin_get_by_name(GST_BIN(session->pipeline), "src");
+    g_signal_connect(rtspsrc, "on-sdp", G_CALLBACK(load_on_sdp), session);
+    g_signal_connect(rtspsrc, "pad-added", G_CALLBACK(load_on_pad_added), session);
+    g_signal_connect(rtspsrc, "new-manager", G_CALLBACK(load_on_new_manager), session);
+    gst_object_unref(rtspsrc);
+
+    bus = gst_element_get_bus(session->pipeline);
+    session->bus_watch_id = gst_bus_add_watch(bus, load_on_bus_message, session);
+    gst_object_unref(bus);
+
+    return session;
+}
+
+void load_session_add_packet(struct load_session_t *session, GstBuffer *buffer, const gint64 now)
+{
+    GstRTPBuffer rtp = GST_RTP_BUFFER_INIT;
+    const guint8 *payload = NULL;
+    guint length = 0;
+    guint offset = 0;
+    guint8 type = 0;
+    gboolean keyframe = FALSE;
+
+    guint32 arrival = 0;
+    guint32 transit = 0;
+    gint32 delta = 0;
+    gint16 step = 0;
+    guint32 timestamp = 0;
+    guint index = 0;
+
+    if (!gst_rtp_buffer_map(buffer, GST_MAP_READ, &rtp))
+    {
+        return;
+    }
+
+    payload = gst_rtp_buffer_get_payload(&rtp);
+    length = gst_rtp_buffer_get_payload_len(&rtp);
+
+    /* Sequence numbers are extended to count wrap-arounds */
+    if (session->packets == 0)
+    {
+        session->base_seq = gst_rtp_buffer_get_seq(&rtp);
+        session->highest_seq = session->base_seq;
+        session->first_packet_time = now;
+    }
+    else
+    {
+        step = (gint16)(gst_rtp_buffer_get_seq(&rtp) - (guint16)session->highest_seq);
+        if (step > 0)
+        {
+            session->highest_seq += step;
+        }
+
+        /* Packets missing after the jitter buffer: they were not recovered */
+        if (step > 1)
+        {
+            session->frame_broken = TRUE;
+        }
+
+        if (now - session->last_time > session->max_gap)
+        {
+            session->max_gap = now - session->last_time;
+        }
+
+        if (now - session->last_time > LOAD_STALL_GAP * 1000)
+        {
+            session->stalls++;
+        }
+    }
+
+    /* Interarrival jitter (RFC 3550, A.8), in RTP units */
+    arrival = (guint32)(now * session->clock_rate / G_USEC_PER_SEC);
+    transit = arrival - gst_rtp_buffer_get_timestamp(&rtp);
+
+    if (session->packets > 0)
+    {
+        delta = (gint32)(transit - session->transit);
+        session->jitter += (ABS(delta) - session->jitter) / 16.0;
+    }
+
+    session->transit = transit;
+    session->last_time = now;
+    session->packets++;
+    session->bytes += length;
+
+    if (gst_rtp_buffer_get_marker(&rtp))
+    {
+        session->frames++;
+
+        if (session->frame_broken)
+        {
+            session->broken_frames++;
+            session->frame_broken = FALSE;
+        }
+
+        /* Delay of the access unit: from its first packet in the jitter buffer */
+        timestamp = gst_rtp_buffer_get_timestamp(&rtp);
+
+        g_mutex_lock(&session->lock);
+        for (index = 0; index < LOAD_MAX_ARRIVALS; index++)
+        {
+            if ((session->arrival_times[index] != 0) && (session->arrival_timestamps[index] == timestamp))
+            {
+                session->delay_sum += now - session->arrival_times[index];
+                session->delay_max = MAX(session->delay_max, now - session->arrival_times[index]);
+                session->delayed_frames++;
+                break;
+            }
+        }
+        g_mutex_unlock(&session->lock);
+    }
+
+    /* Keyframes: IDR NAL units, alone, aggregated (STAP-A) or fragmented (first FU-A) */
+    if ((session->first_keyframe_time == 0) && (length > 1))
+    {
+        type = payload[0] & 0x1f;
+
+        if (type == LOAD_NAL_TYPE_IDR)
+        {
+            keyframe = TRUE;
+        }
+        else if (type == LOAD_NAL_TYPE_FU_A)
+        {
+            keyframe = ((payload[1] & 0x80) != 0) && ((payload[1] & 0x1f) == LOAD_NAL_TYPE_IDR);
+        }
+        else if (type == LOAD_NAL_TYPE_STAP_A)
+        {
+            for (offset = 1; (offset + 2 < length) && !keyframe;
+                 offset += 2 + ((payload[offset] << 8) | payload[offset + 1]))
+            {
+                keyframe = ((payload[offset + 2] & 0x1f) == LOAD_NAL_TYPE_IDR);
+            }
+        }
+
+        if (keyframe)
+        {
+            session->first_keyframe_time = now;
+        }
+    }
+
+    gst_rtp_buffer_unmap(&rtp);
+}
+
+void load_session_free(gpointer data)
+{
+    struct load_session_t *session = (struct load_session_t*)data;
+
+    if (session->bus_watch_id != 0)
+    {
+        g_source_remove(session->bus_watch_id);
+    }
+
+    if (session->pipeline != NULL)
+    {
+        gst_element_set_state(session->pipeline, GST_STATE_NULL);
+        gst_object_unref(session->pipeline);
+    }
+
+    if (session->jitterbuffer != NULL)
+    {
+        gst_object_unref(session->jitterbuffer);
+    }
+
+    g_mutex_clear(&session->lock);
+    g_free(session->url);
+    g_free(session->error);
+    g_free(session);
+}
+
+void load_on_sdp(GstElement *rtspsrc, gpointer sdp, gpointer user_data)
+{
+    struct load_session_t *session = (struct load_session_t*)user_data;
+
+    session->sdp_time = g_get_monotonic_time();
+}
+
+void load_on_new_manager(GstElement *rtspsrc, GstElement *manager, gpointer user_data)
+{
+    g_signal_connect(manager, "new-jitterbuffer", G_CALLBACK(load_on_new_jitterbuffer), user_data);
+}
+
+void load_on_new_jitterbuffer(GstElement *rtpbin, GstElement *jitterbuffer, guint session_id,
+                              guint ssrc, gpointer user_data)
+{
+    struct load_session_t *session = (struct load_session_t*)user_data;
+    GstPad *pad = NULL;
+
+    /* One stream per session: the first jitter buffer is the stream (RTX has none) */
+    g_mutex_lock(&session->lock);
+    if (session->jitterbuffer == NULL)
+    {
+        session->jitterbuffer = gst_object_ref(jitterbuffer);
+
+        pad = gst_element_get_static_pad(jitterbuffer, "sink");
+        gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_BUFFER_LIST,
+                          load_on_arrival, session, NULL);
+        gst_object_unref(pad);
+    }
+    g_mutex_unlock(&session->lock);
+}
+
+GstPadProbeReturn load_on_arrival(GstPad *pad, GstPadProbeInfo *info, gpointer user_data)
+{
+    struct load_session_t *session = (struct load_session_t*)user_data;
+    GstBuffer *buffer = NULL;
+    GstRTPBuffer rtp = GST_RTP_BUFFER_INIT;
+    guint32 timestamp = 0;
+    guint index = 0;
+
+    /* Buffer lists: the first packet is enough (packets of a list have arrived together) */
+    buffer = (info->type & GST_PAD_PROBE_TYPE_BUFFER_LIST) ?
+             gst_buffer_list_get(GST_PAD_PROBE_INFO_BUFFER_LIST(info), 0) : GST_PAD_PROBE_INFO_BUFFER(info);
+
+    if ((buffer == NULL) || !gst_rtp_buffer_map(buffer, GST_MAP_READ, &rtp))
+    {
+        return GST_PAD_PROBE_OK;
+    }
+
+    timestamp = gst_rtp_buffer_get_timestamp(&rtp);
+    gst_rtp_buffer_unmap(&rtp);
+
+    g_mutex_lock(&session->lock);
+
+    for (index = 0; index < LOAD_MAX_ARRIVALS; index++)
+    {
+        if ((session->arrival_times[index] != 0) && (session->arrival_timestamps[index] == timestamp))
+        {
+            break;
+        }
+    }
+
+    if (index == LOAD_MAX_ARRIVALS)
+    {
+        session->arrival_timestamps[session->arrival_index] = timestamp;
+        session->arrival_times[session->arrival_index] = g_get_monotonic_time();
+        session->arrival_index = (session->arrival_index + 1) % LOAD_MAX_ARRIVALS;
+    }
+
+    g_mutex_unlock(&session->lock);
+
+    return GST_PAD_PROBE_OK;
+}
+
+void load_get_rtx_stats(const struct load_session_t *session, guint64 *requests, guint64 *successes)
+{
+    GstStructure *stats = NULL;
+
+    *requests = 0;
+    *successes = 0;
+
+    if (session->jitterbuffer == NULL)
+    {
+        return;
+    }
+
+    /* "rtpjitterbuffer::stats" (GStreamer 1.4 or later) */
+    g_object_get(session->jitterbuffer, "stats", &stats, NULL);
+    if (stats != NULL)
+    {
+        gst_structure_get_uint64(stats, "rtx-count", requests);
+        gst_structure_get_uint64(stats, "rtx-success-count", successes);
+        gst_structure_free(stats);
+    }
+}
+
+void load_on_pad_added(GstElement *rtspsrc, GstPad *pad, gpointer user_data)
+{
+    struct load_session_t *session = (struct load_session_t*)user_data;
+    GstCaps *caps = NULL;
+
+    caps = gst_pad_get_current_caps(pad);
+    if (caps != NULL)
+    {
+        gst_structure_get_int(gst_caps_get_structure(caps, 0), "clock-rate", &session->clock_rate);
+        gst_caps_unref(caps);
+    }
+
+    gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_BUFFER_LIST,
+                      load_on_rtp, session, NULL);
+}
+
+GstPadProbeReturn load_on_rtp(GstPad *pad, GstPadProbeInfo *info, gpointer user_data)
+{
+    struct load_session_t *session = (struct load_session_t*)user_data;
+    GstBufferList *list = NULL;
+    gint64 now = g_get_monotonic_time();
+    guint index = 0;
+
+    if (info->type & GST_PAD_PROBE_TYPE_BUFFER_LIST)
+    {
+        list = GST_PAD_PROBE_INFO_BUFFER_LIST(info);
+
+        for (index = 0; index < gst_buffer_list_length(list); index++)
+        {
+            load_session_add_packet(session, gst_buffer_list_get(list, index), now);
+        }
+    }
+    else
+    {
+        load_session_add_packet(session, GST_PAD_PROBE_INFO_BUFFER(info), now);
+    }
+
+    return GST_PAD_PROBE_OK;
+}
+
+gboolean load_on_bus_message(GstBus *bus, GstMessage *message, gpointer user_data)
+{
+    struct load_session_t *session = (struct load_session_t*)user_data;
+    GError *error = NULL;
+
+    if ((GST_MESSAGE_TYPE(message) == GST_MESSAGE_ERROR) && (session->error == NULL))
+    {
+        gst_message_parse_error(message, &error, NULL);
+
+        g_message("Warning: Session %d (%s, %s): %s", session->index, session->url,
+                  load_protocol_names[session->protocol], error->message);
+
+        session->error = g_strdup(error->message);
+        g_error_free(error);
+    }
+    else if ((GST_MESSAGE_TYPE(message) == GST_MESSAGE_EOS) && (session->error == NULL))
+    {
+        session->error = g_strdup("End of stream");
+    }
+
+    return TRUE;
+}
+
+gboolean load_on_start(gpointer user_data)
+{
+    struct load_t *load = (struct load_t*)user_data;
+    struct load_session_t *session = NULL;
+
+    session = g_ptr_array_index(load->sessions, load->started);
+    session->start_time = g_get_monotonic_time();
+    gst_element_set_state(session->pipeline, GST_STATE_PLAYING);
+
+    load->started++;
+
+    if (load->started < load->sessions->len)
+    {
+        return G_SOURCE_CONTINUE;
+    }
+
+    g_message("Info: %u session(s) started, playing for %d s", load->started, option_duration);
+    g_timeout_add_seconds((guint)option_duration, load_on_end, load);
+
+    return G_SOURCE_REMOVE;
+}
+
+gboolean load_on_end(gpointer user_data)
+{
+    struct load_t *load = (struct load_t*)user_data;
+
+    g_main_loop_quit(load->loop);
+
+    return G_SOURCE_REMOVE;
+}
+
+void load_print_string(FILE *file, const gchar *value)
+{
+    const gchar *character = NULL;
+
+    if (value == NULL)
+    {
+        fprintf(file, "null");
+        return;
+    }
+
+    fputc('"', file);
+
+    for (character = value; *character != '\0'; character++)
+    {
+        if ((*character == '"') || (*character == '\\'))
+        {
+            fprintf(file, "\\%c", *character);
+        }
+        else if ((guchar)*character < 0x20)
+        {
+            fprintf(file, "\\u%04x", (guchar)*character);
+        }
+        else
+        {
+            fputc(*character, file);
+        }
+    }
+
+    fputc('"', file);
+}
+
+void load_print_time(FILE *file, const gint64 start, const gint64 time)
+{
+    if (time == 0)
+    {
+        fprintf(file, "null");
+    }
+    else
+    {
+        fprintf(file, "%.1f", (time - start) / 1000.0);
+    }
+}
+
+guint load_print_report(const struct load_t *load, FILE *file)
+{
+    struct load_session_t *session = NULL;
+
+    gdouble seconds = 0;
+    gdouble fps = 0;
+    gdouble loss = 0;
+    gint64 expected = 0;
+    gint64 lost = 0;
+    gdouble complete = 0;
+    guint64 rtx_requests = 0;
+    guint64 rtx_successes = 0;
+
+    guint failed = 0;
+    guint measured = 0;
+    gdouble setup_sum = 0;
+    gdouble setup_max = 0;
+    gdouble keyframe_sum = 0;
+    gdouble keyframe_max = 0;
+    gdouble fps_sum = 0;
+    gdouble fps_min = G_MAXDOUBLE;
+    gint64 expected_total = 0;
+    gint64 lost_total = 0;
+    gdouble jitter_max = 0;
+    gint64 gap_max = 0;
+    guint stalls = 0;
+    guint64 frames_total = 0;
+    guint64 broken_total = 0;
+    guint64 delayed_total = 0;
+    gint64 delay_total = 0;
+    gint64 delay_max = 0;
+    guint64 rtx_requests_total = 0;
+    guint64 rtx_successes_total = 0;
+    guint index = 0;
+
+    fprintf(file, "{\n  \"server\": ");
+    load_print_string(file, option_server);
+    fprintf(file, ",\n  \"tier\": ");
+    load_print_string(file, option_tier);
+    fprintf(file, ",\n  \"protocol\": ");
+    load_print_string(file, option_protocol);
+    fprintf(file, ",\n  \"duration_s\": %d,\n  \"recovery_ms\": %d,\n  \"sessions\": [",
+            option_duration, option_recovery);
+
+    for (index = 0; index < load->sessions->len; index++)
+    {
+        session = g_ptr_array_index(load->sessions, index);
+
+        /* Statistics cover the time from the first packet to the end of the test */
+        seconds = (session->first_packet_time != 0) ?
+                  (load->end_time - session->first_packet_time) / (gdouble)G_USEC_PER_SEC : 0;
+        fps = (seconds > 0) ? session->frames / seconds : 0;
+
+        expected = (session->packets > 0) ? session->highest_seq - session->base_seq + 1 : 0;
+        lost = MAX(0, expected - (gint64)session->packets);
+        loss = (expected > 0) ? lost * 100.0 / expected : 0;
+
+        complete = (session->frames > 0) ? (session->frames - session->broken_frames) * 100.0 / session->frames : 0;
+        load_get_rtx_stats(session, &rtx_requests, &rtx_successes);
+
+        fprintf(file, "%s\n    {\n      \"index\": %d,\n      \"url\": ", (index > 0) ? "," : "", session->index);
+        load_print_string(file, session->url);
+        fprintf(file, ",\n      \"protocol\": ");
+        load_print_string(file, load_protocol_names[session->protocol]);
+        fprintf(file, ",\n      \"status\": ");
+        load_print_string(file, ((session->error == NULL) && (session->packets > 0)) ? "ok" : "failed");
+        fprintf(file, ",\n      \"error\": ");
+        load_print_string(file, ((session->error == NULL) && (session->packets == 0)) ? "No RTP packet" :
+                                                                                        session->error);
+        fprintf(file, ",\n      \"sdp_ms\": ");
+        load_print_time(file, session->start_time, session->sdp_time);
+        fprintf(file, ",\n      \"setup_ms\": ");
+        load_print_time(file, session->start_time, session->first_packet_time);
+        fprintf(file, ",\n      \"first_keyframe_ms\": ");
+        load_print_time(file, session->start_time, session->first_keyframe_time);
+        fprintf(file, ",\n      \"packets\": %" G_GUINT64_FORMAT ",\n      \"bytes\": %" G_GUINT64_FORMAT
+                      ",\n      \"frames\": %" G_GUINT64_FORMAT ",\n      \"fps\": %.2f"
+                      ",\n      \"bitrate_kbps\": %.1f,\n      \"expected\": %" G_GINT64_FORMAT
+                      ",\n      \"lost\": %" G_GINT64_FORMAT ",\n      \"loss_percent\": %.3f"
+                      ",\n      \"jitter_ms\": %.3f,\n      \"max_gap_ms\": %.1f,\n      \"stalls\": %u"
+                      ",\n      \"broken_frames\": %" G_GUINT64_FORMAT ",\n      \"complete_percent\": %.3f"
+                      ",\n      \"frame_delay_ms\": %.1f,\n      \"max_frame_delay_ms\": %.1f"
+                      ",\n      \"rtx_requests\": %" G_GUINT64_FORMAT ",\n      \"rtx_recovered\": %" G_GUINT64_FORMAT
+                      "\n    }",
+                session->packets, session->bytes, session->frames, fps,
+                (seconds > 0) ? session->bytes * 8 / seconds / 1000.0 : 0.0, expected, lost, loss,
+                session->jitter * 1000.0 / session->clock_rate, session->max_gap / 1000.0, session->stalls,
+                session->broken_frames, complete,
+                (session->delayed_frames > 0) ? session->delay_sum / 1000.0 / session->delayed_frames : 0.0,
+                session->delay_max / 1000.0, rtx_requests, rtx_successes);
+
+        if ((session->error != NULL) || (session->packets == 0))
+        {
+            failed++;
+            continue;
+        }
+
+        measured++;
+        setup_sum += (session->first_packet_time - session->start_time) / 1000.0;
+        setup_max = MAX(setup_max, (session->first_packet_time - session->start_time) / 1000.0);
+
+        if (session->first_keyframe_time != 0)
+        {
+            keyframe_sum += (session->first_keyframe_time - session->start_time) / 1000.0;
+            keyframe_max = MAX(keyframe_max, (session->first_keyframe_time - session->start_time) / 1000.0);
+        }
+
+        fps_sum += fps;
+        fps_min = MIN(fps_min, fps);
+        expected_total += expected;
+        lost_total += lost;
+        jitter_max = MAX(jitter_max, session->jitter * 1000.0 / session->clock_rate);
+        gap_max = MAX(gap_max, session->max_gap);
+        stalls += session->stalls;
+        frames_total += session->frames;
+        broken_total += session->broken_frames;
+        delayed_total += session->delayed_frames;
+        delay_total += session->delay_sum;
+        delay_max = MAX(delay_max, session->delay_max);
+        rtx_requests_total += rtx_requests;
+        rtx_successes_total += rtx_successes;
+    }
+
+    if (measured == 0)
+    {
+        fps_min = 0;
+    }
+
+    fprintf(file, "\n  ],\n  \"summary\": {\n    \"sessions\": %u,\n    \"failed\": %u,"
+                  "\n    \"setup_ms_mean\": %.1f,\n    \"setup_ms_max\": %.1f,"
+                  "\n    \"first_keyframe_ms_mean\": %.1f,\n    \"first_keyframe_ms_max\": %.1f,"
+                  "\n    \"fps_mean\": %.2f,\n    \"fps_min\": %.2f,\n    \"loss_percent\": %.3f,"
+                  "\n    \"jitter_ms_max\": %.3f,\n    \"max_gap_ms\": %.1f,\n    \"stalls\": %u,"
+                  "\n    \"complete_percent\": %.3f,\n    \"frame_delay_ms_mean\": %.1f,"
+                  "\n    \"frame_delay_ms_max\": %.1f,\n    \"rtx_requests\": %" G_GUINT64_FORMAT ","
+                  "\n    \"rtx_recovered\": %" G_GUINT64_FORMAT "\n  }\n}\n",
+            load->sessions->len, failed,
+            (measured > 0) ? setup_sum / measured : 0.0, setup_max,
+            (measured > 0) ? keyframe_sum / measured : 0.0, keyframe_max,
+            (measured > 0) ? fps_sum / measured : 0.0, fps_min,
+            (expected_total > 0) ? lost_total * 100.0 / expected_total : 0.0,
+            jitter_max, gap_max / 1000.0, stalls,
+            (frames_total > 0) ? (frames_total - broken_total) * 100.0 / frames_total : 0.0,
+            (delayed_total > 0) ? delay_total / 1000.0 / delayed_total : 0.0, delay_max / 1000.0,
+            rtx_requests_total, rtx_successes_total);
+
+    g_message("Info: %u session(s), %u failed. Setup %.1f ms (max %.1f ms), first keyframe %.1f ms "
+              "(max %.1f ms), %.1f fps (min %.1f fps), loss %.3f %%, jitter max %.3f ms, "
+              "longest gap %.1f ms, %u stall(s)",
+              load->sessions->len, failed, (measured > 0) ? setup_sum / measured : 0.0, setup_max,
+              (measured > 0) ? keyframe_sum / measured : 0.0, keyframe_max,
+              (measured > 0) ? fps_sum / measured : 0.0, fps_min,
+              (expected_total > 0) ? lost_total * 100.0 / expected_total : 0.0,
+              jitter_max, gap_max / 1000.0, stalls);
+
+    g_message("Info: Complete frames %.3f %%, frame delay %.1f ms (max %.1f ms), "
+              "%" G_GUINT64_FORMAT " retransmission(s) asked, %" G_GUINT64_FORMAT " recovered",
+              (frames_total > 0) ? (frames_total - broken_total) * 100.0 / frames_total : 0.0,
+              (delayed_total > 0) ? delay_total / 1000.0 / delayed_total : 0.0, delay_max / 1000.0,
+              rtx_requests_total, rtx_successes_total);
+
+    return failed;
+}
+
+/*
+ * Function: main
+ * ---
+ *   Usage: rtsp_load [options] (see --help)
+ *
+ *   returns: 0 (all sessions received packets), 1 (some sessions failed), 2 (invalid options).
+ */
+int main(int argc, char *argv[])
+{
+    struct load_t load;
+    struct load_session_t *session = NULL;
+    enum load_protocol_t protocol = LOAD_PROTOCOL_UDP;
+    GOptionContext *context = NULL;
+    GError *error = NULL;
+    FILE *file = stdout;
+    gchar *url = NULL;
+    gint result = 0;
+    gint index = 0;
+
+    memset(&load, 0, sizeof(load));
+
+    context = g_option_context_new("- RTSP load generator for outdoor");
+    g_option_context_add_main_entries(context, entries, NULL);
+    g_option_context_add_group(context, gst_init_get_option_group());
+
+    if (!g_option_context_parse(context, &argc, &argv, &error))
+    {
+        g_printerr("Error: %s\n", error->message);
+        g_error_free(error);
+        g_option_context_free(context);
+
+        return 2;
+    }
+
+    g_option_context_free(context);
+
+    if (option_server == NULL)
+    {
+        option_server = g_strdup(LOAD_DEFAULT_SERVER);
+    }
+
+    if (option_protocol == NULL)
+    {
+        option_protocol = g_strdup(load_protocol_names[LOAD_PROTOCOL_UDP]);
+    }
+
+    if (option_tier == NULL)
+    {
+        option_tier = g_strdup("main");
+    }
+
+    protocol = load_protocol_from_string(option_protocol);
+
+    if ((protocol == LOAD_PROTOCOL_UNKNOWN) || (option_cameras < 1) || (option_clients < 1) ||
+        (option_duration < 1) || (option_ramp < 0) || (option_recovery < 0) ||
+        ((g_strcmp0(option_tier, "main") != 0) && (g_strcmp0(option_tier, "sub") != 0)))
+    {
+        g_printerr("Error: Invalid options (see --help)\n");
+        return 2;
+    }
+
+    if (option_output != NULL)
+    {
+        file = fopen(option_output, "w");
+        if (file == NULL)
+        {
+            g_printerr("Error: Cannot write '%s'\n", option_output);
+            return 2;
+        }
+    }
+
+    /* Sessions are spread over cameras, and over transports in "mixed" mode */
+    load.sessions = g_ptr_array_new_with_free_func(load_session_free);
+
+    for (index = 0; index < option_clients; index++)
+    {
+        url = g_strdup_printf("%s/camera-%d%s", option_server, index % option_cameras + 1,
+                              (g_strcmp0(option_tier, "sub") == 0) ? "/sub" : "");
+
+        session = load_session_create(index + 1, url, (protocol == LOAD_PROTOCOL_MIXED) ?
+                                                      (enum load_protocol_t)(index % LOAD_PROTOCOL_MIXED) :
+                                                      protocol);
+        g_free(url);
+
+        if (session == NULL)
+        {
+            result = 2;
+            break;
+        }
+
+        g_ptr_array_add(load.sessions, session);
+    }
+
+    if (result == 0)
+    {
+        g_message("Info: %d session(s) to %s (%s, %s streams), one every %d ms",
+                  option_clients, option_server, option_protocol, option_tier, option_ramp);
+
+        load.loop = g_main_loop_new(NULL, FALSE);
+
+        load_on_start(&load);
+        if (load.started < load.sessions->len)
+        {
+            g_timeout_add((guint)MAX(1, option_ramp), load_on_start, &load);
+        }
+
+        g_main_loop_run(load.loop);
+
+        /* Stop every session before reading statistics */
+        load.end_time = g_get_monotonic_time();
+
+        for (index = 0; index < (gint)load.sessions->len; index++)
+        {
+            session = g_ptr_array_index(load.sessions, index);
+            gst_element_set_state(session->pipeline, GST_STATE_NULL);
+        }
+
+        result = (load_print_report(&load, file) > 0) ? 1 : 0;
+
+        g_main_loop_unref(load.loop);
+    }
+
+    g_ptr_array_free(load.sessions, TRUE);
+
+    if (file != stdout)
+    {
+        fclose(file);
+    }
+
+    g_free(option_server);
+    g_free(option_protocol);
+    g_free(option_tier);
+    g_free(option_output);
+
+    return result;
+}
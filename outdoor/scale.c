@@ -0,0 +1,870 @@
+/***********************************************************************
+ * FILENAME: scale.c
+ *
+ * DESCRIPTION:
+ *   YUY2/UYVY to NV12 conversion and scaling kernels.
+ *
+ * NOTE:
+ *   For more further information about datatypes and function usages,
+ *   please refer to "scale.h".
+ *
+ * AUTHOR: RVC       START DATE: 17/10/2026
+ *
+ * CHANGES:
+ *
+ ***********************************************************************/
+
+/* ---------- Header files ---------- */
+
+#include <glib.h>
+#include <glib/gprintf.h>
+#include <errno.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define SCALE_X86
+#include <immintrin.h>
+#endif
+
+#if defined(__ARM_NEON)
+#define SCALE_NEON
+#include <arm_neon.h>
+#endif
+
+#include "scale.h"
+
+/* ---------- Macros ---------- */
+
+#define SCALE_ERROR g_quark_from_static_string("scale-error")
+
+/* Rounded average of 2 samples (same as "pavgb" and "vrhadd") */
+#define SCALE_AVG(a, b) ((guint8)(((guint)(a) + (guint)(b) + 1) >> 1))
+
+/* Bilinear weights are fractions of 256 */
+#define SCALE_WEIGHT_BITS 8
+#define SCALE_WEIGHT_ONE (1 << SCALE_WEIGHT_BITS)
+
+/* Rounded linear interpolation between 2 samples, "weight" is the part of "b" */
+#define SCALE_LERP(a, b, weight) ((guint8)(((guint)(a) * (SCALE_WEIGHT_ONE - (weight)) + \
+                                             (guint)(b) * (weight) + (SCALE_WEIGHT_ONE / 2)) >> SCALE_WEIGHT_BITS))
+
+/* Maximum length of kernel descriptions */
+#define SCALE_KERNEL_MAX_LENGTH 32
+
+#ifdef SCALE_X86
+/* Even bytes (Y of YUY2, U/V of UYVY) and odd bytes of 16-bit lanes, as 16-bit lanes */
+#define SSE2_EVEN(x) _mm_and_si128((x), _mm_set1_epi16(0x00FF))
+#define SSE2_ODD(x) _mm_srli_epi16((x), 8)
+#define SSE2_LUMA(x, uyvy) ((uyvy) ? SSE2_ODD(x) : SSE2_EVEN(x))
+#define SSE2_CHROMA(x, uyvy) ((uyvy) ? SSE2_EVEN(x) : SSE2_ODD(x))
+
+#define AVX2_EVEN(x) _mm256_and_si256((x), _mm256_set1_epi16(0x00FF))
+#define AVX2_ODD(x) _mm256_srli_epi16((x), 8)
+#define AVX2_LUMA(x, uyvy) ((uyvy) ? AVX2_ODD(x) : AVX2_EVEN(x))
+#define AVX2_CHROMA(x, uyvy) ((uyvy) ? AVX2_EVEN(x) : AVX2_ODD(x))
+
+/* AVX2 packs work within 128-bit lanes: put the 64-bit quarters back in order */
+#define AVX2_PACK_ORDER(x) _mm256_permute4x64_epi64((x), 0xD8)
+#endif
+
+/* ---------- Datatypes ---------- */
+
+/*
+ * Enum: scale_ratio_t
+ * ---
+ *   Represents the ratio between input and output sizes:
+ *     - SCALE_RATIO_COPY: Same size (conversion only).
+ *     - SCALE_RATIO_HALF: Half width and half height.
+ *     - SCALE_RATIO_BILINEAR: Any other size.
+ */
+enum scale_ratio_t
+{
+    SCALE_RATIO_COPY,
+    SCALE_RATIO_HALF,
+    SCALE_RATIO_BILINEAR
+};
+
+/*
+ * Struct: scale_tap_t
+ * ---
+ *   Represents the input samples of an output sample of the bilinear kernel:
+ *     - offset0, offset1 (gint): Position of the 2 samples (bytes in input rows, or row indexes).
+ *     - weight (guint): Part of the second sample (fraction of SCALE_WEIGHT_ONE).
+ */
+struct scale_tap_t
+{
+    gint offset0;
+
+    gint offset1;
+
+    guint weight;
+};
+
+/*
+ * Kernel of 1:1 ratio: converts input rows "r0" and "r1" to luma rows "y0" and "y1",
+ * and to the chroma row "uv" (average of both rows). "width" is in pixels
+ */
+typedef void (*scale_copy_rows_t)(const guint8 *r0, const guint8 *r1, guint8 *y0, guint8 *y1,
+                                  guint8 *uv, const gint width, const gboolean uyvy);
+
+/*
+ * Kernel of 2:1 ratio: converts input rows "r0" to "r3" to luma rows "y0" (from "r0"
+ * and "r1") and "y1" (from "r2" and "r3"), and to the chroma row "uv" (from the 4 rows).
+ * "width" is the output width, in pixels
+ */
+typedef void (*scale_half_rows_t)(const guint8 *r0, const guint8 *r1, const guint8 *r2,
+                                  const guint8 *r3, guint8 *y0, guint8 *y1, guint8 *uv,
+                                  const gint width, const gboolean uyvy);
+
+struct scale_t
+{
+    enum scale_format_t format;
+
+    enum scale_isa_t isa;
+
+    enum scale_ratio_t ratio;
+
+    gint src_width;
+    gint src_height;
+    gint dst_width;
+    gint dst_height;
+
+    gint luma_offset;
+    gint chroma_offset;
+
+    scale_copy_rows_t copy_rows;
+    scale_half_rows_t half_rows;
+
+    struct scale_tap_t *luma_x;
+    struct scale_tap_t *chroma_x;
+
+    gchar kernel[SCALE_KERNEL_MAX_LENGTH];
+};
+
+/* ---------- Private functions ---------- */
+
+/*
+ * Function: scale_get_tap
+ * ---
+ *   Get the input samples of output sample "index" when scaling "src_length" samples
+ *   to "dst_length" samples (sample centers are aligned, edges are repeated).
+ *
+ *   return: void.
+ */
+static void scale_get_tap(const gint index, const gint src_length, const gint dst_length,
+                          struct scale_tap_t *tap);
+
+/*
+ * Function: scale_copy_rows_scalar
+ * ---
+ *   Reference kernel of 1:1 ratio (see "scale_copy_rows_t"). SIMD kernels call it
+ *   for the last pixels of rows.
+ */
+static void scale_copy_rows_scalar(const guint8 *r0, const guint8 *r1, guint8 *y0, guint8 *y1,
+                                   guint8 *uv, const gint width, const gboolean uyvy);
+
+/*
+ * Function: scale_half_rows_scalar
+ * ---
+ *   Reference kernel of 2:1 ratio (see "scale_half_rows_t"). Rows are averaged first,
+ *   then columns, with rounding at each step (SIMD kernels give the same output).
+ */
+static void scale_half_rows_scalar(const guint8 *r0, const guint8 *r1, const guint8 *r2,
+                                   const guint8 *r3, guint8 *y0, guint8 *y1, guint8 *uv,
+                                   const gint width, const gboolean uyvy);
+
+#ifdef SCALE_X86
+/*
+ * Function: scale_copy_rows_sse2, scale_half_rows_sse2
+ * ---
+ *   SSE2 kernels: 16 output pixels per iteration.
+ */
+static void scale_copy_rows_sse2(const guint8 *r0, const guint8 *r1, guint8 *y0, guint8 *y1,
+                                 guint8 *uv, const gint width, const gboolean uyvy);
+
+static void scale_half_rows_sse2(const guint8 *r0, const guint8 *r1, const guint8 *r2,
+                                 const guint8 *r3, guint8 *y0, guint8 *y1, guint8 *uv,
+                                 const gint width, const gboolean uyvy);
+
+/*
+ * Function: scale_copy_rows_avx2, scale_half_rows_avx2
+ * ---
+ *   AVX2 kernels: 32 output pixels per iteration.
+ */
+static void scale_copy_rows_avx2(const guint8 *r0, const guint8 *r1, guint8 *y0, guint8 *y1,
+                                 guint8 *uv, const gint width, const gboolean uyvy);
+
+static void scale_half_rows_avx2(const guint8 *r0, const guint8 *r1, const guint8 *r2,
+                                 const guint8 *r3, guint8 *y0, guint8 *y1, guint8 *uv,
+                                 const gint width, const gboolean uyvy);
+#endif
+
+#ifdef SCALE_NEON
+/*
+ * Function: scale_copy_rows_neon, scale_half_rows_neon
+ * ---
+ *   NEON kernels: 32 (1:1) or 16 (2:1) output pixels per iteration. Pixel pairs are
+ *   loaded de-interleaved ("vld4q_u8"): Y0, U, Y1, V (YUY2) or U, Y0, V, Y1 (UYVY).
+ */
+static void scale_copy_rows_neon(const guint8 *r0, const guint8 *r1, guint8 *y0, guint8 *y1,
+                                 guint8 *uv, const gint width, const gboolean uyvy);
+
+static void scale_half_rows_neon(const guint8 *r0, const guint8 *r1, const guint8 *r2,
+                                 const guint8 *r3, guint8 *y0, guint8 *y1, guint8 *uv,
+                                 const gint width, const gboolean uyvy);
+#endif
+
+/*
+ * Function: scale_process_bilinear
+ * ---
+ *   Same as "scale_process()" for SCALE_RATIO_BILINEAR.
+ *
+ *   return: void.
+ */
+static void scale_process_bilinear(const struct scale_t *scale, const guint8 *src, const gint src_stride,
+                                   guint8 *dst_y, const gint y_stride, guint8 *dst_uv, const gint uv_stride);
+
+/* ---------- Private functions ---------- */
+
+void scale_get_tap(const gint index, const gint src_length, const gint dst_length,
+                   struct scale_tap_t *tap)
+{
+    /* Input position of the center of output sample "index", in 1/256 of samples */
+    gint64 position = ((2 * (gint64)index + 1) * src_length * (SCALE_WEIGHT_ONE / 2)) / dst_length -
+                      (SCALE_WEIGHT_ONE / 2);
+
+    if (position < 0)
+    {
+        position = 0;
+    }
+
+    tap->offset0 = (gint)(position >> SCALE_WEIGHT_BITS);
+    tap->weight = (guint)(position & (SCALE_WEIGHT_ONE - 1));
+
+    if (tap->offset0 >= src_length - 1)
+    {
+        tap->offset0 = src_length - 1;
+        tap->offset1 = tap->offset0;
+        tap->weight = 0;
+    }
+    else
+    {
+        tap->offset1 = tap->offset0 + 1;
+    }
+}
+
+void scale_copy_rows_scalar(const guint8 *r0, const guint8 *r1, guint8 *y0, guint8 *y1,
+                            guint8 *uv, const gint width, const gboolean uyvy)
+{
+    const gint luma = (uyvy) ? 1 : 0;
+    const gint chroma = 1 - luma;
+    gint x = 0;
+
+    /* One chroma byte per pixel in both formats: U and V alternate as in NV12 */
+    for (x = 0; x < width; x++)
+    {
+        y0[x] = r0[2 * x + luma];
+        y1[x] = r1[2 * x + luma];
+        uv[x] = SCALE_AVG(r0[2 * x + chroma], r1[2 * x + chroma]);
+    }
+}
+
+void scale_half_rows_scalar(const guint8 *r0, const guint8 *r1, const guint8 *r2,
+                            const guint8 *r3, guint8 *y0, guint8 *y1, guint8 *uv,
+                            const gint width, const gboolean uyvy)
+{
+    const gint luma = (uyvy) ? 1 : 0;
+    const gint chroma = 1 - luma;
+    gint x = 0;
+    gint offset = 0;
+
+    for (x = 0; x < width; x++)
+    {
+        /* Luma of input pixels 2x and 2x + 1 */
+        offset = 4 * x + luma;
+
+        y0[x] = SCALE_AVG(SCALE_AVG(r0[offset], r1[offset]), SCALE_AVG(r0[offset + 2], r1[offset + 2]));
+        y1[x] = SCALE_AVG(SCALE_AVG(r2[offset], r3[offset]), SCALE_AVG(r2[offset + 2], r3[offset + 2]));
+
+        /* U (even "x") or V (odd "x") of input pixel pairs 2 * (x / 2) and 2 * (x / 2) + 1 */
+        offset = 4 * (x & ~1) + 2 * (x & 1) + chroma;
+
+        uv[x] = SCALE_AVG(SCALE_AVG(SCALE_AVG(r0[offset], r1[offset]), SCALE_AVG(r2[offset], r3[offset])),
+                          SCALE_AVG(SCALE_AVG(r0[offset + 4], r1[offset + 4]),
+                                    SCALE_AVG(r2[offset + 4], r3[offset + 4])));
+    }
+}
+
+#ifdef SCALE_X86
+__attribute__((target("sse2")))
+void scale_copy_rows_sse2(const guint8 *r0, const guint8 *r1, guint8 *y0, guint8 *y1,
+                          guint8 *uv, const gint width, const gboolean uyvy)
+{
+    __m128i a0, a1, b0, b1;
+    gint x = 0;
+
+    for (x = 0; x + 16 <= width; x += 16)
+    {
+        a0 = _mm_loadu_si128((const __m128i *)(r0 + 2 * x));
+        a1 = _mm_loadu_si128((const __m128i *)(r0 + 2 * x + 16));
+        b0 = _mm_loadu_si128((const __m128i *)(r1 + 2 * x));
+        b1 = _mm_loadu_si128((const __m128i *)(r1 + 2 * x + 16));
+
+        _mm_storeu_si128((__m128i *)(y0 + x), _mm_packus_epi16(SSE2_LUMA(a0, uyvy), SSE2_LUMA(a1, uyvy)));
+        _mm_storeu_si128((__m128i *)(y1 + x), _mm_packus_epi16(SSE2_LUMA(b0, uyvy), SSE2_LUMA(b1, uyvy)));
+
+        a0 = _mm_avg_epu8(a0, b0);
+        a1 = _mm_avg_epu8(a1, b1);
+
+        _mm_storeu_si128((__m128i *)(uv + x), _mm_packus_epi16(SSE2_CHROMA(a0, uyvy), SSE2_CHROMA(a1, uyvy)));
+    }
+
+    scale_copy_rows_scalar(r0 + 2 * x, r1 + 2 * x, y0 + x, y1 + x, uv + x, width - x, uyvy);
+}
+
+__attribute__((target("sse2")))
+void scale_half_rows_sse2(const guint8 *r0, const guint8 *r1, const guint8 *r2,
+                          const guint8 *r3, guint8 *y0, guint8 *y1, guint8 *uv,
+                          const gint width, const gboolean uyvy)
+{
+    const __m128i mask = _mm_set1_epi16(0x00FF);
+    __m128i top[4], bottom[4];
+    __m128i l0, l1, c0, c1;
+    gint x = 0;
+    gint index = 0;
+
+    for (x = 0; x + 16 <= width; x += 16)
+    {
+        /* 32 input pixels: rows 0-1 and rows 2-3 averaged */
+        for (index = 0; index < 4; index++)
+        {
+            top[index] = _mm_avg_epu8(_mm_loadu_si128((const __m128i *)(r0 + 4 * x + 16 * index)),
+                                      _mm_loadu_si128((const __m128i *)(r1 + 4 * x + 16 * index)));
+            bottom[index] = _mm_avg_epu8(_mm_loadu_si128((const __m128i *)(r2 + 4 * x + 16 * index)),
+                                         _mm_loadu_si128((const __m128i *)(r3 + 4 * x + 16 * index)));
+        }
+
+        /* Luma: 32 samples per row, then pairs averaged (low byte of 16-bit lanes) */
+        l0 = _mm_packus_epi16(SSE2_LUMA(top[0], uyvy), SSE2_LUMA(top[1], uyvy));
+        l1 = _mm_packus_epi16(SSE2_LUMA(top[2], uyvy), SSE2_LUMA(top[3], uyvy));
+        l0 = _mm_and_si128(_mm_avg_epu8(l0, _mm_srli_epi16(l0, 8)), mask);
+        l1 = _mm_and_si128(_mm_avg_epu8(l1, _mm_srli_epi16(l1, 8)), mask);
+        _mm_storeu_si128((__m128i *)(y0 + x), _mm_packus_epi16(l0, l1));
+
+        l0 = _mm_packus_epi16(SSE2_LUMA(bottom[0], uyvy), SSE2_LUMA(bottom[1], uyvy));
+        l1 = _mm_packus_epi16(SSE2_LUMA(bottom[2], uyvy), SSE2_LUMA(bottom[3], uyvy));
+        l0 = _mm_and_si128(_mm_avg_epu8(l0, _mm_srli_epi16(l0, 8)), mask);
+        l1 = _mm_and_si128(_mm_avg_epu8(l1, _mm_srli_epi16(l1, 8)), mask);
+        _mm_storeu_si128((__m128i *)(y1 + x), _mm_packus_epi16(l0, l1));
+
+        /* Chroma: 16 UV pairs of the 4 rows, then pairs of UV pairs averaged (low half
+         * of 32-bit lanes, sign-extended so that the signed pack keeps it as it is) */
+        c0 = _mm_packus_epi16(SSE2_CHROMA(_mm_avg_epu8(top[0], bottom[0]), uyvy),
+                              SSE2_CHROMA(_mm_avg_epu8(top[1], bottom[1]), uyvy));
+        c1 = _mm_packus_epi16(SSE2_CHROMA(_mm_avg_epu8(top[2], bottom[2]), uyvy),
+                              SSE2_CHROMA(_mm_avg_epu8(top[3], bottom[3]), uyvy));
+        c0 = _mm_avg_epu8(c0, _mm_srli_epi32(c0, 16));
+        c1 = _mm_avg_epu8(c1, _mm_srli_epi32(c1, 16));
+        c0 = _mm_srai_epi32(_mm_slli_epi32(c0, 16), 16);
+        c1 = _mm_srai_epi32(_mm_slli_epi32(c1, 16), 16);
+        _mm_storeu_si128((__m128i *)(uv + x), _mm_packs_epi32(c0, c1));
+    }
+
+    scale_half_rows_scalar(r0 + 4 * x, r1 + 4 * x, r2 + 4 * x, r3 + 4 * x,
+                           y0 + x, y1 + x, uv + x, width - x, uyvy);
+}
+
+__attribute__((target("avx2")))
+void scale_copy_rows_avx2(const guint8 *r0, const guint8 *r1, guint8 *y0, guint8 *y1,
+                          guint8 *uv, const gint width, const gboolean uyvy)
+{
+    __m256i a0, a1, b0, b1;
+    gint x = 0;
+
+    for (x = 0; x + 32 <= width; x += 32)
+    {
+        a0 = _mm256_loadu_si256((const __m256i *)(r0 + 2 * x));
+        a1 = _mm256_loadu_si256((const __m256i *)(r0 + 2 * x + 32));
+        b0 = _mm256_loadu_si256((const __m256i *)(r1 + 2 * x));
+        b1 = _mm256_loadu_si256((const __m256i *)(r1 + 2 * x + 32));
+
+        _mm256_storeu_si256((__m256i *)(y0 + x),
+                            AVX2_PACK_ORDER(_mm256_packus_epi16(AVX2_LUMA(a0, uyvy), AVX2_LUMA(a1, uyvy))));
+        _mm256_storeu_si256((__m256i *)(y1 + x),
+                            AVX2_PACK_ORDER(_mm256_packus_epi16(AVX2_LUMA(b0, uyvy), AVX2_LUMA(b1, uyvy))));
+
+        a0 = _mm256_avg_epu8(a0, b0);
+        a1 = _mm256_avg_epu8(a1, b1);
+
+        _mm256_storeu_si256((__m256i *)(uv + x),
+                            AVX2_PACK_ORDER(_mm256_packus_epi16(AVX2_CHROMA(a0, uyvy), AVX2_CHROMA(a1, uyvy))));
+    }
+
+    scale_copy_rows_scalar(r0 + 2 * x, r1 + 2 * x, y0 + x, y1 + x, uv + x, width - x, uyvy);
+}
+
+__attribute__((target("avx2")))
+void scale_half_rows_avx2(const guint8 *r0, const guint8 *r1, const guint8 *r2,
+                          const guint8 *r3, guint8 *y0, guint8 *y1, guint8 *uv,
+                          const gint width, const gboolean uyvy)
+{
+    const __m256i mask = _mm256_set1_epi16(0x00FF);
+    __m256i top[4], bottom[4];
+    __m256i l0, l1, c0, c1;
+    gint x = 0;
+    gint index = 0;
+
+    /* Same steps as "scale_half_rows_sse2()", packs are followed by AVX2_PACK_ORDER */
+    for (x = 0; x + 32 <= width; x += 32)
+    {
+        for (index = 0; index < 4; index++)
+        {
+            top[index] = _mm256_avg_epu8(_mm256_loadu_si256((const __m256i *)(r0 + 4 * x + 32 * index)),
+                                         _mm256_loadu_si256((const __m256i *)(r1 + 4 * x + 32 * index)));
+            bottom[index] = _mm256_avg_epu8(_mm256_loadu_si256((const __m256i *)(r2 + 4 * x + 32 * index)),
+                                            _mm256_loadu_si256((const __m256i *)(r3 + 4 * x + 32 * index)));
+        }
+
+        l0 = AVX2_PACK_ORDER(_mm256_packus_epi16(AVX2_LUMA(top[0], uyvy), AVX2_LUMA(top[1], uyvy)));
+        l1 = AVX2_PACK_ORDER(_mm256_packus_epi16(AVX2_LUMA(top[2], uyvy), AVX2_LUMA(top[3], uyvy)));
+        l0 = _mm256_and_si256(_mm256_avg_epu8(l0, _mm256_srli_epi16(l0, 8)), mask);
+        l1 = _mm256_and_si256(_mm256_avg_epu8(l1, _mm256_srli_epi16(l1, 8)), mask);
+        _mm256_storeu_si256((__m256i *)(y0 + x), AVX2_PACK_ORDER(_mm256_packus_epi16(l0, l1)));
+
+        l0 = AVX2_PACK_ORDER(_mm256_packus_epi16(AVX2_LUMA(bottom[0], uyvy), AVX2_LUMA(bottom[1], uyvy)));
+        l1 = AVX2_PACK_ORDER(_mm256_packus_epi16(AVX2_LUMA(bottom[2], uyvy), AVX2_LUMA(bottom[3], uyvy)));
+        l0 = _mm256_and_si256(_mm256_avg_epu8(l0, _mm256_srli_epi16(l0, 8)), mask);
+        l1 = _mm256_and_si256(_mm256_avg_epu8(l1, _mm256_srli_epi16(l1, 8)), mask);
+        _mm256_storeu_si256((__m256i *)(y1 + x), AVX2_PACK_ORDER(_mm256_packus_epi16(l0, l1)));
+
+        c0 = AVX2_PACK_ORDER(_mm256_packus_epi16(AVX2_CHROMA(_mm256_avg_epu8(top[0], bottom[0]), uyvy),
+                                                 AVX2_CHROMA(_mm256_avg_epu8(top[1], bottom[1]), uyvy)));
+        c1 = AVX2_PACK_ORDER(_mm256_packus_epi16(AVX2_CHROMA(_mm256_avg_epu8(top[2], bottom[2]), uyvy),
+                                                 AVX2_CHROMA(_mm256_avg_epu8(top[3], bottom[3]), uyvy)));
+        c0 = _mm256_avg_epu8(c0, _mm256_srli_epi32(c0, 16));
+        c1 = _mm256_avg_epu8(c1, _mm256_srli_epi32(c1, 16));
+        c0 = _mm256_srai_epi32(_mm256_slli_epi32(c0, 16), 16);
+        c1 = _mm256_srai_epi32(_mm256_slli_epi32(c1, 16), 16);
+        _mm256_storeu_si256((__m256i *)(uv + x), AVX2_PACK_ORDER(_mm256_packs_epi32(c0, c1)));
+    }
+
+    scale_half_rows_scalar(r0 + 4 * x, r1 + 4 * x, r2 + 4 * x, r3 + 4 * x,
+                           y0 + x, y1 + x, uv + x, width - x, uyvy);
+}
+#endif
+
+#ifdef SCALE_NEON
+void scale_copy_rows_neon(const guint8 *r0, const guint8 *r1, guint8 *y0, guint8 *y1,
+                          guint8 *uv, const gint width, const gboolean uyvy)
+{
+    const gint luma = (uyvy) ? 1 : 0;
+    const gint chroma = 1 - luma;
+    uint8x16x4_t a, b;
+    uint8x16x2_t out;
+    gint x = 0;
+
+    for (x = 0; x + 32 <= width; x += 32)
+    {
+        a = vld4q_u8(r0 + 2 * x);
+        b = vld4q_u8(r1 + 2 * x);
+
+        out.val[0] = a.val[luma];
+        out.val[1] = a.val[luma + 2];
+        vst2q_u8(y0 + x, out);
+
+        out.val[0] = b.val[luma];
+        out.val[1] = b.val[luma + 2];
+        vst2q_u8(y1 + x, out);
+
+        out.val[0] = vrhaddq_u8(a.val[chroma], b.val[chroma]);
+        out.val[1] = vrhaddq_u8(a.val[chroma + 2], b.val[chroma + 2]);
+        vst2q_u8(uv + x, out);
+    }
+
+    scale_copy_rows_scalar(r0 + 2 * x, r1 + 2 * x, y0 + x, y1 + x, uv + x, width - x, uyvy);
+}
+
+void scale_half_rows_neon(const guint8 *r0, const guint8 *r1, const guint8 *r2,
+                          const guint8 *r3, guint8 *y0, guint8 *y1, guint8 *uv,
+                          const gint width, const gboolean uyvy)
+{
+    const gint luma = (uyvy) ? 1 : 0;
+    const gint chroma = 1 - luma;
+    uint8x16x4_t a, b, c, d;
+    uint8x16_t top[4], bottom[4];
+    uint8x16x2_t u, v;
+    uint8x8x2_t out;
+    gint x = 0;
+    gint index = 0;
+
+    for (x = 0; x + 16 <= width; x += 16)
+    {
+        a = vld4q_u8(r0 + 4 * x);
+        b = vld4q_u8(r1 + 4 * x);
+        c = vld4q_u8(r2 + 4 * x);
+        d = vld4q_u8(r3 + 4 * x);
+
+        for (index = 0; index < 4; index++)
+        {
+            top[index] = vrhaddq_u8(a.val[index], b.val[index]);
+            bottom[index] = vrhaddq_u8(c.val[index], d.val[index]);
+        }
+
+        /* Luma: Y0 and Y1 of each pixel pair averaged */
+        vst1q_u8(y0 + x, vrhaddq_u8(top[luma], top[luma + 2]));
+        vst1q_u8(y1 + x, vrhaddq_u8(bottom[luma], bottom[luma + 2]));
+
+        /* Chroma: 16 U and V of the 4 rows, then even and odd ones averaged */
+        u = vuzpq_u8(vrhaddq_u8(top[chroma], bottom[chroma]), vrhaddq_u8(top[chroma], bottom[chroma]));
+        v = vuzpq_u8(vrhaddq_u8(top[chroma + 2], bottom[chroma + 2]),
+                     vrhaddq_u8(top[chroma + 2], bottom[chroma + 2]));
+
+        out.val[0] = vrhadd_u8(vget_low_u8(u.val[0]), vget_low_u8(u.val[1]));
+        out.val[1] = vrhadd_u8(vget_low_u8(v.val[0]), vget_low_u8(v.val[1]));
+        vst2_u8(uv + x, out);
+    }
+
+    scale_half_rows_scalar(r0 + 4 * x, r1 + 4 * x, r2 + 4 * x, r3 + 4 * x,
+                           y0 + x, y1 + x, uv + x, width - x, uyvy);
+}
+#endif
+
+void scale_process_bilinear(const struct scale_t *scale, const guint8 *src, const gint src_stride,
+                            guint8 *dst_y, const gint y_stride, guint8 *dst_uv, const gint uv_stride)
+{
+    struct scale_tap_t row;
+    const struct scale_tap_t *tap = NULL;
+    const guint8 *r0 = NULL;
+    const guint8 *r1 = NULL;
+    guint8 top = 0;
+    guint8 bottom = 0;
+    guint8 *out = NULL;
+    gint x = 0;
+    gint y = 0;
+
+    for (y = 0; y < scale->dst_height; y++)
+    {
+        scale_get_tap(y, scale->src_height, scale->dst_height, &row);
+
+        r0 = src + row.offset0 * src_stride;
+        r1 = src + row.offset1 * src_stride;
+        out = dst_y + y * y_stride;
+
+        for (x = 0; x < scale->dst_width; x++)
+        {
+            tap = &scale->luma_x[x];
+
+            top = SCALE_LERP(r0[tap->offset0], r0[tap->offset1], tap->weight);
+            bottom = SCALE_LERP(r1[tap->offset0], r1[tap->offset1], tap->weight);
+            out[x] = SCALE_LERP(top, bottom, row.weight);
+        }
+    }
+
+    /* Input chroma has all rows (4:2:2), output chroma has half of them (4:2:0) */
+    for (y = 0; y < scale->dst_height / 2; y++)
+    {
+        scale_get_tap(y, scale->src_height, scale->dst_height / 2, &row);
+
+        r0 = src + row.offset0 * src_stride;
+        r1 = src + row.offset1 * src_stride;
+        out = dst_uv + y * uv_stride;
+
+        for (x = 0; x < scale->dst_width / 2; x++)
+        {
+            tap = &scale->chroma_x[x];
+
+            /* U, then V two bytes further */
+            top = SCALE_LERP(r0[tap->offset0], r0[tap->offset1], tap->weight);
+            bottom = SCALE_LERP(r1[tap->offset0], r1[tap->offset1], tap->weight);
+            out[2 * x] = SCALE_LERP(top, bottom, row.weight);
+
+            top = SCALE_LERP(r0[tap->offset0 + 2], r0[tap->offset1 + 2], tap->weight);
+            bottom = SCALE_LERP(r1[tap->offset0 + 2], r1[tap->offset1 + 2], tap->weight);
+            out[2 * x + 1] = SCALE_LERP(top, bottom, row.weight);
+        }
+    }
+}
+
+/* ---------- Public functions ---------- */
+
+struct scale_t *scale_create(const enum scale_format_t format, const enum scale_isa_t isa,
+                             const gint src_width, const gint src_height,
+                             const gint dst_width, const gint dst_height, GError **error)
+{
+    struct scale_t *scale = NULL;
+    enum scale_isa_t kernel_isa = isa;
+    const gchar *ratio = NULL;
+    gint index = 0;
+
+    /* Check parameter(s) */
+    g_return_val_if_fail((format < SCALE_FORMAT_UNKNOWN) && (isa < SCALE_ISA_UNKNOWN), NULL);
+
+    if ((src_width <= 0) || (src_height <= 0) || (dst_width <= 0) || (dst_height <= 0) ||
+        ((src_width | src_height | dst_width | dst_height) & 1))
+    {
+        g_set_error(error, SCALE_ERROR, EINVAL, "Sizes must be even: %dx%d to %dx%d",
+                    src_width, src_height, dst_width, dst_height);
+        return NULL;
+    }
+
+    if (kernel_isa == SCALE_ISA_AUTO)
+    {
+        kernel_isa = (scale_has_isa(SCALE_ISA_AVX2)) ? SCALE_ISA_AVX2 :
+                     (scale_has_isa(SCALE_ISA_SSE2)) ? SCALE_ISA_SSE2 :
+                     (scale_has_isa(SCALE_ISA_NEON)) ? SCALE_ISA_NEON : SCALE_ISA_SCALAR;
+    }
+    else if (!scale_has_isa(kernel_isa))
+    {
+        g_set_error(error, SCALE_ERROR, ENOTSUP, "%s is not supported by this CPU",
+                    scale_isa_to_string(kernel_isa));
+        return NULL;
+    }
+
+    scale = g_new0(struct scale_t, 1);
+
+    scale->format = format;
+    scale->src_width = src_width;
+    scale->src_height = src_height;
+    scale->dst_width = dst_width;
+    scale->dst_height = dst_height;
+
+    scale->luma_offset = (format == SCALE_FORMAT_UYVY) ? 1 : 0;
+    scale->chroma_offset = 1 - scale->luma_offset;
+
+    if ((dst_width == src_width) && (dst_height == src_height))
+    {
+        scale->ratio = SCALE_RATIO_COPY;
+        ratio = "1:1";
+    }
+    else if ((dst_width * 2 == src_width) && (dst_height * 2 == src_height))
+    {
+        scale->ratio = SCALE_RATIO_HALF;
+        ratio = "2:1";
+    }
+    else
+    {
+        /* There is no SIMD bilinear kernel */
+        scale->ratio = SCALE_RATIO_BILINEAR;
+        ratio = "bilinear";
+        kernel_isa = SCALE_ISA_SCALAR;
+
+        scale->luma_x = g_new(struct scale_tap_t, dst_width);
+        scale->chroma_x = g_new(struct scale_tap_t, dst_width / 2);
+
+        /* Byte positions in input rows: Y every 2 bytes, U every 4 bytes */
+        for (index = 0; index < dst_width; index++)
+        {
+            scale_get_tap(index, src_width, dst_width, &scale->luma_x[index]);
+
+            scale->luma_x[index].offset0 = 2 * scale->luma_x[index].offset0 + scale->luma_offset;
+            scale->luma_x[index].offset1 = 2 * scale->luma_x[index].offset1 + scale->luma_offset;
+        }
+
+        for (index = 0; index < dst_width / 2; index++)
+        {
+            scale_get_tap(index, src_width / 2, dst_width / 2, &scale->chroma_x[index]);
+
+            scale->chroma_x[index].offset0 = 4 * scale->chroma_x[index].offset0 + scale->chroma_offset;
+            scale->chroma_x[index].offset1 = 4 * scale->chroma_x[index].offset1 + scale->chroma_offset;
+        }
+    }
+
+    switch (kernel_isa)
+    {
+#ifdef SCALE_X86
+        case SCALE_ISA_SSE2:
+            scale->copy_rows = scale_copy_rows_sse2;
+            scale->half_rows = scale_half_rows_sse2;
+        break;
+
+        case SCALE_ISA_AVX2:
+            scale->copy_rows = scale_copy_rows_avx2;
+            scale->half_rows = scale_half_rows_avx2;
+        break;
+#endif
+
+#ifdef SCALE_NEON
+        case SCALE_ISA_NEON:
+            scale->copy_rows = scale_copy_rows_neon;
+            scale->half_rows = scale_half_rows_neon;
+        break;
+#endif
+
+        default:
+            kernel_isa = SCALE_ISA_SCALAR;
+            scale->copy_rows = scale_copy_rows_scalar;
+            scale->half_rows = scale_half_rows_scalar;
+        break;
+    }
+
+    scale->isa = kernel_isa;
+
+    g_snprintf(scale->kernel, sizeof(scale->kernel), "%s, %s", ratio, scale_isa_to_string(kernel_isa));
+
+    return scale;
+}
+
+void scale_process(const struct scale_t *scale, const guint8 *src, const gint src_stride,
+                   guint8 *dst_y, const gint y_stride, guint8 *dst_uv, const gint uv_stride)
+{
+    const gboolean uyvy = (scale->format == SCALE_FORMAT_UYVY);
+    gint y = 0;
+
+    switch (scale->ratio)
+    {
+        case SCALE_RATIO_COPY:
+            for (y = 0; y < scale->dst_height; y += 2)
+            {
+                scale->copy_rows(src + y * src_stride, src + (y + 1) * src_stride,
+                                 dst_y + y * y_stride, dst_y + (y + 1) * y_stride,
+                                 dst_uv + (y / 2) * uv_stride, scale->dst_width, uyvy);
+            }
+        break;
+
+        case SCALE_RATIO_HALF:
+            for (y = 0; y < scale->dst_height; y += 2)
+            {
+                scale->half_rows(src + (2 * y) * src_stride, src + (2 * y + 1) * src_stride,
+                                 src + (2 * y + 2) * src_stride, src + (2 * y + 3) * src_stride,
+                                 dst_y + y * y_stride, dst_y + (y + 1) * y_stride,
+                                 dst_uv + (y / 2) * uv_stride, scale->dst_width, uyvy);
+            }
+        break;
+
+        default:
+            scale_process_bilinear(scale, src, src_stride, dst_y, y_stride, dst_uv, uv_stride);
+        break;
+    }
+}
+
+const gchar *scale_get_kernel(const struct scale_t *scale)
+{
+    /* Check parameter(s) */
+    g_return_val_if_fail(scale != NULL, NULL);
+
+    return scale->kernel;
+}
+
+enum scale_isa_t scale_get_isa(const struct scale_t *scale)
+{
+    /* Check parameter(s) */
+    g_return_val_if_fail(scale != NULL, SCALE_ISA_UNKNOWN);
+
+    return scale->isa;
+}
+
+gboolean scale_has_isa(const enum scale_isa_t isa)
+{
+    gboolean result = FALSE;
+
+    switch (isa)
+    {
+        case SCALE_ISA_AUTO:
+        case SCALE_ISA_SCALAR:
+            result = TRUE;
+        break;
+
+#ifdef SCALE_X86
+        case SCALE_ISA_SSE2:
+            result = __builtin_cpu_supports("sse2");
+        break;
+
+        case SCALE_ISA_AVX2:
+            result = __builtin_cpu_supports("avx2");
+        break;
+#endif
+
+#ifdef SCALE_NEON
+        case SCALE_ISA_NEON:
+            result = TRUE;
+        break;
+#endif
+
+        default:
+            result = FALSE;
+        break;
+    }
+
+    return result;
+}
+
+const gchar *scale_format_to_string(const enum scale_format_t format)
+{
+    const gchar* result = "";
+
+    switch (format)
+    {
+        case SCALE_FORMAT_YUY2:
+            result = "YUY2";
+        break;
+
+        case SCALE_FORMAT_UYVY:
+            result = "UYVY";
+        break;
+
+        default:
+            result = "unknown";
+        break;
+    }
+
+    return result;
+}
+
+enum scale_format_t scale_format_from_string(const gchar *format)
+{
+    enum scale_format_t result = SCALE_FORMAT_UNKNOWN;
+
+    if (g_strcmp0(format, "YUY2") == 0)
+    {
+        result = SCALE_FORMAT_YUY2;
+    }
+    else if (g_strcmp0(format, "UYVY") == 0)
+    {
+        result = SCALE_FORMAT_UYVY;
+    }
+
+    return result;
+}
+
+const gchar *scale_isa_to_string(const enum scale_isa_t isa)
+{
+    const gchar* result = "";
+
+    switch (isa)
+    {
+        case SCALE_ISA_AUTO:
+            result = "auto";
+        break;
+
+        case SCALE_ISA_SCALAR:
+            result = "scalar";
+        break;
+
+        case SCALE_ISA_SSE2:
+            result = "SSE2";
+        break;
+
+        case SCALE_ISA_AVX2:
+            result = "AVX2";
+        break;
+
+        case SCALE_ISA_NEON:
+            result = "NEON";
+        break;
+
+        default:
+            result = "unknown";
+        break;
+    }
+
+    return result;
+}
+
+void scale_free(struct scale_t *scale)
+{
+    if (scale != NULL)
+    {
+        g_free(scale->luma_x);
+        g_free(scale->chroma_x);
+        g_free(scale);
+    }
+}
@@ -0,0 +1,188 @@
+/***********************************************************************
+ * FILENAME: scale.h
+ *
+ * DESCRIPTION:
+ *   Contains APIs to convert packed YUV 4:2:2 frames (YUY2, UYVY) to
+ *   NV12, with scaling, on hosts without VSP.
+ *
+ *   Output sizes of camera pipelines are the capture size (1:1) or half
+ *   of it (2:1, substreams): these two ratios have SIMD kernels (SSE2 and
+ *   AVX2 on x86, NEON on Arm), which give the same output as the scalar
+ *   reference. Other ratios are scaled by a bilinear scalar kernel.
+ *
+ * PUBLIC FUNCTIONS:
+ *   struct scale_t *scale_create(const enum scale_format_t format, const enum scale_isa_t isa,
+ *                                const gint src_width, const gint src_height,
+ *                                const gint dst_width, const gint dst_height, GError **error);
+ *
+ *   void scale_process(const struct scale_t *scale, const guint8 *src, const gint src_stride,
+ *                      guint8 *dst_y, const gint y_stride, guint8 *dst_uv, const gint uv_stride);
+ *
+ *   const gchar *scale_get_kernel(const struct scale_t *scale);
+ *
+ *   enum scale_isa_t scale_get_isa(const struct scale_t *scale);
+ *
+ *   gboolean scale_has_isa(const enum scale_isa_t isa);
+ *
+ *   const gchar *scale_format_to_string(const enum scale_format_t format);
+ *
+ *   enum scale_format_t scale_format_from_string(const gchar *format);
+ *
+ *   const gchar *scale_isa_to_string(const enum scale_isa_t isa);
+ *
+ *   void scale_free(struct scale_t *scale);
+ *
+ * AUTHOR: RVC       START DATE: 17/10/2026
+ *
+ * CHANGES:
+ *
+ ***********************************************************************/
+
+#ifndef _SCALE_H_
+#define _SCALE_H_
+
+/* ---------- Datatypes ---------- */
+
+/*
+ * Enum: scale_format_t
+ * ---
+ *   Represents the format of input frames (one plane, 2 bytes per pixel):
+ *     - SCALE_FORMAT_YUY2: Y0 U Y1 V (USB cameras).
+ *     - SCALE_FORMAT_UYVY: U Y0 V Y1 (MIPI camera).
+ */
+enum scale_format_t
+{
+    SCALE_FORMAT_YUY2,
+    SCALE_FORMAT_UYVY,
+    SCALE_FORMAT_UNKNOWN
+};
+
+/*
+ * Enum: scale_isa_t
+ * ---
+ *   Represents the instruction set of kernels:
+ *     - SCALE_ISA_AUTO: The best one of the CPU.
+ *     - SCALE_ISA_SCALAR: Plain C (reference).
+ *     - SCALE_ISA_SSE2, SCALE_ISA_AVX2: x86 (AVX2 is detected at run time).
+ *     - SCALE_ISA_NEON: Arm.
+ */
+enum scale_isa_t
+{
+    SCALE_ISA_AUTO,
+    SCALE_ISA_SCALAR,
+    SCALE_ISA_SSE2,
+    SCALE_ISA_AVX2,
+    SCALE_ISA_NEON,
+    SCALE_ISA_UNKNOWN
+};
+
+/*
+ * Struct: scale_t
+ * ---
+ *   Represents a conversion:
+ *     - format (enum scale_format_t): Format of input frames.
+ *     - isa (enum scale_isa_t): Instruction set of the kernel (never SCALE_ISA_AUTO).
+ *     - ratio (enum scale_ratio_t): 1:1, 2:1 or any other ratio (bilinear).
+ *     - src_width, src_height, dst_width, dst_height (gint): Frame sizes (pixels).
+ *     - luma_offset, chroma_offset (gint): Position of the first Y and U byte of a pixel pair.
+ *     - copy_rows, half_rows (functions): Kernels of 1:1 and 2:1 ratios.
+ *     - luma_x, chroma_x (arrays of "scale_tap_t"): Horizontal taps of the bilinear kernel.
+ *     - kernel (string): Description of the kernel (such as: "2:1, AVX2").
+ */
+struct scale_t;
+
+/* ---------- Functions ---------- */
+
+/*
+ * Function: scale_create
+ * ---
+ *   Prepares the conversion of "format" frames of "src_width"x"src_height" to NV12
+ *   frames of "dst_width"x"dst_height". Sizes must be even.
+ *
+ *   isa: Instruction set of the kernel (SCALE_ISA_AUTO: the best one of the CPU).
+ *   error: Error (output), such as: odd size, instruction set not supported by the CPU.
+ *
+ *   return: NULL (the conversion is not supported, "error" is set).
+ *           not NULL (the conversion, see "scale_free()").
+ */
+struct scale_t *scale_create(const enum scale_format_t format, const enum scale_isa_t isa,
+                             const gint src_width, const gint src_height,
+                             const gint dst_width, const gint dst_height, GError **error);
+
+/*
+ * Function: scale_process
+ * ---
+ *   Converts frame "src" to NV12 planes "dst_y" and "dst_uv". Strides are in bytes,
+ *   planes need no alignment.
+ *
+ *   return: void.
+ */
+void scale_process(const struct scale_t *scale, const guint8 *src, const gint src_stride,
+                   guint8 *dst_y, const gint y_stride, guint8 *dst_uv, const gint uv_stride);
+
+/*
+ * Function: scale_get_kernel
+ * ---
+ *   Get the description of the kernel of "scale".
+ *
+ *   Note: The output string must not be de-allocated or modified.
+ *
+ *   return: String (such as: "1:1, NEON", "bilinear, scalar").
+ */
+const gchar *scale_get_kernel(const struct scale_t *scale);
+
+/*
+ * Function: scale_get_isa
+ * ---
+ *   Get the instruction set of the kernel of "scale" (SCALE_ISA_SCALAR for the bilinear kernel).
+ *
+ *   return: The instruction set (never SCALE_ISA_AUTO).
+ */
+enum scale_isa_t scale_get_isa(const struct scale_t *scale);
+
+/*
+ * Function: scale_has_isa
+ * ---
+ *   Check if kernels of instruction set "isa" can run on this CPU.
+ *
+ *   return: TRUE (supported), FALSE (not built for this architecture, or not supported by the CPU).
+ */
+gboolean scale_has_isa(const enum scale_isa_t isa);
+
+/*
+ * Function: scale_format_to_string
+ * ---
+ *   Get the GStreamer name of "format".
+ *
+ *   return: String (such as: "YUY2", "UYVY", "unknown").
+ */
+const gchar *scale_format_to_string(const enum scale_format_t format);
+
+/*
+ * Function: scale_format_from_string
+ * ---
+ *   Get the format of GStreamer name "format" (NULL is allowed).
+ *
+ *   return: The format (SCALE_FORMAT_UNKNOWN: the format cannot be converted).
+ */
+enum scale_format_t scale_format_from_string(const gchar *format);
+
+/*
+ * Function: scale_isa_to_string
+ * ---
+ *   Get the name of "isa".
+ *
+ *   return: String (such as: "auto", "scalar", "SSE2", "AVX2", "NEON", "unknown").
+ */
+const gchar *scale_isa_to_string(const enum scale_isa_t isa);
+
+/*
+ * Function: scale_free
+ * ---
+ *   Frees "scale".
+ *
+ *   return: void.
+ */
+void scale_free(struct scale_t *scale);
+
+#endif
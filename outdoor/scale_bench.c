@@ -0,0 +1,233 @@
+/***********************************************************************
+ * FILENAME: scale_bench.c
+ *
+ * DESCRIPTION:
+ *   Microbenchmark of the YUY2/UYVY to NV12 kernels of "scale.h".
+ *
+ *   Each conversion of camera pipelines is run with every instruction
+ *   set of the CPU. The output of SIMD kernels is compared with the one
+ *   of the scalar reference.
+ *
+ * AUTHOR: RVC       START DATE: 17/10/2026
+ *
+ * CHANGES:
+ *
+ ***********************************************************************/
+
+/* ---------- Header files ---------- */
+#include <glib.h>
+#include <glib/gprintf.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "scale.h"
+
+/* ---------- Macros ---------- */
+
+/* Frames converted by default for each kernel, after warm-up frames */
+#define BENCH_DEFAULT_ITERATIONS 200
+#define BENCH_WARMUP_ITERATIONS 10
+
+/* Padding at the end of rows (strides are not multiples of the width, as with V4L2 buffers) */
+#define BENCH_ROW_PADDING 64
+
+/* ---------- Datatypes ---------- */
+
+/*
+ * Struct: bench_case_t
+ * ---
+ *   Represents a conversion of camera pipelines:
+ *     - format (enum scale_format_t): Capture format.
+ *     - src_width, src_height (gint): Capture size.
+ *     - dst_width, dst_height (gint): Output size.
+ */
+struct bench_case_t
+{
+    enum scale_format_t format;
+
+    gint src_width;
+    gint src_height;
+
+    gint dst_width;
+    gint dst_height;
+};
+
+/* Conversions: main streams and substreams of USB (YUY2) and MIPI (UYVY) cameras */
+const struct bench_case_t bench_cases[] = {
+    { SCALE_FORMAT_YUY2, 1280, 720, 1280, 720 },
+    { SCALE_FORMAT_YUY2, 1280, 720, 640, 360 },
+    { SCALE_FORMAT_YUY2, 800, 600, 1280, 720 },
+    { SCALE_FORMAT_YUY2, 800, 600, 400, 300 },
+    { SCALE_FORMAT_UYVY, 1280, 960, 1280, 960 },
+    { SCALE_FORMAT_UYVY, 1280, 960, 640, 480 },
+    { SCALE_FORMAT_UYVY, 1280, 960, 800, 600 },
+};
+
+/* Instruction sets to measure, the reference first */
+const enum scale_isa_t bench_isas[] = {
+    SCALE_ISA_SCALAR,
+    SCALE_ISA_SSE2,
+    SCALE_ISA_AVX2,
+    SCALE_ISA_NEON,
+};
+
+/*
+ * Function: bench_run
+ * ---
+ *   Converts "src" to "y" and "uv" "iterations" times with "scale".
+ *
+ *   return: Average time of a frame (ms).
+ */
+static gdouble bench_run(const struct scale_t *scale, const guint8 *src, const gint src_stride,
+                         guint8 *y, const gint y_stride, guint8 *uv, const gint uv_stride,
+                         const gint iterations)
+{
+    gint64 start = 0;
+    gint index = 0;
+
+    for (index = 0; index < BENCH_WARMUP_ITERATIONS; index++)
+    {
+        scale_process(scale, src, src_stride, y, y_stride, uv, uv_stride);
+    }
+
+    start = g_get_monotonic_time();
+
+    for (index = 0; index < iterations; index++)
+    {
+        scale_process(scale, src, src_stride, y, y_stride, uv, uv_stride);
+    }
+
+    return (gdouble)(g_get_monotonic_time() - start) / 1000.0 / iterations;
+}
+
+/*
+ * Function: main
+ * ---
+ *   Usage: scale_bench [iterations]
+ *
+ *   returns: 0 (SIMD kernels match the reference), 1 (mismatch).
+ */
+int main(int argc, char *argv[])
+{
+    const struct bench_case_t *bench = NULL;
+    struct scale_t *scale = NULL;
+    GError *error = NULL;
+    GRand *rand = NULL;
+    gchar conversion[64];
+
+    guint8 *src = NULL;
+    guint8 *reference = NULL;
+    guint8 *output = NULL;
+    gint src_stride = 0;
+    gint y_stride = 0;
+    gsize src_size = 0;
+    gsize dst_size = 0;
+
+    gdouble reference_time = 0;
+    gdouble time = 0;
+    gboolean match = TRUE;
+    gint iterations = BENCH_DEFAULT_ITERATIONS;
+    gint result = 0;
+    guint index = 0;
+    guint isa = 0;
+    gsize offset = 0;
+
+    if (argc > 1)
+    {
+        iterations = MAX(1, atoi(argv[1]));
+    }
+
+    /* Same input for every run */
+    rand = g_rand_new_with_seed(2026);
+
+    g_print("%d frames per kernel\n", iterations);
+    g_print("%-28s %-16s %10s %10s %8s %s\n", "Conversion", "Kernel", "ms/frame", "Mpx/s", "Speedup", "Output");
+
+    for (index = 0; index < G_N_ELEMENTS(bench_cases); index++)
+    {
+        bench = &bench_cases[index];
+
+        src_stride = bench->src_width * 2 + BENCH_ROW_PADDING;
+        y_stride = bench->dst_width + BENCH_ROW_PADDING;
+        src_size = (gsize)src_stride * bench->src_height;
+
+        /* Y plane then UV plane, with the same stride */
+        dst_size = (gsize)y_stride * (bench->dst_height + bench->dst_height / 2);
+
+        src = g_malloc(src_size);
+        reference = g_malloc0(dst_size);
+        output = g_malloc0(dst_size);
+
+        for (offset = 0; offset < src_size; offset++)
+        {
+            src[offset] = (guint8)g_rand_int(rand);
+        }
+
+        g_snprintf(conversion, sizeof(conversion), "%s %dx%d -> %dx%d",
+                   scale_format_to_string(bench->format), bench->src_width, bench->src_height,
+                   bench->dst_width, bench->dst_height);
+
+        for (isa = 0; isa < G_N_ELEMENTS(bench_isas); isa++)
+        {
+            if (!scale_has_isa(bench_isas[isa]))
+            {
+                continue;
+            }
+
+            scale = scale_create(bench->format, bench_isas[isa], bench->src_width, bench->src_height,
+                                 bench->dst_width, bench->dst_height, &error);
+
+            if (scale == NULL)
+            {
+                g_print("%-28s %-16s failed: %s\n", conversion, scale_isa_to_string(bench_isas[isa]),
+                        error->message);
+                g_clear_error(&error);
+                result = 1;
+                continue;
+            }
+
+            /* Ratios without SIMD kernel are measured once */
+            if (scale_get_isa(scale) != bench_isas[isa])
+            {
+                scale_free(scale);
+                continue;
+            }
+
+            if (bench_isas[isa] == SCALE_ISA_SCALAR)
+            {
+                reference_time = bench_run(scale, src, src_stride, reference, y_stride,
+                                           reference + (gsize)y_stride * bench->dst_height, y_stride,
+                                           iterations);
+                time = reference_time;
+                match = TRUE;
+            }
+            else
+            {
+                memset(output, 0, dst_size);
+                time = bench_run(scale, src, src_stride, output, y_stride,
+                                 output + (gsize)y_stride * bench->dst_height, y_stride, iterations);
+                match = (memcmp(output, reference, dst_size) == 0);
+            }
+
+            g_print("%-28s %-16s %10.3f %10.1f %7.2fx %s\n", conversion, scale_get_kernel(scale), time,
+                    (gdouble)bench->dst_width * bench->dst_height / time / 1000.0,
+                    reference_time / time, (match) ? "ok" : "MISMATCH");
+
+            if (!match)
+            {
+                result = 1;
+            }
+
+            scale_free(scale);
+        }
+
+        g_free(src);
+        g_free(reference);
+        g_free(output);
+    }
+
+    g_rand_free(rand);
+
+    return result;
+}
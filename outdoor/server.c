@@ -0,0 +1,895 @@
+/***********************************************************************
+ * FILENAME: server.c
+ *
+ * DESCRIPTION:
+ *   RTSP server implementations.
+ *
+ * NOTE:
+ *   For more further information about datatypes and function usages,
+ *   please refer to "server.h".
+ *
+ * AUTHOR: RVC       START DATE: 16/10/2026
+ *
+ * CHANGES:
+ *
+ ***********************************************************************/
+
+/* ---------- Header files ---------- */
+
+#include <glib.h>
+#include <glib/gprintf.h>
+#include <string.h>
+
+#include <gst/rtsp-server/rtsp-server.h>
+
+#include "server.h"
+
+/* ---------- Datatypes ---------- */
+
+struct server_t
+{
+    enum server_mode_t mode;
+
+    GArray *servers;
+
+    GArray *ports;
+
+    gint threads;
+
+    gint stream_counts;
+
+    GPtrArray *groups;
+
+    gint retransmission;
+
+    GArray *fecs;
+};
+
+/*
+ * Struct: server_group_t
+ * ---
+ *   Represents multicast groups of mount points:
+ *     - multicast (struct server_multicast_t): Mount point, addresses, ports and TTL.
+ *     - pool (GstRTSPAddressPool): Addresses and ports not used by a stream yet.
+ */
+struct server_group_t
+{
+    struct server_multicast_t multicast;
+
+    GstRTSPAddressPool *pool;
+};
+
+/*
+ * Struct: ServerMulticastMedia
+ * ---
+ *   RTSP media of mount points with multicast transport. The SDP of the media
+ *   advertises its multicast group.
+ */
+typedef struct
+{
+    GstRTSPMedia parent;
+} ServerMulticastMedia;
+
+typedef struct
+{
+    GstRTSPMediaClass parent_class;
+} ServerMulticastMediaClass;
+
+G_DEFINE_TYPE(ServerMulticastMedia, server_multicast_media, GST_TYPE_RTSP_MEDIA);
+
+/* ---------- Private functions ---------- */
+
+/*
+ * Function: server_multicast_media_setup_sdp
+ * ---
+ *   Implementation of "GstRTSPMediaClass::setup_sdp". Replaces the connection of every
+ *   SDP media by the multicast group of its stream (address, TTL and port).
+ *
+ *   return: TRUE (success), FALSE (the SDP cannot be created).
+ */
+static gboolean server_multicast_media_setup_sdp(GstRTSPMedia *media, GstSDPMessage *sdp,
+                                                 GstSDPInfo *info);
+
+/*
+ * Function: server_configure_multicast
+ * ---
+ *   Enables the multicast transport of "factory" if mount point "mount" has a group.
+ */
+static void server_configure_multicast(const struct server_t *server, GstRTSPMediaFactory *factory,
+                                       const gchar *mount);
+
+/*
+ * Function: server_configure_recovery
+ * ---
+ *   Enables retransmissions of "factory" (if "server_t::retransmission" is set), and
+ *   ULPFEC if mount point "mount" has an entry in "server_t::fecs".
+ */
+static void server_configure_recovery(const struct server_t *server, GstRTSPMediaFactory *factory,
+                                      const gchar *mount);
+
+/*
+ * Function: server_on_fec_media_configure
+ * ---
+ *   Callback of "GstRTSPMediaFactory::media-configure" of mount points with ULPFEC.
+ *   Sets the payload type and the percentage ("user_data") of every stream of "media".
+ */
+static void server_on_fec_media_configure(GstRTSPMediaFactory *factory, GstRTSPMedia *media,
+                                          gpointer user_data);
+
+/*
+ * Function: server_parse_range
+ * ---
+ *   Splits "<first>-<last>" (or "<first>") of "str" into "first" and "last".
+ *
+ *   return: TRUE (success), FALSE ("str" is empty, or a part is too long).
+ */
+static gboolean server_parse_range(const gchar *str, gchar *first, gchar *last, const gsize size);
+
+/*
+ * Function: server_is_multicast_address
+ * ---
+ *   Check if "str" is an IPv4 multicast address or not?
+ */
+static gboolean server_is_multicast_address(const gchar *str);
+
+/*
+ * Function: server_free_group
+ * ---
+ *   Frees "server_group_t" object (free function of "server_t::groups").
+ */
+static void server_free_group(gpointer data);
+
+/*
+ * Function: server_new_rtsp_server
+ * ---
+ *   Creates new "GstRTSPServer" object which listens on "port" and
+ *   handles its clients with "server_t::threads" worker threads.
+ *
+ *   return: Pointer to "GstRTSPServer".
+ */
+static GstRTSPServer *server_new_rtsp_server(const struct server_t *server, const gint port);
+
+/*
+ * Function: server_on_client_connected
+ * ---
+ *   Callback of "GstRTSPServer::client-connected". Follows the play requests of "client".
+ */
+static void server_on_client_connected(GstRTSPServer *rtsp_server, GstRTSPClient *client,
+                                       gpointer user_data);
+
+/*
+ * Function: server_on_play_request
+ * ---
+ *   Callback of "GstRTSPClient::play-request". Attaches the client to its media if the
+ *   media is not shared (see SERVER_CLIENT_ADDRESS_KEY and SERVER_CLIENT_KEY).
+ */
+static void server_on_play_request(GstRTSPClient *client, GstRTSPContext *ctx, gpointer user_data);
+
+/*
+ * Function: server_free_weak_ref
+ * ---
+ *   Clears and frees a "GWeakRef" attached to a media.
+ */
+static void server_free_weak_ref(gpointer data);
+
+/*
+ * Function: server_count_session
+ * ---
+ *   Filter of session pools: counts the media of "session" in "user_data"
+ *   (see "server_count_sessions()").
+ *
+ *   return: GST_RTSP_FILTER_KEEP.
+ */
+static GstRTSPFilterResult server_count_session(GstRTSPSessionPool *pool, GstRTSPSession *session,
+                                                gpointer user_data);
+
+/*
+ * Function: server_count_session_media
+ * ---
+ *   Filter of sessions: increments the count of the media of "session_media".
+ *
+ *   return: GST_RTSP_FILTER_KEEP.
+ */
+static GstRTSPFilterResult server_count_session_media(GstRTSPSession *session,
+                                                      GstRTSPSessionMedia *session_media,
+                                                      gpointer user_data);
+
+/* ---------- Private functions ---------- */
+
+void server_multicast_media_class_init(ServerMulticastMediaClass *klass)
+{
+    GST_RTSP_MEDIA_CLASS(klass)->setup_sdp = server_multicast_media_setup_sdp;
+}
+
+void server_multicast_media_init(ServerMulticastMedia *self)
+{
+}
+
+gboolean server_multicast_media_setup_sdp(GstRTSPMedia *media, GstSDPMessage *sdp, GstSDPInfo *info)
+{
+    GstRTSPMediaClass *parent_class = GST_RTSP_MEDIA_CLASS(server_multicast_media_parent_class);
+    GstRTSPStream *stream = NULL;
+    GstRTSPAddress *address = NULL;
+    GstSDPMedia *sdp_media = NULL;
+    guint index = 0;
+
+    if (!parent_class->setup_sdp(media, sdp, info))
+    {
+        return FALSE;
+    }
+
+    /* One SDP media per stream, in order (the groups are IPv4 only) */
+    for (index = 0; (index < gst_rtsp_media_n_streams(media)) && (index < gst_sdp_message_medias_len(sdp)) &&
+                    !info->is_ipv6; index++)
+    {
+        /* The address of the stream is reserved once, and shared by all clients of the media */
+        stream = gst_rtsp_media_get_stream(media, index);
+        address = gst_rtsp_stream_get_multicast_address(stream, G_SOCKET_FAMILY_IPV4);
+
+        if (address == NULL)
+        {
+            continue;
+        }
+
+        sdp_media = (GstSDPMedia*)gst_sdp_message_get_media(sdp, index);
+
+        while (gst_sdp_media_connections_len(sdp_media) > 0)
+        {
+            gst_sdp_media_remove_connection(sdp_media, 0);
+        }
+
+        gst_sdp_media_add_connection(sdp_media, "IN", "IP4", address->address, address->ttl, 1);
+        gst_sdp_media_set_port_info(sdp_media, address->port, 1);
+
+        gst_rtsp_address_free(address);
+    }
+
+    return TRUE;
+}
+
+void server_configure_multicast(const struct server_t *server, GstRTSPMediaFactory *factory,
+                                const gchar *mount)
+{
+    struct server_group_t *group = NULL;
+    guint index = 0;
+
+    for (index = 0; index < server->groups->len; index++)
+    {
+        group = g_ptr_array_index(server->groups, index);
+
+        if ((g_strcmp0(group->multicast.mount, mount) == 0) ||
+            (g_strcmp0(group->multicast.mount, SERVER_MULTICAST_ALL_MOUNTS) == 0))
+        {
+            break;
+        }
+    }
+
+    if (index == server->groups->len)
+    {
+        return;
+    }
+
+    /* One group per stream: all clients of the mount point share its media */
+    gst_rtsp_media_factory_set_shared(factory, TRUE);
+
+    /* Multicast when clients ask for it, unicast (UDP or TCP) otherwise */
+    gst_rtsp_media_factory_set_address_pool(factory, group->pool);
+    gst_rtsp_media_factory_set_protocols(factory, GST_RTSP_LOWER_TRANS_UDP_MCAST |
+                                                  GST_RTSP_LOWER_TRANS_UDP | GST_RTSP_LOWER_TRANS_TCP);
+    gst_rtsp_media_factory_set_media_gtype(factory, server_multicast_media_get_type());
+
+#if GST_CHECK_VERSION(1, 16, 0)
+    /* Clients must not send packets farther than the configured TTL */
+    gst_rtsp_media_factory_set_max_mcast_ttl(factory, (guint)group->multicast.ttl);
+#endif
+
+    g_message("Info: Multicast of \"%s\": %s-%s, ports %d-%d, TTL %d (unicast for other clients)",
+              mount, group->multicast.min_address, group->multicast.max_address,
+              group->multicast.min_port, group->multicast.max_port, group->multicast.ttl);
+}
+
+void server_configure_recovery(const struct server_t *server, GstRTSPMediaFactory *factory,
+                               const gchar *mount)
+{
+    const struct server_fec_t *fec = NULL;
+    guint index = 0;
+
+    if (server->retransmission > 0)
+    {
+        /* AVPF for clients which send NACKs, AVP for the others */
+        gst_rtsp_media_factory_set_profiles(factory, GST_RTSP_PROFILE_AVP | GST_RTSP_PROFILE_AVPF);
+        gst_rtsp_media_factory_set_retransmission_time(factory,
+                                                       (GstClockTime)server->retransmission * GST_MSECOND);
+    }
+
+    for (index = 0; index < server->fecs->len; index++)
+    {
+        fec = &g_array_index(server->fecs, struct server_fec_t, index);
+
+        if ((g_strcmp0(fec->mount, mount) == 0) ||
+            (g_strcmp0(fec->mount, SERVER_MULTICAST_ALL_MOUNTS) == 0))
+        {
+            break;
+        }
+    }
+
+    if (index == server->fecs->len)
+    {
+        return;
+    }
+
+#if GST_CHECK_VERSION(1, 16, 0)
+    g_signal_connect(factory, "media-configure", G_CALLBACK(server_on_fec_media_configure),
+                     GINT_TO_POINTER(fec->percentage));
+
+    g_message("Info: ULPFEC of \"%s\": %d %%, payload type %d", mount, fec->percentage, SERVER_ULPFEC_PT);
+#else
+    g_message("Warning: ULPFEC of \"%s\" needs GStreamer 1.16 or later, it is disabled", mount);
+#endif
+}
+
+void server_on_fec_media_configure(GstRTSPMediaFactory *factory, GstRTSPMedia *media,
+                                   gpointer user_data)
+{
+#if GST_CHECK_VERSION(1, 16, 0)
+    GstRTSPStream *stream = NULL;
+    guint index = 0;
+
+    /* Streams are joined to "rtpbin" when the media is prepared, after this signal */
+    for (index = 0; index < gst_rtsp_media_n_streams(media); index++)
+    {
+        stream = gst_rtsp_media_get_stream(media, index);
+
+        gst_rtsp_stream_set_ulpfec_pt(stream, SERVER_ULPFEC_PT);
+        gst_rtsp_stream_set_ulpfec_percentage(stream, (guint)GPOINTER_TO_INT(user_data));
+    }
+#endif
+}
+
+gboolean server_parse_range(const gchar *str, gchar *first, gchar *last, const gsize size)
+{
+    gchar **parts = g_strsplit(str, "-", 2);
+    gboolean result = FALSE;
+
+    if ((parts[0] != NULL) && (parts[0][0] != '\0') && (strlen(parts[0]) < size) &&
+        ((parts[1] == NULL) || ((parts[1][0] != '\0') && (strlen(parts[1]) < size))))
+    {
+        g_stpcpy(first, parts[0]);
+        g_stpcpy(last, (parts[1] != NULL) ? parts[1] : parts[0]);
+
+        result = TRUE;
+    }
+
+    g_strfreev(parts);
+
+    return result;
+}
+
+gboolean server_is_multicast_address(const gchar *str)
+{
+    GInetAddress *address = g_inet_address_new_from_string(str);
+    gboolean result = FALSE;
+
+    if (address != NULL)
+    {
+        result = (g_inet_address_get_family(address) == G_SOCKET_FAMILY_IPV4) &&
+                 g_inet_address_get_is_multicast(address);
+
+        g_object_unref(address);
+    }
+
+    return result;
+}
+
+void server_free_group(gpointer data)
+{
+    struct server_group_t *group = (struct server_group_t*)data;
+
+    g_object_unref(group->pool);
+    g_free(group);
+}
+
+GstRTSPFilterResult server_count_session(GstRTSPSessionPool *pool, GstRTSPSession *session,
+                                         gpointer user_data)
+{
+    gst_rtsp_session_filter(session, server_count_session_media, user_data);
+
+    return GST_RTSP_FILTER_KEEP;
+}
+
+GstRTSPFilterResult server_count_session_media(GstRTSPSession *session,
+                                               GstRTSPSessionMedia *session_media,
+                                               gpointer user_data)
+{
+    GHashTable *counts = (GHashTable*)user_data;
+    GstRTSPMedia *media = gst_rtsp_session_media_get_media(session_media);
+
+    g_hash_table_insert(counts, media, GINT_TO_POINTER(GPOINTER_TO_INT(g_hash_table_lookup(counts, media)) + 1));
+
+    return GST_RTSP_FILTER_KEEP;
+}
+
+GstRTSPServer *server_new_rtsp_server(const struct server_t *server, const gint port)
+{
+    GstRTSPServer *rtsp_server = NULL;
+    GstRTSPThreadPool *pool = NULL;
+    gchar *port_str = NULL;
+
+    /* Create RTSP server */
+    rtsp_server = gst_rtsp_server_new();
+
+    /* Set port for RTSP server
+     *
+     * We needn't set IP address for it. By default, it will listen for incoming
+     * connecting from address 0.0.0.0. In the context of servers, 0.0.0.0 means all
+     * IPv4 addresses on the local machine. If a host has two IP addresses, 192.168.1.1
+     * and 10.1.2.1, and a server running on the host listens on 0.0.0.0,
+     * it will be reachable at both of those IPs.*/
+    port_str = g_strdup_printf("%d", port);
+    gst_rtsp_server_set_service(rtsp_server, port_str);
+    g_free(port_str);
+
+    /* Each worker thread of the pool runs its own main context. Clients are
+     * spread over these threads, so RTSP requests of one camera do not have to
+     * wait for the main loop which accepts new connections */
+    pool = gst_rtsp_server_get_thread_pool(rtsp_server);
+    gst_rtsp_thread_pool_set_max_threads(pool, server->threads);
+    g_object_unref(pool);
+
+    /* Slow clients are isolated by "capture_t", which needs to know them */
+    g_signal_connect(rtsp_server, "client-connected", G_CALLBACK(server_on_client_connected), NULL);
+
+    return rtsp_server;
+}
+
+void server_on_client_connected(GstRTSPServer *rtsp_server, GstRTSPClient *client,
+                                gpointer user_data)
+{
+    g_signal_connect(client, "play-request", G_CALLBACK(server_on_play_request), NULL);
+}
+
+void server_on_play_request(GstRTSPClient *client, GstRTSPContext *ctx, gpointer user_data)
+{
+    GstRTSPMedia *media = NULL;
+    GstRTSPConnection *connection = NULL;
+    GWeakRef *client_ref = NULL;
+
+    if (ctx->sessmedia == NULL)
+    {
+        return;
+    }
+
+    /* Shared media (multicast mount points) never wait for a client: the RTSP server
+     * keeps dropping the backlog of slow TCP clients */
+    media = gst_rtsp_session_media_get_media(ctx->sessmedia);
+    if (gst_rtsp_media_is_shared(media))
+    {
+        return;
+    }
+
+#if GST_CHECK_VERSION(1, 14, 0)
+    /* The media only feeds this client: let a slow connection back-pressure it, so that
+     * access units queue up in its "appsrc" (bounded by "capture_t") instead of RTP
+     * packets being dropped at random */
+    g_object_set(client, "drop-backlog", FALSE, NULL);
+#endif
+
+    connection = gst_rtsp_client_get_connection(client);
+    if (connection != NULL)
+    {
+        g_object_set_data_full(G_OBJECT(media), SERVER_CLIENT_ADDRESS_KEY,
+                               g_strdup(gst_rtsp_connection_get_ip(connection)), g_free);
+    }
+
+    /* The media must not keep the client alive (the client owns the session of the media) */
+    client_ref = g_new0(GWeakRef, 1);
+    g_weak_ref_init(client_ref, client);
+    g_object_set_data_full(G_OBJECT(media), SERVER_CLIENT_KEY, client_ref, server_free_weak_ref);
+}
+
+void server_free_weak_ref(gpointer data)
+{
+    g_weak_ref_clear((GWeakRef*)data);
+    g_free(data);
+}
+
+/* ---------- Public functions ---------- */
+
+struct server_t *server_create(const enum server_mode_t mode, const gint *ports,
+                               const gint port_counts, const gint threads)
+{
+    struct server_t *server = NULL;
+
+    /* Check parameter(s) */
+    g_return_val_if_fail(mode != SERVER_MODE_UNKNOWN, NULL);
+    g_return_val_if_fail((ports != NULL) && (port_counts > 0) && (threads >= 0), NULL);
+
+    server = g_new0(struct server_t, 1);
+
+    server->mode = mode;
+    server->threads = threads;
+    server->stream_counts = 0;
+
+    server->servers = g_array_new(FALSE, FALSE, sizeof(GstRTSPServer*));
+    server->groups = g_ptr_array_new_with_free_func(server_free_group);
+
+    server->retransmission = SERVER_DEFAULT_RETRANSMISSION;
+    server->fecs = g_array_new(FALSE, FALSE, sizeof(struct server_fec_t));
+
+    server->ports = g_array_new(FALSE, FALSE, sizeof(gint));
+    g_array_append_vals(server->ports, ports, port_counts);
+
+    /* In single-server mode, all streams share one server (one listening socket) */
+    if (mode == SERVER_MODE_SINGLE)
+    {
+        GstRTSPServer *rtsp_server = server_new_rtsp_server(server, ports[0]);
+        g_array_append_val(server->servers, rtsp_server);
+    }
+
+    return server;
+}
+
+gboolean server_add_stream(struct server_t *server, GstRTSPMediaFactory *factory,
+                           GstRTSPMediaFactory *sub_factory)
+{
+    GstRTSPServer *rtsp_server = NULL;
+    GstRTSPMountPoints *mounts = NULL;
+
+    gchar *mount = NULL;
+    gchar *sub_mount = NULL;
+    gint port = 0;
+
+    /* Check parameter(s) */
+    g_return_val_if_fail((server != NULL) && (factory != NULL), FALSE);
+
+    if (server->mode == SERVER_MODE_SINGLE)
+    {
+        /* Every stream is a mount point of the only server */
+        rtsp_server = g_array_index(server->servers, GstRTSPServer*, 0);
+        port = g_array_index(server->ports, gint, 0);
+
+        mount = g_strdup_printf("/%s-%d", SERVER_MOUNT_PREFIX, server->stream_counts + 1);
+    }
+    else
+    {
+        /* Every stream has its own server which listens on its own port */
+        if (server->stream_counts >= (gint)server->ports->len)
+        {
+            g_message("Error: No RTSP port left for stream %d", server->stream_counts + 1);
+
+            g_object_unref(factory);
+            if (sub_factory != NULL)
+            {
+                g_object_unref(sub_factory);
+            }
+
+            return FALSE;
+        }
+
+        port = g_array_index(server->ports, gint, server->stream_counts);
+
+        rtsp_server = server_new_rtsp_server(server, port);
+        g_array_append_val(server->servers, rtsp_server);
+
+        mount = g_strdup(SERVER_LEGACY_MOUNT);
+    }
+
+    /* Get default GstRTSPMountPoints from "rtsp_server" */
+    mounts = gst_rtsp_server_get_mount_points(rtsp_server);
+
+    /* Attach the pipeline to new URL */
+    g_object_set_data_full(G_OBJECT(factory), SERVER_MOUNT_PATH_KEY, g_strdup(mount), g_free);
+    server_configure_multicast(server, factory, mount);
+    server_configure_recovery(server, factory, mount);
+    gst_rtsp_mount_points_add_factory(mounts, mount, factory);
+    g_message("Stream is ready at: \"rtsp://<IP address>:%d%s\"", port, mount);
+
+    /* Attach the substream below the stream's URL */
+    if (sub_factory != NULL)
+    {
+        sub_mount = g_strdup_printf("%s/%s", mount, SERVER_SUB_MOUNT);
+
+        g_object_set_data_full(G_OBJECT(sub_factory), SERVER_MOUNT_PATH_KEY,
+                               g_strdup(sub_mount), g_free);
+        server_configure_multicast(server, sub_factory, sub_mount);
+        server_configure_recovery(server, sub_factory, sub_mount);
+        gst_rtsp_mount_points_add_factory(mounts, sub_mount, sub_factory);
+        g_message("Substream is ready at: \"rtsp://<IP address>:%d%s\"", port, sub_mount);
+    }
+
+    /* Don't need the ref to the mapper anymore */
+    g_object_unref(mounts);
+
+    server->stream_counts++;
+
+    /* Free resources */
+    g_free(mount);
+    g_free(sub_mount);
+
+    return TRUE;
+}
+
+void server_attach(struct server_t *server, GMainContext *context)
+{
+    guint index = 0;
+
+    /* Check parameter(s) */
+    g_return_if_fail(server != NULL);
+
+    g_message("Info: RTSP server mode: %s (%d server(s), %d worker thread(s) each)",
+              server_mode_to_string(server->mode), server->servers->len, server->threads);
+
+    for (index = 0; index < server->servers->len; index++)
+    {
+        gst_rtsp_server_attach(g_array_index(server->servers, GstRTSPServer*, index), context);
+    }
+}
+
+gboolean server_add_multicast(struct server_t *server, const struct server_multicast_t *multicast)
+{
+    struct server_group_t *group = NULL;
+
+    /* Check parameter(s) */
+    g_return_val_if_fail((server != NULL) && (multicast != NULL), FALSE);
+
+    group = g_new0(struct server_group_t, 1);
+
+    group->multicast = *multicast;
+    group->pool = gst_rtsp_address_pool_new();
+
+    /* The first address must not be greater than the last one */
+    if (!gst_rtsp_address_pool_add_range(group->pool, multicast->min_address, multicast->max_address,
+                                         (guint16)multicast->min_port, (guint16)multicast->max_port,
+                                         (guint8)multicast->ttl))
+    {
+        g_message("Error: Invalid multicast range of \"%s\": %s-%s, ports %d-%d", multicast->mount,
+                  multicast->min_address, multicast->max_address,
+                  multicast->min_port, multicast->max_port);
+
+        server_free_group(group);
+
+        return FALSE;
+    }
+
+    g_ptr_array_add(server->groups, group);
+
+    return TRUE;
+}
+
+void server_set_retransmission(struct server_t *server, const gint time)
+{
+    /* Check parameter(s) */
+    g_return_if_fail((server != NULL) && (time >= 0));
+
+    server->retransmission = time;
+}
+
+void server_add_fec(struct server_t *server, const struct server_fec_t *fec)
+{
+    /* Check parameter(s) */
+    g_return_if_fail((server != NULL) && (fec != NULL));
+
+    g_array_append_val(server->fecs, *fec);
+}
+
+void server_count_sessions(struct server_t *server, GHashTable *counts)
+{
+    GstRTSPSessionPool *pool = NULL;
+    guint index = 0;
+
+    /* Check parameter(s) */
+    g_return_if_fail((server != NULL) && (counts != NULL));
+
+    for (index = 0; index < server->servers->len; index++)
+    {
+        pool = gst_rtsp_server_get_session_pool(g_array_index(server->servers, GstRTSPServer*, index));
+        gst_rtsp_session_pool_filter(pool, server_count_session, counts);
+
+        g_object_unref(pool);
+    }
+}
+
+gchar *server_get_media_client(GstRTSPMedia *media)
+{
+    /* Check parameter(s) */
+    g_return_val_if_fail(media != NULL, NULL);
+
+    /* Copied under the lock of object data: the client may play the media again meanwhile */
+    return g_object_dup_data(G_OBJECT(media), SERVER_CLIENT_ADDRESS_KEY, (GDuplicateFunc)g_strdup, NULL);
+}
+
+gboolean server_close_media_client(GstRTSPMedia *media)
+{
+    GWeakRef *client_ref = NULL;
+    GstRTSPClient *client = NULL;
+
+    /* Check parameter(s) */
+    g_return_val_if_fail(media != NULL, FALSE);
+
+    client_ref = g_object_get_data(G_OBJECT(media), SERVER_CLIENT_KEY);
+    if (client_ref != NULL)
+    {
+        client = g_weak_ref_get(client_ref);
+    }
+
+    if (client == NULL)
+    {
+        return FALSE;
+    }
+
+    /* Tears down the sessions of the client, its media are unprepared */
+    gst_rtsp_client_close(client);
+    g_object_unref(client);
+
+    return TRUE;
+}
+
+void server_free(struct server_t *server)
+{
+    guint index = 0;
+
+    /* Check parameter(s) */
+    g_return_if_fail(server != NULL);
+
+    /* Free RTSP servers */
+    for (index = 0; index < server->servers->len; index++)
+    {
+        g_object_unref(g_array_index(server->servers, GstRTSPServer*, index));
+    }
+
+    g_array_free(server->servers, TRUE);
+    g_array_free(server->ports, TRUE);
+    g_ptr_array_free(server->groups, TRUE);
+    g_array_free(server->fecs, TRUE);
+
+    g_free(server);
+}
+
+const gchar* server_mode_to_string(const enum server_mode_t mode)
+{
+    const gchar* result = "";
+
+    switch (mode)
+    {
+        case SERVER_MODE_SINGLE:
+            result = "single";
+        break;
+
+        case SERVER_MODE_PER_PORT:
+            result = "per-port";
+        break;
+
+        default:
+            result = "unknown";
+        break;
+    }
+
+    return result;
+}
+
+enum server_mode_t server_mode_from_string(const gchar *str)
+{
+    enum server_mode_t mode = SERVER_MODE_UNKNOWN;
+
+    /* Check parameter(s) */
+    g_return_val_if_fail(str != NULL, SERVER_MODE_UNKNOWN);
+
+    if (g_ascii_strcasecmp(str, "single") == 0)
+    {
+        mode = SERVER_MODE_SINGLE;
+    }
+    else if ((g_ascii_strcasecmp(str, "per-port") == 0) || (g_ascii_strcasecmp(str, "legacy") == 0))
+    {
+        /* "legacy" is kept as an alias for the original layout (one server per port) */
+        mode = SERVER_MODE_PER_PORT;
+    }
+
+    return mode;
+}
+
+gboolean server_parse_multicast(const gchar *str, struct server_multicast_t *multicast)
+{
+    const gchar *separator = NULL;
+    gchar **fields = NULL;
+    gchar min_port[8];
+    gchar max_port[8];
+    gchar *end = NULL;
+    gint64 value = 0;
+    gboolean result = FALSE;
+
+    /* Check parameter(s) */
+    g_return_val_if_fail((str != NULL) && (multicast != NULL), FALSE);
+
+    /* Mount point: "/..." or SERVER_MULTICAST_ALL_MOUNTS */
+    separator = strchr(str, '=');
+    if ((separator == NULL) || (separator == str) || ((gsize)(separator - str) >= sizeof(multicast->mount)))
+    {
+        return FALSE;
+    }
+
+    memset(multicast, 0, sizeof(*multicast));
+    memcpy(multicast->mount, str, separator - str);
+
+    if ((multicast->mount[0] != '/') && (g_strcmp0(multicast->mount, SERVER_MULTICAST_ALL_MOUNTS) != 0))
+    {
+        return FALSE;
+    }
+
+    /* Addresses, ports and TTL (optional) */
+    fields = g_strsplit(separator + 1, ":", 4);
+
+    if ((g_strv_length(fields) >= 2) && (g_strv_length(fields) <= 3) &&
+        server_parse_range(fields[0], multicast->min_address, multicast->max_address,
+                           sizeof(multicast->min_address)) &&
+        server_is_multicast_address(multicast->min_address) &&
+        server_is_multicast_address(multicast->max_address) &&
+        server_parse_range(fields[1], min_port, max_port, sizeof(min_port)))
+    {
+        multicast->min_port = (gint)g_ascii_strtoll(min_port, &end, 10);
+        result = (*end == '\0');
+
+        multicast->max_port = (gint)g_ascii_strtoll(max_port, &end, 10);
+        result = result && (*end == '\0');
+
+        /* RTP and RTCP ports of at least one stream */
+        result = result && (multicast->min_port > 0) && (multicast->max_port <= G_MAXUINT16) &&
+                 (multicast->min_port < multicast->max_port);
+
+        multicast->ttl = SERVER_MULTICAST_DEFAULT_TTL;
+
+        if (result && (fields[2] != NULL))
+        {
+            value = g_ascii_strtoll(fields[2], &end, 10);
+            result = (end != fields[2]) && (*end == '\0') && (value >= 1) && (value <= G_MAXUINT8);
+
+            multicast->ttl = (gint)value;
+        }
+    }
+
+    g_strfreev(fields);
+
+    return result;
+}
+
+gboolean server_parse_fec(const gchar *str, struct server_fec_t *fec)
+{
+    const gchar *separator = NULL;
+    gchar *end = NULL;
+    gint64 value = 0;
+    gsize length = 0;
+
+    /* Check parameter(s) */
+    g_return_val_if_fail((str != NULL) && (fec != NULL), FALSE);
+
+    /* Mount point: "/..." or SERVER_MULTICAST_ALL_MOUNTS, then the percentage (optional) */
+    separator = strchr(str, '=');
+    length = (separator != NULL) ? (gsize)(separator - str) : strlen(str);
+
+    if ((length == 0) || (length >= sizeof(fec->mount)))
+    {
+        return FALSE;
+    }
+
+    memset(fec, 0, sizeof(*fec));
+    memcpy(fec->mount, str, length);
+
+    if ((fec->mount[0] != '/') && (g_strcmp0(fec->mount, SERVER_MULTICAST_ALL_MOUNTS) != 0))
+    {
+        return FALSE;
+    }
+
+    fec->percentage = SERVER_FEC_DEFAULT_PERCENTAGE;
+
+    if (separator != NULL)
+    {
+        value = g_ascii_strtoll(separator + 1, &end, 10);
+        if ((end == separator + 1) || (*end != '\0') || (value < 1) || (value > 100))
+        {
+            return FALSE;
+        }
+
+        fec->percentage = (gint)value;
+    }
+
+    return TRUE;
+}
@@ -0,0 +1,357 @@
+/***********************************************************************
+ * FILENAME: server.h
+ *
+ * DESCRIPTION:
+ *   Contains APIs to set up RTSP server(s) and publish camera streams.
+ *
+ * PUBLIC FUNCTIONS:
+ *   struct server_t *server_create(const enum server_mode_t mode, const gint *ports,
+ *                                  const gint port_counts, const gint threads);
+ *
+ *   gboolean server_add_stream(struct server_t *server, GstRTSPMediaFactory *factory,
+ *                              GstRTSPMediaFactory *sub_factory);
+ *
+ *   gboolean server_add_multicast(struct server_t *server,
+ *                                 const struct server_multicast_t *multicast);
+ *
+ *   void server_set_retransmission(struct server_t *server, const gint time);
+ *
+ *   void server_add_fec(struct server_t *server, const struct server_fec_t *fec);
+ *
+ *   void server_attach(struct server_t *server, GMainContext *context);
+ *
+ *   void server_count_sessions(struct server_t *server, GHashTable *counts);
+ *
+ *   gchar *server_get_media_client(GstRTSPMedia *media);
+ *
+ *   gboolean server_close_media_client(GstRTSPMedia *media);
+ *
+ *   void server_free(struct server_t *server);
+ *
+ *   const gchar* server_mode_to_string(const enum server_mode_t mode);
+ *
+ *   enum server_mode_t server_mode_from_string(const gchar *str);
+ *
+ *   gboolean server_parse_multicast(const gchar *str, struct server_multicast_t *multicast);
+ *
+ *   gboolean server_parse_fec(const gchar *str, struct server_fec_t *fec);
+ *
+ * AUTHOR: RVC       START DATE: 16/10/2026
+ *
+ * CHANGES:
+ *
+ ***********************************************************************/
+
+#ifndef _SERVER_H_
+#define _SERVER_H_
+
+/* ---------- Macros ---------- */
+
+/* Mount point prefix of streams in single-server mode ("/camera-1", "/camera-2"...) */
+#define SERVER_MOUNT_PREFIX "camera"
+
+/* Mount point of streams in per-port (legacy) mode */
+#define SERVER_LEGACY_MOUNT "/camera"
+
+/* Mount point of substreams, relative to their stream ("/camera-1/sub"...) */
+#define SERVER_SUB_MOUNT "sub"
+
+/* Key of the mount point path (string) attached to every published factory */
+#define SERVER_MOUNT_PATH_KEY "server-mount-path"
+
+/* Keys of the address (string) and of a weak reference (GWeakRef) of the client
+ * attached to every unicast media when it is played */
+#define SERVER_CLIENT_ADDRESS_KEY "server-client-address"
+#define SERVER_CLIENT_KEY "server-client"
+
+/* Mount point of multicast groups which apply to every mount point */
+#define SERVER_MULTICAST_ALL_MOUNTS "all"
+
+/* TTL of multicast packets if not set: the local network only */
+#define SERVER_MULTICAST_DEFAULT_TTL 1
+
+/* Retransmission buffer of every stream (ms) if not set (disabled), and its maximum */
+#define SERVER_DEFAULT_RETRANSMISSION 0
+#define SERVER_MAX_RETRANSMISSION 2000
+
+/* Payload type of ULPFEC packets (RFC 5109), and FEC overhead if not set (%) */
+#define SERVER_ULPFEC_PT 122
+#define SERVER_FEC_DEFAULT_PERCENTAGE 20
+
+/* Maximum length of mount point paths and IPv4 addresses (with terminators) */
+#define SERVER_MAX_MOUNT_LENGTH 64
+#define SERVER_MAX_ADDRESS_LENGTH 16
+
+/* ---------- Datatypes ---------- */
+
+/*
+ * Enum: server_mode_t
+ * ---
+ *   Represents the way streams are published:
+ *     - SERVER_MODE_SINGLE: One RTSP server listens on the first port and exposes
+ *       every camera as its own mount point ("/camera-1", "/camera-2"...).
+ *     - SERVER_MODE_PER_PORT: One RTSP server per camera, each of them listens on
+ *       its own port and exposes the camera at "/camera" (legacy layout).
+ *     - SERVER_MODE_UNKNOWN: Indicate that the mode is invalid.
+ */
+enum server_mode_t
+{
+    SERVER_MODE_SINGLE,
+    SERVER_MODE_PER_PORT,
+    SERVER_MODE_UNKNOWN
+};
+
+/*
+ * Struct: server_t
+ * ---
+ *   Represents RTSP server(s) of the program:
+ *     - mode (enum server_mode_t): Publishing mode.
+ *     - servers (array of "GstRTSPServer" objects): Created RTSP servers.
+ *     - ports (array of integers): Ports for RTSP servers to listen to.
+ *     - threads (gint): Maximum number of worker threads of each server.
+ *     - stream_counts (gint): The number of published streams.
+ *     - groups (array of "server_group_t"): Multicast groups and their address pools.
+ *     - retransmission (gint): Retransmission buffer of every stream (ms, 0 if disabled).
+ *     - fecs (array of "server_fec_t"): Mount points with forward error correction.
+ */
+struct server_t;
+
+/*
+ * Struct: server_multicast_t
+ * ---
+ *   Represents the multicast transport of a mount point:
+ *     - mount (string): Mount point path (such as: "/camera-1/sub"), or
+ *       SERVER_MULTICAST_ALL_MOUNTS.
+ *     - min_address, max_address (string): Range of IPv4 multicast addresses. Every
+ *       stream of a mount point (all clients of it) gets one address of the range.
+ *     - min_port, max_port (gint): Range of UDP ports (two per stream: RTP and RTCP).
+ *     - ttl (gint): Time to live of multicast packets (1 to 255).
+ */
+struct server_multicast_t
+{
+    gchar mount[SERVER_MAX_MOUNT_LENGTH];
+
+    gchar min_address[SERVER_MAX_ADDRESS_LENGTH];
+
+    gchar max_address[SERVER_MAX_ADDRESS_LENGTH];
+
+    gint min_port;
+
+    gint max_port;
+
+    gint ttl;
+};
+
+/*
+ * Struct: server_fec_t
+ * ---
+ *   Represents the forward error correction of a mount point:
+ *     - mount (string): Mount point path (such as: "/camera-1"), or SERVER_MULTICAST_ALL_MOUNTS.
+ *     - percentage (gint): ULPFEC packets sent per 100 media packets (1 to 100).
+ */
+struct server_fec_t
+{
+    gchar mount[SERVER_MAX_MOUNT_LENGTH];
+
+    gint percentage;
+};
+
+/* ---------- Functions ---------- */
+
+/*
+ * Function: server_create
+ * ---
+ *   Creates new "server_t" object.
+ *
+ *   mode: Publishing mode.
+ *   ports: Ports for RTSP servers. In single-server mode, only the first port is used.
+ *   port_counts: The number of elements of "ports" array.
+ *   threads: Maximum number of worker threads (each of them owns a main context)
+ *            used to handle RTSP clients. Set to 0 to handle clients in the
+ *            context the server is attached to.
+ *
+ *   return: NULL (invalid parameters).
+ *           not NULL (successfully create "server_t" object).
+ *
+ *   Note: Should use "server_free()" to deallocate if it is not used anymore.
+ */
+struct server_t *server_create(const enum server_mode_t mode, const gint *ports,
+                               const gint port_counts, const gint threads);
+
+/*
+ * Function: server_add_stream
+ * ---
+ *   Publishes a camera as a new stream.
+ *
+ *   server: Reference to "server_t" object.
+ *   factory: Media factory of the stream.
+ *   sub_factory: Media factory of the substream (NULL if there is no substream).
+ *
+ *   Note: The function takes ownership of "factory" and "sub_factory".
+ *         Their mount point paths are attached to them (see SERVER_MOUNT_PATH_KEY).
+ *
+ *   return: TRUE (the stream is published successfully).
+ *           FALSE (there are no ports left for the stream).
+ */
+gboolean server_add_stream(struct server_t *server, GstRTSPMediaFactory *factory,
+                           GstRTSPMediaFactory *sub_factory);
+
+/*
+ * Function: server_attach
+ * ---
+ *   Attaches all RTSP servers to "context".
+ *
+ *   server: Reference to "server_t" object.
+ *   context: Main context (NULL for the default one).
+ *
+ *   return: void.
+ */
+void server_attach(struct server_t *server, GMainContext *context);
+
+/*
+ * Function: server_add_multicast
+ * ---
+ *   Publishes mount point "multicast::mount" with multicast transport as well.
+ *   Must be called before its stream is added (see "server_add_stream()").
+ *
+ *   Clients which ask for multicast (SETUP with "Transport: RTP/AVP;multicast")
+ *   share one group per stream, so that the stream is sent once whatever the number
+ *   of clients. Clients which cannot join the group keep asking for unicast UDP
+ *   or TCP. The group is advertised in the SDP of the mount point (connection
+ *   address, TTL and port of every media).
+ *
+ *   Mount points with several groups use the first one. Their media are shared
+ *   by all clients, including unicast ones (the backlog of a slow TCP client is
+ *   dropped by the RTSP server).
+ *
+ *   return: TRUE (success).
+ *           FALSE (the address or port range is invalid).
+ */
+gboolean server_add_multicast(struct server_t *server, const struct server_multicast_t *multicast);
+
+/*
+ * Function: server_set_retransmission
+ * ---
+ *   Keeps the RTP packets of every stream for "time" ms (SERVER_DEFAULT_RETRANSMISSION
+ *   if not called), to retransmit those which clients report lost. Must be called before
+ *   streams are added (see "server_add_stream()").
+ *
+ *   Mount points are published with the AVPF profile (RTCP feedback) besides AVP. Clients
+ *   which ask for AVPF send NACKs (RFC 4585), and lost packets are sent again in their
+ *   own RTX stream (RFC 4588). Clients which ask for AVP are not affected.
+ *
+ *   time: Retransmission buffer (ms), 0 to disable retransmissions.
+ *
+ *   return: void.
+ */
+void server_set_retransmission(struct server_t *server, const gint time);
+
+/*
+ * Function: server_add_fec
+ * ---
+ *   Protects the streams of mount point "fec::mount" with ULPFEC packets (RFC 5109,
+ *   payload type SERVER_ULPFEC_PT), advertised in its SDP. Clients recover lost packets
+ *   without asking for them, at the cost of "fec::percentage" % more packets.
+ *   Must be called before its stream is added (see "server_add_stream()").
+ *
+ *   Mount points with several entries use the first one. Needs GStreamer 1.16 or later.
+ *
+ *   return: void.
+ */
+void server_add_fec(struct server_t *server, const struct server_fec_t *fec);
+
+/*
+ * Function: server_count_sessions
+ * ---
+ *   Count RTSP sessions (clients) of every media of all RTSP servers.
+ *
+ *   counts: Hash table (GstRTSPMedia -> gint with GINT_TO_POINTER), the count of
+ *           every media of a session is incremented. Media are not referenced.
+ *
+ *   return: void.
+ */
+void server_count_sessions(struct server_t *server, GHashTable *counts);
+
+/*
+ * Function: server_get_media_client
+ * ---
+ *   Get the address of the client playing unicast media "media".
+ *
+ *   return: NULL (the media is shared, or not played yet).
+ *           not NULL (should be freed with "g_free()").
+ */
+gchar *server_get_media_client(GstRTSPMedia *media);
+
+/*
+ * Function: server_close_media_client
+ * ---
+ *   Closes the connection of the client playing unicast media "media" (and its sessions).
+ *
+ *   return: TRUE (the connection is closed).
+ *           FALSE (no client plays the media anymore).
+ */
+gboolean server_close_media_client(GstRTSPMedia *media);
+
+/*
+ * Function: server_free
+ * ---
+ *   Frees "server_t" object and all RTSP servers inside it.
+ *
+ *   return: void.
+ */
+void server_free(struct server_t *server);
+
+/*
+ * Function: server_mode_to_string
+ * ---
+ *   Convert "enum server_mode_t" to string.
+ *
+ *   Note: The output string must not be de-allocated or modified.
+ *
+ *   return: String (server mode).
+ */
+const gchar* server_mode_to_string(const enum server_mode_t mode);
+
+/*
+ * Function: server_mode_from_string
+ * ---
+ *   Convert string to "enum server_mode_t".
+ *   "legacy" is accepted as an alias of "per-port".
+ *
+ *   return: SERVER_MODE_UNKNOWN if "str" is not a valid mode.
+ */
+enum server_mode_t server_mode_from_string(const gchar *str);
+
+/*
+ * Function: server_parse_multicast
+ * ---
+ *   Convert string to "struct server_multicast_t":
+ *     <mount>=<first address>[-<last address>]:<first port>-<last port>[:<TTL>]
+ *
+ *   Example: "/camera-1=239.255.42.1-239.255.42.4:5000-5099:4",
+ *            "all=239.255.42.1-239.255.42.16:5000-5999".
+ *
+ *   multicast: Multicast transport (output). TTL is SERVER_MULTICAST_DEFAULT_TTL if not set.
+ *
+ *   return: TRUE (success).
+ *           FALSE ("str" is not valid, such as: an address is not an IPv4 multicast address).
+ */
+gboolean server_parse_multicast(const gchar *str, struct server_multicast_t *multicast);
+
+/*
+ * Function: server_parse_fec
+ * ---
+ *   Convert string to "struct server_fec_t":
+ *     <mount>[=<percentage>]
+ *
+ *   Example: "/camera-1=30", "all".
+ *
+ *   fec: Forward error correction (output). Percentage is SERVER_FEC_DEFAULT_PERCENTAGE
+ *        if not set.
+ *
+ *   return: TRUE (success).
+ *           FALSE ("str" is not valid, such as: the percentage is out of range).
+ */
+gboolean server_parse_fec(const gchar *str, struct server_fec_t *fec);
+
+#endif
@@ -0,0 +1,225 @@
+/***********************************************************************
+ * FILENAME: server_test.c
+ *
+ * DESCRIPTION:
+ *   Test of the transports of mount points published by "server.h".
+ *
+ *   Streams are published on an RTSP server which is never attached,
+ *   with empty media factories. Each case gives some mount points a
+ *   multicast group, then checks the configuration of every factory:
+ *   mount points with a group have one media shared by all their clients,
+ *   multicast and unicast fallback (UDP and TCP) ones alike, the others
+ *   are left as they are.
+ *
+ * AUTHOR: RVC       START DATE: 17/10/2026
+ *
+ * CHANGES:
+ *
+ ***********************************************************************/
+
+/* ---------- Header files ---------- */
+#include <glib.h>
+#include <glib/gprintf.h>
+
+#include <gst/gst.h>
+#include <gst/rtsp-server/rtsp-server.h>
+
+#include "server.h"
+
+/* ---------- Macros ---------- */
+
+/* The most streams of a case, and the most groups */
+#define TEST_MAX_STREAMS 4
+#define TEST_MAX_GROUPS 2
+
+/* RTSP port of the server (it never listens) */
+#define TEST_PORT 8554
+
+/* Transports of mount points with a group: multicast, and unicast for the other clients */
+#define TEST_MULTICAST_PROTOCOLS (GST_RTSP_LOWER_TRANS_UDP_MCAST | GST_RTSP_LOWER_TRANS_UDP | \
+                                  GST_RTSP_LOWER_TRANS_TCP)
+
+/* ---------- Datatypes ---------- */
+
+/*
+ * Struct: test_case_t
+ * ---
+ *   Represents streams published with multicast groups:
+ *     - name (string): Description of the case.
+ *     - groups (array of string): Groups (see "server_parse_multicast()").
+ *     - stream_counts (gint): The number of streams, each one with a substream.
+ *     - multicast (array of gboolean): Expected multicast of each stream.
+ *     - sub_multicast (array of gboolean): Expected multicast of each substream.
+ */
+struct test_case_t
+{
+    const gchar *name;
+
+    const gchar *groups[TEST_MAX_GROUPS];
+
+    gint stream_counts;
+
+    gboolean multicast[TEST_MAX_STREAMS];
+
+    gboolean sub_multicast[TEST_MAX_STREAMS];
+};
+
+/* Cases */
+const struct test_case_t test_cases[] = {
+    { "no group", { NULL }, 2,
+      { FALSE, FALSE }, { FALSE, FALSE } },
+    { "group of stream 1", { "/camera-1=239.255.42.1-239.255.42.4:5000-5099:4" }, 2,
+      { TRUE, FALSE }, { FALSE, FALSE } },
+    { "groups of stream 2 and of its substream", { "/camera-2=239.255.42.1:5000-5099",
+                                                   "/camera-2/sub=239.255.42.2:5100-5199" }, 3,
+      { FALSE, TRUE, FALSE }, { FALSE, TRUE, FALSE } },
+    { "group of every mount point", { "all=239.255.42.1-239.255.42.16:5000-5999" }, 2,
+      { TRUE, TRUE }, { TRUE, TRUE } },
+};
+
+/* ---------- Test ---------- */
+
+/*
+ * Function: test_on_log
+ * ---
+ *   Log handler dropping messages (server logs are not part of the results).
+ */
+static void test_on_log(const gchar *domain, GLogLevelFlags level, const gchar *message,
+                        gpointer user_data)
+{
+}
+
+/*
+ * Function: test_check_factory
+ * ---
+ *   Checks the transports of "factory" against "multicast".
+ *
+ *   return: TRUE (expected transports), FALSE (otherwise).
+ */
+static gboolean test_check_factory(GstRTSPMediaFactory *factory, const gboolean multicast)
+{
+    GstRTSPAddressPool *pool = NULL;
+    const gchar *mount = g_object_get_data(G_OBJECT(factory), SERVER_MOUNT_PATH_KEY);
+
+    gboolean shared = gst_rtsp_media_factory_is_shared(factory);
+    GstRTSPLowerTrans protocols = gst_rtsp_media_factory_get_protocols(factory);
+    gboolean result = TRUE;
+
+    pool = gst_rtsp_media_factory_get_address_pool(factory);
+
+    if (multicast)
+    {
+        /* Unicast clients are served by the media of the group */
+        if ((!shared) || (protocols != TEST_MULTICAST_PROTOCOLS) || (pool == NULL))
+        {
+            g_print("  %s: shared %d, protocols 0x%x, address pool %s, expected a shared media "
+                    "with multicast, UDP and TCP\n", mount, shared, (guint)protocols,
+                    (pool != NULL) ? "set" : "none");
+            result = FALSE;
+        }
+    }
+    else if (shared || (pool != NULL))
+    {
+        g_print("  %s: shared %d, address pool %s, expected neither\n", mount, shared,
+                (pool != NULL) ? "set" : "none");
+        result = FALSE;
+    }
+
+    if (pool != NULL)
+    {
+        g_object_unref(pool);
+    }
+
+    return result;
+}
+
+/*
+ * Function: test_run
+ * ---
+ *   Publishes the streams of "test" and checks their factories.
+ *
+ *   return: TRUE (expected transports), FALSE (otherwise).
+ */
+static gboolean test_run(const struct test_case_t *test)
+{
+    struct server_t *server = NULL;
+    struct server_multicast_t multicast;
+
+    GstRTSPMediaFactory *factories[TEST_MAX_STREAMS];
+    GstRTSPMediaFactory *sub_factories[TEST_MAX_STREAMS];
+
+    gint port = TEST_PORT;
+    gboolean result = TRUE;
+    gint index = 0;
+
+    server = server_create(SERVER_MODE_SINGLE, &port, 1, 0);
+
+    for (index = 0; (index < TEST_MAX_GROUPS) && (test->groups[index] != NULL); index++)
+    {
+        if ((!server_parse_multicast(test->groups[index], &multicast)) ||
+            (!server_add_multicast(server, &multicast)))
+        {
+            g_print("  invalid group \"%s\"\n", test->groups[index]);
+            result = FALSE;
+        }
+    }
+
+    /* Factories start unshared. The server takes them, they are kept to be checked */
+    for (index = 0; index < test->stream_counts; index++)
+    {
+        factories[index] = gst_rtsp_media_factory_new();
+        gst_rtsp_media_factory_set_shared(factories[index], FALSE);
+        g_object_ref(factories[index]);
+
+        sub_factories[index] = gst_rtsp_media_factory_new();
+        gst_rtsp_media_factory_set_shared(sub_factories[index], FALSE);
+        g_object_ref(sub_factories[index]);
+
+        server_add_stream(server, factories[index], sub_factories[index]);
+    }
+
+    for (index = 0; index < test->stream_counts; index++)
+    {
+        result = test_check_factory(factories[index], test->multicast[index]) && result;
+        result = test_check_factory(sub_factories[index], test->sub_multicast[index]) && result;
+
+        g_object_unref(factories[index]);
+        g_object_unref(sub_factories[index]);
+    }
+
+    server_free(server);
+
+    return result;
+}
+
+/*
+ * Function: main
+ * ---
+ *   Usage: server_test
+ *
+ *   returns: 0 (every case passed), 1 (failure).
+ */
+int main(int argc, char *argv[])
+{
+    gint result = 0;
+    guint index = 0;
+
+    gst_init(&argc, &argv);
+
+    g_log_set_handler(NULL, G_LOG_LEVEL_MESSAGE, test_on_log, NULL);
+
+    for (index = 0; index < G_N_ELEMENTS(test_cases); index++)
+    {
+        if (test_run(&test_cases[index]))
+        {
+            g_print("%-48s ok\n", test_cases[index].name);
+        }
+        else
+        {
+            g_print("%-48s FAILED\n", test_cases[index].name);
+            result = 1;
+        }
+    }
+
+    return result;
+}
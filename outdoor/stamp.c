@@ -0,0 +1,217 @@
+/***********************************************************************
+ * FILENAME: stamp.c
+ *
+ * DESCRIPTION:
+ *   Latency stamp implementations.
+ *
+ * NOTE:
+ *   For more further information about datatypes and function usages,
+ *   please refer to "stamp.h".
+ *
+ * AUTHOR: RVC       START DATE: 17/10/2026
+ *
+ * CHANGES:
+ *
+ ***********************************************************************/
+
+/* ---------- Header files ---------- */
+
+#include <glib.h>
+#include <string.h>
+
+#include <gst/gst.h>
+
+#include "stamp.h"
+
+/* ---------- Macros ---------- */
+
+/* NAL unit types */
+#define STAMP_NAL_SLICE 1
+#define STAMP_NAL_IDR_SLICE 5
+#define STAMP_NAL_SEI 6
+
+/* SEI payload type: user data unregistered */
+#define STAMP_SEI_USER_DATA_UNREGISTERED 5
+
+/* UUID and two times */
+#define STAMP_PAYLOAD_SIZE 32
+
+/* NAL header, payload type and size, payload (with emulation prevention bytes,
+ * at most one every two bytes) and RBSP trailing bits */
+#define STAMP_NAL_MAX_SIZE (3 + STAMP_PAYLOAD_SIZE + (STAMP_PAYLOAD_SIZE / 2) + 1)
+
+/* ---------- Private variables ---------- */
+
+static const guint8 stamp_uuid[] = STAMP_UUID;
+
+/* ---------- Private functions ---------- */
+
+/*
+ * Function: stamp_write_nal
+ * ---
+ *   Writes the SEI NAL unit (without length) of the stamp to "nal".
+ *
+ *   return: Size of the NAL unit (bytes, at most STAMP_NAL_MAX_SIZE).
+ */
+static gsize stamp_write_nal(guint8 *nal, const gint64 capture_time, const gint64 encode_time);
+
+/* ---------- Private functions ---------- */
+
+gsize stamp_write_nal(guint8 *nal, const gint64 capture_time, const gint64 encode_time)
+{
+    guint8 payload[STAMP_PAYLOAD_SIZE];
+    guint64 value = 0;
+    gsize size = 0;
+    guint zeros = 0;
+    guint index = 0;
+
+    memcpy(payload, stamp_uuid, sizeof(stamp_uuid));
+
+    value = GUINT64_TO_BE((guint64)capture_time);
+    memcpy(payload + 16, &value, sizeof(value));
+
+    value = GUINT64_TO_BE((guint64)encode_time);
+    memcpy(payload + 24, &value, sizeof(value));
+
+    nal[size++] = STAMP_NAL_SEI;
+    nal[size++] = STAMP_SEI_USER_DATA_UNREGISTERED;
+    nal[size++] = STAMP_PAYLOAD_SIZE;
+
+    /* Emulation prevention: "00 00" is never followed by 00, 01, 02 or 03 */
+    for (index = 0; index < STAMP_PAYLOAD_SIZE; index++)
+    {
+        if ((zeros >= 2) && (payload[index] <= 0x03))
+        {
+            nal[size++] = 0x03;
+            zeros = 0;
+        }
+
+        nal[size++] = payload[index];
+        zeros = (payload[index] == 0x00) ? zeros + 1 : 0;
+    }
+
+    /* RBSP trailing bits */
+    nal[size++] = 0x80;
+
+    return size;
+}
+
+/* ---------- Public functions ---------- */
+
+gboolean stamp_is_supported(const GstCaps *caps)
+{
+    const gchar *format = NULL;
+
+    /* Check parameter(s) */
+    g_return_val_if_fail(caps != NULL, FALSE);
+
+    if (gst_caps_is_empty(caps))
+    {
+        return FALSE;
+    }
+
+    format = gst_structure_get_string(gst_caps_get_structure(caps, 0), "stream-format");
+
+    return (format != NULL) && (g_strcmp0(format, "avc") == 0);
+}
+
+guint stamp_get_nal_length_size(const GstCaps *caps)
+{
+    const GValue *value = NULL;
+    GstBuffer *codec_data = NULL;
+    GstMapInfo map;
+    guint size = 4;
+
+    /* Check parameter(s) */
+    g_return_val_if_fail(caps != NULL, 4);
+
+    value = gst_structure_get_value(gst_caps_get_structure(caps, 0), "codec_data");
+    if ((value == NULL) || !GST_VALUE_HOLDS_BUFFER(value))
+    {
+        return size;
+    }
+
+    /* AVCDecoderConfigurationRecord: lengthSizeMinusOne is in byte 4 */
+    codec_data = gst_value_get_buffer(value);
+    if (gst_buffer_map(codec_data, &map, GST_MAP_READ))
+    {
+        if ((map.size > 4) && ((map.data[4] & 0x03) != 2))
+        {
+            size = (map.data[4] & 0x03) + 1;
+        }
+
+        gst_buffer_unmap(codec_data, &map);
+    }
+
+    return size;
+}
+
+GstBuffer *stamp_insert(GstBuffer *buffer, const guint nal_length_size,
+                        const gint64 capture_time, const gint64 encode_time)
+{
+    GstBuffer *stamped = NULL;
+    GstMapInfo map;
+    GstMapInfo stamped_map;
+
+    guint8 nal[STAMP_NAL_MAX_SIZE];
+    gsize nal_size = 0;
+    gsize offset = 0;
+    gsize length = 0;
+    gsize slice_offset = 0;
+    gboolean found = FALSE;
+    guint index = 0;
+    guint type = 0;
+
+    /* Check parameter(s) */
+    g_return_val_if_fail((buffer != NULL) && (nal_length_size >= 1) && (nal_length_size <= 4), NULL);
+
+    if (!gst_buffer_map(buffer, &map, GST_MAP_READ))
+    {
+        return NULL;
+    }
+
+    /* Look for the first slice */
+    while ((offset + nal_length_size < map.size) && !found)
+    {
+        for (length = 0, index = 0; index < nal_length_size; index++)
+        {
+            length = (length << 8) | map.data[offset + index];
+        }
+
+        type = map.data[offset + nal_length_size] & 0x1f;
+        if ((type == STAMP_NAL_SLICE) || (type == STAMP_NAL_IDR_SLICE))
+        {
+            slice_offset = offset;
+            found = TRUE;
+        }
+
+        offset += nal_length_size + length;
+    }
+
+    if (found)
+    {
+        nal_size = stamp_write_nal(nal, capture_time, encode_time);
+
+        stamped = gst_buffer_new_allocate(NULL, map.size + nal_length_size + nal_size, NULL);
+        gst_buffer_copy_into(stamped, buffer, GST_BUFFER_COPY_METADATA, 0, -1);
+        gst_buffer_map(stamped, &stamped_map, GST_MAP_WRITE);
+
+        /* NAL units before the slice, the stamp (with its length), then the rest */
+        memcpy(stamped_map.data, map.data, slice_offset);
+
+        for (index = 0; index < nal_length_size; index++)
+        {
+            stamped_map.data[slice_offset + index] = (nal_size >> (8 * (nal_length_size - 1 - index))) & 0xff;
+        }
+
+        memcpy(stamped_map.data + slice_offset + nal_length_size, nal, nal_size);
+        memcpy(stamped_map.data + slice_offset + nal_length_size + nal_size, map.data + slice_offset,
+               map.size - slice_offset);
+
+        gst_buffer_unmap(stamped, &stamped_map);
+    }
+
+    gst_buffer_unmap(buffer, &map);
+
+    return stamped;
+}
@@ -0,0 +1,82 @@
+/***********************************************************************
+ * FILENAME: stamp.h
+ *
+ * DESCRIPTION:
+ *   Contains APIs to stamp H.264 access units with their capture time
+ *   (option "--latency-stamp"), so that the basephone measures the
+ *   glass-to-glass latency of streams.
+ *
+ *   The stamp is an SEI NAL unit (user data unregistered, identified by
+ *   STAMP_UUID) inserted before the first slice of the access unit:
+ *     - capture time (8 bytes, big-endian): wall-clock time (us since
+ *       1970) when the frame was captured,
+ *     - encode time (8 bytes, big-endian): wall-clock time (us since
+ *       1970) when the access unit left the encoder.
+ *
+ *   Both are times of the outdoor board. The basephone maps them to its
+ *   own clock with RTCP sender reports (which carry the NTP time of the
+ *   same clock), see "basephone/latency.h".
+ *
+ *   Decoders ignore unknown SEI messages.
+ *
+ * PUBLIC FUNCTIONS:
+ *   gboolean stamp_is_supported(const GstCaps *caps);
+ *
+ *   guint stamp_get_nal_length_size(const GstCaps *caps);
+ *
+ *   GstBuffer *stamp_insert(GstBuffer *buffer, const guint nal_length_size,
+ *                           const gint64 capture_time, const gint64 encode_time);
+ *
+ * AUTHOR: RVC       START DATE: 17/10/2026
+ *
+ * CHANGES:
+ *
+ ***********************************************************************/
+
+#ifndef _STAMP_H_
+#define _STAMP_H_
+
+/* ---------- Macros ---------- */
+
+/* UUID of stamps (must match "LATENCY_STAMP_UUID" of the basephone) */
+#define STAMP_UUID { 0x52, 0x5a, 0x47, 0x32, 0x2d, 0x64, 0x6f, 0x6f, \
+                     0x72, 0x70, 0x68, 0x6f, 0x6e, 0x65, 0x2d, 0x74 }
+
+/* ---------- Functions ---------- */
+
+/*
+ * Function: stamp_is_supported
+ * ---
+ *   Checks whether access units of "caps" can be stamped: only
+ *   "video/x-h264, stream-format=avc" (NAL units prefixed by their length).
+ *   Byte-stream access units (start codes, such as: raw .h264 clips) are not.
+ *
+ *   return: TRUE (supported), FALSE (not supported).
+ */
+gboolean stamp_is_supported(const GstCaps *caps);
+
+/*
+ * Function: stamp_get_nal_length_size
+ * ---
+ *   Get the size of NAL unit lengths of "video/x-h264, stream-format=avc" caps
+ *   (from "codec_data").
+ *
+ *   return: 1, 2 or 4 (bytes), 4 if "caps" has no valid "codec_data".
+ */
+guint stamp_get_nal_length_size(const GstCaps *caps);
+
+/*
+ * Function: stamp_insert
+ * ---
+ *   Inserts a stamp before the first slice of access unit "buffer"
+ *   (NAL units prefixed by their length, on "nal_length_size" bytes).
+ *
+ *   capture_time, encode_time: Wall-clock times (us since 1970), see above.
+ *
+ *   return: NULL (the access unit has no slice or is malformed),
+ *           not NULL (a new access unit with the metadata of "buffer").
+ */
+GstBuffer *stamp_insert(GstBuffer *buffer, const guint nal_length_size,
+                        const gint64 capture_time, const gint64 encode_time);
+
+#endif
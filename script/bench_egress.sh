@@ -0,0 +1,133 @@
+#!/bin/bash
+
+USAGE="\n\
+usage:\n\
+   ./bench_egress.sh <cameras> [clients] [seconds]  - UDP egress benchmark of outdoor\n\
+\n\
+   Runs outdoor twice with <cameras> synthetic cameras and <clients> local RTSP clients\n\
+   over UDP (default: one per camera), on the loopback interface:\n\
+     - stock:  one packet per system call (--egress-batch 0)\n\
+     - paced:  batches of \$BATCH packets spread over \$PACING % of frame intervals\n\
+   and reports, for <seconds> seconds (default: 30) after a warm-up:\n\
+     - CPU load of outdoor (% of one core)\n\
+     - UDP datagrams sent per second (whole host, see /proc/net/snmp)\n\
+     - send system calls per second and datagrams per call (needs strace, measured\n\
+       in a second window: strace slows outdoor down)\n\
+\n\
+   Environment variables:\n\
+     OUTDOOR (default: ./outdoor) - outdoor binary\n\
+     PORT    (default: 5001)      - RTSP port\n\
+     PACING  (default: 80)        - --pacing of the paced run (%)\n\
+     BATCH   (default: 8)         - --egress-batch of the paced run (packets)\n\
+     TIER    (default: main)      - stream played by clients: main or sub\n\
+"
+
+if [ "$1" == "" ] ; then
+	echo -e "$USAGE"
+	exit
+fi
+
+CAMERAS=$1
+CLIENTS=${2:-$CAMERAS}
+SECONDS_RUN=${3:-30}
+OUTDOOR=${OUTDOOR:-./outdoor}
+PORT=${PORT:-5001}
+PACING=${PACING:-80}
+BATCH=${BATCH:-8}
+TIER=${TIER:-main}
+HZ=$(getconf CLK_TCK)
+
+# Warm-up (pipelines start with their first client)
+WARMUP=5
+
+OPTIONS="--synthetic $CAMERAS -n $CAMERAS --uplink-bitrate 0 --control-socket="
+
+if [ "$TIER" == "sub" ] ; then
+	MOUNT_SUFFIX="/sub"
+fi
+
+# CPU time (user + system) of a process, in clock ticks
+# Usage: ticks <pid>
+ticks()
+{
+	if [ -e /proc/$1/stat ] ; then
+		awk '{ print $14 + $15 }' /proc/$1/stat
+	else
+		echo 0
+	fi
+}
+
+# UDP datagrams sent by the host
+# Usage: datagrams
+datagrams()
+{
+	awk '$1 == "Udp:" && $2 ~ /^[0-9]+$/ { print $5 }' /proc/net/snmp
+}
+
+# Runs outdoor with extra options and prints: <CPU %> <datagrams/s> <calls/s>
+# Usage: run <options>
+run()
+{
+	local LOG=$(mktemp /tmp/bench_egress.XXXXXX)
+	local PIDS=()
+	local START END FIRST LAST CALLS="-"
+
+	$OUTDOOR -p $PORT $OPTIONS $1 > $LOG 2>&1 &
+	local SERVER=$!
+	sleep 3
+
+	if [ ! -e /proc/$SERVER ] ; then
+		echo "ERROR: outdoor failed to start ($OUTDOOR -p $PORT $OPTIONS $1):" >&2
+		tail -n 20 $LOG >&2
+		rm -f $LOG
+		return 1
+	fi
+
+	for INDEX in $(seq 0 $((CLIENTS - 1))) ; do
+		gst-launch-1.0 -q rtspsrc location=rtsp://127.0.0.1:$PORT/camera-$((INDEX % CAMERAS + 1))$MOUNT_SUFFIX \
+			protocols=udp ! fakesink sync=false > /dev/null 2>&1 &
+		PIDS+=($!)
+	done
+
+	sleep $WARMUP
+
+	START=$(ticks $SERVER)
+	FIRST=$(datagrams)
+	sleep $SECONDS_RUN
+	END=$(ticks $SERVER)
+	LAST=$(datagrams)
+
+	# Send calls of every thread (RTSP server threads included)
+	if which strace > /dev/null 2>&1 ; then
+		strace -c -f -e trace=sendto,sendmsg,sendmmsg -o $LOG.strace -p $SERVER > /dev/null 2>&1 &
+		local TRACER=$!
+		sleep $SECONDS_RUN
+		kill -INT $TRACER > /dev/null 2>&1
+		wait $TRACER > /dev/null 2>&1
+
+		CALLS=$(awk -v time=$SECONDS_RUN '$NF ~ /^send/ { calls += $4 } END { printf "%.0f", calls / time }' \
+			$LOG.strace)
+		rm -f $LOG.strace
+	fi
+
+	kill ${PIDS[@]} $SERVER > /dev/null 2>&1
+	wait ${PIDS[@]} $SERVER > /dev/null 2>&1
+	rm -f $LOG
+
+	echo "$END $START $HZ $SECONDS_RUN $LAST $FIRST $CALLS" \
+		| awk '{ printf "%.1f %.0f %s\n", ($1 - $2) / $3 / $4 * 100, ($5 - $6) / $4, $7 }'
+}
+
+STOCK=$(run "--egress-batch 0") || exit 1
+PACED=$(run "--egress-batch $BATCH --pacing $PACING") || exit 1
+
+echo "$CAMERAS synthetic camera(s), $CLIENTS UDP client(s) of $TIER streams, ${SECONDS_RUN} s"
+
+echo -e "stock $STOCK\npaced $PACED" | awk -v batch=$BATCH -v pacing=$PACING '
+	{
+		label = ($1 == "stock") ? "stock (1 packet/call)" : "paced (" batch " packets, " pacing " %)";
+		per_call = ($4 != "-" && $4 > 0) ? sprintf("%.1f", $3 / $4) : "-";
+
+		if (NR == 1) { printf "%-28s %8s %14s %10s %16s\n", "Egress", "CPU (%)", "datagrams/s", "calls/s", "datagrams/call"; }
+		printf "%-28s %8.1f %14d %10s %16s\n", label, $2, $3, $4, per_call;
+	}'
@@ -0,0 +1,102 @@
+#!/bin/bash
+
+USAGE="\n\
+usage:\n\
+   ./bench_mjpeg.sh <device> [frames]  - compare YUY2 and MJPEG capture of a USB camera\n\
+\n\
+   Each path runs the same pipeline as outdoor (capture, decode, VSP, encode)\n\
+   for <frames> frames (default: 300) and reports frame rate and CPU load.\n\
+\n\
+   Resolutions can be changed with environment variables:\n\
+     YUY2_SIZE  (default: 1280x720)  - raw capture\n\
+     MJPEG_SIZE (default: 1920x1080) - MJPEG capture\n\
+     OUT_SIZE   (default: 1280x720)  - encoder input\n\
+"
+
+if [ "$1" == "" ] ; then
+	echo -e "$USAGE"
+	exit
+fi
+
+DEVICE=$1
+FRAMES=${2:-300}
+YUY2_SIZE=${YUY2_SIZE:-1280x720}
+MJPEG_SIZE=${MJPEG_SIZE:-1920x1080}
+OUT_SIZE=${OUT_SIZE:-1280x720}
+CPUS=$(nproc)
+
+if [ ! -e "$DEVICE" ] ; then
+	echo "ERROR: $DEVICE not found"
+	exit
+fi
+
+# Same branch as CAMERA_ENCODE_FMT_STR (my_gst.h). Software decoders output system memory
+# Usage: encode <dmabuf-use>
+encode()
+{
+	echo "vspmfilter dmabuf-use=$1 \
+		! video/x-raw, format=NV12, width=${OUT_SIZE%x*}, height=${OUT_SIZE#*x} \
+		! omxh264enc target-bitrate=4000000 quant-p-frames=0 \
+		! video/x-h264, profile=high ! h264parse ! fakesink sync=false"
+}
+
+# Run a pipeline, print: name, fps, CPU load (% of one core, and of all cores)
+# Usage: run <name> <pipeline>
+run()
+{
+	local NAME=$1
+	local PIPELINE=$2
+	local START END TICKS_START TICKS_END
+
+	# CPU time of the whole system (user + nice + system), in clock ticks
+	TICKS_START=$(awk '/^cpu / { print $2 + $3 + $4 }' /proc/stat)
+	START=$(date +%s.%N)
+
+	if ! gst-launch-1.0 -q $PIPELINE > /dev/null 2>&1 ; then
+		printf "%-28s %10s\n" "$NAME" "failed"
+		return
+	fi
+
+	END=$(date +%s.%N)
+	TICKS_END=$(awk '/^cpu / { print $2 + $3 + $4 }' /proc/stat)
+
+	awk -v name="$NAME" -v frames=$FRAMES -v start=$START -v end=$END \
+	    -v ticks=$((TICKS_END - TICKS_START)) -v hz=$(getconf CLK_TCK) -v cpus=$CPUS \
+	    'BEGIN { time = end - start; load = ticks / hz / time * 100;
+	             printf "%-28s %10.1f %10.1f %10.1f\n", name, frames / time, load, load / cpus }'
+}
+
+# Check if a GStreamer element is installed
+has_element()
+{
+	gst-inspect-1.0 $1 > /dev/null 2>&1
+}
+
+CAPTURE_YUY2="v4l2src device=$DEVICE io-mode=dmabuf num-buffers=$FRAMES \
+	! video/x-raw, format=YUY2, width=${YUY2_SIZE%x*}, height=${YUY2_SIZE#*x}"
+
+# Usage: capture_mjpeg <io-mode>
+capture_mjpeg()
+{
+	echo "v4l2src device=$DEVICE io-mode=$1 num-buffers=$FRAMES \
+		! image/jpeg, width=${MJPEG_SIZE%x*}, height=${MJPEG_SIZE#*x}"
+}
+
+echo "Device: $DEVICE, $FRAMES frames, $CPUS CPU(s), output $OUT_SIZE"
+printf "%-28s %10s %10s %10s\n" "Path" "fps" "CPU %" "CPU % (all)"
+
+run "YUY2 $YUY2_SIZE" "$CAPTURE_YUY2 ! $(encode true)"
+
+# Same decoders as GST_JPEG_*_DECODER_* (my_gst.h)
+if has_element v4l2jpegdec ; then
+	run "MJPEG $MJPEG_SIZE v4l2jpegdec" \
+	    "$(capture_mjpeg dmabuf) ! v4l2jpegdec capture-io-mode=dmabuf ! video/x-raw, format=NV12 ! $(encode true)"
+fi
+
+if has_element avdec_mjpeg ; then
+	run "MJPEG $MJPEG_SIZE avdec_mjpeg" "$(capture_mjpeg mmap) ! avdec_mjpeg max-threads=$CPUS ! $(encode false)"
+fi
+
+if has_element jpegdec ; then
+	run "MJPEG $MJPEG_SIZE jpegdec" "$(capture_mjpeg mmap) ! jpegdec ! $(encode false)"
+fi
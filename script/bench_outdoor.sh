@@ -0,0 +1,140 @@
+#!/bin/bash
+
+USAGE="\n\
+usage:\n\
+   ./bench_outdoor.sh <cameras> [clients] [seconds]  - end-to-end benchmark of outdoor\n\
+\n\
+   Starts outdoor with <cameras> synthetic cameras (test patterns, no device needed)\n\
+   and <clients> local RTSP clients (default: one per camera, assigned to cameras in\n\
+   turn), then reports for <seconds> seconds (default: 30), after a warm-up:\n\
+     - sustained frame rate and encode latency (capture to encoded frame) of every stream\n\
+     - CPU load of outdoor (% of one core), in total and per stream\n\
+     - memory of outdoor (resident, and peak resident)\n\
+\n\
+   Streams without client are not running, they are not reported.\n\
+   Clients are not measured (they run on the same board).\n\
+\n\
+   Environment variables:\n\
+     OUTDOOR (default: ./outdoor) - outdoor binary\n\
+     PORT    (default: 5001)      - RTSP port\n\
+     WIDTH, HEIGHT (default: 1280x720) - resolution of synthetic cameras\n\
+     FPS     (default: 30)        - frame rate of synthetic cameras\n\
+     MOTION  (default: medium)    - motion of patterns: static, low, medium or high\n\
+     TIER    (default: main)      - stream played by clients: main or sub\n\
+"
+
+if [ "$1" == "" ] ; then
+	echo -e "$USAGE"
+	exit
+fi
+
+CAMERAS=$1
+CLIENTS=${2:-$CAMERAS}
+SECONDS_RUN=${3:-30}
+OUTDOOR=${OUTDOOR:-./outdoor}
+PORT=${PORT:-5001}
+FPS=${FPS:-30}
+MOTION=${MOTION:-medium}
+TIER=${TIER:-main}
+HZ=$(getconf CLK_TCK)
+CPUS=$(nproc)
+
+# Statistics interval of outdoor (seconds) and warm-up (pipelines start with their first client)
+STATS=5
+WARMUP=5
+
+LOG=$(mktemp /tmp/bench_outdoor.XXXXXX)
+
+OPTIONS="--synthetic $CAMERAS -n $CAMERAS --synthetic-fps $FPS --synthetic-motion $MOTION"
+OPTIONS="$OPTIONS --stats $STATS --uplink-bitrate 0 --control-socket="
+if [ "$WIDTH" != "" ] ; then
+	OPTIONS="$OPTIONS --width $WIDTH --height $HEIGHT"
+fi
+
+if [ "$TIER" == "sub" ] ; then
+	MOUNT_SUFFIX="/sub"
+fi
+
+# CPU time (user + system) of a process, in clock ticks
+# Usage: ticks <pid>
+ticks()
+{
+	if [ -e /proc/$1/stat ] ; then
+		awk '{ print $14 + $15 }' /proc/$1/stat
+	else
+		echo 0
+	fi
+}
+
+# Memory of a process (kB)
+# Usage: memory <pid> <VmRSS|VmHWM>
+memory()
+{
+	awk -v field="$2:" '$1 == field { print $2 }' /proc/$1/status 2> /dev/null
+}
+
+$OUTDOOR -p $PORT $OPTIONS > $LOG 2>&1 &
+SERVER=$!
+sleep 3
+
+if [ ! -e /proc/$SERVER ] ; then
+	echo "ERROR: outdoor failed to start ($OUTDOOR -p $PORT $OPTIONS):"
+	tail -n 20 $LOG
+	rm -f $LOG
+	exit 1
+fi
+
+PIDS=()
+for INDEX in $(seq 0 $((CLIENTS - 1))) ; do
+	gst-launch-1.0 -q rtspsrc location=rtsp://127.0.0.1:$PORT/camera-$((INDEX % CAMERAS + 1))$MOUNT_SUFFIX \
+		protocols=udp ! fakesink sync=false > /dev/null 2>&1 &
+	PIDS+=($!)
+done
+
+sleep $WARMUP
+
+# Statistics logged from now on are measured
+FIRST_LINE=$(($(wc -l < $LOG) + 1))
+START=$(ticks $SERVER)
+sleep $SECONDS_RUN
+END=$(ticks $SERVER)
+RSS=$(memory $SERVER VmRSS)
+HWM=$(memory $SERVER VmHWM)
+
+kill ${PIDS[@]} $SERVER > /dev/null 2>&1
+wait > /dev/null 2>&1
+
+echo "$CAMERAS synthetic camera(s) (${WIDTH:-1280}x${HEIGHT:-720}, $FPS fps, $MOTION motion)," \
+     "$CLIENTS client(s) of $TIER streams, ${SECONDS_RUN} s, $CPUS CPU(s)"
+
+# Line format (see "capture_on_stats"):
+#   Info: Stats of Synthetic camera 'synthetic-1' (main): 30.0 fps, latency 12.3 ms (max 20.1 ms)
+tail -n +$FIRST_LINE $LOG \
+	| sed -n "s/.*Info: Stats of .* '\(.*\)' (\(.*\)): \(.*\) fps, latency \(.*\) ms (max \(.*\) ms)/\1 \2 \3 \4 \5/p" \
+	| awk -v ticks=$((END - START)) -v hz=$HZ -v time=$SECONDS_RUN -v cpus=$CPUS -v rss=$RSS -v hwm=$HWM '
+	{
+		stream = $1 " (" $2 ")";
+		if (!(stream in samples)) { order[streams++] = stream; }
+
+		samples[stream]++;
+		fps[stream] += $3;
+		latency[stream] += $4;
+		if ($5 > worst[stream]) { worst[stream] = $5; }
+	}
+	END {
+		printf "%-24s %8s %14s %14s\n", "Stream", "fps", "latency (ms)", "max (ms)";
+		for (index_ = 0; index_ < streams; index_++) {
+			stream = order[index_];
+			printf "%-24s %8.1f %14.1f %14.1f\n", stream, fps[stream] / samples[stream],
+			       latency[stream] / samples[stream], worst[stream];
+		}
+
+		load = ticks / hz / time * 100;
+		printf "CPU: %.1f %% (%.1f %% of all cores), %.1f %% per stream\n", load, load / cpus,
+		       (streams > 0) ? load / streams : 0;
+		printf "Memory: %.1f MB resident, %.1f MB peak\n", rss / 1024, hwm / 1024;
+
+		if (streams == 0) { print "ERROR: no statistics (are clients able to play the streams?)"; }
+	}'
+
+rm -f $LOG
@@ -0,0 +1,142 @@
+#!/bin/bash
+
+USAGE="\n\
+usage:\n\
+   ./bench_replay.sh <video dir> [streams] [seconds]  - compare CPU load of sample video streams\n\
+\n\
+   Plays <streams> sample videos (default: 4) for <seconds> seconds (default: 30)\n\
+   in each mode, and reports the CPU load per stream:\n\
+     qtdemux    - filesrc ! qtdemux ! h264parse ! rtph264pay (gst-launch, one per stream)\n\
+     rtph264pay - outdoor --no-rtp-cache, one RTSP client per stream\n\
+     RTP cache  - outdoor, one RTSP client per stream\n\
+\n\
+   The qtdemux path has no RTSP server and no network, so it is a lower bound of the\n\
+   previous path. Clients are not measured (they run on the same board).\n\
+   Videos should last longer than <seconds> + 5 seconds.\n\
+\n\
+   Environment variables:\n\
+     OUTDOOR (default: ./outdoor) - outdoor binary\n\
+     PORT    (default: 5001)      - RTSP port\n\
+"
+
+if [ "$1" == "" ] ; then
+	echo -e "$USAGE"
+	exit
+fi
+
+VIDEO_DIR=$1
+STREAMS=${2:-4}
+SECONDS_RUN=${3:-30}
+OUTDOOR=${OUTDOOR:-./outdoor}
+PORT=${PORT:-5001}
+HZ=$(getconf CLK_TCK)
+CPUS=$(nproc)
+
+if [ ! -d "$VIDEO_DIR" ] ; then
+	echo "ERROR: $VIDEO_DIR not found"
+	exit
+fi
+
+# Sample videos, reused in turn (like outdoor does)
+VIDEOS=( $(find "$VIDEO_DIR" -name "*.mp4" | sort) )
+if [ ${#VIDEOS[@]} -eq 0 ] ; then
+	echo "ERROR: no MP4 video in $VIDEO_DIR"
+	exit
+fi
+
+# CPU time (user + system) of processes, in clock ticks
+# Usage: ticks <pid>...
+ticks()
+{
+	local PID TOTAL=0
+
+	for PID in $@ ; do
+		if [ -e /proc/$PID/stat ] ; then
+			TOTAL=$((TOTAL + $(awk '{ print $14 + $15 }' /proc/$PID/stat)))
+		fi
+	done
+
+	echo $TOTAL
+}
+
+# Print: name, CPU load (% of one core) per stream and in total, and of all cores
+# Usage: report <name> <ticks>
+report()
+{
+	awk -v name="$1" -v ticks=$2 -v hz=$HZ -v time=$SECONDS_RUN -v streams=$STREAMS -v cpus=$CPUS \
+	    'BEGIN { load = ticks / hz / time * 100;
+	             printf "%-12s %12.1f %10.1f %12.1f\n", name, load / streams, load, load / cpus }'
+}
+
+# Measure processes for SECONDS_RUN seconds, after a warm-up of 5 seconds
+# Usage: measure <name> <pid>...
+measure()
+{
+	local NAME=$1
+	local START END
+
+	shift
+	sleep 5
+
+	START=$(ticks $@)
+	sleep $SECONDS_RUN
+	END=$(ticks $@)
+
+	report "$NAME" $((END - START))
+}
+
+# Run outdoor with sample videos only, play every stream, then measure outdoor
+# Usage: run_outdoor <name> [options]
+run_outdoor()
+{
+	local NAME=$1
+	local SERVER INDEX
+	local CLIENTS=()
+
+	shift
+
+	$OUTDOOR -d "$VIDEO_DIR" -n $STREAMS -p $PORT $@ > /dev/null 2>&1 &
+	SERVER=$!
+	sleep 3
+
+	if [ ! -e /proc/$SERVER ] ; then
+		printf "%-12s %12s\n" "$NAME" "failed"
+		return
+	fi
+
+	for INDEX in $(seq 1 $STREAMS) ; do
+		gst-launch-1.0 -q rtspsrc location=rtsp://127.0.0.1:$PORT/camera-$INDEX protocols=udp \
+			! fakesink sync=false > /dev/null 2>&1 &
+		CLIENTS+=($!)
+	done
+
+	measure "$NAME" $SERVER
+
+	kill ${CLIENTS[@]} $SERVER > /dev/null 2>&1
+	wait > /dev/null 2>&1
+}
+
+# Same elements as the fake camera pipeline before the RTP cache, in real time
+run_qtdemux()
+{
+	local INDEX
+	local PIDS=()
+
+	for INDEX in $(seq 0 $((STREAMS - 1))) ; do
+		gst-launch-1.0 -q filesrc location="${VIDEOS[$((INDEX % ${#VIDEOS[@]}))]}" ! qtdemux \
+			! h264parse ! rtph264pay pt=96 config-interval=3 ! fakesink sync=true > /dev/null 2>&1 &
+		PIDS+=($!)
+	done
+
+	measure "qtdemux" ${PIDS[@]}
+
+	kill ${PIDS[@]} > /dev/null 2>&1
+	wait > /dev/null 2>&1
+}
+
+echo "$STREAMS stream(s), ${SECONDS_RUN} s, $CPUS CPU(s), videos: $VIDEO_DIR"
+printf "%-12s %12s %10s %12s\n" "Path" "CPU %/stream" "CPU %" "CPU % (all)"
+
+run_qtdemux
+run_outdoor "rtph264pay" --no-rtp-cache
+run_outdoor "RTP cache"
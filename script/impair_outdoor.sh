@@ -0,0 +1,112 @@
+#!/bin/bash
+
+USAGE="\n\
+usage:\n\
+   ./impair_outdoor.sh <loss> [delay] [seconds]  - packet loss recovery of outdoor\n\
+\n\
+   Impairs the loopback interface with netem (<loss> % of packets lost, <delay> ms\n\
+   more each way, default: 5), then plays synthetic cameras of outdoor with rtsp_load\n\
+   over UDP for <seconds> seconds (default: 30), three times:\n\
+     - none:    lost packets are not recovered\n\
+     - nack:    NACKs and retransmissions (outdoor --retransmission)\n\
+     - nack+fec: retransmissions and ULPFEC (outdoor --fec all)\n\
+   and reports the complete frames (no packet missing after the jitter buffer), the\n\
+   packet loss left, the frame delay (first packet received to complete frame out of\n\
+   the jitter buffer), and the retransmissions asked and recovered.\n\
+\n\
+   Needs root (tc) and the netem queueing discipline. The impairment is removed at exit.\n\
+\n\
+   Environment variables:\n\
+     OUTDOOR   (default: ./outdoor)   - outdoor binary\n\
+     RTSP_LOAD (default: ./rtsp_load) - rtsp_load binary\n\
+     PORT      (default: 5001)        - RTSP port\n\
+     CAMERAS   (default: 2)           - synthetic cameras\n\
+     CLIENTS   (default: 4)           - sessions (spread over cameras)\n\
+     LATENCY   (default: 200)         - jitter buffer of recovering sessions (ms)\n\
+     RTX       (default: 300)         - retransmission buffer of outdoor (ms)\n\
+     FEC       (default: 20)          - ULPFEC overhead (%)\n\
+"
+
+if [ "$1" == "" ] ; then
+	echo -e "$USAGE"
+	exit
+fi
+
+LOSS=$1
+DELAY=${2:-5}
+SECONDS_RUN=${3:-30}
+OUTDOOR=${OUTDOOR:-./outdoor}
+RTSP_LOAD=${RTSP_LOAD:-./rtsp_load}
+PORT=${PORT:-5001}
+CAMERAS=${CAMERAS:-2}
+CLIENTS=${CLIENTS:-4}
+LATENCY=${LATENCY:-200}
+RTX=${RTX:-300}
+FEC=${FEC:-20}
+
+OPTIONS="--synthetic $CAMERAS -n $CAMERAS --uplink-bitrate 0 --control-socket="
+
+# Removes the impairment of the loopback interface
+cleanup()
+{
+	tc qdisc del dev lo root > /dev/null 2>&1
+}
+
+if ! tc qdisc add dev lo root netem loss ${LOSS}% delay ${DELAY}ms ; then
+	echo "ERROR: Cannot impair the loopback interface (are you root? is sch_netem available?)"
+	exit 1
+fi
+
+trap cleanup EXIT
+
+# Runs outdoor with extra options, then rtsp_load with extra options.
+# Prints the summary of rtsp_load: <complete %> <loss %> <delay ms> <max delay ms> <asked> <recovered>
+# Usage: run <outdoor options> <rtsp_load options>
+run()
+{
+	local LOG=$(mktemp /tmp/impair_outdoor.XXXXXX)
+
+	$OUTDOOR -p $PORT $OPTIONS $1 > $LOG 2>&1 &
+	local SERVER=$!
+	sleep 3
+
+	if [ ! -e /proc/$SERVER ] ; then
+		echo "ERROR: outdoor failed to start ($OUTDOOR -p $PORT $OPTIONS $1):" >&2
+		tail -n 20 $LOG >&2
+		rm -f $LOG
+		return 1
+	fi
+
+	$RTSP_LOAD -s rtsp://127.0.0.1:$PORT -n $CAMERAS -c $CLIENTS -p udp -d $SECONDS_RUN $2 \
+		-o $LOG.json > /dev/null 2>&1
+
+	kill $SERVER > /dev/null 2>&1
+	wait $SERVER > /dev/null 2>&1
+
+	# Fields of the "summary" object of the JSON report
+	sed -n '/"summary"/,$p' $LOG.json | tr -d ' ",' | awk -F: '
+		{ value[$1] = $2 }
+		END {
+			printf "%s %s %s %s %s %s\n", value["complete_percent"], value["loss_percent"],
+			       value["frame_delay_ms_mean"], value["frame_delay_ms_max"],
+			       value["rtx_requests"], value["rtx_recovered"];
+		}'
+
+	rm -f $LOG $LOG.json
+}
+
+NONE=$(run "--retransmission 0" "") || exit 1
+NACK=$(run "--retransmission $RTX" "--recovery $LATENCY") || exit 1
+FEC_RUN=$(run "--retransmission $RTX --fec all=$FEC" "--recovery $LATENCY") || exit 1
+
+echo "$CAMERAS synthetic camera(s), $CLIENTS UDP session(s), ${SECONDS_RUN} s," \
+     "loopback: $LOSS % loss, $DELAY ms delay"
+
+echo -e "none $NONE\nnack $NACK\nnack+fec $FEC_RUN" | awk '
+	{
+		if (NR == 1) {
+			printf "%-10s %12s %10s %12s %12s %10s %10s\n", "Recovery", "complete (%)", "loss (%)",
+			       "delay (ms)", "max (ms)", "NACKs", "recovered";
+		}
+		printf "%-10s %12.3f %10.3f %12.1f %12.1f %10d %10d\n", $1, $2, $3, $4, $5, $6, $7;
+	}'
@@ -0,0 +1,63 @@
+#!/bin/bash
+
+USAGE="\n\
+usage:\n\
+   ./load_outdoor.sh <cameras> <clients> [protocol] [seconds]  - RTSP load test of outdoor\n\
+\n\
+   Starts outdoor with <cameras> synthetic cameras (test patterns, no device needed),\n\
+   then opens <clients> concurrent RTSP sessions against it on the loopback interface\n\
+   with rtsp_load, for <seconds> seconds (default: 30). Sessions are spread over cameras.\n\
+\n\
+   protocol: udp (default), tcp (interleaved), multicast or mixed (the three in turn).\n\
+\n\
+   The JSON report of rtsp_load (setup time, time to first keyframe, fps, packet loss,\n\
+   jitter and inter-arrival gaps of every session) is written to the standard output,\n\
+   or to \$REPORT. Logs of outdoor are kept in \$REPORT.log (if \$REPORT is set).\n\
+\n\
+   Environment variables:\n\
+     OUTDOOR   (default: ./outdoor)   - outdoor binary\n\
+     RTSP_LOAD (default: ./rtsp_load) - rtsp_load binary\n\
+     PORT      (default: 5001)        - RTSP port\n\
+     TIER      (default: main)        - stream played by clients: main or sub\n\
+     RAMP      (default: 100)         - delay between two session starts (ms)\n\
+     REPORT                           - file of the JSON report\n\
+"
+
+if [ "$2" == "" ] ; then
+	echo -e "$USAGE"
+	exit
+fi
+
+CAMERAS=$1
+CLIENTS=$2
+PROTOCOL=${3:-udp}
+SECONDS_RUN=${4:-30}
+OUTDOOR=${OUTDOOR:-./outdoor}
+RTSP_LOAD=${RTSP_LOAD:-./rtsp_load}
+PORT=${PORT:-5001}
+TIER=${TIER:-main}
+RAMP=${RAMP:-100}
+
+if [ "$REPORT" != "" ] ; then
+	LOG=$REPORT.log
+else
+	LOG=/dev/null
+fi
+
+$OUTDOOR -p $PORT --synthetic $CAMERAS -n $CAMERAS --stats 5 --uplink-bitrate 0 --control-socket= > $LOG 2>&1 &
+SERVER=$!
+sleep 3
+
+if [ ! -e /proc/$SERVER ] ; then
+	echo "ERROR: outdoor failed to start (see $LOG)"
+	exit 1
+fi
+
+$RTSP_LOAD -s rtsp://127.0.0.1:$PORT -n $CAMERAS -c $CLIENTS -p $PROTOCOL --tier $TIER \
+	-d $SECONDS_RUN -r $RAMP ${REPORT:+-o "$REPORT"}
+RESULT=$?
+
+kill $SERVER > /dev/null 2>&1
+wait > /dev/null 2>&1
+
+exit $RESULT